@@ -3,14 +3,28 @@
  *
  * Exposes G-code parsing via AppBus using LinuxCNC's rs274ngc interpreter.
  * Implements GCodeProtocol from @linuxcnc-node/eden-protocol.
+ *
+ * Clients opening the same program concurrently share one native parse:
+ * parseGCode attaches later requests to the one already in flight.
  */
 
-import { parseGCode } from "@linuxcnc-node/gcode";
+import {
+  encodePngAsync,
+  parseGCode,
+  parseGCodeCompact,
+  prescanGCode,
+  renderThumbnail,
+  watchGCode,
+  type ProgramWatcher,
+} from "@linuxcnc-node/gcode";
 import type { GCodeProtocol } from "@linuxcnc-node/eden-protocol";
 import type { HostConnection } from "@edenapp/types";
 
 const SERVICE_NAME = "gcode";
 
+/** Programs parsed and rasterized at once by the thumbnails handler */
+const THUMBNAIL_CONCURRENCY = 4;
+
 /**
  * Initialize the G-code service
  */
@@ -22,19 +36,38 @@ export function initGCodeService(): void {
 
       const typedConn = connection as HostConnection<GCodeProtocol>;
 
+      // Programs this client watches, by path
+      const watchers = new Map<string, ProgramWatcher>();
+
       // Handle disconnect
       connection.onClose(() => {
         console.log(`[GCode] Client disconnected: ${clientAppId}`);
+        for (const watcher of watchers.values()) {
+          watcher.close();
+        }
+        watchers.clear();
       });
 
       // Parse handler
       typedConn.handle(
         "parse",
-        async ({ filepath, iniPath, progressUpdates }) => {
+        async ({
+          filepath,
+          iniPath,
+          progressUpdates,
+          collectErrors,
+          maxErrors,
+          profile,
+          profileLines,
+        }) => {
           try {
             const result = await parseGCode(filepath, {
               iniPath,
               progressUpdates: progressUpdates ?? 40,
+              collectErrors,
+              maxErrors,
+              profile,
+              profileLines,
               onProgress: (progress) => {
                 // Stream progress updates to the client
                 try {
@@ -58,6 +91,112 @@ export function initGCodeService(): void {
         }
       );
 
+      // Compact parse handler: same as parse, encoded for transport
+      typedConn.handle(
+        "parse-compact",
+        async ({ filepath, iniPath, progressUpdates, collectErrors, maxErrors, resolution }) => {
+          try {
+            return await parseGCodeCompact(filepath, {
+              iniPath,
+              progressUpdates: progressUpdates ?? 40,
+              collectErrors,
+              maxErrors,
+              resolution,
+              onProgress: (progress) => {
+                try {
+                  typedConn.send("parse-progress", progress);
+                } catch (err) {
+                  console.error("[GCode] Error sending progress:", err);
+                }
+              },
+            });
+          } catch (err) {
+            typedConn.send("error", {
+              code: "PARSE_ERROR",
+              message: err instanceof Error ? err.message : String(err),
+            });
+            throw err;
+          }
+        }
+      );
+
+      // Watch handler: parse now, re-parse when the program or its deps change
+      typedConn.handle("watch", async ({ filepath, iniPath }) => {
+        watchers.get(filepath)?.close();
+
+        const watcher = watchGCode(filepath, { iniPath, progressUpdates: 0 });
+        watcher.on("invalidated", (changedPath: string) => {
+          typedConn.send("program-invalidated", { filepath, changedPath });
+        });
+        watcher.on("result", (result) => {
+          typedConn.send("program-updated", { filepath, result });
+        });
+        watcher.on("error", (err: Error) => {
+          typedConn.send("error", { code: "PARSE_ERROR", message: err.message });
+        });
+        watchers.set(filepath, watcher);
+
+        try {
+          return await watcher.start();
+        } catch (err) {
+          watcher.close();
+          watchers.delete(filepath);
+          typedConn.send("error", {
+            code: "PARSE_ERROR",
+            message: err instanceof Error ? err.message : String(err),
+          });
+          throw err;
+        }
+      });
+
+      typedConn.handle("unwatch", ({ filepath }) => {
+        watchers.get(filepath)?.close();
+        watchers.delete(filepath);
+      });
+
+      // Pre-scan handler: quick structural feedback, no interpreter run
+      typedConn.handle("prescan", async ({ filepath, maxIssues }) => {
+        try {
+          return await prescanGCode(filepath, { maxIssues });
+        } catch (err) {
+          typedConn.send("error", {
+            code: "PRESCAN_ERROR",
+            message: err instanceof Error ? err.message : String(err),
+          });
+          throw err;
+        }
+      });
+
+      // Thumbnail handler: a few programs at a time, each one parsed,
+      // rasterized and encoded before its parse result is dropped
+      typedConn.handle("thumbnails", async ({ filepaths, iniPath, options }) => {
+        const results: { filepath: string; png?: Uint8Array; error?: string }[] =
+          new Array(filepaths.length);
+        let next = 0;
+
+        const drain = async () => {
+          while (next < filepaths.length) {
+            const index = next++;
+            const filepath = filepaths[index];
+            try {
+              const result = await parseGCode(filepath, { iniPath, progressUpdates: 0 });
+              const thumbnail = await renderThumbnail(result, options);
+              results[index] = { filepath, png: await encodePngAsync(thumbnail) };
+            } catch (err) {
+              results[index] = {
+                filepath,
+                error: err instanceof Error ? err.message : String(err),
+              };
+            }
+          }
+        };
+
+        await Promise.all(
+          Array.from({ length: Math.min(THUMBNAIL_CONCURRENCY, filepaths.length) }, drain)
+        );
+        return results;
+      });
+
       // Ping handler
       typedConn.handle("ping", () => {
         return { timestamp: Date.now() };
@@ -1,8 +1,8 @@
 import { app, BrowserWindow, ipcMain, dialog } from "electron";
 import path from "path";
 import fs from "fs";
-import { parseGCode } from "@linuxcnc-node/gcode";
-import { GCodeParseResult } from "@linuxcnc-node/types";
+import { parseGCode, PathSampler } from "@linuxcnc-node/gcode";
+import { GCodeParseResult, PathQuery } from "@linuxcnc-node/types";
 
 process.env.DIST = path.join(__dirname, "../dist");
 process.env.PUBLIC = app.isPackaged
@@ -11,6 +11,8 @@ process.env.PUBLIC = app.isPackaged
 
 let win: BrowserWindow | null;
 let cachedIniPath: string | null = null;
+// Arc-length/time index of the loaded program, queried by playback
+let sampler: PathSampler | null = null;
 const VITE_DEV_SERVER_URL = process.env["VITE_DEV_SERVER_URL"];
 
 function createWindow() {
@@ -66,6 +68,15 @@ app.whenReady().then(() => {
     return cachedIniPath;
   });
 
+  // Playback queries against the loaded program
+  ipcMain.handle("path:sample", (_event, query: PathQuery) => {
+    return sampler ? sampler.positionAt(query) : null;
+  });
+
+  ipcMain.handle("path:lineDistance", (_event, lineNumber: number) => {
+    return sampler ? sampler.lineDistance(lineNumber) : -1;
+  });
+
   ipcMain.handle("dialog:openFile", async () => {
     // If no INI file is selected yet, prompt for one first
     if (!cachedIniPath) {
@@ -106,7 +117,15 @@ app.whenReady().then(() => {
           if (win) win.webContents.send("gcode:progress", progress);
         },
       });
-      return { success: true, result, gcodeContent, filePath: filePaths[0] };
+      sampler = new PathSampler(result);
+      return {
+        success: true,
+        result,
+        gcodeContent,
+        filePath: filePaths[0],
+        pathLength: sampler.length,
+        pathDuration: sampler.duration,
+      };
     } catch (error: any) {
       console.error("Parse error:", error);
       return { success: false, error: error.message };
@@ -4,6 +4,9 @@ contextBridge.exposeInMainWorld("electronAPI", {
   openFile: () => ipcRenderer.invoke("dialog:openFile"),
   selectIni: () => ipcRenderer.invoke("dialog:selectIni"),
   getIniPath: () => ipcRenderer.invoke("ini:getPath"),
+  samplePath: (query: any) => ipcRenderer.invoke("path:sample", query),
+  lineDistance: (lineNumber: number) =>
+    ipcRenderer.invoke("path:lineDistance", lineNumber),
   onProgress: (callback: (progress: any) => void) => {
     ipcRenderer.on("gcode:progress", (_event, value) => callback(value));
   },
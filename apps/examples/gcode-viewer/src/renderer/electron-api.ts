@@ -1,4 +1,4 @@
-import { GCodeParseResult } from "@linuxcnc-node/types";
+import { GCodeParseResult, PathQuery, PathSample } from "@linuxcnc-node/types";
 
 // Define the interface for the exposed Electron API
 export interface ElectronAPI {
@@ -7,10 +7,18 @@ export interface ElectronAPI {
     result?: GCodeParseResult;
     gcodeContent?: string;
     filePath?: string;
+    /** Total toolpath length in mm */
+    pathLength?: number;
+    /** Estimated run time in seconds */
+    pathDuration?: number;
     error?: string;
   }>;
   selectIni: () => Promise<{ success: boolean; iniPath?: string }>;
   getIniPath: () => Promise<string | null>;
+  /** Tool position at a path length or time; null if nothing is loaded */
+  samplePath: (query: PathQuery) => Promise<PathSample | null>;
+  /** Path length at which a G-code line first moves the tool, or -1 */
+  lineDistance: (lineNumber: number) => Promise<number>;
   onProgress: (callback: (progress: any) => void) => void;
   onIniChanged: (callback: (iniPath: string) => void) => void;
 }
@@ -45,28 +45,11 @@ export function displayGCode(content: string, filePath?: string): void {
 /**
  * Seek playback to a specific G-code line number
  */
-export function seekToLine(lineNumber: number): void {
-  // Find the first path segment with this line number
-  for (const seg of state.pathSegments) {
-    if (seg.lineNumber === lineNumber) {
-      // Calculate progress based on the start of this segment
-      const prevCumulative = seg.cumulativeLength - seg.length;
-      const progress =
-        state.totalPathLength > 0 ? prevCumulative / state.totalPathLength : 0;
-      seekToProgress(progress);
-      return;
-    }
-  }
-  // If no exact match, find the closest segment with a line number >= target
-  for (const seg of state.pathSegments) {
-    if (seg.lineNumber >= lineNumber) {
-      const prevCumulative = seg.cumulativeLength - seg.length;
-      const progress =
-        state.totalPathLength > 0 ? prevCumulative / state.totalPathLength : 0;
-      seekToProgress(progress);
-      return;
-    }
-  }
+export async function seekToLine(lineNumber: number): Promise<void> {
+  // Start of the first move from this line, or from the next line that moves
+  const distance = await window.electronAPI.lineDistance(lineNumber);
+  if (distance < 0 || state.totalPathLength === 0) return;
+  seekToProgress(distance / state.totalPathLength);
 }
 
 /**
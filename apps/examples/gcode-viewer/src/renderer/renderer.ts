@@ -2,7 +2,7 @@ import "./electron-api"; // Register global ElectronAPI types
 import { state } from "./state";
 import { initScene, onWindowResize, animate } from "./scene";
 import { displayGCode } from "./gcode-panel";
-import { visualizeGCode, buildPathSegments } from "./visualization";
+import { visualizeGCode } from "./visualization";
 import { resetPlayback, seekToProgress, animatePlayback } from "./playback";
 
 /**
@@ -38,8 +38,9 @@ async function handleOpenFile(): Promise<void> {
     state.operations = result.result.operations;
     visualizeGCode(result.result);
 
-    // Build path segments for progress tracking
-    buildPathSegments();
+    // Path length and run time come from the main-process path sampler
+    state.totalPathLength = result.pathLength ?? 0;
+    state.totalDuration = result.pathDuration ?? 0;
 
     // Display G-code content
     if (result.gcodeContent) {
@@ -75,6 +76,7 @@ function init(): void {
     ?.addEventListener("click", handleOpenFile);
 
   document.getElementById("play-btn")?.addEventListener("click", () => {
+    if (state.isPlaying) return;
     state.isPlaying = true;
     animatePlayback();
   });
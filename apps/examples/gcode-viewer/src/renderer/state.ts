@@ -2,17 +2,6 @@ import * as THREE from "three";
 import { OrbitControls } from "three/examples/jsm/controls/OrbitControls.js";
 import { GCodeOperation } from "@linuxcnc-node/types";
 
-// Path segment for progress tracking
-export interface PathSegment {
-  opIndex: number;
-  lineNumber: number;
-  startPos: THREE.Vector3;
-  endPos: THREE.Vector3;
-  length: number;
-  cumulativeLength: number;
-  arcPoints?: THREE.Vector3[];
-}
-
 // Application state - centralized mutable state
 export const state = {
   // Three.js objects
@@ -28,20 +17,17 @@ export const state = {
   // Playback state
   isPlaying: false,
   currentOpIndex: 0,
-  progressInOp: 0,
   speed: 1.0,
   animationId: null as number | null,
-  currentFeedrate: 1000,
-  RAPID_FEEDRATE: 5000,
-
-  // Arc animation state
-  currentArcPoints: [] as THREE.Vector3[],
-  arcTotalLength: 0,
-  arcDistanceTraveled: 0,
+  // Estimated program time at the tool position, in seconds
+  playbackTime: 0,
+  lastFrameTime: null as number | null,
+  // A path:sample query is outstanding; frames skip until it answers
+  sampleInFlight: false,
 
-  // Progress tracking
-  pathSegments: [] as PathSegment[],
+  // Progress tracking (from the main-process PathSampler)
   totalPathLength: 0,
+  totalDuration: 0,
   globalDistanceTraveled: 0,
   isDraggingProgress: false,
 
@@ -59,64 +59,3 @@ export function visualizeGCode(result: GCodeParseResult): void {
   state.camera.position.set(distance * 0.7, -distance * 0.7, distance * 0.7);
   state.controls.update();
 }
-
-/**
- * Build path segments from operations for progress tracking
- */
-export function buildPathSegments(): void {
-  state.pathSegments = [];
-  state.totalPathLength = 0;
-  let currentPos = new THREE.Vector3(0, 0, 0);
-
-  for (let i = 0; i < state.operations.length; i++) {
-    const op = state.operations[i];
-
-    if (op.type === OperationType.TRAVERSE || op.type === OperationType.FEED) {
-      const nextPos = new THREE.Vector3(op.pos[X], op.pos[Y], op.pos[Z]);
-      const length = currentPos.distanceTo(nextPos);
-      state.totalPathLength += length;
-      state.pathSegments.push({
-        opIndex: i,
-        lineNumber: op.lineNumber,
-        startPos: currentPos.clone(),
-        endPos: nextPos.clone(),
-        length,
-        cumulativeLength: state.totalPathLength,
-      });
-      currentPos = nextPos.clone();
-    } else if (
-      op.type === OperationType.ARC &&
-      "arcData" in op &&
-      "plane" in op
-    ) {
-      const nextPos = new THREE.Vector3(op.pos[X], op.pos[Y], op.pos[Z]);
-      const arcPoints = computeArcPoints(
-        currentPos,
-        nextPos,
-        op.arcData as {
-          centerFirst: number;
-          centerSecond: number;
-          rotation: number;
-          axisEndPoint: number;
-        },
-        op.plane as number
-      );
-      // Calculate arc length
-      let arcLen = 0;
-      for (let j = 1; j < arcPoints.length; j++) {
-        arcLen += arcPoints[j - 1].distanceTo(arcPoints[j]);
-      }
-      state.totalPathLength += arcLen;
-      state.pathSegments.push({
-        opIndex: i,
-        lineNumber: op.lineNumber,
-        startPos: currentPos.clone(),
-        endPos: nextPos.clone(),
-        length: arcLen,
-        cumulativeLength: state.totalPathLength,
-        arcPoints,
-      });
-      currentPos = nextPos.clone();
-    }
-  }
-}
@@ -13,11 +13,18 @@
         "src/cpp/linuxcnc_emc_ops.cc",
         "src/cpp/linuxcnc_modal_state.cc",
         "src/cpp/common.cc",
+        "src/cpp/shared_stat_channel.cc",
         "src/cpp/stat_channel.cc",
+        "src/cpp/stat_tree.cc",
+        "src/cpp/job_progress.cc",
         "src/cpp/command_channel.cc",
         "src/cpp/command_worker.cc",
+        "src/cpp/command_journal.cc",
+        "src/cpp/program_sequencer.cc",
+        "src/cpp/stat_publisher.cc",
         "src/cpp/error_channel.cc",
-        "src/cpp/position_logger.cc"
+        "src/cpp/position_logger.cc",
+        "src/cpp/line_heatmap.cc"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")"
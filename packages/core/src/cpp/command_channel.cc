@@ -16,6 +16,7 @@
 #define EMC_COMMAND_TIMEOUT_DEFAULT 5.0
 #define EMC_COMMAND_ACCEPTED_TIMEOUT_DEFAULT 1.0
 #define EMC_COMMAND_DELAY_DEFAULT 0.01
+#define JOURNAL_PENDING_MAX 1024
 
 namespace LinuxCNC
 {
@@ -124,6 +125,11 @@ namespace LinuxCNC
             }
 
             Napi::Object options = info[0].As<Napi::Object>();
+            if (!ParseNmlConnectionConfig(env, options, config_))
+            {
+                return;
+            }
+
             Napi::Value wait_mode = options.Get(COMMAND_WAIT_MODE_OPTION);
             if (!wait_mode.IsUndefined())
             {
@@ -155,12 +161,12 @@ namespace LinuxCNC
 
         for (int attempt = 0; attempt < NML_CONNECT_ATTEMPTS; ++attempt)
         {
-            const char *nml_file = GetNmlFileCStr();
-            c_channel_ = new RCS_CMD_CHANNEL(emcFormat, "emcCommand", "xemc", nml_file);
+            c_channel_ = new RCS_CMD_CHANNEL(emcFormat, config_.commandBuffer.c_str(),
+                                             config_.processName.c_str(), config_.nmlFile.c_str());
             if (c_channel_ && c_channel_->valid())
             {
-                s_channel_ = new RCS_STAT_CHANNEL(emcFormat, "emcStatus", "xemc", nml_file);
-                if (s_channel_ && s_channel_->valid())
+                s_channel_ = SharedStatChannel::Acquire(config_);
+                if (s_channel_)
                 {
                     // Parse INI file to cache commonly used settings
                     if (!parseIniFile())
@@ -176,8 +182,7 @@ namespace LinuxCNC
 
             delete c_channel_;
             c_channel_ = nullptr;
-            delete s_channel_;
-            s_channel_ = nullptr;
+            s_channel_.reset();
             esleep(NML_CONNECT_RETRY_DELAY);
         }
 
@@ -193,18 +198,12 @@ namespace LinuxCNC
         }
 
         // Poll status to get current INI filename
-        if (s_channel_->peek() != EMC_STAT_TYPE)
+        if (!s_channel_->peek([this](const EMC_STAT &stat)
+                              { ini_filename_ = std::string(stat.task.ini_filename); }))
         {
             return false;
         }
 
-        EMC_STAT *emc_status_ptr = static_cast<EMC_STAT *>(s_channel_->get_address());
-        if (!emc_status_ptr)
-        {
-            return false;
-        }
-
-        ini_filename_ = std::string(emc_status_ptr->task.ini_filename);
         if (ini_filename_.empty())
         {
             return false;
@@ -248,8 +247,7 @@ namespace LinuxCNC
     {
         delete c_channel_;
         c_channel_ = nullptr;
-        delete s_channel_;
-        s_channel_ = nullptr;
+        s_channel_.reset();
 
         // Clear cached INI settings
         ini_filename_.clear();
@@ -287,11 +285,14 @@ namespace LinuxCNC
         }
 
         // Write command to channel
+        CommandJournal &journal = CommandJournal::instance();
         if (c_channel_->write(cmd_msg.get()))
         {
+            journal.record(JournalEvent::WriteFailed, cmd_msg.get(), journal_channel_);
             Napi::Error::New(env, "Failed to write command to NML channel.").ThrowAsJavaScriptException();
             return env.Null();
         }
+        journal.record(JournalEvent::Sent, cmd_msg.get(), journal_channel_);
 
         // Store the serial number for tracking
         last_serial_ = cmd_msg->serial_number;
@@ -300,6 +301,15 @@ namespace LinuxCNC
         // the shared status channel in this mode.
         if (command_wait_mode_ == CommandWaitMode::Sent)
         {
+            if (journal.active())
+            {
+                // Bounded: outcomes of commands nobody polls for are not journaled
+                if (journal_pending_.size() >= JOURNAL_PENDING_MAX)
+                {
+                    journal_pending_.pop_front();
+                }
+                journal_pending_.push_back({last_serial_, static_cast<int>(cmd_msg->type), false});
+            }
             return Napi::Number::New(env, last_serial_);
         }
 
@@ -1141,15 +1151,12 @@ namespace LinuxCNC
 
         int echo_serial = 0;
         RCS_STATUS status = RCS_STATUS::UNINITIALIZED;
-        if (s_channel_->peek() == EMC_STAT_TYPE)
-        {
-            EMC_STAT *stat = static_cast<EMC_STAT *>(s_channel_->get_address());
-            if (stat)
-            {
-                echo_serial = stat->echo_serial_number;
-                status = stat->status;
-            }
-        }
+        s_channel_->peek([&](const EMC_STAT &stat)
+                         {
+            echo_serial = stat.echo_serial_number;
+            status = stat.status; });
+
+        journalSnapshot(echo_serial, status);
 
         Napi::Object snapshot = Napi::Object::New(env);
         snapshot.Set("echoSerial", Napi::Number::New(env, echo_serial));
@@ -1157,35 +1164,80 @@ namespace LinuxCNC
         return snapshot;
     }
 
+    // Journals acceptance and final status of sent-mode commands from the
+    // snapshots the TypeScript status coordinator polls anyway
+    void NapiCommandChannel::journalSnapshot(int echo_serial, RCS_STATUS status)
+    {
+        CommandJournal &journal = CommandJournal::instance();
+        if (!journal.active())
+        {
+            journal_pending_.clear();
+            return;
+        }
+
+        while (!journal_pending_.empty())
+        {
+            JournalPending &pending = journal_pending_.front();
+            int serial_diff = echo_serial - pending.serial;
+            if (serial_diff < 0)
+            {
+                break;
+            }
+            if (!pending.accepted)
+            {
+                journal.record(JournalEvent::Accepted, pending.serial, pending.msgType, journal_channel_);
+                pending.accepted = true;
+            }
+            if (serial_diff > 0)
+            {
+                // A later command was taken, so this one was processed
+                journal.record(JournalEvent::Completed, pending.serial, pending.msgType, journal_channel_,
+                               static_cast<int>(RCS_STATUS::DONE));
+            }
+            else if (status == RCS_STATUS::DONE || status == RCS_STATUS::ERROR)
+            {
+                journal.record(JournalEvent::Completed, pending.serial, pending.msgType, journal_channel_,
+                               static_cast<int>(status));
+            }
+            else
+            {
+                break; // Still executing
+            }
+            journal_pending_.pop_front();
+        }
+    }
+
     RCS_STATUS NapiCommandChannel::waitCommandComplete(double timeout)
     {
         double start = etime();
         do
         {
             double now = etime();
-            if (s_channel_->peek() == EMC_STAT_TYPE)
-            {
-                EMC_STAT *stat = static_cast<EMC_STAT *>(s_channel_->get_address());
-                if (stat)
+            uint32_t seen = s_channel_->sequence();
+            std::optional<RCS_STATUS> result;
+            s_channel_->peek([&](const EMC_STAT &stat)
+                             {
+                // Check if we have any pending command with a known serial
+                if (last_serial_ > 0)
                 {
-                    // Check if we have any pending command with a known serial
-                    if (last_serial_ > 0)
-                    {
-                        int serial_diff = stat->echo_serial_number - last_serial_;
-                        if (serial_diff > 0)
-                        {
-                            return RCS_STATUS::DONE; // Command processed by LCNC
-                        }
-                    }
-                    // Also check current status
-                    if (stat->status == RCS_STATUS::DONE || stat->status == RCS_STATUS::ERROR)
+                    int serial_diff = stat.echo_serial_number - last_serial_;
+                    if (serial_diff > 0)
                     {
-                        return stat->status;
+                        result = RCS_STATUS::DONE; // Command processed by LCNC
+                        return;
                     }
                 }
+                // Also check current status
+                if (stat.status == RCS_STATUS::DONE || stat.status == RCS_STATUS::ERROR)
+                {
+                    result = stat.status;
+                } });
+            if (result)
+            {
+                return *result;
             }
-            // Use LinuxCNC's esleep for portability within its ecosystem
-            esleep(std::min(timeout - (now - start), EMC_COMMAND_DELAY_DEFAULT));
+            // Wakes on the next status write, or polls when task cannot notify
+            s_channel_->waitForUpdate(seen, timeout - (now - start), EMC_COMMAND_DELAY_DEFAULT);
         } while (etime() - start < timeout);
         return RCS_STATUS::UNINITIALIZED; // Timeout
     }
@@ -6,6 +6,9 @@
 #include "emc_nml.hh"
 #include "timer.hh"
 #include "command_worker.hh"
+#include "shared_stat_channel.hh"
+#include "command_journal.hh"
+#include <deque>
 #include <memory>
 
 namespace LinuxCNC
@@ -26,8 +29,9 @@ namespace LinuxCNC
         friend class ProgramOpenWorker;
         friend class SetToolWorker;
 
+        NmlConnectionConfig config_;
         RCS_CMD_CHANNEL *c_channel_ = nullptr;
-        RCS_STAT_CHANNEL *s_channel_ = nullptr; // For echo checking
+        std::shared_ptr<SharedStatChannel> s_channel_; // For echo checking
         int last_serial_ = 0;
         std::string ini_filename_;
         std::string tool_table_filename_;
@@ -35,6 +39,18 @@ namespace LinuxCNC
         std::size_t active_exceptional_workers_ = 0;
         bool disconnect_pending_ = false;
 
+        // Command journal: this channel's id in records, and the sent-mode
+        // commands whose acceptance/outcome is journaled from status snapshots
+        struct JournalPending
+        {
+            int serial;
+            int msgType;
+            bool accepted;
+        };
+        uint16_t journal_channel_ = CommandJournal::nextChannelId();
+        std::deque<JournalPending> journal_pending_;
+        void journalSnapshot(int echo_serial, RCS_STATUS status);
+
         bool connect();
         void disconnect();
         void closeChannels();
@@ -45,6 +61,7 @@ namespace LinuxCNC
         // Getters for cached INI settings
         const std::string &getIniFilename() const { return ini_filename_; }
         const std::string &getToolTableFilename() const { return tool_table_filename_; }
+        const NmlConnectionConfig &getConnectionConfig() const { return config_; }
 
         // Helper for sending commands asynchronously
         Napi::Value sendCommandAsync(const Napi::CallbackInfo &info, std::unique_ptr<RCS_CMD_MSG> cmd_msg, double timeout = 5.0);
@@ -0,0 +1,361 @@
+#include "command_journal.hh"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace LinuxCNC
+{
+    namespace
+    {
+        constexpr size_t FLUSH_BATCH = 256;
+
+        uint64_t nowNs(std::chrono::system_clock::time_point t)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+        }
+
+        uint64_t nowNs(std::chrono::steady_clock::time_point t)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+        }
+
+        std::string rotatedName(const std::string &path, unsigned index)
+        {
+            return index == 0 ? path : path + "." + std::to_string(index);
+        }
+    }
+
+    CommandJournal &CommandJournal::instance()
+    {
+        static CommandJournal journal;
+        return journal;
+    }
+
+    CommandJournal::~CommandJournal()
+    {
+        stop();
+    }
+
+    uint16_t CommandJournal::nextChannelId()
+    {
+        static std::atomic<uint16_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CommandJournal::start(const CommandJournalOptions &options)
+    {
+        stop();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = options;
+        options_.maxFiles = std::max(1u, options_.maxFiles);
+        // stop() drained the ring and no producer can still hold it
+        size_t capacity = JournalRing::roundCapacity(options_.capacity);
+        if (!ring_ || ring_->capacity() != capacity)
+        {
+            ring_ = std::make_unique<JournalRing>(capacity);
+        }
+        batch_.reserve(FLUSH_BATCH);
+
+        last_error_ = openFile();
+        if (!last_error_.empty())
+        {
+            throw std::runtime_error(last_error_);
+        }
+
+        stop_requested_ = false;
+        thread_ = std::thread(&CommandJournal::flushThread, this);
+        active_.store(true, std::memory_order_release);
+    }
+
+    void CommandJournal::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!thread_.joinable())
+            {
+                return;
+            }
+            active_.store(false, std::memory_order_seq_cst);
+            stop_requested_ = true;
+        }
+
+        // Producers that saw the journal active finish their push before the
+        // final drain; later ones see it stopped
+        while (producers_.load(std::memory_order_acquire) != 0)
+        {
+            std::this_thread::yield();
+        }
+        wake_.notify_one();
+        thread_.join();
+
+        if (file_)
+        {
+            fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    void CommandJournal::record(JournalEvent event, const RCS_CMD_MSG *msg, uint16_t channel, int status)
+    {
+        if (!active() || !msg)
+        {
+            return;
+        }
+
+        JournalRecord record;
+        record.serial = msg->serial_number;
+        record.msgType = static_cast<int32_t>(msg->type);
+        record.event = static_cast<uint16_t>(event);
+        record.status = static_cast<int16_t>(status);
+        record.channel = channel;
+
+        // Parameters are the message body after the common header. Derived
+        // messages may start their members in the header's tail padding, so
+        // the body starts right after serial_number.
+        const uint8_t *base = reinterpret_cast<const uint8_t *>(msg);
+        const uint8_t *body = reinterpret_cast<const uint8_t *>(&msg->serial_number + 1);
+        long headerSize = static_cast<long>(body - base);
+        size_t bodySize = msg->size > headerSize ? static_cast<size_t>(msg->size - headerSize) : 0;
+        record.payloadSize = static_cast<uint16_t>(std::min(bodySize, JournalRecord::PAYLOAD_SIZE));
+        memcpy(record.payload, body, record.payloadSize);
+        memset(record.payload + record.payloadSize, 0, JournalRecord::PAYLOAD_SIZE - record.payloadSize);
+        push(record);
+    }
+
+    void CommandJournal::record(JournalEvent event, int serial, int msgType, uint16_t channel, int status)
+    {
+        if (!active())
+        {
+            return;
+        }
+
+        JournalRecord record;
+        record.serial = serial;
+        record.msgType = msgType;
+        record.event = static_cast<uint16_t>(event);
+        record.status = static_cast<int16_t>(status);
+        record.channel = channel;
+        record.payloadSize = 0;
+        memset(record.payload, 0, JournalRecord::PAYLOAD_SIZE);
+        push(record);
+    }
+
+    void CommandJournal::push(JournalRecord &record)
+    {
+        record.wallTimeNs = nowNs(std::chrono::system_clock::now());
+        record.monoTimeNs = nowNs(std::chrono::steady_clock::now());
+
+        // Registered before re-checking active_, pairing with stop()
+        producers_.fetch_add(1, std::memory_order_seq_cst);
+        if (active_.load(std::memory_order_seq_cst))
+        {
+            record.sequence = sequence_.fetch_add(1, std::memory_order_relaxed);
+            if (!ring_->push(record))
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        producers_.fetch_sub(1, std::memory_order_release);
+    }
+
+    CommandJournalStats CommandJournal::stats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CommandJournalStats stats;
+        stats.active = active();
+        stats.path = options_.path;
+        stats.recorded = sequence_.load(std::memory_order_relaxed) - dropped_.load(std::memory_order_relaxed);
+        stats.written = written_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.lastError = last_error_;
+        return stats;
+    }
+
+    void CommandJournal::flushThread()
+    {
+        auto interval = std::chrono::duration<double>(options_.flushInterval);
+        for (;;)
+        {
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait_for(lock, interval, [this]
+                               { return stop_requested_; });
+                stopping = stop_requested_;
+            }
+            drain();
+            if (stopping)
+            {
+                return;
+            }
+        }
+    }
+
+    void CommandJournal::drain()
+    {
+        JournalRecord record;
+        bool more = true;
+        while (more)
+        {
+            batch_.clear();
+            while (batch_.size() < FLUSH_BATCH && (more = ring_->pop(record)))
+            {
+                batch_.push_back(record);
+            }
+            if (batch_.empty() || !file_)
+            {
+                continue;
+            }
+
+            size_t bytes = batch_.size() * sizeof(JournalRecord);
+            if (file_bytes_ > sizeof(JournalFileHeader) && file_bytes_ + bytes > options_.maxFileSize)
+            {
+                fclose(file_);
+                file_ = nullptr;
+                std::string error = openFile();
+                if (!error.empty())
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    last_error_ = error;
+                    continue; // Records are dropped until the next start()
+                }
+            }
+
+            size_t written = fwrite(batch_.data(), sizeof(JournalRecord), batch_.size(), file_);
+            file_bytes_ += written * sizeof(JournalRecord);
+            written_.fetch_add(written, std::memory_order_relaxed);
+            if (written != batch_.size())
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                last_error_ = "Failed to write " + options_.path + " (" + strerror(errno) + ")";
+            }
+        }
+        if (file_)
+        {
+            fflush(file_);
+        }
+    }
+
+    // Opens a fresh file with a header; an existing one is shifted to
+    // path.1. Returns an error message, empty on success.
+    std::string CommandJournal::openFile()
+    {
+        const std::string &path = options_.path;
+
+        FILE *existing = fopen(path.c_str(), "rb");
+        if (existing)
+        {
+            fclose(existing);
+            shiftFiles();
+        }
+
+        file_ = fopen(path.c_str(), "wb");
+        if (!file_)
+        {
+            return "Failed to open " + path + " (" + strerror(errno) + ")";
+        }
+
+        JournalFileHeader header = {};
+        memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = JOURNAL_VERSION;
+        header.recordSize = sizeof(JournalRecord);
+        header.createdWallNs = nowNs(std::chrono::system_clock::now());
+        fwrite(&header, sizeof(header), 1, file_);
+        file_bytes_ = sizeof(header);
+        return "";
+    }
+
+    // path.(n-1) is dropped, path.k moves to path.(k+1) and path to path.1
+    void CommandJournal::shiftFiles()
+    {
+        const std::string &path = options_.path;
+        unsigned last = options_.maxFiles - 1;
+        remove(rotatedName(path, last).c_str());
+        for (unsigned k = last; k > 0; --k)
+        {
+            rename(rotatedName(path, k - 1).c_str(), rotatedName(path, k).c_str());
+        }
+    }
+
+    // startCommandJournal({ path, maxFileSize?, maxFiles?, capacity?, flushInterval? })
+    Napi::Value StartCommandJournal(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsObject())
+        {
+            Napi::TypeError::New(env, "Journal options object expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        Napi::Object obj = info[0].As<Napi::Object>();
+
+        CommandJournalOptions options;
+        Napi::Value path = obj.Get("path");
+        if (!path.IsString() || path.As<Napi::String>().Utf8Value().empty())
+        {
+            Napi::TypeError::New(env, "Journal path (string) expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        options.path = path.As<Napi::String>().Utf8Value();
+
+        auto positive = [&](const char *key, double &out) -> bool
+        {
+            Napi::Value value = obj.Get(key);
+            if (value.IsUndefined())
+                return true;
+            if (!value.IsNumber() || !(value.As<Napi::Number>().DoubleValue() > 0))
+            {
+                Napi::RangeError::New(env, std::string(key) + " must be a positive number").ThrowAsJavaScriptException();
+                return false;
+            }
+            out = value.As<Napi::Number>().DoubleValue();
+            return true;
+        };
+
+        double maxFileSize = static_cast<double>(options.maxFileSize);
+        double maxFiles = options.maxFiles;
+        double capacity = static_cast<double>(options.capacity);
+        if (!positive("maxFileSize", maxFileSize) || !positive("maxFiles", maxFiles) ||
+            !positive("capacity", capacity) || !positive("flushInterval", options.flushInterval))
+        {
+            return env.Undefined();
+        }
+        options.maxFileSize = static_cast<uint64_t>(maxFileSize);
+        options.maxFiles = static_cast<unsigned>(maxFiles);
+        options.capacity = static_cast<size_t>(capacity);
+
+        try
+        {
+            CommandJournal::instance().start(options);
+        }
+        catch (const std::exception &e)
+        {
+            Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        }
+        return env.Undefined();
+    }
+
+    Napi::Value StopCommandJournal(const Napi::CallbackInfo &info)
+    {
+        CommandJournal::instance().stop();
+        return info.Env().Undefined();
+    }
+
+    Napi::Value GetCommandJournalStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        CommandJournalStats stats = CommandJournal::instance().stats();
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("active", Napi::Boolean::New(env, stats.active));
+        result.Set("path", stats.path.empty() ? env.Null() : Napi::String::New(env, stats.path));
+        result.Set("recorded", Napi::Number::New(env, static_cast<double>(stats.recorded)));
+        result.Set("written", Napi::Number::New(env, static_cast<double>(stats.written)));
+        result.Set("dropped", Napi::Number::New(env, static_cast<double>(stats.dropped)));
+        result.Set("lastError", stats.lastError.empty() ? env.Null() : Napi::String::New(env, stats.lastError));
+        return result;
+    }
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <napi.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcs.hh"
+#include "command_journal_utils.hh"
+
+namespace LinuxCNC
+{
+
+    struct CommandJournalOptions
+    {
+        std::string path;
+        uint64_t maxFileSize = 64ull << 20; // Bytes before rotating
+        unsigned maxFiles = 8;              // path, path.1 ... path.(maxFiles-1)
+        size_t capacity = 1 << 16;          // Ring records, rounded up to a power of two
+        double flushInterval = 0.05;        // Seconds
+    };
+
+    struct CommandJournalStats
+    {
+        bool active = false;
+        std::string path;
+        uint64_t recorded = 0; // Pushed into the ring
+        uint64_t written = 0;  // Flushed to disk
+        uint64_t dropped = 0;  // Lost to a full ring
+        std::string lastError;
+    };
+
+    // Process-wide binary journal of every command sent to LinuxCNC. The
+    // command path only copies a fixed-size record into a lock-free ring; a
+    // background thread writes the ring to a size-rotated file.
+    class CommandJournal
+    {
+    public:
+        static CommandJournal &instance();
+
+        // Opens a fresh file (an existing one is rotated away) and starts the
+        // flush thread, restarting it if already running. A changed capacity
+        // replaces the ring, which stop() has emptied.
+        // Throws std::runtime_error if the file cannot be created.
+        void start(const CommandJournalOptions &options);
+
+        // Waits out pushes in progress, flushes what is in the ring and
+        // closes the file
+        void stop();
+
+        bool active() const { return active_.load(std::memory_order_acquire); }
+
+        // Never blocks; a no-op while the journal is stopped
+        void record(JournalEvent event, const RCS_CMD_MSG *msg, uint16_t channel, int status = -1);
+        void record(JournalEvent event, int serial, int msgType, uint16_t channel, int status = -1);
+
+        CommandJournalStats stats();
+
+        // Distinct id for each channel instance, stored in records
+        static uint16_t nextChannelId();
+
+    private:
+        CommandJournal() = default;
+        ~CommandJournal();
+
+        void push(JournalRecord &record);
+        void flushThread();
+        void drain();
+        std::string openFile();
+        void shiftFiles();
+
+        CommandJournalOptions options_;
+        std::unique_ptr<JournalRing> ring_; // Only replaced while stopped
+        std::atomic<bool> active_{false};
+        std::atomic<uint32_t> producers_{0}; // Threads inside push()
+        std::atomic<uint64_t> sequence_{0};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> written_{0};
+
+        std::mutex mutex_; // start/stop, stats and the stop flag, never the command path
+        std::condition_variable wake_;
+        bool stop_requested_ = false;
+        std::thread thread_;
+        std::string last_error_;
+
+        // Flush thread only
+        FILE *file_ = nullptr;
+        uint64_t file_bytes_ = 0;
+        std::vector<JournalRecord> batch_;
+    };
+
+    Napi::Value StartCommandJournal(const Napi::CallbackInfo &info);
+    Napi::Value StopCommandJournal(const Napi::CallbackInfo &info);
+    Napi::Value GetCommandJournalStats(const Napi::CallbackInfo &info);
+
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+// Command journal record format and ring buffer.
+
+namespace LinuxCNC
+{
+    enum class JournalEvent : uint16_t
+    {
+        Sent = 0,        // Written to the command buffer
+        WriteFailed = 1, // NML write returned an error
+        Accepted = 2,    // echo_serial_number reached the serial
+        Completed = 3,   // Final status seen (status field)
+        TimedOut = 4     // No final status within the wait timeout
+    };
+
+    // One journal entry. Written to disk as-is (host byte order) after a
+    // JournalFileHeader, so the layout is fixed.
+    struct JournalRecord
+    {
+        static constexpr size_t PAYLOAD_SIZE = 88;
+
+        uint64_t wallTimeNs;  // Unix time
+        uint64_t monoTimeNs;  // Steady clock, for intervals
+        uint64_t sequence;    // Per process, gaps mean dropped records
+        int32_t serial;       // NML serial number
+        int32_t msgType;      // NML message type
+        uint16_t event;       // JournalEvent
+        int16_t status;       // RCS_STATUS for Completed, else -1
+        uint16_t channel;     // Id of the sending channel instance
+        uint16_t payloadSize; // Valid bytes in payload
+        uint8_t payload[PAYLOAD_SIZE]; // Message body after the RCS_CMD_MSG header, truncated
+    };
+    static_assert(sizeof(JournalRecord) == 128, "journal records are 128 bytes");
+
+    struct JournalFileHeader
+    {
+        char magic[8];        // "LCNCJRNL"
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t createdWallNs;
+        uint64_t reserved;
+    };
+    static_assert(sizeof(JournalFileHeader) == 32, "journal header is 32 bytes");
+
+    constexpr char JOURNAL_MAGIC[8] = {'L', 'C', 'N', 'C', 'J', 'R', 'N', 'L'};
+    constexpr uint32_t JOURNAL_VERSION = 1;
+
+    // Bounded multi-producer multi-consumer queue (Vyukov). push() and pop()
+    // never block or allocate; push() fails when the ring is full.
+    class JournalRing
+    {
+    public:
+        explicit JournalRing(size_t capacity)
+        {
+            size_t size = roundCapacity(capacity);
+            mask_ = size - 1;
+            cells_.reset(new Cell[size]);
+            for (size_t i = 0; i < size; ++i)
+            {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        size_t capacity() const { return mask_ + 1; }
+
+        // Capacity of a ring asked for `capacity` records
+        static size_t roundCapacity(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        bool push(const JournalRecord &record)
+        {
+            size_t pos = enqueue_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = cells_[pos & mask_];
+                size_t seq = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.record = record;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false; // Full
+                }
+                else
+                {
+                    pos = enqueue_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pop(JournalRecord &record)
+        {
+            size_t pos = dequeue_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = cells_[pos & mask_];
+                size_t seq = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        record = cell.record;
+                        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false; // Empty
+                }
+                else
+                {
+                    pos = dequeue_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            JournalRecord record;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_ = 0;
+        alignas(64) std::atomic<size_t> enqueue_{0};
+        alignas(64) std::atomic<size_t> dequeue_{0};
+    };
+
+}
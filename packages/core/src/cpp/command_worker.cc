@@ -5,8 +5,10 @@
 #include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <optional>
 #include "cms.hh"
 #include "tooldata.hh"
+#include "command_journal.hh"
 
 #define EMC_COMMAND_TIMEOUT_DEFAULT 5.0
 #define EMC_COMMAND_DELAY_DEFAULT 0.01
@@ -31,6 +33,12 @@ namespace LinuxCNC
     void CommandWorker::Execute()
     {
         result_status_ = waitCommandComplete();
+
+        if (result_status_ == RCS_STATUS::UNINITIALIZED)
+            CommandJournal::instance().record(JournalEvent::TimedOut, cmd_msg_.get(), channel_->journal_channel_);
+        else
+            CommandJournal::instance().record(JournalEvent::Completed, cmd_msg_.get(), channel_->journal_channel_,
+                                              static_cast<int>(result_status_));
     }
 
     void CommandWorker::OnOK()
@@ -57,24 +65,25 @@ namespace LinuxCNC
         do
         {
             double now = etime();
-            if (channel_->s_channel_->peek() == EMC_STAT_TYPE)
-            {
-                EMC_STAT *stat = static_cast<EMC_STAT *>(channel_->s_channel_->get_address());
-                if (stat)
+            uint32_t seen = channel_->s_channel_->sequence();
+            std::optional<RCS_STATUS> result;
+            channel_->s_channel_->peek([&](const EMC_STAT &stat)
+                                       {
+                int serial_diff = stat.echo_serial_number - command_serial_;
+                if (serial_diff > 0)
                 {
-                    int serial_diff = stat->echo_serial_number - command_serial_;
-                    if (serial_diff > 0)
-                    {
-                        return RCS_STATUS::DONE; // Command processed by LCNC
-                    }
-                    if (serial_diff == 0 && (stat->status == RCS_STATUS::DONE || stat->status == RCS_STATUS::ERROR))
-                    {
-                        return stat->status; // Final status from LCNC for this command
-                    }
+                    result = RCS_STATUS::DONE; // Command processed by LCNC
                 }
+                else if (serial_diff == 0 && (stat.status == RCS_STATUS::DONE || stat.status == RCS_STATUS::ERROR))
+                {
+                    result = stat.status; // Final status from LCNC for this command
+                } });
+            if (result)
+            {
+                return *result;
             }
-            // Use LinuxCNC's esleep for portability within its ecosystem
-            esleep(std::min(timeout_ - (now - start), EMC_COMMAND_DELAY_DEFAULT));
+            // Wakes on the next status write, or polls when task cannot notify
+            channel_->s_channel_->waitForUpdate(seen, timeout_ - (now - start), EMC_COMMAND_DELAY_DEFAULT);
         } while (etime() - start < timeout_);
         return RCS_STATUS::UNINITIALIZED; // Timeout
     }
@@ -109,14 +118,14 @@ namespace LinuxCNC
 
             // First close any open program
             EMC_TASK_PLAN_CLOSE close_msg;
-            if (channel_->c_channel_->write(&close_msg))
+            if (!sendJournaled(close_msg))
             {
                 result_status_ = RCS_STATUS::ERROR;
                 SetError("Failed to send close command");
                 return;
             }
 
-            RCS_STATUS close_status = waitCommandComplete(close_msg.serial_number);
+            RCS_STATUS close_status = waitJournaled(close_msg);
             if (close_status != RCS_STATUS::DONE)
             {
                 result_status_ = close_status;
@@ -148,7 +157,7 @@ namespace LinuxCNC
             else
             {
                 // Local case - simple command
-                if (channel_->c_channel_->write(&open_msg))
+                if (!sendJournaled(open_msg))
                 {
                     result_status_ = RCS_STATUS::ERROR;
                     SetError("Failed to send open command");
@@ -157,7 +166,7 @@ namespace LinuxCNC
                 final_serial_ = open_msg.serial_number;
                 result_status_ = wait_mode_ == CommandWaitMode::Sent
                                      ? RCS_STATUS::DONE
-                                     : waitCommandComplete(final_serial_);
+                                     : waitJournaled(open_msg);
             }
         }
         catch (const std::exception &e)
@@ -188,8 +197,9 @@ namespace LinuxCNC
 
     bool ProgramOpenWorker::connectStatusChannel()
     {
+        const NmlConnectionConfig &config = channel_->getConnectionConfig();
         status_channel_ = std::make_unique<RCS_STAT_CHANNEL>(
-            emcFormat, "emcStatus", "xemc", GetNmlFileCStr());
+            emcFormat, config.statusBuffer.c_str(), config.processName.c_str(), config.nmlFile.c_str());
         return status_channel_ && status_channel_->valid();
     }
 
@@ -200,6 +210,7 @@ namespace LinuxCNC
         do
         {
             double now = etime();
+            uint32_t seen = channel_->s_channel_->sequence();
             if (status_channel_->peek() == EMC_STAT_TYPE)
             {
                 EMC_STAT *stat = static_cast<EMC_STAT *>(status_channel_->get_address());
@@ -217,7 +228,7 @@ namespace LinuxCNC
                     }
                 }
             }
-            esleep(std::min(completion_timeout_ - (now - start), EMC_COMMAND_DELAY_DEFAULT));
+            channel_->s_channel_->waitForUpdate(seen, completion_timeout_ - (now - start), EMC_COMMAND_DELAY_DEFAULT);
         } while (etime() - start < completion_timeout_);
         return RCS_STATUS::UNINITIALIZED;
     }
@@ -273,7 +284,7 @@ namespace LinuxCNC
 
             open_msg.remote_buffersize = actually_read;
 
-            if (channel_->c_channel_->write(&open_msg))
+            if (!sendJournaled(open_msg))
             {
                 fclose(fd);
                 SetError("Error sending file chunk for: " + file_path_);
@@ -289,7 +300,7 @@ namespace LinuxCNC
                 return RCS_STATUS::DONE;
             }
 
-            last_chunk_status = waitCommandComplete(final_serial_);
+            last_chunk_status = waitJournaled(open_msg);
             if (last_chunk_status != RCS_STATUS::DONE)
             {
                 fclose(fd);
@@ -303,6 +314,25 @@ namespace LinuxCNC
         return last_chunk_status;
     }
 
+    bool ProgramOpenWorker::sendJournaled(RCS_CMD_MSG &msg)
+    {
+        bool failed = channel_->c_channel_->write(&msg) != 0;
+        CommandJournal::instance().record(failed ? JournalEvent::WriteFailed : JournalEvent::Sent,
+                                          &msg, channel_->journal_channel_);
+        return !failed;
+    }
+
+    RCS_STATUS ProgramOpenWorker::waitJournaled(const RCS_CMD_MSG &msg)
+    {
+        RCS_STATUS status = waitCommandComplete(msg.serial_number);
+        if (status == RCS_STATUS::UNINITIALIZED)
+            CommandJournal::instance().record(JournalEvent::TimedOut, &msg, channel_->journal_channel_);
+        else
+            CommandJournal::instance().record(JournalEvent::Completed, &msg, channel_->journal_channel_,
+                                              static_cast<int>(status));
+        return status;
+    }
+
     void ProgramOpenWorker::releaseChannel()
     {
         if (!channel_)
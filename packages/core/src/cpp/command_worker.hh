@@ -73,6 +73,9 @@ namespace LinuxCNC
         bool connectStatusChannel();
         RCS_STATUS waitCommandComplete(int serial);
         RCS_STATUS handleRemoteFileTransfer(EMC_TASK_PLAN_OPEN &open_msg);
+        // Command channel write and completion wait, both journaled
+        bool sendJournaled(RCS_CMD_MSG &msg);
+        RCS_STATUS waitJournaled(const RCS_CMD_MSG &msg);
         void releaseChannel();
     };
 
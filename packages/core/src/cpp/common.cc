@@ -1,5 +1,6 @@
 #include "common.hh"
 #include <vector>
+#include <utility>
 
 namespace LinuxCNC
 {
@@ -28,6 +29,43 @@ namespace LinuxCNC
         return g_nmlFilePath.c_str();
     }
 
+    bool ParseNmlConnectionConfig(Napi::Env env, Napi::Value options, NmlConnectionConfig &config)
+    {
+        if (options.IsUndefined() || options.IsNull())
+        {
+            return true;
+        }
+        if (!options.IsObject())
+        {
+            Napi::TypeError::New(env, "NML connection options object expected").ThrowAsJavaScriptException();
+            return false;
+        }
+
+        Napi::Object obj = options.As<Napi::Object>();
+        const std::pair<const char *, std::string *> fields[] = {
+            {"nmlFile", &config.nmlFile},
+            {"processName", &config.processName},
+            {"statusBuffer", &config.statusBuffer},
+            {"commandBuffer", &config.commandBuffer},
+            {"errorBuffer", &config.errorBuffer},
+        };
+        for (const auto &[key, target] : fields)
+        {
+            Napi::Value value = obj.Get(key);
+            if (value.IsUndefined())
+            {
+                continue;
+            }
+            if (!value.IsString() || value.As<Napi::String>().Utf8Value().empty())
+            {
+                Napi::TypeError::New(env, std::string(key) + " must be a non-empty string").ThrowAsJavaScriptException();
+                return false;
+            }
+            *target = value.As<Napi::String>().Utf8Value();
+        }
+        return true;
+    }
+
     Napi::Float64Array EmcPoseToNapiFloat64Array(Napi::Env env, const EmcPose &pose)
     {
         Napi::Float64Array arr = Napi::Float64Array::New(env, 9);
@@ -16,6 +16,22 @@ namespace LinuxCNC
     Napi::Value GetNmlFilePath(const Napi::CallbackInfo &info);
     const char *GetNmlFileCStr();
 
+    // Per-instance NML connection settings. Channels built from a default
+    // config use the process-wide NML file and the stock LinuxCNC buffers.
+    struct NmlConnectionConfig
+    {
+        std::string nmlFile = g_nmlFilePath;
+        std::string processName = "xemc";
+        std::string statusBuffer = "emcStatus";
+        std::string commandBuffer = "emcCommand";
+        std::string errorBuffer = "emcError";
+    };
+
+    // Reads {nmlFile, processName, statusBuffer, commandBuffer, errorBuffer}
+    // from an options object. Undefined options leave the defaults in place.
+    // Throws a JS TypeError and returns false on malformed options.
+    bool ParseNmlConnectionConfig(Napi::Env env, Napi::Value options, NmlConnectionConfig &config);
+
     // Helper to convert EmcPose to Napi::Float64Array (9 elements: x,y,z,a,b,c,u,v,w)
     Napi::Float64Array EmcPoseToNapiFloat64Array(Napi::Env env, const EmcPose &pose);
 
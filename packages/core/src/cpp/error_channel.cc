@@ -26,6 +26,10 @@ namespace LinuxCNC
     NapiErrorChannel::NapiErrorChannel(const Napi::CallbackInfo &info) : Napi::ObjectWrap<NapiErrorChannel>(info)
     {
         Napi::Env env = info.Env();
+        if (info.Length() > 0 && !ParseNmlConnectionConfig(env, info[0], config_))
+        {
+            return;
+        }
         if (!connect())
         {
             Napi::Error::New(env, "Failed to connect to LinuxCNC error channel").ThrowAsJavaScriptException();
@@ -41,8 +45,8 @@ namespace LinuxCNC
     {
         if (c_channel_)
             return true;
-        const char *nml_file = GetNmlFileCStr();
-        c_channel_ = new NML(emcFormat, "emcError", "xemc", nml_file);
+        c_channel_ = new NML(emcFormat, config_.errorBuffer.c_str(),
+                             config_.processName.c_str(), config_.nmlFile.c_str());
         if (!c_channel_ || !c_channel_->valid())
         {
             delete c_channel_;
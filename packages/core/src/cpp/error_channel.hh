@@ -16,6 +16,7 @@ namespace LinuxCNC
 
     private:
         static Napi::FunctionReference constructor;
+        NmlConnectionConfig config_;
         NML *c_channel_ = nullptr;
 
         bool connect();
@@ -0,0 +1,170 @@
+#include "job_progress.hh"
+#include <algorithm>
+#include <stdexcept>
+
+namespace LinuxCNC
+{
+    bool JobProgress::operator==(const JobProgress &other) const
+    {
+        return active == other.active && segment == other.segment && percent == other.percent &&
+               distanceDone == other.distanceDone && distanceRemaining == other.distanceRemaining &&
+               timeRemaining == other.timeRemaining;
+    }
+
+    void JobProgressEngine::setProgram(std::vector<int32_t> lineNumbers,
+                                       const std::vector<double> &lengths,
+                                       const std::vector<double> &durations,
+                                       const std::vector<uint8_t> &rapid)
+    {
+        size_t n = lineNumbers.size();
+        if (lengths.size() != n || durations.size() != n || (!rapid.empty() && rapid.size() != n))
+        {
+            throw std::invalid_argument("Program table columns must have the same length");
+        }
+
+        clear();
+        lineNumbers_ = std::move(lineNumbers);
+        cumLength_.assign(n + 1, 0.0);
+        cumFeedTime_.assign(n + 1, 0.0);
+        cumRapidTime_.assign(n + 1, 0.0);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool isRapid = !rapid.empty() && rapid[i];
+            double seconds = std::max(durations[i], 0.0);
+            cumLength_[i + 1] = cumLength_[i] + std::max(lengths[i], 0.0);
+            cumFeedTime_[i + 1] = cumFeedTime_[i] + (isRapid ? 0.0 : seconds);
+            cumRapidTime_[i + 1] = cumRapidTime_[i] + (isRapid ? seconds : 0.0);
+
+            if (i == 0 || lineNumbers_[i] != lineNumbers_[i - 1])
+            {
+                runsByLine_[lineNumbers_[i]].push_back(i);
+            }
+        }
+
+        last_.distanceRemaining = totalLength();
+        last_.timeRemaining = totalTime();
+    }
+
+    void JobProgressEngine::clear()
+    {
+        lineNumbers_.clear();
+        cumLength_.clear();
+        cumFeedTime_.clear();
+        cumRapidTime_.clear();
+        runsByLine_.clear();
+        runStart_ = runEnd_ = 0;
+        located_ = false;
+        wasRunning_ = false;
+        last_ = JobProgress{};
+    }
+
+    bool JobProgressEngine::locate(int motionLine, size_t &runStart, size_t &runEnd) const
+    {
+        auto it = runsByLine_.find(motionLine);
+        if (it == runsByLine_.end())
+        {
+            return false;
+        }
+
+        // Lines repeat in loops and subroutines: take the first run at or
+        // after the current one, wrapping to the first run otherwise
+        const std::vector<size_t> &runs = it->second;
+        size_t from = located_ ? runStart_ : 0;
+        auto next = std::lower_bound(runs.begin(), runs.end(), from);
+        runStart = next != runs.end() ? *next : runs.front();
+
+        runEnd = runStart + 1;
+        while (runEnd < lineNumbers_.size() && lineNumbers_[runEnd] == motionLine)
+        {
+            ++runEnd;
+        }
+        return true;
+    }
+
+    JobProgress JobProgressEngine::at(size_t runStart, size_t runEnd, const JobProgressInput &input) const
+    {
+        size_t n = lineNumbers_.size();
+        double runLength = cumLength_[runEnd] - cumLength_[runStart];
+        double runFeed = cumFeedTime_[runEnd] - cumFeedTime_[runStart];
+        double runRapid = cumRapidTime_[runEnd] - cumRapidTime_[runStart];
+
+        // Fraction of the current run still to go: distance-to-go for
+        // motion, the dwell timer for moves without length
+        double left = 1.0;
+        if (runLength > 0.0)
+        {
+            left = std::clamp(input.distanceToGo / runLength, 0.0, 1.0);
+        }
+        else if (runFeed + runRapid > 0.0)
+        {
+            left = std::clamp(input.delayLeft / (runFeed + runRapid), 0.0, 1.0);
+        }
+
+        double feedLeft = cumFeedTime_[n] - cumFeedTime_[runEnd] + runFeed * left;
+        double rapidLeft = cumRapidTime_[n] - cumRapidTime_[runEnd] + runRapid * left;
+        double total = totalTime();
+
+        JobProgress progress;
+        progress.active = true;
+        progress.segment = static_cast<int>(runStart);
+        progress.distanceRemaining = cumLength_[n] - cumLength_[runEnd] + runLength * left;
+        progress.distanceDone = totalLength() - progress.distanceRemaining;
+        progress.timeRemaining = feedLeft / std::max(input.feedScale, MIN_SCALE) +
+                                 rapidLeft / std::max(input.rapidScale, MIN_SCALE);
+        if (total > 0.0)
+        {
+            progress.percent = 100.0 * (1.0 - (feedLeft + rapidLeft) / total);
+        }
+        else if (totalLength() > 0.0)
+        {
+            progress.percent = 100.0 * progress.distanceDone / totalLength();
+        }
+        return progress;
+    }
+
+    JobProgress JobProgressEngine::update(const JobProgressInput &input)
+    {
+        if (!hasProgram())
+        {
+            return JobProgress{};
+        }
+
+        if (!input.running)
+        {
+            wasRunning_ = false;
+            last_.active = false;
+            return last_;
+        }
+
+        if (!wasRunning_)
+        {
+            // (Re)started: search from the top of the program again
+            wasRunning_ = true;
+            located_ = false;
+        }
+
+        size_t runStart, runEnd;
+        if (input.motionLine > 0 && locate(input.motionLine, runStart, runEnd))
+        {
+            runStart_ = runStart;
+            runEnd_ = runEnd;
+            located_ = true;
+        }
+
+        if (!located_)
+        {
+            // Nothing has moved yet
+            JobProgress progress;
+            progress.active = true;
+            progress.distanceRemaining = totalLength();
+            progress.timeRemaining = cumFeedTime_.back() / std::max(input.feedScale, MIN_SCALE) +
+                                     cumRapidTime_.back() / std::max(input.rapidScale, MIN_SCALE);
+            last_ = progress;
+            return last_;
+        }
+
+        last_ = at(runStart_, runEnd_, input);
+        return last_;
+    }
+}
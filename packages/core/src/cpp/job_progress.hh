@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Job progress and ETA from a program's per-move timing table plus live
+// status. Pure algorithm without N-API or NML dependencies.
+
+namespace LinuxCNC
+{
+    struct JobProgress
+    {
+        bool active = false;            // Program loaded in task and interpreter running
+        int segment = -1;               // Move being executed (-1 before the first)
+        double percent = 0.0;           // Of the nominal program time, 0-100
+        double distanceDone = 0.0;      // mm
+        double distanceRemaining = 0.0; // mm
+        double timeRemaining = 0.0;     // Seconds at the current overrides
+
+        bool operator==(const JobProgress &other) const;
+        bool operator!=(const JobProgress &other) const { return !(*this == other); }
+    };
+
+    // Live inputs, taken from EMC_STAT by the caller
+    struct JobProgressInput
+    {
+        bool running = false;       // task.interpState != IDLE
+        int motionLine = 0;         // task.motionLine
+        double distanceToGo = 0.0;  // motion.traj.distance_to_go, in mm
+        double delayLeft = 0.0;     // task.delayLeft, seconds of dwell left
+        double feedScale = 1.0;     // motion.traj.scale
+        double rapidScale = 1.0;    // motion.traj.rapid_scale
+    };
+
+    class JobProgressEngine
+    {
+    public:
+        // Overrides below this are treated as this, so a feed hold reads as a
+        // very long ETA rather than a division by zero
+        static constexpr double MIN_SCALE = 0.01;
+
+        // One entry per move, in program order. rapid may be empty (every
+        // move then scales with the feed override). Throws
+        // std::invalid_argument when the column lengths differ.
+        void setProgram(std::vector<int32_t> lineNumbers,
+                        const std::vector<double> &lengths,
+                        const std::vector<double> &durations,
+                        const std::vector<uint8_t> &rapid);
+        void clear();
+        bool hasProgram() const { return !lineNumbers_.empty(); }
+
+        double totalLength() const { return cumLength_.empty() ? 0.0 : cumLength_.back(); }
+        double totalTime() const { return cumFeedTime_.empty() ? 0.0 : cumFeedTime_.back() + cumRapidTime_.back(); }
+
+        // Progress for the current status. Keeps the last position while the
+        // interpreter is idle, so a finished job reads 100%.
+        JobProgress update(const JobProgressInput &input);
+
+    private:
+        // Locate the run of consecutive moves from motionLine, preferring the
+        // first one at or after the current position. Returns false when the
+        // line has no moves.
+        bool locate(int motionLine, size_t &runStart, size_t &runEnd) const;
+        JobProgress at(size_t runStart, size_t runEnd, const JobProgressInput &input) const;
+
+        std::vector<int32_t> lineNumbers_;
+        // Entry i holds the totals before move i; one extra entry at the end
+        std::vector<double> cumLength_;
+        std::vector<double> cumFeedTime_;
+        std::vector<double> cumRapidTime_;
+        // Line -> indices of the moves that start a run from that line
+        std::unordered_map<int32_t, std::vector<size_t>> runsByLine_;
+
+        size_t runStart_ = 0;
+        size_t runEnd_ = 0;
+        bool located_ = false;
+        bool wasRunning_ = false;
+        JobProgress last_;
+    };
+}
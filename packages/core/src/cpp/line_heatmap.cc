@@ -0,0 +1,317 @@
+#include "line_heatmap.hh"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace LinuxCNC
+{
+  Napi::FunctionReference NapiLineHeatmap::constructor;
+
+  namespace
+  {
+#define IO_COUNT(array) static_cast<int>(sizeof(EMC_MOTION_STAT::array) / sizeof(EMC_MOTION_STAT::array[0]))
+
+    struct ChannelSpec
+    {
+      const char *pattern; // '#' stands for an index
+      double (*read)(const EMC_STAT &stat, int index);
+      int count;           // Valid indices, 0 for plain paths
+    };
+
+    const ChannelSpec CHANNEL_SPECS[] = {
+        {"motion.traj.currentVelocity", [](const EMC_STAT &s, int) { return s.motion.traj.current_vel; }, 0},
+        {"motion.traj.distanceToGo", [](const EMC_STAT &s, int) { return s.motion.traj.distance_to_go; }, 0},
+        {"motion.traj.feedRateOverride", [](const EMC_STAT &s, int) { return s.motion.traj.scale; }, 0},
+        {"motion.traj.rapidRateOverride", [](const EMC_STAT &s, int) { return s.motion.traj.rapid_scale; }, 0},
+        {"motion.joint.#.ferrorCurrent", [](const EMC_STAT &s, int i) { return s.motion.joint[i].ferrorCurrent; }, EMCMOT_MAX_JOINTS},
+        {"motion.joint.#.velocity", [](const EMC_STAT &s, int i) { return s.motion.joint[i].velocity; }, EMCMOT_MAX_JOINTS},
+        {"motion.joint.#.output", [](const EMC_STAT &s, int i) { return s.motion.joint[i].output; }, EMCMOT_MAX_JOINTS},
+        {"motion.joint.#.input", [](const EMC_STAT &s, int i) { return s.motion.joint[i].input; }, EMCMOT_MAX_JOINTS},
+        {"motion.axis.#.velocity", [](const EMC_STAT &s, int i) { return s.motion.axis[i].velocity; }, EMCMOT_MAX_AXIS},
+        {"motion.spindle.#.speed", [](const EMC_STAT &s, int i) { return s.motion.spindle[i].speed; }, EMCMOT_MAX_SPINDLES},
+        {"motion.spindle.#.override", [](const EMC_STAT &s, int i) { return s.motion.spindle[i].spindle_scale; }, EMCMOT_MAX_SPINDLES},
+        {"motion.analogInput.#", [](const EMC_STAT &s, int i) { return s.motion.analog_input[i]; }, IO_COUNT(analog_input)},
+        {"motion.analogOutput.#", [](const EMC_STAT &s, int i) { return s.motion.analog_output[i]; }, IO_COUNT(analog_output)},
+        {"motion.digitalInput.#", [](const EMC_STAT &s, int i) { return static_cast<double>(s.motion.synch_di[i]); }, IO_COUNT(synch_di)},
+        {"motion.digitalOutput.#", [](const EMC_STAT &s, int i) { return static_cast<double>(s.motion.synch_do[i]); }, IO_COUNT(synch_do)},
+        {"task.activeSettings.feedRate", [](const EMC_STAT &s, int) { return s.task.activeSettings[1]; }, 0},
+        {"task.activeSettings.speed", [](const EMC_STAT &s, int) { return s.task.activeSettings[2]; }, 0},
+        {"task.delayLeft", [](const EMC_STAT &s, int) { return s.task.delayLeft; }, 0},
+    };
+
+#undef IO_COUNT
+  }
+
+  bool NapiLineHeatmap::resolveChannel(const std::string &path, Channel &channel)
+  {
+    // Replace the first all-digit component with '#'
+    std::string pattern;
+    int index = 0;
+    bool indexed = false;
+    size_t start = 0;
+    while (start <= path.size())
+    {
+      size_t end = path.find('.', start);
+      if (end == std::string::npos)
+        end = path.size();
+      std::string part = path.substr(start, end - start);
+      if (!pattern.empty())
+        pattern += '.';
+      if (!indexed && !part.empty() && part.find_first_not_of("0123456789") == std::string::npos && part.size() < 6)
+      {
+        index = std::atoi(part.c_str());
+        indexed = true;
+        pattern += '#';
+      }
+      else
+      {
+        pattern += part;
+      }
+      start = end + 1;
+    }
+
+    for (const ChannelSpec &spec : CHANNEL_SPECS)
+    {
+      if (pattern != spec.pattern)
+        continue;
+      if (indexed != (spec.count > 0) || (indexed && index >= spec.count))
+        return false;
+      channel.path = path;
+      channel.read = spec.read;
+      channel.index = index;
+      return true;
+    }
+    return false;
+  }
+
+  Napi::Object NapiLineHeatmap::Init(Napi::Env env, Napi::Object exports)
+  {
+    Napi::HandleScope scope(env);
+    Napi::Function func = DefineClass(env, "NativeLineHeatmap", {
+                                                                    InstanceMethod("start", &NapiLineHeatmap::Start),
+                                                                    InstanceMethod("stop", &NapiLineHeatmap::Stop),
+                                                                    InstanceMethod("clear", &NapiLineHeatmap::Clear),
+                                                                    InstanceMethod("getData", &NapiLineHeatmap::GetData),
+                                                                    InstanceMethod("isRunning", &NapiLineHeatmap::IsRunning),
+                                                                });
+
+    constructor = Napi::Persistent(func);
+    constructor.SuppressDestruct();
+    exports.Set("NativeLineHeatmap", func);
+    return exports;
+  }
+
+  NapiLineHeatmap::NapiLineHeatmap(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<NapiLineHeatmap>(info)
+  {
+    if (info.Length() > 0 && !ParseNmlConnectionConfig(info.Env(), info[0], config_))
+    {
+      return;
+    }
+  }
+
+  NapiLineHeatmap::~NapiLineHeatmap()
+  {
+    stopThread();
+    stat_channel_.reset();
+  }
+
+  void NapiLineHeatmap::stopThread()
+  {
+    should_stop_ = true;
+    if (stat_channel_)
+    {
+      stat_channel_->interruptWaits();
+    }
+    if (sampler_thread_.joinable())
+    {
+      sampler_thread_.join();
+    }
+  }
+
+  // start(channels: string[], interval?: number, maxLines?: number)
+  Napi::Value NapiLineHeatmap::Start(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray())
+    {
+      Napi::TypeError::New(env, "channels must be an array of stat paths").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    std::vector<Channel> channels;
+    Napi::Array paths = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < paths.Length(); ++i)
+    {
+      Napi::Value value = paths.Get(i);
+      Channel channel;
+      if (!value.IsString() || !resolveChannel(value.As<Napi::String>().Utf8Value(), channel))
+      {
+        std::string shown = value.IsString() ? value.As<Napi::String>().Utf8Value() : "(not a string)";
+        Napi::TypeError::New(env, "Unsupported heatmap channel: " + shown).ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      channels.push_back(channel);
+    }
+
+    double interval = DEFAULT_INTERVAL;
+    if (info.Length() > 1 && info[1].IsNumber())
+    {
+      interval = info[1].As<Napi::Number>().DoubleValue();
+      if (!(interval > 0))
+      {
+        interval = DEFAULT_INTERVAL;
+      }
+    }
+
+    size_t maxLines = LineHeatmapData::DEFAULT_MAX_LINES;
+    if (info.Length() > 2 && info[2].IsNumber())
+    {
+      uint32_t requested = info[2].As<Napi::Number>().Uint32Value();
+      if (requested > 0)
+      {
+        maxLines = requested;
+      }
+    }
+
+    if (!stat_channel_)
+    {
+      stat_channel_ = SharedStatChannel::Acquire(config_);
+      if (!stat_channel_)
+      {
+        Napi::Error::New(env, "Failed to connect to LinuxCNC stat channel").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+
+    // Restart with the new channel set
+    stopThread();
+    {
+      std::lock_guard<std::mutex> lock(data_mutex_);
+      channels_ = std::move(channels);
+      data_.reset(channels_.size(), maxLines);
+    }
+    sampling_interval_ = interval;
+    should_stop_ = false;
+    sampler_thread_ = std::thread(&NapiLineHeatmap::SamplerThread, this);
+
+    return env.Undefined();
+  }
+
+  Napi::Value NapiLineHeatmap::Stop(const Napi::CallbackInfo &info)
+  {
+    stopThread();
+    return info.Env().Undefined();
+  }
+
+  Napi::Value NapiLineHeatmap::Clear(const Napi::CallbackInfo &info)
+  {
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    data_.clear();
+    return info.Env().Undefined();
+  }
+
+  Napi::Value NapiLineHeatmap::IsRunning(const Napi::CallbackInfo &info)
+  {
+    return Napi::Boolean::New(info.Env(), sampler_thread_.joinable() && !should_stop_);
+  }
+
+  Napi::Value NapiLineHeatmap::GetData(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(data_mutex_);
+
+    size_t lines = data_.lineCount();
+    Napi::Uint32Array samples = Napi::Uint32Array::New(env, lines);
+    Napi::Float64Array time = Napi::Float64Array::New(env, lines);
+    Napi::Float64Array dwellTime = Napi::Float64Array::New(env, lines);
+    if (lines > 0)
+    {
+      std::memcpy(samples.Data(), data_.samples.data(), lines * sizeof(uint32_t));
+      std::memcpy(time.Data(), data_.time.data(), lines * sizeof(double));
+      std::memcpy(dwellTime.Data(), data_.dwellTime.data(), lines * sizeof(double));
+    }
+
+    const double nan = std::nan("");
+    Napi::Object channels = Napi::Object::New(env);
+    for (size_t c = 0; c < channels_.size(); ++c)
+    {
+      Napi::Float64Array min = Napi::Float64Array::New(env, lines);
+      Napi::Float64Array max = Napi::Float64Array::New(env, lines);
+      Napi::Float64Array mean = Napi::Float64Array::New(env, lines);
+      for (size_t line = 0; line < lines; ++line)
+      {
+        bool sampled = data_.samples[line] > 0;
+        min[line] = sampled ? data_.min[c][line] : nan;
+        max[line] = sampled ? data_.max[c][line] : nan;
+        mean[line] = data_.mean(c, line);
+      }
+
+      Napi::Object stats = Napi::Object::New(env);
+      stats.Set("min", min);
+      stats.Set("max", max);
+      stats.Set("mean", mean);
+      channels.Set(channels_[c].path, stats);
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("lineCount", Napi::Number::New(env, static_cast<double>(lines)));
+    result.Set("samples", samples);
+    result.Set("time", time);
+    result.Set("dwellTime", dwellTime);
+    result.Set("channels", channels);
+    result.Set("dropped", Napi::Number::New(env, static_cast<double>(data_.dropped)));
+    return result;
+  }
+
+  void NapiLineHeatmap::SamplerThread()
+  {
+    std::vector<double> values(channels_.size());
+    auto last = std::chrono::steady_clock::now();
+    auto interval = std::chrono::duration<double>(sampling_interval_);
+
+    while (!should_stop_)
+    {
+      uint32_t seen = stat_channel_->sequence();
+      bool running = false;
+      bool dwelling = false;
+      int line = 0;
+
+      // Read only the fields we need while the channel is locked instead of
+      // copying the whole EMC_STAT
+      stat_channel_->peek([&](const EMC_STAT &stat)
+                          {
+        running = stat.task.interpState != EMC_TASK_INTERP::IDLE;
+        if (!running)
+          return;
+        line = stat.task.motionLine;
+        dwelling = stat.task.delayLeft > 0.0;
+        for (size_t c = 0; c < channels_.size(); ++c)
+          values[c] = channels_[c].read(stat, channels_[c].index); });
+
+      auto now = std::chrono::steady_clock::now();
+      double dt = std::chrono::duration<double>(now - last).count();
+      last = now;
+
+      if (running)
+      {
+        std::lock_guard<std::mutex> lock(data_mutex_);
+        data_.record(line, dt, dwelling, values.data());
+      }
+
+      if (running)
+      {
+        std::this_thread::sleep_for(interval);
+      }
+      else
+      {
+        // Nothing to sample until a program starts
+        stat_channel_->waitForUpdate(seen, IDLE_WAIT, sampling_interval_);
+        last = std::chrono::steady_clock::now();
+      }
+    }
+  }
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <napi.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common.hh"
+#include "rcs.hh"
+#include "emc.hh"
+#include "emc_nml.hh"
+#include "line_heatmap_utils.hh"
+#include "shared_stat_channel.hh"
+
+namespace LinuxCNC
+{
+
+  // Per-program-line process statistics. A background thread samples the
+  // shared stat channel and, while a program runs, folds the chosen numeric
+  // stat channels into per-line min/max/sum keyed by task.motionLine.
+  class NapiLineHeatmap : public Napi::ObjectWrap<NapiLineHeatmap>
+  {
+  public:
+    static Napi::Object Init(Napi::Env env, Napi::Object exports);
+    NapiLineHeatmap(const Napi::CallbackInfo &info);
+    ~NapiLineHeatmap();
+
+    // Reads one numeric field of EMC_STAT; `index` selects the joint,
+    // spindle or pin for indexed paths
+    struct Channel
+    {
+      std::string path;
+      double (*read)(const EMC_STAT &stat, int index);
+      int index;
+    };
+
+    // Resolves a stat delta path such as "motion.joint.0.ferrorCurrent".
+    // Returns false for paths that are not numeric sampled fields.
+    static bool resolveChannel(const std::string &path, Channel &channel);
+
+  private:
+    static Napi::FunctionReference constructor;
+
+    // Methods exposed to JavaScript
+    Napi::Value Start(const Napi::CallbackInfo &info);
+    Napi::Value Stop(const Napi::CallbackInfo &info);
+    Napi::Value Clear(const Napi::CallbackInfo &info);
+    Napi::Value GetData(const Napi::CallbackInfo &info);
+    Napi::Value IsRunning(const Napi::CallbackInfo &info);
+
+    void SamplerThread();
+    void stopThread();
+
+    NmlConnectionConfig config_;
+    std::shared_ptr<SharedStatChannel> stat_channel_;
+
+    std::vector<Channel> channels_;
+    LineHeatmapData data_;
+    std::mutex data_mutex_;
+
+    std::thread sampler_thread_;
+    std::atomic<bool> should_stop_{false};
+    double sampling_interval_ = DEFAULT_INTERVAL; // in seconds
+
+    static constexpr double DEFAULT_INTERVAL = 0.001; // 1ms, the task cycle
+    static constexpr double IDLE_WAIT = 0.1;          // Longest wait for a program start, s
+  };
+}
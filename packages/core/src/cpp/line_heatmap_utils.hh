@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Per-program-line accumulator for line_heatmap. Pure algorithm without
+// N-API dependencies.
+
+namespace LinuxCNC
+{
+    // Dense per-line statistics: one slot per line number up to the highest
+    // line seen, each channel stored as its own column.
+    class LineHeatmapData
+    {
+    public:
+        static constexpr size_t DEFAULT_MAX_LINES = 1 << 20;
+
+        explicit LineHeatmapData(size_t channels = 0, size_t maxLines = DEFAULT_MAX_LINES)
+        {
+            reset(channels, maxLines);
+        }
+
+        // Drop everything and change the channel count and line bound
+        void reset(size_t channels, size_t maxLines)
+        {
+            channels_ = channels;
+            maxLines_ = maxLines;
+            clear();
+        }
+
+        void clear()
+        {
+            samples.clear();
+            time.clear();
+            dwellTime.clear();
+            min.assign(channels_, {});
+            max.assign(channels_, {});
+            sum.assign(channels_, {});
+            dropped = 0;
+            lines_ = 0;
+        }
+
+        // Attribute one sample covering `dt` seconds to `line`. `values` holds
+        // one value per channel. Returns false (and counts it as dropped) when
+        // the line is outside 0..maxLines-1.
+        bool record(int line, double dt, bool dwelling, const double *values)
+        {
+            if (line < 0 || static_cast<size_t>(line) >= maxLines_)
+            {
+                ++dropped;
+                return false;
+            }
+
+            size_t index = static_cast<size_t>(line);
+            if (index >= samples.size())
+            {
+                grow(index + 1);
+            }
+            lines_ = std::max(lines_, index + 1);
+
+            ++samples[index];
+            time[index] += dt;
+            if (dwelling)
+            {
+                dwellTime[index] += dt;
+            }
+            for (size_t c = 0; c < channels_; ++c)
+            {
+                double value = values[c];
+                if (value < min[c][index])
+                    min[c][index] = value;
+                if (value > max[c][index])
+                    max[c][index] = value;
+                sum[c][index] += value;
+            }
+            return true;
+        }
+
+        // One past the highest line recorded; the columns may be longer
+        size_t lineCount() const { return lines_; }
+        size_t channelCount() const { return channels_; }
+
+        double mean(size_t channel, size_t line) const
+        {
+            return samples[line] ? sum[channel][line] / samples[line] : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        std::vector<uint32_t> samples;
+        std::vector<double> time;      // Seconds spent on each line
+        std::vector<double> dwellTime; // Of which in a G4 dwell
+        std::vector<std::vector<double>> min; // [channel][line], +inf when unsampled
+        std::vector<std::vector<double>> max; // [channel][line], -inf when unsampled
+        std::vector<std::vector<double>> sum; // [channel][line]
+        uint64_t dropped = 0;
+
+    private:
+        void grow(size_t lines)
+        {
+            // Grow geometrically so long programs do not resize per line
+            size_t capacity = std::max(lines, std::min(samples.size() * 2, maxLines_));
+            samples.resize(capacity, 0);
+            time.resize(capacity, 0.0);
+            dwellTime.resize(capacity, 0.0);
+            for (size_t c = 0; c < channels_; ++c)
+            {
+                min[c].resize(capacity, std::numeric_limits<double>::infinity());
+                max[c].resize(capacity, -std::numeric_limits<double>::infinity());
+                sum[c].resize(capacity, 0.0);
+            }
+        }
+
+        size_t channels_ = 0;
+        size_t lines_ = 0;
+        size_t maxLines_ = DEFAULT_MAX_LINES;
+    };
+}
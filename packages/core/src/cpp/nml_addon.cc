@@ -4,6 +4,11 @@
 #include "command_channel.hh"
 #include "error_channel.hh"
 #include "position_logger.hh"
+#include "line_heatmap.hh"
+#include "program_sequencer.hh"
+#include "stat_publisher.hh"
+#include "command_journal.hh"
+#include "shared_stat_channel.hh"
 #include "emc.hh"
 #include "emc_nml.hh"
 #include "kinematics.h"
@@ -27,11 +32,18 @@ Napi::Object InitAll(Napi::Env env, Napi::Object exports)
 {
     exports.Set(Napi::String::New(env, "setNmlFilePath"), Napi::Function::New(env, LinuxCNC::SetNmlFilePath));
     exports.Set(Napi::String::New(env, "getNmlFilePath"), Napi::Function::New(env, LinuxCNC::GetNmlFilePath));
+    exports.Set(Napi::String::New(env, "startCommandJournal"), Napi::Function::New(env, LinuxCNC::StartCommandJournal));
+    exports.Set(Napi::String::New(env, "stopCommandJournal"), Napi::Function::New(env, LinuxCNC::StopCommandJournal));
+    exports.Set(Napi::String::New(env, "getCommandJournalStats"), Napi::Function::New(env, LinuxCNC::GetCommandJournalStats));
+    exports.Set(Napi::String::New(env, "getStatChannelPool"), Napi::Function::New(env, LinuxCNC::GetStatChannelPool));
 
     LinuxCNC::NapiStatChannel::Init(env, exports);
     LinuxCNC::NapiCommandChannel::Init(env, exports);
     LinuxCNC::NapiErrorChannel::Init(env, exports);
     LinuxCNC::NapiPositionLogger::Init(env, exports);
+    LinuxCNC::NapiLineHeatmap::Init(env, exports);
+    LinuxCNC::NapiProgramSequencer::Init(env, exports);
+    LinuxCNC::NapiStatPublisher::Init(env, exports);
 
     // Export constants
     exports.Set(Napi::String::New(env, "NMLFILE_DEFAULT"), Napi::String::New(env, DEFAULT_EMC_NMLFILE));
@@ -32,13 +32,18 @@ namespace LinuxCNC
   }
 
   NapiPositionLogger::NapiPositionLogger(const Napi::CallbackInfo &info)
-      : Napi::ObjectWrap<NapiPositionLogger>(info), stat_channel_(nullptr), should_stop_(false), should_clear_(false), logging_interval_(DEFAULT_INTERVAL), max_history_size_(DEFAULT_MAX_HISTORY), cursor_(0), oldest_cursor_(0)
+      : Napi::ObjectWrap<NapiPositionLogger>(info), should_stop_(false), should_clear_(false), logging_interval_(DEFAULT_INTERVAL), max_history_size_(DEFAULT_MAX_HISTORY), cursor_(0), oldest_cursor_(0)
   {
+    if (info.Length() > 0 && !ParseNmlConnectionConfig(info.Env(), info[0], config_))
+    {
+      return;
+    }
   }
 
   NapiPositionLogger::~NapiPositionLogger()
   {
     should_stop_ = true;
+    wakeLoggerThread();
     if (logger_thread_.joinable())
     {
       logger_thread_.join();
@@ -81,6 +86,7 @@ namespace LinuxCNC
     if (logger_thread_.joinable())
     {
       should_stop_ = true;
+      wakeLoggerThread();
       logger_thread_.join();
     }
 
@@ -98,6 +104,7 @@ namespace LinuxCNC
     Napi::Env env = info.Env();
 
     should_stop_ = true;
+    wakeLoggerThread();
     if (logger_thread_.joinable())
     {
       logger_thread_.join();
@@ -113,6 +120,7 @@ namespace LinuxCNC
     // Clear is handled in logger thread to avoid race conditions
     // but we also reset cursors atomically here
     should_clear_ = true;
+    wakeLoggerThread();
 
     return env.Undefined();
   }
@@ -278,6 +286,8 @@ namespace LinuxCNC
 
     while (!should_stop_)
     {
+      uint32_t seen = stat_channel_ ? stat_channel_->sequence() : 0;
+
       if (should_clear_)
       {
         std::lock_guard<std::mutex> lock(history_mutex_);
@@ -359,8 +369,21 @@ namespace LinuxCNC
         }
       }
 
-      // Sleep for the specified interval
+      // Sleep for the specified interval, then until the status changes,
+      // so an idle machine costs no wakeups
       std::this_thread::sleep_for(std::chrono::duration<double>(logging_interval_));
+      if (stat_channel_)
+      {
+        stat_channel_->waitForUpdate(seen, IDLE_WAIT, 0.0);
+      }
+    }
+  }
+
+  void NapiPositionLogger::wakeLoggerThread()
+  {
+    if (stat_channel_)
+    {
+      stat_channel_->interruptWaits();
     }
   }
 
@@ -404,27 +427,16 @@ namespace LinuxCNC
       return true; // Already connected
     }
 
-    // Get NML file path
-    const char *nml_file = GetNmlFileCStr();
-    if (strlen(nml_file) == 0)
-    {
-      return false;
-    }
-
-    // Create the stat channel
-    stat_channel_ = new RCS_STAT_CHANNEL(emcFormat, "emcStatus", "xemc", nml_file);
-    if (!stat_channel_ || !stat_channel_->valid())
+    stat_channel_ = SharedStatChannel::Acquire(config_);
+    if (!stat_channel_)
     {
-      delete stat_channel_;
-      stat_channel_ = nullptr;
       return false;
     }
 
     // for some reason, tool_mmap_user() must be called before using the stat channel
     if (tool_mmap_user() != 0)
     {
-      delete stat_channel_;
-      stat_channel_ = nullptr;
+      stat_channel_.reset();
       return false;
     }
 
@@ -436,32 +448,18 @@ namespace LinuxCNC
 
   void NapiPositionLogger::disconnectFromStatChannel()
   {
-    if (stat_channel_)
-    {
-      delete stat_channel_;
-      stat_channel_ = nullptr;
-    }
+    stat_channel_.reset();
   }
 
   bool NapiPositionLogger::pollStatChannel()
   {
-    if (!stat_channel_ || !stat_channel_->valid())
+    if (!stat_channel_)
     {
       return false;
     }
 
-    if (stat_channel_->peek() == EMC_STAT_TYPE)
-    {
-      EMC_STAT *emc_status_ptr = static_cast<EMC_STAT *>(stat_channel_->get_address());
-      if (emc_status_ptr)
-      {
-        // Copy the status data
-        current_status_ = *emc_status_ptr;
-        return true;
-      }
-    }
-
-    return false;
+    // Copy the status data
+    return stat_channel_->read(current_status_);
   }
 
 }
@@ -12,6 +12,7 @@
 #include "emc.hh"
 #include "emc_nml.hh"
 #include "position_logger_utils.hh"
+#include "shared_stat_channel.hh"
 
 namespace LinuxCNC
 {
@@ -40,13 +41,15 @@ namespace LinuxCNC
 
     // Internal methods
     void LoggerThread();
+    void wakeLoggerThread();
     std::optional<PositionPoint> getCurrentPositionInternal();
     bool connectToStatChannel();
     void disconnectFromStatChannel();
     bool pollStatChannel();
 
     // Member variables
-    RCS_STAT_CHANNEL *stat_channel_;
+    NmlConnectionConfig config_;
+    std::shared_ptr<SharedStatChannel> stat_channel_;
     EMC_STAT current_status_{};
     std::vector<PositionPoint> position_history_;
 
@@ -67,5 +70,6 @@ namespace LinuxCNC
     static constexpr double DEFAULT_INTERVAL = 0.01; // 10ms
     static constexpr size_t DEFAULT_MAX_HISTORY = 10000;
     static constexpr double POSITION_EPSILON = 1e-6; // Minimum change to log
+    static constexpr double IDLE_WAIT = 0.1;         // Longest wait for a status change, s
   };
 }
\ No newline at end of file
@@ -0,0 +1,658 @@
+#include "program_sequencer.hh"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include "timer.hh"
+
+namespace LinuxCNC
+{
+
+    Napi::FunctionReference NapiProgramSequencer::constructor;
+
+    namespace
+    {
+        const char *phaseName(NapiProgramSequencer::Phase phase)
+        {
+            switch (phase)
+            {
+            case NapiProgramSequencer::Phase::Waiting:
+                return "waiting";
+            case NapiProgramSequencer::Phase::Launching:
+                return "launching";
+            case NapiProgramSequencer::Phase::Starting:
+                return "starting";
+            case NapiProgramSequencer::Phase::Running:
+                return "running";
+            default:
+                return "stopped";
+            }
+        }
+
+        const char *resultName(NapiProgramSequencer::CycleResult result)
+        {
+            switch (result)
+            {
+            case NapiProgramSequencer::CycleResult::Aborted:
+                return "aborted";
+            case NapiProgramSequencer::CycleResult::Error:
+                return "error";
+            default:
+                return "done";
+            }
+        }
+    }
+
+    Napi::Object NapiProgramSequencer::Init(Napi::Env env, Napi::Object exports)
+    {
+        Napi::HandleScope scope(env);
+        Napi::Function func = DefineClass(env, "NativeProgramSequencer", {
+                                                                             InstanceMethod("stage", &NapiProgramSequencer::Stage),
+                                                                             InstanceMethod("clearQueue", &NapiProgramSequencer::ClearQueue),
+                                                                             InstanceMethod("start", &NapiProgramSequencer::Start),
+                                                                             InstanceMethod("stop", &NapiProgramSequencer::Stop),
+                                                                             InstanceMethod("hold", &NapiProgramSequencer::Hold),
+                                                                             InstanceMethod("release", &NapiProgramSequencer::Release),
+                                                                             InstanceMethod("poll", &NapiProgramSequencer::Poll),
+                                                                             InstanceMethod("disconnect", &NapiProgramSequencer::Disconnect),
+                                                                         });
+        constructor = Napi::Persistent(func);
+        constructor.SuppressDestruct();
+        exports.Set("NativeProgramSequencer", func);
+        return exports;
+    }
+
+    NapiProgramSequencer::NapiProgramSequencer(const Napi::CallbackInfo &info)
+        : Napi::ObjectWrap<NapiProgramSequencer>(info)
+    {
+        Napi::Env env = info.Env();
+        if (info.Length() > 0 && !ParseNmlConnectionConfig(env, info[0], config_))
+        {
+            return;
+        }
+        if (!connect())
+        {
+            Napi::Error::New(env, "Failed to connect to LinuxCNC command/status channels").ThrowAsJavaScriptException();
+        }
+    }
+
+    NapiProgramSequencer::~NapiProgramSequencer()
+    {
+        stopThread();
+        disconnect();
+    }
+
+    bool NapiProgramSequencer::connect()
+    {
+        if (c_channel_ && s_channel_)
+            return true;
+
+        for (int attempt = 0; attempt < NML_CONNECT_ATTEMPTS; ++attempt)
+        {
+            c_channel_ = new RCS_CMD_CHANNEL(emcFormat, config_.commandBuffer.c_str(),
+                                             config_.processName.c_str(), config_.nmlFile.c_str());
+            if (c_channel_ && c_channel_->valid())
+            {
+                s_channel_ = SharedStatChannel::Acquire(config_);
+                if (s_channel_)
+                {
+                    remote_ = s_channel_->isRemote();
+                    return true;
+                }
+            }
+
+            delete c_channel_;
+            c_channel_ = nullptr;
+            s_channel_.reset();
+            esleep(NML_CONNECT_RETRY_DELAY);
+        }
+
+        return false;
+    }
+
+    void NapiProgramSequencer::disconnect()
+    {
+        delete c_channel_;
+        c_channel_ = nullptr;
+        s_channel_.reset();
+    }
+
+    void NapiProgramSequencer::stopThread()
+    {
+        should_stop_ = true;
+        wakeThread();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    // The thread sleeps until the next status write; requests from
+    // JavaScript wake it so they do not wait for the machine to change
+    void NapiProgramSequencer::wakeThread()
+    {
+        if (s_channel_)
+        {
+            s_channel_->interruptWaits();
+        }
+    }
+
+    // stage(file: string): number - queue a program, returns the queue length
+    Napi::Value NapiProgramSequencer::Stage(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString())
+        {
+            Napi::TypeError::New(env, "File path (string) expected for stage").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        StagedProgram program;
+        program.file = info[0].As<Napi::String>().Utf8Value();
+        if (program.file.empty() || program.file.length() >= sizeof(EMC_TASK_PLAN_OPEN::file))
+        {
+            Napi::RangeError::New(env, "File path is empty or too long").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        size_t length;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(program));
+            length = queue_.size();
+        }
+        wakeThread();
+        return Napi::Number::New(env, static_cast<double>(length));
+    }
+
+    Napi::Value NapiProgramSequencer::ClearQueue(const Napi::CallbackInfo &info)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        return info.Env().Undefined();
+    }
+
+    // start(options?: { permissiveInput?: number })
+    Napi::Value NapiProgramSequencer::Start(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        int permissive = -1;
+        if (info.Length() > 0 && info[0].IsObject())
+        {
+            Napi::Value input = info[0].As<Napi::Object>().Get("permissiveInput");
+            if (!input.IsUndefined())
+            {
+                const int count = static_cast<int>(sizeof(EMC_MOTION_STAT::synch_di) / sizeof(EMC_MOTION_STAT::synch_di[0]));
+                if (!input.IsNumber() || input.As<Napi::Number>().Int32Value() < 0 ||
+                    input.As<Napi::Number>().Int32Value() >= count)
+                {
+                    Napi::RangeError::New(env, "permissiveInput must be a motion digital input index").ThrowAsJavaScriptException();
+                    return env.Undefined();
+                }
+                permissive = input.As<Napi::Number>().Int32Value();
+            }
+        }
+
+        if (!connect())
+        {
+            Napi::Error::New(env, "Sequencer not connected.").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        stopThread();
+        permissive_input_ = permissive;
+        last_end_ = etime();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            phase_ = Phase::Waiting;
+        }
+        should_stop_ = false;
+        thread_ = std::thread(&NapiProgramSequencer::SequencerThread, this);
+        return env.Undefined();
+    }
+
+    // stop(): stop sequencing. A program already running is left to finish.
+    Napi::Value NapiProgramSequencer::Stop(const Napi::CallbackInfo &info)
+    {
+        stopThread();
+        std::lock_guard<std::mutex> lock(mutex_);
+        phase_ = Phase::Stopped;
+        current_file_.clear();
+        return info.Env().Undefined();
+    }
+
+    // hold(reason?: string): finish the current program, launch no more
+    Napi::Value NapiProgramSequencer::Hold(const Napi::CallbackInfo &info)
+    {
+        std::string reason = info.Length() > 0 && info[0].IsString()
+                                 ? info[0].As<Napi::String>().Utf8Value()
+                                 : "requested";
+        holdFor(reason);
+        return info.Env().Undefined();
+    }
+
+    Napi::Value NapiProgramSequencer::Release(const Napi::CallbackInfo &info)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held_ = false;
+            hold_reason_.clear();
+        }
+        wakeThread();
+        return info.Env().Undefined();
+    }
+
+    Napi::Value NapiProgramSequencer::Poll(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        std::vector<CycleReport> reports;
+        Napi::Object result = Napi::Object::New(env);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            reports.swap(reports_);
+
+            result.Set("phase", Napi::String::New(env, phaseName(phase_)));
+            result.Set("held", Napi::Boolean::New(env, held_));
+            result.Set("holdReason", held_ ? Napi::String::New(env, hold_reason_) : env.Null());
+            result.Set("waitingFor", phase_ == Phase::Waiting && !waiting_for_.empty()
+                                         ? Napi::String::New(env, waiting_for_)
+                                         : env.Null());
+            result.Set("current", current_file_.empty() ? env.Null() : Napi::String::New(env, current_file_));
+
+            Napi::Array queued = Napi::Array::New(env, queue_.size());
+            for (size_t i = 0; i < queue_.size(); ++i)
+            {
+                queued.Set(static_cast<uint32_t>(i), Napi::String::New(env, queue_[i].file));
+            }
+            result.Set("queued", queued);
+        }
+
+        Napi::Array cycles = Napi::Array::New(env, reports.size());
+        for (size_t i = 0; i < reports.size(); ++i)
+        {
+            const CycleReport &report = reports[i];
+            Napi::Object cycle = Napi::Object::New(env);
+            cycle.Set("index", Napi::Number::New(env, static_cast<double>(report.index)));
+            cycle.Set("file", Napi::String::New(env, report.file));
+            cycle.Set("result", Napi::String::New(env, resultName(report.result)));
+            cycle.Set("error", report.error.empty() ? env.Null() : Napi::String::New(env, report.error));
+            cycle.Set("gap", Napi::Number::New(env, report.gap));
+            cycle.Set("launchTime", Napi::Number::New(env, report.launchTime));
+            cycle.Set("openTime", Napi::Number::New(env, report.openTime));
+            cycle.Set("cycleTime", Napi::Number::New(env, report.cycleTime));
+            cycle.Set("endedAt", Napi::Number::New(env, report.endedAt));
+            cycles.Set(static_cast<uint32_t>(i), cycle);
+        }
+        result.Set("cycles", cycles);
+        return result;
+    }
+
+    Napi::Value NapiProgramSequencer::Disconnect(const Napi::CallbackInfo &info)
+    {
+        stopThread();
+        disconnect();
+        std::lock_guard<std::mutex> lock(mutex_);
+        phase_ = Phase::Stopped;
+        return info.Env().Undefined();
+    }
+
+    void NapiProgramSequencer::holdFor(const std::string &reason)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = true;
+        hold_reason_ = reason;
+    }
+
+    bool NapiProgramSequencer::observe(Observation &obs)
+    {
+        return s_channel_->peek([&](const EMC_STAT &stat)
+                                {
+            obs.machineOn = stat.task.state == EMC_TASK_STATE::ON;
+            obs.autoMode = stat.task.mode == EMC_TASK_MODE::AUTO;
+            obs.interpIdle = stat.task.interpState == EMC_TASK_INTERP::IDLE;
+            obs.permissive = permissive_input_ < 0 || stat.motion.synch_di[permissive_input_] != 0;
+            obs.echoSerial = stat.echo_serial_number;
+            obs.status = stat.status; });
+    }
+
+    // Why the next program cannot be launched yet, or nullptr if it can.
+    // Called with mutex_ held.
+    const char *NapiProgramSequencer::waitingFor(const Observation &obs)
+    {
+        if (held_)
+            return "hold";
+        if (queue_.empty())
+            return "queue";
+        if (!queue_.front().loaded)
+            return "staging";
+        if (!obs.machineOn)
+            return "machine";
+        if (!obs.autoMode)
+            return "mode";
+        if (!obs.interpIdle)
+            return "interpreter";
+        if (!obs.permissive)
+            return "permissive";
+        return nullptr;
+    }
+
+    // Read the next program while the current one runs, so a missing file
+    // is caught early and a remote transfer needs no disk access at launch
+    void NapiProgramSequencer::preloadHead()
+    {
+        std::string file;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty() || queue_.front().loaded)
+                return;
+            file = queue_.front().file;
+        }
+
+        std::vector<char> content;
+        std::string error;
+        std::ifstream in(file, std::ios::binary);
+        if (in)
+        {
+            content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        if (!in && !in.eof())
+        {
+            error = "Failed to read " + file + " (" + strerror(errno) + ")";
+        }
+        if (!remote_)
+        {
+            // The task reads the file itself; reading it here only warms the
+            // page cache
+            content.clear();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!queue_.empty() && queue_.front().file == file && !queue_.front().loaded)
+        {
+            queue_.front().content = std::move(content);
+            queue_.front().error = std::move(error);
+            queue_.front().loaded = true;
+        }
+    }
+
+    RCS_STATUS NapiProgramSequencer::waitCommand(int serial)
+    {
+        bool serial_observed = false;
+        double start = etime();
+        do
+        {
+            uint32_t seen = s_channel_->sequence();
+            std::optional<RCS_STATUS> result;
+            s_channel_->peek([&](const EMC_STAT &stat)
+                             {
+                if (stat.echo_serial_number - serial >= 0)
+                {
+                    serial_observed = true;
+                }
+                if (serial_observed && (stat.status == RCS_STATUS::DONE || stat.status == RCS_STATUS::ERROR))
+                {
+                    result = stat.status;
+                } });
+            if (result)
+            {
+                return *result;
+            }
+            s_channel_->waitForUpdate(seen, STATUS_WAIT, POLL_PERIOD);
+        } while (!should_stop_ && etime() - start < COMMAND_TIMEOUT);
+        return RCS_STATUS::UNINITIALIZED; // Timeout
+    }
+
+    RCS_STATUS NapiProgramSequencer::sendAndWait(RCS_CMD_MSG &msg, std::string &error)
+    {
+        CommandJournal &journal = CommandJournal::instance();
+        if (c_channel_->write(&msg))
+        {
+            journal.record(JournalEvent::WriteFailed, &msg, journal_channel_);
+            error = "write to NML channel failed";
+            return RCS_STATUS::ERROR;
+        }
+        journal.record(JournalEvent::Sent, &msg, journal_channel_);
+
+        RCS_STATUS status = waitCommand(msg.serial_number);
+        if (status == RCS_STATUS::UNINITIALIZED)
+        {
+            journal.record(JournalEvent::TimedOut, &msg, journal_channel_);
+            error = "timed out";
+            return status;
+        }
+        journal.record(JournalEvent::Completed, &msg, journal_channel_, static_cast<int>(status));
+        if (status != RCS_STATUS::DONE)
+        {
+            error = "rejected by task";
+        }
+        return status;
+    }
+
+    bool NapiProgramSequencer::transferProgram(const StagedProgram &program, std::string &error)
+    {
+        EMC_TASK_PLAN_OPEN open_msg;
+        strncpy(open_msg.file, program.file.c_str(), sizeof(open_msg.file) - 1);
+        open_msg.file[sizeof(open_msg.file) - 1] = '\0';
+        open_msg.remote_filesize = program.content.size();
+
+        // An empty file still takes one (empty) chunk
+        size_t sent = 0;
+        do
+        {
+            size_t chunk = std::min(sizeof(open_msg.remote_buffer), program.content.size() - sent);
+            if (chunk > 0)
+            {
+                memcpy(open_msg.remote_buffer, program.content.data() + sent, chunk);
+            }
+            open_msg.remote_buffersize = chunk;
+            if (sendAndWait(open_msg, error) != RCS_STATUS::DONE)
+            {
+                return false;
+            }
+            sent += chunk;
+        } while (sent < program.content.size());
+        return true;
+    }
+
+    void NapiProgramSequencer::launch(double now)
+    {
+        StagedProgram program;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            program = std::move(queue_.front());
+            queue_.pop_front();
+            phase_ = Phase::Launching;
+            current_file_ = program.file;
+            waiting_for_.clear();
+        }
+
+        cycle_ = CycleReport();
+        cycle_.index = ++cycle_count_;
+        cycle_.file = program.file;
+        launch_started_ = now;
+        running_since_ = 0.0;
+
+        if (!program.error.empty())
+        {
+            finishCycle(CycleResult::Error, program.error, now);
+            return;
+        }
+
+        // Close whatever is open (a no-op after M2/M30), then open and run
+        std::string error;
+        EMC_TASK_PLAN_CLOSE close_msg;
+        if (sendAndWait(close_msg, error) != RCS_STATUS::DONE)
+        {
+            finishCycle(CycleResult::Error, "close " + error, etime());
+            return;
+        }
+
+        if (remote_)
+        {
+            if (!transferProgram(program, error))
+            {
+                finishCycle(CycleResult::Error, "open " + error, etime());
+                return;
+            }
+        }
+        else
+        {
+            EMC_TASK_PLAN_OPEN open_msg;
+            strncpy(open_msg.file, program.file.c_str(), sizeof(open_msg.file) - 1);
+            open_msg.file[sizeof(open_msg.file) - 1] = '\0';
+            open_msg.remote_buffersize = 0;
+            open_msg.remote_filesize = 0;
+            if (sendAndWait(open_msg, error) != RCS_STATUS::DONE)
+            {
+                finishCycle(CycleResult::Error, "open " + error, etime());
+                return;
+            }
+        }
+        cycle_.openTime = etime() - launch_started_;
+
+        EMC_TASK_PLAN_RUN run_msg;
+        run_msg.line = 0;
+        if (c_channel_->write(&run_msg))
+        {
+            CommandJournal::instance().record(JournalEvent::WriteFailed, &run_msg, journal_channel_);
+            finishCycle(CycleResult::Error, "run write to NML channel failed", etime());
+            return;
+        }
+        CommandJournal::instance().record(JournalEvent::Sent, &run_msg, journal_channel_);
+        run_serial_ = run_msg.serial_number;
+        run_sent_ = etime();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        phase_ = Phase::Starting;
+    }
+
+    void NapiProgramSequencer::finishCycle(CycleResult result, const std::string &error, double now)
+    {
+        cycle_.result = result;
+        cycle_.error = error;
+        if (running_since_ > 0.0)
+        {
+            cycle_.cycleTime = now - running_since_;
+        }
+        cycle_.endedAt = static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                 std::chrono::system_clock::now().time_since_epoch())
+                                                 .count());
+        last_end_ = now;
+        running_since_ = 0.0;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        reports_.push_back(cycle_);
+        current_file_.clear();
+        phase_ = Phase::Waiting;
+        if (result != CycleResult::Done)
+        {
+            // Hold the cell until the operator releases it
+            held_ = true;
+            hold_reason_ = resultName(result);
+        }
+    }
+
+    void NapiProgramSequencer::SequencerThread()
+    {
+        while (!should_stop_)
+        {
+            uint32_t seen = s_channel_->sequence();
+            Observation obs;
+            if (!observe(obs))
+            {
+                esleep(POLL_PERIOD);
+                continue;
+            }
+            double now = etime();
+
+            Phase phase;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                phase = phase_;
+            }
+
+            switch (phase)
+            {
+            case Phase::Waiting:
+            {
+                preloadHead();
+                bool ready;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    const char *reason = waitingFor(obs);
+                    waiting_for_ = reason ? reason : "";
+                    ready = reason == nullptr;
+                }
+                if (ready)
+                {
+                    launch(now);
+                }
+                break;
+            }
+
+            case Phase::Starting:
+            {
+                int serial_diff = obs.echoSerial - run_serial_;
+                if (serial_diff < 0)
+                {
+                    if (now - run_sent_ > COMMAND_TIMEOUT)
+                    {
+                        finishCycle(CycleResult::Error, "run timed out", now);
+                    }
+                }
+                else if (serial_diff == 0 && obs.status == RCS_STATUS::ERROR)
+                {
+                    CommandJournal::instance().record(JournalEvent::Completed, run_serial_, EMC_TASK_PLAN_RUN_TYPE,
+                                                      journal_channel_, static_cast<int>(RCS_STATUS::ERROR));
+                    finishCycle(CycleResult::Error, "run rejected by task", now);
+                }
+                else if (!obs.interpIdle)
+                {
+                    CommandJournal::instance().record(JournalEvent::Accepted, run_serial_, EMC_TASK_PLAN_RUN_TYPE,
+                                                      journal_channel_);
+                    running_since_ = now;
+                    cycle_.launchTime = now - launch_started_;
+                    cycle_.gap = now - last_end_;
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    phase_ = Phase::Running;
+                }
+                else if (now - run_sent_ > START_GRACE)
+                {
+                    // Accepted but never seen running: ended within one status period
+                    cycle_.launchTime = run_sent_ - launch_started_;
+                    cycle_.gap = run_sent_ - last_end_;
+                    running_since_ = run_sent_;
+                    finishCycle(CycleResult::Done, "", now);
+                }
+                break;
+            }
+
+            case Phase::Running:
+                if (!obs.machineOn || !obs.autoMode)
+                {
+                    finishCycle(CycleResult::Aborted, obs.machineOn ? "left AUTO mode" : "machine turned off", now);
+                }
+                else if (obs.interpIdle)
+                {
+                    if (obs.status == RCS_STATUS::ERROR)
+                        finishCycle(CycleResult::Error, "program ended in error", now);
+                    else
+                        finishCycle(CycleResult::Done, "", now);
+                }
+                break;
+
+            default:
+                break;
+            }
+
+            // Every transition follows a status change, except for the
+            // timeouts, which STATUS_WAIT bounds
+            s_channel_->waitForUpdate(seen, STATUS_WAIT, POLL_PERIOD);
+        }
+    }
+
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <napi.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common.hh"
+#include "rcs.hh"
+#include "emc.hh"
+#include "emc_nml.hh"
+#include "shared_stat_channel.hh"
+#include "command_journal.hh"
+
+namespace LinuxCNC
+{
+
+    // Runs queued programs back to back. A native thread watches the status
+    // buffer and, as soon as a program ends and nothing holds the cell,
+    // issues close/open/run for the next one on its own command channel,
+    // without a round trip through JavaScript.
+    class NapiProgramSequencer : public Napi::ObjectWrap<NapiProgramSequencer>
+    {
+    public:
+        static Napi::Object Init(Napi::Env env, Napi::Object exports);
+        NapiProgramSequencer(const Napi::CallbackInfo &info);
+        ~NapiProgramSequencer();
+
+        enum class Phase
+        {
+            Stopped,   // start() not called
+            Waiting,   // For the queue, a hold or the machine
+            Launching, // Sending close/open/run
+            Starting,  // Run sent, interpreter not seen running yet
+            Running
+        };
+
+        enum class CycleResult
+        {
+            Done,
+            Aborted, // Machine left ON/AUTO mid-program
+            Error    // Open or run rejected, or the program ended in error
+        };
+
+        // One program run. Times are in seconds.
+        struct CycleReport
+        {
+            uint64_t index = 0;
+            std::string file;
+            CycleResult result = CycleResult::Done;
+            std::string error;
+            double gap = 0.0;          // Previous program end (or start()) to this one running
+            double launchTime = 0.0;   // Close/open/run sent to interpreter running
+            double openTime = 0.0;     // Of which close + open (+ transfer)
+            double cycleTime = 0.0;    // Interpreter running to idle
+            double endedAt = 0.0;      // Unix time in ms
+        };
+
+    private:
+        static Napi::FunctionReference constructor;
+
+        // A queued program, read ahead of its launch
+        struct StagedProgram
+        {
+            std::string file;
+            bool loaded = false;       // File read (and kept for a remote transfer)
+            std::vector<char> content;
+            std::string error;         // Set when the file could not be read
+        };
+
+        // The status fields the sequencer decides on
+        struct Observation
+        {
+            bool machineOn = false;
+            bool autoMode = false;
+            bool interpIdle = true;
+            bool permissive = true;
+            int echoSerial = 0;
+            RCS_STATUS status = RCS_STATUS::UNINITIALIZED;
+        };
+
+        // Methods exposed to JavaScript
+        Napi::Value Stage(const Napi::CallbackInfo &info);
+        Napi::Value ClearQueue(const Napi::CallbackInfo &info);
+        Napi::Value Start(const Napi::CallbackInfo &info);
+        Napi::Value Stop(const Napi::CallbackInfo &info);
+        Napi::Value Hold(const Napi::CallbackInfo &info);
+        Napi::Value Release(const Napi::CallbackInfo &info);
+        Napi::Value Poll(const Napi::CallbackInfo &info);
+        Napi::Value Disconnect(const Napi::CallbackInfo &info);
+
+        bool connect();
+        void disconnect();
+        void stopThread();
+        void wakeThread();
+
+        // Sequencer thread
+        void SequencerThread();
+        bool observe(Observation &obs);
+        const char *waitingFor(const Observation &obs);
+        void preloadHead();
+        void launch(double now);
+        RCS_STATUS sendAndWait(RCS_CMD_MSG &msg, std::string &error);
+        RCS_STATUS waitCommand(int serial);
+        bool transferProgram(const StagedProgram &program, std::string &error);
+        void finishCycle(CycleResult result, const std::string &error, double now);
+        void holdFor(const std::string &reason);
+
+        NmlConnectionConfig config_;
+        RCS_CMD_CHANNEL *c_channel_ = nullptr;
+        std::shared_ptr<SharedStatChannel> s_channel_;
+        bool remote_ = false;      // Programs must be transferred over NML
+        uint16_t journal_channel_ = CommandJournal::nextChannelId();
+
+        std::thread thread_;
+        std::atomic<bool> should_stop_{false};
+        int permissive_input_ = -1;  // motion.digitalInput that must be high to launch
+
+        // Shared with JavaScript, guarded by mutex_
+        std::mutex mutex_;
+        std::deque<StagedProgram> queue_;
+        std::vector<CycleReport> reports_;     // Not yet polled
+        Phase phase_ = Phase::Stopped;
+        bool held_ = false;
+        std::string hold_reason_;
+        std::string waiting_for_;
+        std::string current_file_;
+
+        // Thread-only state of the current cycle
+        uint64_t cycle_count_ = 0;
+        CycleReport cycle_;
+        int run_serial_ = 0;
+        double run_sent_ = 0.0;
+        double launch_started_ = 0.0;
+        double running_since_ = 0.0;
+        double last_end_ = 0.0;
+
+        static constexpr double POLL_PERIOD = 0.001;      // Status check period without notification, s
+        static constexpr double STATUS_WAIT = 0.05;       // Longest wait for a status write, s
+        static constexpr double COMMAND_TIMEOUT = 5.0;    // Per close/open/run, s
+        static constexpr double START_GRACE = 0.5;        // Run done but never seen running, s
+    };
+
+}
@@ -0,0 +1,318 @@
+#include "shared_stat_channel.hh"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <cstring>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "cms.hh"
+#include "timer.hh"
+
+namespace LinuxCNC
+{
+    namespace
+    {
+        std::mutex g_poolMutex;
+        // NML keeps process-wide channel lists, so channels are still
+        // created and deleted one at a time, but not under g_poolMutex
+        std::mutex g_nmlMutex;
+        std::map<std::string, std::weak_ptr<SharedStatChannel>> g_pool;
+
+        std::string poolKey(const NmlConnectionConfig &config)
+        {
+            return config.nmlFile + '\0' + config.processName + '\0' + config.statusBuffer;
+        }
+
+#if !LINUXCNC_STATUS_NOTIFY
+        // Without linuxcnc-patches/0007 there is never a segment, so every
+        // wait takes the polling path
+        emc_status_notify *emcStatusNotifyOpen(int, const char *, const char *) { return nullptr; }
+        void emcStatusNotifyClose(emc_status_notify *) {}
+        uint32_t emcStatusNotifySequence(emc_status_notify *) { return 0; }
+        int emcStatusNotifyWait(emc_status_notify *, uint32_t, double) { return 0; }
+#endif
+
+        // What a released channel still has to close: its watcher, which
+        // exits within WATCH_SLICE of the stop request, then the
+        // notification segment and the NML channel
+        struct ChannelTeardown
+        {
+            std::thread watcher;
+            emc_status_notify *segment;
+            std::unique_ptr<RCS_STAT_CHANNEL> channel;
+
+            void operator()()
+            {
+                if (watcher.joinable())
+                {
+                    watcher.join();
+                }
+                emcStatusNotifyClose(segment);
+                std::lock_guard<std::mutex> nmlLock(g_nmlMutex);
+                channel.reset();
+            }
+        };
+    }
+
+    std::shared_ptr<SharedStatChannel> SharedStatChannel::Acquire(const NmlConnectionConfig &config)
+    {
+        if (config.nmlFile.empty())
+        {
+            return nullptr;
+        }
+
+        std::string key = poolKey(config);
+        {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            auto it = g_pool.find(key);
+            if (it != g_pool.end())
+            {
+                if (auto existing = it->second.lock())
+                {
+                    return existing;
+                }
+                g_pool.erase(it);
+            }
+        }
+
+        // Connect without the pool lock, so that an unreachable machine does
+        // not hold up channels for the others during its retries
+        RCS_STAT_CHANNEL *channel = nullptr;
+        for (int attempt = 0; attempt < NML_CONNECT_ATTEMPTS; ++attempt)
+        {
+            {
+                std::lock_guard<std::mutex> nmlLock(g_nmlMutex);
+                channel = new RCS_STAT_CHANNEL(emcFormat, config.statusBuffer.c_str(),
+                                               config.processName.c_str(), config.nmlFile.c_str());
+                if (channel && channel->valid())
+                {
+                    break;
+                }
+                delete channel;
+                channel = nullptr;
+            }
+            esleep(NML_CONNECT_RETRY_DELAY);
+        }
+        if (!channel)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        auto it = g_pool.find(key);
+        if (it != g_pool.end())
+        {
+            // Another thread connected the same key meanwhile: use its channel
+            if (auto existing = it->second.lock())
+            {
+                std::lock_guard<std::mutex> nmlLock(g_nmlMutex);
+                delete channel;
+                return existing;
+            }
+        }
+        std::shared_ptr<SharedStatChannel> shared(new SharedStatChannel(key, config, channel));
+        g_pool[key] = shared;
+        return shared;
+    }
+
+    std::vector<SharedStatChannel::PoolEntry> SharedStatChannel::Pool()
+    {
+        std::vector<PoolEntry> entries;
+        std::vector<std::shared_ptr<SharedStatChannel>> channels;
+        {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            for (const auto &[key, weak] : g_pool)
+            {
+                if (auto channel = weak.lock())
+                {
+                    entries.push_back(PoolEntry{key, channel.use_count() - 1, false, 0});
+                    channels.push_back(std::move(channel));
+                }
+            }
+        }
+
+        // Outside the pool lock: releasing the last holder below destroys
+        // the channel, which takes the lock
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            emc_status_notify *segment = channels[i]->notifySegment();
+            entries[i].notify = segment != nullptr;
+            entries[i].sequence = segment ? emcStatusNotifySequence(segment) : 0;
+        }
+        return entries;
+    }
+
+    SharedStatChannel::SharedStatChannel(std::string key, const NmlConnectionConfig &config,
+                                         RCS_STAT_CHANNEL *channel)
+        : key_(std::move(key)), nml_file_(config.nmlFile), status_buffer_(config.statusBuffer),
+          channel_(channel)
+    {
+    }
+
+    SharedStatChannel::~SharedStatChannel()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wait_->mutex);
+            wait_->stop = true;
+        }
+
+        // The last holder is often released by a finalizer on the JS thread;
+        // joining the watcher and waiting for g_nmlMutex happen on a thread
+        // of their own instead, or here if none can be started
+        auto teardown = std::make_shared<ChannelTeardown>(
+            ChannelTeardown{std::move(watcher_), notify_.load(), std::move(channel_)});
+        try
+        {
+            std::thread([teardown]
+                        { (*teardown)(); })
+                .detach();
+        }
+        catch (const std::system_error &)
+        {
+            (*teardown)();
+        }
+
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        auto it = g_pool.find(key_);
+        if (it != g_pool.end() && it->second.expired())
+        {
+            g_pool.erase(it);
+        }
+    }
+
+    bool SharedStatChannel::valid()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return channel_ && channel_->valid();
+    }
+
+    bool SharedStatChannel::read(EMC_STAT &out)
+    {
+        return peek([&out](const EMC_STAT &stat)
+                    { out = stat; });
+    }
+
+    bool SharedStatChannel::isRemote()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return channel_ && channel_->cms &&
+               channel_->cms->ProcessType == CMS_REMOTE_TYPE &&
+               strcmp(channel_->cms->ProcessName, "emc") != 0;
+    }
+
+    emc_status_notify *SharedStatChannel::notifySegment()
+    {
+        emc_status_notify *segment = notify_.load(std::memory_order_acquire);
+        if (segment)
+        {
+            return segment;
+        }
+
+        std::lock_guard<std::mutex> lock(notify_mutex_);
+        segment = notify_.load(std::memory_order_relaxed);
+        double now = etime();
+        if (segment || now < next_notify_attempt_)
+        {
+            return segment;
+        }
+
+        // The segment lives on the machine running task; a remote buffer
+        // never gets one
+        if (isRemote())
+        {
+            next_notify_attempt_ = std::numeric_limits<double>::infinity();
+            return nullptr;
+        }
+        next_notify_attempt_ = now + NOTIFY_RETRY_PERIOD;
+        segment = emcStatusNotifyOpen(0, nml_file_.c_str(), status_buffer_.c_str());
+        notify_.store(segment, std::memory_order_release);
+        return segment;
+    }
+
+    uint32_t SharedStatChannel::sequence()
+    {
+        emc_status_notify *segment = notifySegment();
+        return segment ? emcStatusNotifySequence(segment) : 0;
+    }
+
+    void SharedStatChannel::waitForUpdate(uint32_t seen, double timeout, double pollPeriod)
+    {
+        emc_status_notify *segment = notifySegment();
+        if (timeout <= 0.0)
+        {
+            return;
+        }
+
+        WaitState &wait = *wait_;
+        std::unique_lock<std::mutex> lock(wait.mutex);
+        uint64_t interrupts = wait.interrupts;
+        if (!segment)
+        {
+            wait.cv.wait_for(lock, std::chrono::duration<double>(std::min(timeout, pollPeriod)),
+                             [&]
+                             { return wait.interrupts != interrupts; });
+            return;
+        }
+
+        if (!watcher_.joinable() && !wait.stop)
+        {
+            watcher_ = std::thread(&SharedStatChannel::watchNotify, wait_, segment);
+        }
+        wait.cv.wait_for(lock, std::chrono::duration<double>(timeout), [&]
+                         { return wait.interrupts != interrupts || emcStatusNotifySequence(segment) != seen; });
+    }
+
+    void SharedStatChannel::interruptWaits()
+    {
+        std::lock_guard<std::mutex> lock(wait_->mutex);
+        wait_->interrupts++;
+        wait_->cv.notify_all();
+    }
+
+    void SharedStatChannel::watchNotify(std::shared_ptr<WaitState> wait, emc_status_notify *segment)
+    {
+        std::unique_lock<std::mutex> lock(wait->mutex);
+        while (!wait->stop)
+        {
+            // Taken under the lock, so a change after a waiter checked the
+            // sequence either ends this wait or is seen by the next one
+            uint32_t seen = emcStatusNotifySequence(segment);
+            lock.unlock();
+            bool changed = emcStatusNotifyWait(segment, seen, WATCH_SLICE);
+            lock.lock();
+            if (changed)
+            {
+                wait->cv.notify_all();
+            }
+        }
+    }
+
+    Napi::Value GetStatChannelPool(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        std::vector<SharedStatChannel::PoolEntry> entries = SharedStatChannel::Pool();
+
+        Napi::Array result = Napi::Array::New(env, entries.size());
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const std::string &key = entries[i].key;
+            size_t first = key.find('\0');
+            size_t second = key.find('\0', first + 1);
+
+            Napi::Object entry = Napi::Object::New(env);
+            entry.Set("nmlFile", Napi::String::New(env, key.substr(0, first)));
+            entry.Set("processName", Napi::String::New(env, key.substr(first + 1, second - first - 1)));
+            entry.Set("statusBuffer", Napi::String::New(env, key.substr(second + 1)));
+            entry.Set("holders", Napi::Number::New(env, static_cast<double>(entries[i].holders)));
+            if (entries[i].notify)
+                entry.Set("notifySequence", Napi::Number::New(env, entries[i].sequence));
+            else
+                entry.Set("notifySequence", env.Null());
+            result.Set(static_cast<uint32_t>(i), entry);
+        }
+        return result;
+    }
+
+}
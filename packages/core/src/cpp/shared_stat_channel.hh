@@ -0,0 +1,134 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common.hh"
+#include "rcs.hh"
+#include "emc.hh"
+#include "emc_nml.hh"
+
+// Status change notification of linuxcnc-patches/0007. Built against a
+// LinuxCNC without it, every wait below polls.
+#if __has_include("emc_status_notify.hh")
+#include "emc_status_notify.hh"
+#define LINUXCNC_STATUS_NOTIFY 1
+#else
+#define LINUXCNC_STATUS_NOTIFY 0
+struct emc_status_notify;
+#endif
+
+namespace LinuxCNC
+{
+
+    // One emcStatus connection per (nml file, process, buffer), shared by every
+    // stat reader in the process. Status buffers are read-only for clients, so
+    // a single NML channel can serve any number of StatChannel, CommandChannel
+    // and PositionLogger instances for the same machine. The channel is closed
+    // when the last holder releases it.
+    class SharedStatChannel
+    {
+    public:
+        // Returns the pooled channel for config, connecting on first use.
+        // Returns nullptr when the channel could not be connected.
+        static std::shared_ptr<SharedStatChannel> Acquire(const NmlConnectionConfig &config);
+
+        // Open channels and how many readers share each, for diagnostics
+        struct PoolEntry
+        {
+            std::string key; // nmlFile, processName and statusBuffer, '\0'-separated
+            long holders;
+            bool notify;       // Whether the notification segment is open
+            uint32_t sequence; // Its sequence, when open
+        };
+        static std::vector<PoolEntry> Pool();
+
+        ~SharedStatChannel();
+
+        bool valid();
+
+        // Calls fn(const EMC_STAT &) with the current status buffer while the
+        // channel is locked. Returns false when no status is available.
+        template <typename Fn>
+        bool peek(Fn &&fn)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!channel_ || !channel_->valid() || channel_->peek() != EMC_STAT_TYPE)
+            {
+                return false;
+            }
+            EMC_STAT *stat = static_cast<EMC_STAT *>(channel_->get_address());
+            if (!stat)
+            {
+                return false;
+            }
+            fn(*stat);
+            return true;
+        }
+
+        // Copies the current status into out.
+        bool read(EMC_STAT &out);
+
+        // True when the buffer is reached through a remote (TCP) NML server.
+        bool isRemote();
+
+        const std::string &key() const { return key_; }
+
+        // Status change notification from task (linuxcnc-patches/0007),
+        // through the segment of this channel's NML file and buffer. Take
+        // sequence() before reading the status; waitForUpdate() then returns
+        // as soon as task writes a changed status, or after timeout. Without
+        // the notification segment (remote buffer, task not started on this
+        // host, LinuxCNC without the patch) it sleeps min(timeout,
+        // pollPeriod) instead, like polling did.
+        uint32_t sequence();
+        void waitForUpdate(uint32_t seen, double timeout, double pollPeriod);
+
+        // Wakes the waitForUpdate() calls on this channel in this process
+        // early, so that a thread blocked in one notices a stop request.
+        // Readers in other processes are not woken.
+        void interruptWaits();
+
+    private:
+        SharedStatChannel(std::string key, const NmlConnectionConfig &config, RCS_STAT_CHANNEL *channel);
+
+        emc_status_notify *notifySegment();
+
+        std::string key_;
+        std::string nml_file_;
+        std::string status_buffer_;
+        std::mutex mutex_;
+        std::unique_ptr<RCS_STAT_CHANNEL> channel_;
+
+        std::mutex notify_mutex_;
+        std::atomic<emc_status_notify *> notify_{nullptr};
+        double next_notify_attempt_ = 0.0;
+
+        // Waiters sleep on cv. A single watcher thread blocks on the shared
+        // futex and wakes them, so interruptWaits() never has to wake the
+        // futex, which all processes on the host share. The watcher holds
+        // its own reference, as it may outlive the channel on release.
+        struct WaitState
+        {
+            std::mutex mutex;
+            std::condition_variable cv;
+            uint64_t interrupts = 0;
+            bool stop = false;
+        };
+        std::shared_ptr<WaitState> wait_ = std::make_shared<WaitState>();
+        std::thread watcher_;
+
+        static void watchNotify(std::shared_ptr<WaitState> wait, emc_status_notify *segment);
+
+        static constexpr double NOTIFY_RETRY_PERIOD = 1.0; // s
+        static constexpr double WATCH_SLICE = 0.1;         // s, bounds the watcher's exit after release
+    };
+
+    // [{ nmlFile, processName, statusBuffer, holders }] of the open pool entries
+    Napi::Value GetStatChannelPool(const Napi::CallbackInfo &info);
+
+}
@@ -1,7 +1,10 @@
 #include "stat_channel.hh"
+#include "stat_diff.hh"
 #include "common.hh"
+#include <algorithm>
 #include <cstring>
 #include <cmath>
+#include <stdexcept>
 #include "timer.hh"
 #include "tooldata.hh"
 #include "rtapi_string.h"
@@ -16,8 +19,17 @@ namespace LinuxCNC
         Napi::HandleScope scope(env);
         Napi::Function func = DefineClass(env, "NativeStatChannel", {
                                                                         InstanceMethod("poll", &NapiStatChannel::Poll),
+                                                                        InstanceMethod("materialize", &NapiStatChannel::Materialize),
+                                                                        InstanceMethod("getChangedBitmap", &NapiStatChannel::GetChangedBitmap),
+                                                                        InstanceMethod("getLeafIndex", &NapiStatChannel::GetLeafIndex),
+                                                                        InstanceMethod("getChangedPaths", &NapiStatChannel::GetChangedPaths),
                                                                         InstanceMethod("getCursor", &NapiStatChannel::GetCursor),
                                                                         InstanceMethod("disconnect", &NapiStatChannel::Disconnect),
+                                                                        InstanceMethod("setProgram", &NapiStatChannel::SetProgram),
+                                                                        InstanceMethod("clearProgram", &NapiStatChannel::ClearProgram),
+                                                                        InstanceMethod("getToolTable", &NapiStatChannel::GetToolTable),
+                                                                        InstanceMethod("setRateLimits", &NapiStatChannel::SetRateLimits),
+                                                                        InstanceMethod("snapshotJSON", &NapiStatChannel::SnapshotJSON),
                                                                     });
         constructor = Napi::Persistent(func);
         constructor.SuppressDestruct();
@@ -28,6 +40,10 @@ namespace LinuxCNC
     NapiStatChannel::NapiStatChannel(const Napi::CallbackInfo &info) : Napi::ObjectWrap<NapiStatChannel>(info)
     {
         Napi::Env env = info.Env();
+        if (info.Length() > 0 && !ParseNmlConnectionConfig(env, info[0], config_))
+        {
+            return;
+        }
         if (!connect())
         {
             Napi::Error::New(env, "Failed to connect to LinuxCNC stat channel").ThrowAsJavaScriptException();
@@ -44,39 +60,20 @@ namespace LinuxCNC
         if (s_channel_)
             return true; // Already connected
 
-        // Ensure NML file path is set
-        const char *nml_file = GetNmlFileCStr();
-        if (strlen(nml_file) == 0)
+        s_channel_ = SharedStatChannel::Acquire(config_);
+        if (!s_channel_)
         {
             return false;
         }
 
-        for (int attempt = 0; attempt < NML_CONNECT_ATTEMPTS; ++attempt)
-        {
-            s_channel_ = new RCS_STAT_CHANNEL(emcFormat, "emcStatus", "xemc", nml_file);
-            if (s_channel_ && s_channel_->valid())
-            {
-                // Initial poll to populate status_
-                pollInternal();
-
-                return true;
-            }
-
-            delete s_channel_;
-            s_channel_ = nullptr;
-            esleep(NML_CONNECT_RETRY_DELAY);
-        }
-
-        return false;
+        // Initial poll to populate status_
+        pollInternal();
+        return true;
     }
 
     void NapiStatChannel::disconnect()
     {
-        if (s_channel_)
-        {
-            delete s_channel_;
-            s_channel_ = nullptr;
-        }
+        s_channel_.reset();
         if (tool_mmap_initialized_)
         {
             tool_mmap_initialized_ = false;
@@ -99,24 +96,17 @@ namespace LinuxCNC
             }
         }
 
-        if (s_channel_->peek() == EMC_STAT_TYPE)
-        {
-            EMC_STAT *emc_status_ptr = static_cast<EMC_STAT *>(s_channel_->get_address());
-            if (emc_status_ptr)
+        bool data_changed = false;
+        s_channel_->peek([&](const EMC_STAT &emc_status)
+                         {
+            // Compare new data with current status to determine if it has changed
+            data_changed = (memcmp(&status_, &emc_status, sizeof(EMC_STAT)) != 0);
+            if (data_changed)
             {
-                // Compare new data with current status to determine if it has changed
-                bool data_changed = (memcmp(&status_, emc_status_ptr, sizeof(EMC_STAT)) != 0);
-
-                if (data_changed)
-                {
-                    // Update current status with new data
-                    status_ = *emc_status_ptr;
-                    return true; // Data was updated
-                }
-                return false; // Data exists but hasn't changed
-            }
-        }
-        return false; // No new data or error
+                // Update current status with new data
+                status_ = emc_status;
+            } });
+        return data_changed;
     }
 
     // Helper overloads to convert C++ values to Napi::Value
@@ -124,343 +114,144 @@ namespace LinuxCNC
     inline Napi::Value toNapiValue(Napi::Env env, int v) { return Napi::Number::New(env, v); }
     inline Napi::Value toNapiValue(Napi::Env env, bool v) { return Napi::Boolean::New(env, v); }
     inline Napi::Value toNapiValue(Napi::Env env, const char* v) { return Napi::String::New(env, v); }
-    inline Napi::Value toNapiValue(Napi::Env env, const EmcPose& v) { return EmcPoseToNapiFloat64Array(env, v); }
-
-    // Generic delta helper - adds {path, value} to the changes array
-    template<typename T>
-    void addDelta(Napi::Env env, Napi::Array &deltas, const char* path, const T& value) {
-        Napi::Object change = Napi::Object::New(env);
-        change.Set("path", Napi::String::New(env, path));
-        change.Set("value", toNapiValue(env, value));
-        deltas.Set(deltas.Length(), change);
-    }
 
-    // Macro helpers for cleaner comparison code - force bypasses comparison
-    #define COMPARE_FIELD(field, path) \
-        if (force || newStat.field != oldStat.field) addDelta(env, deltas, path, newStat.field)
-    #define COMPARE_BOOL(field, path) \
-        if (force || newStat.field != oldStat.field) addDelta(env, deltas, path, (bool)newStat.field)
-    #define COMPARE_INT_CAST(field, path) \
-        if (force || (int)newStat.field != (int)oldStat.field) addDelta(env, deltas, path, (int)newStat.field)
-    #define COMPARE_STRING(field, path) \
-        if (force || strcmp(newStat.field, oldStat.field) != 0) addDelta(env, deltas, path, newStat.field)
-    #define COMPARE_POSE(field, path) \
-        if (force || memcmp(&newStat.field, &oldStat.field, sizeof(EmcPose)) != 0) addDelta(env, deltas, path, newStat.field)
-    #define COMPARE_ARRAY(array, idx, path) \
-        if (force || newStat.array[idx] != oldStat.array[idx]) addDelta(env, deltas, path, newStat.array[idx])
-    #define COMPARE_ARRAY_MEMCMP(array, base_path) \
-        do { \
-            char path[128]; \
-            for (int i = 0; i < (int)(sizeof(newStat.array)/sizeof(newStat.array[0])); ++i) { \
-                if (force || memcmp(&newStat.array[i], &oldStat.array[i], sizeof(newStat.array[0])) != 0) { \
-                    snprintf(path, sizeof(path), base_path ".%d", i); \
-                    addDelta(env, deltas, path, newStat.array[i]); \
-                } \
-            } \
-        } while(0)
-    #define COMPARE_SCALAR_ARRAY(array, base_path) \
-        do { \
-            char path[128]; \
-            for (int i = 0; i < (int)(sizeof(newStat.array)/sizeof(newStat.array[0])); ++i) { \
-                if (force || newStat.array[i] != oldStat.array[i]) { \
-                    snprintf(path, sizeof(path), base_path ".%d", i); \
-                    addDelta(env, deltas, path, newStat.array[i]); \
-                } \
-            } \
-        } while(0)
-
-    void NapiStatChannel::compareTaskStat(Napi::Env env, Napi::Array &deltas,
-                                          const EMC_TASK_STAT &newStat, const EMC_TASK_STAT &oldStat, bool force)
+    StatDeltaBatch::StatDeltaBatch(Napi::Env env, StatRateLimiter &limiter, Napi::Object held, double now, bool force)
+        : env_(env), limiter_(limiter), held_(held), now_(now), force_(force)
     {
-        COMPARE_INT_CAST(mode, "task.mode");
-        COMPARE_INT_CAST(state, "task.state");
-        COMPARE_INT_CAST(execState, "task.execState");
-        COMPARE_INT_CAST(interpState, "task.interpState");
-        COMPARE_INT_CAST(stopState, "task.stopState");
-        COMPARE_FIELD(callLevel, "task.callLevel");
-        COMPARE_FIELD(motionLine, "task.motionLine");
-        COMPARE_FIELD(currentLine, "task.currentLine");
-        COMPARE_FIELD(readLine, "task.readLine");
-        COMPARE_BOOL(optional_stop_state, "task.optionalStopState");
-        COMPARE_BOOL(block_delete_state, "task.blockDeleteState");
-        COMPARE_BOOL(input_timeout, "task.inputTimeout");
-        COMPARE_STRING(file, "task.file");
-        COMPARE_STRING(command, "task.command");
-        COMPARE_STRING(ini_filename, "task.iniFilename");
-        COMPARE_POSE(g5x_offset, "task.g5xOffset");
-        COMPARE_FIELD(g5x_index, "task.g5xIndex");
-        COMPARE_ARRAY_MEMCMP(g5x_offsets, "task.g5xOffsets");
-        COMPARE_SCALAR_ARRAY(g5x_rotations, "task.g5xRotations");
-        COMPARE_POSE(g92_offset, "task.g92Offset");
-        COMPARE_FIELD(rotation_xy, "task.rotationXY");
-        COMPARE_POSE(g28_position, "task.g28Position");
-        COMPARE_POSE(g30_position, "task.g30Position");
-        COMPARE_POSE(toolOffset, "task.toolOffset");
-        
-        // Active G-codes
-        COMPARE_ARRAY(activeGCodes, 1, "task.activeGCodes.motionMode");
-        COMPARE_ARRAY(activeGCodes, 2, "task.activeGCodes.gMode0");
-        COMPARE_ARRAY(activeGCodes, 3, "task.activeGCodes.plane");
-        COMPARE_ARRAY(activeGCodes, 4, "task.activeGCodes.cutterComp");
-        COMPARE_ARRAY(activeGCodes, 5, "task.activeGCodes.units");
-        COMPARE_ARRAY(activeGCodes, 6, "task.activeGCodes.distanceMode");
-        COMPARE_ARRAY(activeGCodes, 7, "task.activeGCodes.feedRateMode");
-        COMPARE_ARRAY(activeGCodes, 8, "task.activeGCodes.origin");
-        COMPARE_ARRAY(activeGCodes, 9, "task.activeGCodes.toolLengthOffset");
-        COMPARE_ARRAY(activeGCodes, 10, "task.activeGCodes.retractMode");
-        COMPARE_ARRAY(activeGCodes, 11, "task.activeGCodes.pathControl");
-        COMPARE_ARRAY(activeGCodes, 13, "task.activeGCodes.spindleSpeedMode");
-        COMPARE_ARRAY(activeGCodes, 14, "task.activeGCodes.ijkDistanceMode");
-        COMPARE_ARRAY(activeGCodes, 15, "task.activeGCodes.latheDiameterMode");
-        COMPARE_ARRAY(activeGCodes, 16, "task.activeGCodes.g92Applied");
-
-        // Active M-codes
-        COMPARE_ARRAY(activeMCodes, 1, "task.activeMCodes.stopping");
-        COMPARE_ARRAY(activeMCodes, 2, "task.activeMCodes.spindleControl");
-        COMPARE_ARRAY(activeMCodes, 3, "task.activeMCodes.toolChange");
-        COMPARE_ARRAY(activeMCodes, 4, "task.activeMCodes.mistCoolant");
-        COMPARE_ARRAY(activeMCodes, 5, "task.activeMCodes.floodCoolant");
-        COMPARE_ARRAY(activeMCodes, 6, "task.activeMCodes.overrideControl");
-        COMPARE_ARRAY(activeMCodes, 7, "task.activeMCodes.adaptiveFeedControl");
-        COMPARE_ARRAY(activeMCodes, 8, "task.activeMCodes.feedHoldControl");
-
-        // Active settings
-        COMPARE_ARRAY(activeSettings, 1, "task.activeSettings.feedRate");
-        COMPARE_ARRAY(activeSettings, 2, "task.activeSettings.speed");
-        COMPARE_ARRAY(activeSettings, 3, "task.activeSettings.blendTolerance");
-        COMPARE_ARRAY(activeSettings, 4, "task.activeSettings.naiveCAMTolerance");
-
-        COMPARE_INT_CAST(programUnits, "task.programUnits");
-        COMPARE_FIELD(delayLeft, "task.delayLeft");
-        COMPARE_BOOL(task_paused, "task.taskPaused");
-        COMPARE_FIELD(interpreter_errcode, "task.interpreterErrorCode");
-        COMPARE_FIELD(queuedMDIcommands, "task.queuedMdiCommands");
     }
 
-    void NapiStatChannel::compareTrajStat(Napi::Env env, Napi::Array &deltas, const char* prefix,
-                                          const EMC_TRAJ_STAT &newStat, const EMC_TRAJ_STAT &oldStat, bool force)
+    void StatDeltaBatch::add(const char *path, Napi::Value value)
     {
-        char path[128];
-        #define TRAJ_PATH(name) (snprintf(path, sizeof(path), "%s.%s", prefix, name), path)
-        
-        // Simple field comparisons
-        COMPARE_FIELD(linearUnits, TRAJ_PATH("linearUnits"));
-        COMPARE_FIELD(angularUnits, TRAJ_PATH("angularUnits"));
-        COMPARE_FIELD(cycleTime, TRAJ_PATH("cycleTime"));
-        COMPARE_FIELD(joints, TRAJ_PATH("joints"));
-        COMPARE_FIELD(spindles, TRAJ_PATH("spindles"));
-        
-        // Axis mask - special handling to build string array
-        if (force || newStat.axis_mask != oldStat.axis_mask) {
-            Napi::Array axisArray = Napi::Array::New(env);
-            uint32_t axisMask = newStat.axis_mask;
-            uint32_t idx = 0;
-            if (axisMask & 1) axisArray.Set(idx++, Napi::String::New(env, "X"));
-            if (axisMask & 2) axisArray.Set(idx++, Napi::String::New(env, "Y"));
-            if (axisMask & 4) axisArray.Set(idx++, Napi::String::New(env, "Z"));
-            if (axisMask & 8) axisArray.Set(idx++, Napi::String::New(env, "A"));
-            if (axisMask & 16) axisArray.Set(idx++, Napi::String::New(env, "B"));
-            if (axisMask & 32) axisArray.Set(idx++, Napi::String::New(env, "C"));
-            if (axisMask & 64) axisArray.Set(idx++, Napi::String::New(env, "U"));
-            if (axisMask & 128) axisArray.Set(idx++, Napi::String::New(env, "V"));
-            if (axisMask & 256) axisArray.Set(idx++, Napi::String::New(env, "W"));
-            
-            Napi::Object change = Napi::Object::New(env);
-            change.Set("path", Napi::String::New(env, TRAJ_PATH("availableAxes")));
-            change.Set("value", axisArray);
-            deltas.Set(deltas.Length(), change);
+        if (limiter_.empty())
+        {
+            push(DeltaPriority::Normal, path, value);
+            return;
+        }
+        if (force_)
+        {
+            push(limiter_.priorityOf(path), path, value);
+            return;
         }
-        
-        COMPARE_INT_CAST(mode, TRAJ_PATH("mode"));
-        COMPARE_BOOL(enabled, TRAJ_PATH("enabled"));
-        COMPARE_BOOL(inpos, TRAJ_PATH("inPosition"));
-        COMPARE_FIELD(queue, TRAJ_PATH("queue"));
-        COMPARE_FIELD(activeQueue, TRAJ_PATH("activeQueue"));
-        COMPARE_BOOL(queueFull, TRAJ_PATH("queueFull"));
-        COMPARE_FIELD(id, TRAJ_PATH("id"));
-        COMPARE_BOOL(paused, TRAJ_PATH("paused"));
-        COMPARE_BOOL(single_stepping, TRAJ_PATH("singleStepping"));
-        
-        // Fields with different path names
-        if (force || newStat.scale != oldStat.scale) addDelta(env, deltas, TRAJ_PATH("feedRateOverride"), newStat.scale);
-        if (force || newStat.rapid_scale != oldStat.rapid_scale) addDelta(env, deltas, TRAJ_PATH("rapidRateOverride"), newStat.rapid_scale);
-        
-        COMPARE_POSE(position, TRAJ_PATH("position"));
-        COMPARE_POSE(actualPosition, TRAJ_PATH("actualPosition"));
-        COMPARE_FIELD(acceleration, TRAJ_PATH("acceleration"));
-        COMPARE_FIELD(maxVelocity, TRAJ_PATH("maxVelocity"));
-        COMPARE_FIELD(maxAcceleration, TRAJ_PATH("maxAcceleration"));
-        COMPARE_POSE(probedPosition, TRAJ_PATH("probedPosition"));
-        COMPARE_BOOL(probe_tripped, TRAJ_PATH("probeTripped"));
-        COMPARE_BOOL(probing, TRAJ_PATH("probing"));
-        COMPARE_FIELD(probeval, TRAJ_PATH("probeVal"));
-        COMPARE_FIELD(kinematics_type, TRAJ_PATH("kinematicsType"));
-        COMPARE_FIELD(motion_type, TRAJ_PATH("motionType"));
-        COMPARE_FIELD(distance_to_go, TRAJ_PATH("distanceToGo"));
-        COMPARE_POSE(dtg, TRAJ_PATH("dtg"));
-        COMPARE_FIELD(current_vel, TRAJ_PATH("currentVelocity"));
-        COMPARE_BOOL(feed_override_enabled, TRAJ_PATH("feedOverrideEnabled"));
-        COMPARE_BOOL(adaptive_feed_enabled, TRAJ_PATH("adaptiveFeedEnabled"));
-        COMPARE_BOOL(feed_hold_enabled, TRAJ_PATH("feedHoldEnabled"));
-        
-        #undef TRAJ_PATH
-    }
 
-    void NapiStatChannel::compareJointStat(Napi::Env env, Napi::Array &deltas, const char* prefix,
-                                           const EMC_JOINT_STAT &newStat, const EMC_JOINT_STAT &oldStat, bool force)
-    {
-        char path[128];
-        #define JOINT_PATH(name) (snprintf(path, sizeof(path), "%s.%s", prefix, name), path)
-        
-        COMPARE_INT_CAST(jointType, JOINT_PATH("jointType"));
-        COMPARE_FIELD(units, JOINT_PATH("units"));
-        COMPARE_FIELD(backlash, JOINT_PATH("backlash"));
-        COMPARE_FIELD(minPositionLimit, JOINT_PATH("minPositionLimit"));
-        COMPARE_FIELD(maxPositionLimit, JOINT_PATH("maxPositionLimit"));
-        COMPARE_FIELD(minFerror, JOINT_PATH("minFerror"));
-        COMPARE_FIELD(maxFerror, JOINT_PATH("maxFerror"));
-        COMPARE_FIELD(ferrorCurrent, JOINT_PATH("ferrorCurrent"));
-        COMPARE_FIELD(ferrorHighMark, JOINT_PATH("ferrorHighMark"));
-        COMPARE_FIELD(output, JOINT_PATH("output"));
-        COMPARE_FIELD(input, JOINT_PATH("input"));
-        COMPARE_FIELD(velocity, JOINT_PATH("velocity"));
-        COMPARE_BOOL(inpos, JOINT_PATH("inPosition"));
-        COMPARE_BOOL(homing, JOINT_PATH("homing"));
-        COMPARE_BOOL(homed, JOINT_PATH("homed"));
-        COMPARE_BOOL(fault, JOINT_PATH("fault"));
-        COMPARE_BOOL(enabled, JOINT_PATH("enabled"));
-        COMPARE_BOOL(minSoftLimit, JOINT_PATH("minSoftLimit"));
-        COMPARE_BOOL(maxSoftLimit, JOINT_PATH("maxSoftLimit"));
-        COMPARE_BOOL(minHardLimit, JOINT_PATH("minHardLimit"));
-        COMPARE_BOOL(maxHardLimit, JOINT_PATH("maxHardLimit"));
-        COMPARE_BOOL(overrideLimits, JOINT_PATH("overrideLimits"));
-        
-        #undef JOINT_PATH
+        StatRateLimiter::Decision decision = limiter_.offer(path, now_);
+        if (decision.emit)
+        {
+            push(decision.priority, path, value);
+        }
+        else
+        {
+            held_.Set(path, value); // Coalesce to the latest value
+        }
     }
 
-    void NapiStatChannel::compareSpindleStat(Napi::Env env, Napi::Array &deltas, const char* prefix,
-                                             const EMC_SPINDLE_STAT &newStat, const EMC_SPINDLE_STAT &oldStat, bool force)
+    void StatDeltaBatch::push(DeltaPriority priority, const char *path, Napi::Value value)
     {
-        char path[128];
-        #define SPINDLE_PATH(name) (snprintf(path, sizeof(path), "%s.%s", prefix, name), path)
-        
-        COMPARE_FIELD(speed, SPINDLE_PATH("speed"));
-        COMPARE_FIELD(feedback, SPINDLE_PATH("feedback"));
-        COMPARE_FIELD(css_maximum, SPINDLE_PATH("cssMaximum"));
-        COMPARE_FIELD(css_factor, SPINDLE_PATH("cssFactor"));
-        COMPARE_FIELD(direction, SPINDLE_PATH("direction"));
-        COMPARE_FIELD(increasing, SPINDLE_PATH("increasing"));
-        COMPARE_FIELD(orient_state, SPINDLE_PATH("orientState"));
-        COMPARE_FIELD(orient_fault, SPINDLE_PATH("orientFault"));
-        COMPARE_BOOL(brake, SPINDLE_PATH("brake"));
-        COMPARE_BOOL(enabled, SPINDLE_PATH("enabled"));
-        COMPARE_BOOL(spindle_override_enabled, SPINDLE_PATH("spindleOverrideEnabled"));
-        COMPARE_BOOL(homed, SPINDLE_PATH("homed"));
-        
-        // Field with different path name
-        if (force || newStat.spindle_scale != oldStat.spindle_scale) 
-            addDelta(env, deltas, SPINDLE_PATH("override"), newStat.spindle_scale);
-        
-        #undef SPINDLE_PATH
+        Napi::Array &deltas = classes_[static_cast<size_t>(priority)];
+        if (deltas.IsEmpty())
+        {
+            deltas = Napi::Array::New(env_);
+        }
+        Napi::Object change = Napi::Object::New(env_);
+        change.Set("path", Napi::String::New(env_, path));
+        change.Set("value", value);
+        deltas.Set(deltas.Length(), change);
     }
 
-    void NapiStatChannel::compareAxisStat(Napi::Env env, Napi::Array &deltas, const char* prefix,
-                                          const EMC_AXIS_STAT &newStat, const EMC_AXIS_STAT &oldStat, bool force)
+    Napi::Array StatDeltaBatch::finish()
     {
-        char path[128];
-        #define AXIS_PATH(name) (snprintf(path, sizeof(path), "%s.%s", prefix, name), path)
-        
-        COMPARE_FIELD(minPositionLimit, AXIS_PATH("minPositionLimit"));
-        COMPARE_FIELD(maxPositionLimit, AXIS_PATH("maxPositionLimit"));
-        COMPARE_FIELD(velocity, AXIS_PATH("velocity"));
-        
-        #undef AXIS_PATH
-    }
+        if (!force_ && limiter_.hasPending())
+        {
+            limiter_.takeDue(now_, [&](const std::string &path, DeltaPriority priority)
+                             {
+                push(priority, path.c_str(), held_.Get(path));
+                held_.Delete(path); });
+        }
 
-    void NapiStatChannel::compareMotionStat(Napi::Env env, Napi::Array &deltas,
-                                            const EMC_MOTION_STAT &newStat, const EMC_MOTION_STAT &oldStat, bool force)
-    {
-        // Trajectory
-        compareTrajStat(env, deltas, "motion.traj", newStat.traj, oldStat.traj, force);
-        char prefix[64];
-        
-        // Joints
-        for (int i = 0; i < EMCMOT_MAX_JOINTS; ++i) {
-            snprintf(prefix, sizeof(prefix), "motion.joint.%d", i);
-            compareJointStat(env, deltas, prefix, newStat.joint[i], oldStat.joint[i], force);
+        // Only one class in use (always the case without rules): no copy
+        size_t used = 0;
+        size_t last = 0;
+        for (size_t i = 0; i < DELTA_PRIORITY_COUNT; ++i)
+        {
+            if (!classes_[i].IsEmpty())
+            {
+                used++;
+                last = i;
+            }
         }
-        
-        // Axes
-        for (int i = 0; i < EMCMOT_MAX_AXIS; ++i) {
-            snprintf(prefix, sizeof(prefix), "motion.axis.%d", i);
-            compareAxisStat(env, deltas, prefix, newStat.axis[i], oldStat.axis[i], force);
+        if (used == 0)
+        {
+            return Napi::Array::New(env_);
         }
-        
-        // Spindles
-        for (int i = 0; i < EMCMOT_MAX_SPINDLES; ++i) {
-            snprintf(prefix, sizeof(prefix), "motion.spindle.%d", i);
-            compareSpindleStat(env, deltas, prefix, newStat.spindle[i], oldStat.spindle[i], force);
+        if (used == 1)
+        {
+            return classes_[last];
         }
-        
-        // Local macro for indexed array comparison with dynamic path
-        char path[128];
-        #define COMPARE_INDEXED_IO(array, base_path) \
-            for (int i = 0; i < (int)(sizeof(newStat.array)/sizeof(newStat.array[0])); ++i) { \
-                if (force || newStat.array[i] != oldStat.array[i]) { \
-                    snprintf(path, sizeof(path), base_path ".%d", i); \
-                    addDelta(env, deltas, path, newStat.array[i]); \
-                } \
+
+        Napi::Array result = Napi::Array::New(env_);
+        uint32_t n = 0;
+        for (size_t i = 0; i < DELTA_PRIORITY_COUNT; ++i)
+        {
+            if (classes_[i].IsEmpty())
+                continue;
+            for (uint32_t j = 0; j < classes_[i].Length(); ++j)
+            {
+                result.Set(n++, classes_[i].Get(j));
             }
-        
-        COMPARE_INDEXED_IO(synch_di, "motion.digitalInput");
-        COMPARE_INDEXED_IO(synch_do, "motion.digitalOutput");
-        COMPARE_INDEXED_IO(analog_input, "motion.analogInput");
-        COMPARE_INDEXED_IO(analog_output, "motion.analogOutput");
-        
-        #undef COMPARE_INDEXED_IO
+        }
+        return result;
     }
 
-    void NapiStatChannel::compareIoStat(Napi::Env env, Napi::Array &deltas,
-                                        const EMC_IO_STAT &newStat, const EMC_IO_STAT &oldStat, bool force)
+    // Adapts the live stat tree and a StatDeltaBatch to the stat_diff.hh
+    // sink interface. Deltas are only built when collect is set.
+    struct NapiDeltaSink
     {
-        // Tool stat
-        if (force || newStat.tool.pocketPrepped != oldStat.tool.pocketPrepped) 
-            addDelta(env, deltas, "io.tool.pocketPrepped", newStat.tool.pocketPrepped);
-        if (force || newStat.tool.toolInSpindle != oldStat.tool.toolInSpindle) 
-            addDelta(env, deltas, "io.tool.toolInSpindle", newStat.tool.toolInSpindle);
-        if (force || newStat.tool.toolFromPocket != oldStat.tool.toolFromPocket) 
-            addDelta(env, deltas, "io.tool.toolFromPocket", newStat.tool.toolFromPocket);
-        
-        // Coolant stat
-        if (force || newStat.coolant.mist != oldStat.coolant.mist) 
-            addDelta(env, deltas, "io.coolant.mist", (bool)newStat.coolant.mist);
-        if (force || newStat.coolant.flood != oldStat.coolant.flood) 
-            addDelta(env, deltas, "io.coolant.flood", (bool)newStat.coolant.flood);
-        
-        // Aux stat
-        if (force || newStat.aux.estop != oldStat.aux.estop) 
-            addDelta(env, deltas, "io.estop", (bool)newStat.aux.estop);
-    }
+        Napi::Env env;
+        StatDeltaBatch &deltas;
+        StatTree &tree;
+        bool collect;
+
+        template<typename T>
+        void add(const char* path, const T& value)
+        {
+            Napi::Value napiValue = toNapiValue(env, value);
+            tree.set(env, path, napiValue);
+            if (collect) deltas.add(path, napiValue);
+        }
 
-    // Undefine macros
-    #undef COMPARE_FIELD
-    #undef COMPARE_BOOL
-    #undef COMPARE_INT_CAST
-    #undef COMPARE_STRING
-    #undef COMPARE_POSE
-    #undef COMPARE_ARRAY
-    #undef COMPARE_ARRAY_MEMCMP
-    #undef COMPARE_SCALAR_ARRAY
+        // Poses are written into the tree's array; deltas get a copy
+        void add(const char* path, const EmcPose& pose)
+        {
+            tree.setPose(env, path, pose);
+            if (collect) deltas.add(path, EmcPoseToNapiFloat64Array(env, pose));
+        }
+
+        void addAxes(const char* path, uint32_t axisMask)
+        {
+            static const char* const letters[] = {"X", "Y", "Z", "A", "B", "C", "U", "V", "W"};
+            Napi::Array axisArray = Napi::Array::New(env);
+            uint32_t idx = 0;
+            for (uint32_t bit = 0; bit < 9; ++bit)
+            {
+                if (axisMask & (1u << bit)) axisArray.Set(idx++, Napi::String::New(env, letters[bit]));
+            }
+            tree.set(env, path, axisArray);
+            if (collect) deltas.add(path, axisArray);
+        }
+    };
 
     Napi::Value NapiStatChannel::Poll(const Napi::CallbackInfo &info)
     {
         Napi::Env env = info.Env();
         
-        // Parse optional force parameter
+        // Parse optional force and collect parameters
         bool force = false;
         if (info.Length() > 0 && info[0].IsBoolean()) {
             force = info[0].As<Napi::Boolean>().Value();
         }
+        bool collect = true;
+        if (info.Length() > 1 && info[1].IsBoolean()) {
+            collect = info[1].As<Napi::Boolean>().Value();
+        }
         
         if (!s_channel_ || !s_channel_->valid())
         {
@@ -472,27 +263,59 @@ namespace LinuxCNC
             }
         }
 
+        // The live tree is always complete: fill it on its first poll
+        if (tree_.empty())
+        {
+            tree_.reset(env);
+        }
+        if (tree_.size() == 0)
+        {
+            force = true;
+        }
+        tree_.beginPoll();
+
         // Create result object
         Napi::Object result = Napi::Object::New(env);
-        Napi::Array deltas = Napi::Array::New(env);
+        if (held_deltas_.IsEmpty() || force)
+        {
+            // A full poll makes every held value current
+            held_deltas_ = Napi::Persistent(Napi::Object::New(env));
+            rate_limiter_.clearPending();
+        }
+        StatDeltaBatch deltas(env, rate_limiter_, held_deltas_.Value(), etime(), force);
+
+        NapiDeltaSink sink{env, deltas, tree_, collect};
+        if (!released_deltas_.IsEmpty())
+        {
+            if (!force)
+            {
+                Napi::Object released = released_deltas_.Value();
+                Napi::Array paths = released.GetPropertyNames();
+                for (uint32_t i = 0; i < paths.Length(); ++i)
+                {
+                    std::string path = paths.Get(i).As<Napi::String>().Utf8Value();
+                    deltas.add(path.c_str(), released.Get(path));
+                }
+            }
+            released_deltas_.Reset();
+        }
         
         bool updated = pollInternal();
         
         if (force || (updated && has_prev_status_)) {
             // Compare and generate deltas (force emits all fields)
-            if (force || status_.echo_serial_number != prev_status_.echo_serial_number)
-                addDelta(env, deltas, "echoSerialNumber", (int)status_.echo_serial_number);
-            if (force || (int)status_.status != (int)prev_status_.status)
-                addDelta(env, deltas, "state", (int)status_.status);
-            if (force || status_.debug != prev_status_.debug)
-                addDelta(env, deltas, "debug", (int)status_.debug);
-            
-            compareTaskStat(env, deltas, status_.task, prev_status_.task, force);
-            compareMotionStat(env, deltas, status_.motion, prev_status_.motion, force);
-            compareIoStat(env, deltas, status_.io, prev_status_.io, force);
+            diffStatus(sink, status_, prev_status_, force);
             
             // Tool table comparison
-            compareToolTable(env, deltas, force);
+            compareToolTable(sink, force);
+        }
+
+        // Progress follows the status, and the program when it was just set
+        if (force || progress_dirty_ || (updated && has_prev_status_)) {
+            progress_ = progress_engine_.update(progressInput());
+            diffProgress(sink, progress_, prev_progress_, force);
+            prev_progress_ = progress_;
+            progress_dirty_ = false;
         }
         
         // If we have updated data, copy current to previous for next comparison
@@ -502,75 +325,492 @@ namespace LinuxCNC
         }
         
         // Only increment cursor if there are actual changes
-        if (deltas.Length() > 0) {
+        Napi::Array changes = deltas.finish();
+        if (changes.Length() > 0 || tree_.changed()) {
             cursor_++;
         }
         
-        result.Set("changes", deltas);
+        result.Set("changes", changes);
         result.Set("cursor", Napi::Number::New(env, static_cast<uint32_t>(cursor_)));
         return result;
     }
     
+    // materialize() returns the same object for the life of the channel;
+    // each poll() updates it in place
+    Napi::Value NapiStatChannel::Materialize(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        if (tree_.empty())
+        {
+            tree_.reset(env);
+        }
+        return tree_.root();
+    }
+
+    Napi::Value NapiStatChannel::GetChangedBitmap(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        if (tree_.empty())
+        {
+            tree_.reset(env);
+        }
+        return tree_.changedBitmap(env);
+    }
+
+    Napi::Value NapiStatChannel::GetLeafIndex(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString())
+        {
+            Napi::TypeError::New(env, "Path string expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        return Napi::Number::New(env, tree_.indexOf(info[0].As<Napi::String>().Utf8Value()));
+    }
+
+    Napi::Value NapiStatChannel::GetChangedPaths(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        if (tree_.empty())
+        {
+            return Napi::Array::New(env);
+        }
+        return tree_.changedPaths(env);
+    }
+
     Napi::Value NapiStatChannel::GetCursor(const Napi::CallbackInfo &info)
     {
         return Napi::Number::New(info.Env(), static_cast<uint32_t>(cursor_));
     }
 
-    Napi::Array NapiStatChannel::convertToolTableToNapi(Napi::Env env)
+    JobProgressInput NapiStatChannel::progressInput() const
+    {
+        JobProgressInput input;
+        const EMC_TASK_STAT &task = status_.task;
+        const EMC_TRAJ_STAT &traj = status_.motion.traj;
+
+        input.running = task.interpState != EMC_TASK_INTERP::IDLE &&
+                        (program_file_.empty() || program_file_ == task.file);
+        input.motionLine = task.motionLine;
+        // linearUnits is machine units per mm
+        input.distanceToGo = traj.linearUnits > 0.0 ? traj.distance_to_go / traj.linearUnits : traj.distance_to_go;
+        input.delayLeft = task.delayLeft;
+        input.feedScale = traj.scale;
+        input.rapidScale = traj.rapid_scale;
+        return input;
+    }
+
+    // setProgram(file, { lineNumber, length, duration, rapid? })
+    // One entry per move of the program, in mm and seconds, e.g. the
+    // timing table of a gcode PathSampler or a planner simulation.
+    Napi::Value NapiStatChannel::SetProgram(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsObject())
+        {
+            Napi::TypeError::New(env, "Expected (file: string, table: object)").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Object table = info[1].As<Napi::Object>();
+        auto isTyped = [](Napi::Value value, napi_typedarray_type type)
+        {
+            return value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == type;
+        };
+
+        Napi::Value lineValue = table.Get("lineNumber");
+        Napi::Value lengthValue = table.Get("length");
+        Napi::Value durationValue = table.Get("duration");
+        Napi::Value rapidValue = table.Get("rapid");
+        if (!isTyped(lineValue, napi_int32_array) || !isTyped(lengthValue, napi_float64_array) ||
+            !isTyped(durationValue, napi_float64_array) ||
+            (!rapidValue.IsUndefined() && !isTyped(rapidValue, napi_uint8_array)))
+        {
+            Napi::TypeError::New(env, "table needs lineNumber: Int32Array, length and duration: Float64Array, rapid?: Uint8Array")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Int32Array lines = lineValue.As<Napi::Int32Array>();
+        Napi::Float64Array lengths = lengthValue.As<Napi::Float64Array>();
+        Napi::Float64Array durations = durationValue.As<Napi::Float64Array>();
+
+        std::vector<uint8_t> rapid;
+        if (!rapidValue.IsUndefined())
+        {
+            Napi::Uint8Array rapidArray = rapidValue.As<Napi::Uint8Array>();
+            rapid.assign(rapidArray.Data(), rapidArray.Data() + rapidArray.ElementLength());
+        }
+
+        try
+        {
+            progress_engine_.setProgram(
+                std::vector<int32_t>(lines.Data(), lines.Data() + lines.ElementLength()),
+                std::vector<double>(lengths.Data(), lengths.Data() + lengths.ElementLength()),
+                std::vector<double>(durations.Data(), durations.Data() + durations.ElementLength()),
+                rapid);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            Napi::RangeError::New(env, e.what()).ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        program_file_ = info[0].As<Napi::String>().Utf8Value();
+        progress_dirty_ = true;
+        return env.Undefined();
+    }
+
+    Napi::Value NapiStatChannel::ClearProgram(const Napi::CallbackInfo &info)
+    {
+        progress_engine_.clear();
+        program_file_.clear();
+        progress_dirty_ = true;
+        return info.Env().Undefined();
+    }
+
+    bool NapiStatChannel::ensureToolMmap()
     {
         if (!tool_mmap_initialized_)
         {
-            // fprintf(stderr, "Tool mmap not initialized, cannot get tool table.\n");
-            return Napi::Array::New(env, 0); // Return empty array
+            if (tool_mmap_user() != 0)
+            {
+                return false;
+            }
+            tool_mmap_initialized_ = true;
         }
+        return true;
+    }
 
-        int idxmax = tooldata_last_index_get() + 1;
-        Napi::Array toolList = Napi::Array::New(env);
-        uint32_t js_idx = 0;
+    Napi::Object NapiStatChannel::convertToolTableToColumns(Napi::Env env)
+    {
+        std::vector<CANON_TOOL_TABLE> tools;
+        if (ensureToolMmap())
+        {
+            int idxmax = tooldata_last_index_get() + 1;
+            tools.reserve(idxmax > 0 ? idxmax : 0);
+            for (int i = 0; i < idxmax; ++i)
+            {
+                // Unreadable entries are left out, as compareToolTable()
+                // skips them
+                CANON_TOOL_TABLE tdata;
+                if (tooldata_get(&tdata, i) != IDX_OK)
+                {
+                    continue;
+                }
+                tools.push_back(tdata);
+            }
+        }
 
-        for (int i = 0; i < idxmax; ++i)
+        size_t count = tools.size();
+        Napi::Int32Array toolNo = Napi::Int32Array::New(env, count);
+        Napi::Int32Array pocketNo = Napi::Int32Array::New(env, count);
+        Napi::Float64Array diameter = Napi::Float64Array::New(env, count);
+        Napi::Float64Array frontAngle = Napi::Float64Array::New(env, count);
+        Napi::Float64Array backAngle = Napi::Float64Array::New(env, count);
+        Napi::Int32Array orientation = Napi::Int32Array::New(env, count);
+        Napi::Float64Array offset = Napi::Float64Array::New(env, count * TOOL_OFFSET_STRIDE);
+        Napi::Uint32Array commentOffsets = Napi::Uint32Array::New(env, count + 1);
+
+        int32_t maxToolNo = -1;
+        size_t commentBytes = 0;
+        for (size_t i = 0; i < count; ++i)
         {
-            CANON_TOOL_TABLE tdata;
-            if (tooldata_get(&tdata, i) != IDX_OK)
+            const CANON_TOOL_TABLE &tdata = tools[i];
+            toolNo[i] = tdata.toolno;
+            pocketNo[i] = tdata.pocketno;
+            diameter[i] = tdata.diameter;
+            frontAngle[i] = tdata.frontangle;
+            backAngle[i] = tdata.backangle;
+            orientation[i] = tdata.orientation;
+
+            double *o = offset.Data() + i * TOOL_OFFSET_STRIDE;
+            o[0] = tdata.offset.tran.x;
+            o[1] = tdata.offset.tran.y;
+            o[2] = tdata.offset.tran.z;
+            o[3] = tdata.offset.a;
+            o[4] = tdata.offset.b;
+            o[5] = tdata.offset.c;
+            o[6] = tdata.offset.u;
+            o[7] = tdata.offset.v;
+            o[8] = tdata.offset.w;
+
+            commentOffsets[i] = static_cast<uint32_t>(commentBytes);
+            commentBytes += strnlen(tdata.comment, sizeof(tdata.comment));
+            if (tdata.toolno > maxToolNo)
             {
-                fprintf(stderr, "NapiStatChannel::convertToolTableToNapi: Error getting tool data for index %d\n", i);
-                continue;
+                maxToolNo = tdata.toolno;
             }
+        }
+        commentOffsets[count] = static_cast<uint32_t>(commentBytes);
 
-            Napi::Object toolObj = Napi::Object::New(env);
-            DictAdd(env, toolObj, "toolNo", tdata.toolno);
-            DictAdd(env, toolObj, "pocketNo", tdata.pocketno);
-            DictAdd(env, toolObj, "diameter", tdata.diameter);
-            DictAdd(env, toolObj, "frontAngle", tdata.frontangle);
-            DictAdd(env, toolObj, "backAngle", tdata.backangle);
-            DictAdd(env, toolObj, "orientation", tdata.orientation);
-            toolObj.Set("offset", EmcPoseToNapiFloat64Array(env, tdata.offset));
-            DictAddString(env, toolObj, "comment", tdata.comment);
+        // All comments back to back as UTF-8; comment i spans
+        // [commentOffsets[i], commentOffsets[i + 1])
+        Napi::Uint8Array comments = Napi::Uint8Array::New(env, commentBytes);
+        for (size_t i = 0; i < count; ++i)
+        {
+            memcpy(comments.Data() + commentOffsets[i], tools[i].comment, commentOffsets[i + 1] - commentOffsets[i]);
+        }
 
-            toolList.Set(js_idx++, toolObj);
+        // Row of each tool number, -1 where there is none. Row 0 is the
+        // spindle and repeats the loaded tool, so pocket rows win. Tool
+        // numbers past the cap are left to a scan of toolNo.
+        size_t indexSize = static_cast<size_t>(std::min<int32_t>(maxToolNo, MAX_INDEXED_TOOL_NO) + 1);
+        Napi::Int32Array index = Napi::Int32Array::New(env, indexSize);
+        std::fill(index.Data(), index.Data() + indexSize, -1);
+        for (size_t k = 1; k <= count; ++k)
+        {
+            size_t i = k % count; // 1 .. count-1, then 0
+            int32_t number = tools[i].toolno;
+            if (number >= 0 && static_cast<size_t>(number) < indexSize && index[number] < 0)
+            {
+                index[number] = static_cast<int32_t>(i);
+            }
         }
-        return toolList;
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+        result.Set("toolNo", toolNo);
+        result.Set("pocketNo", pocketNo);
+        result.Set("diameter", diameter);
+        result.Set("frontAngle", frontAngle);
+        result.Set("backAngle", backAngle);
+        result.Set("orientation", orientation);
+        result.Set("offset", offset);
+        result.Set("comments", comments);
+        result.Set("commentOffsets", commentOffsets);
+        result.Set("indexByToolNo", index);
+        return result;
     }
 
-    Napi::Value NapiStatChannel::Disconnect(const Napi::CallbackInfo &info)
+    Napi::Value NapiStatChannel::GetToolTable(const Napi::CallbackInfo &info)
+    {
+        return convertToolTableToColumns(info.Env());
+    }
+
+    // setRateLimits([{ path, maxRate?, priority? }])
+    // maxRate in Hz (0 or absent = unthrottled), priority "high" | "normal" | "low".
+    // Replaces the previous rules; an empty array removes all limits.
+    Napi::Value NapiStatChannel::SetRateLimits(const Napi::CallbackInfo &info)
     {
         Napi::Env env = info.Env();
-        disconnect();
+
+        if (info.Length() < 1 || !info[0].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected an array of rate limit rules").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array array = info[0].As<Napi::Array>();
+        std::vector<RateLimitRule> rules;
+        rules.reserve(array.Length());
+        for (uint32_t i = 0; i < array.Length(); ++i)
+        {
+            Napi::Value item = array.Get(i);
+            if (!item.IsObject())
+            {
+                Napi::TypeError::New(env, "Rate limit rule must be an object").ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+            Napi::Object obj = item.As<Napi::Object>();
+
+            RateLimitRule rule;
+            Napi::Value path = obj.Get("path");
+            if (!path.IsString() || path.As<Napi::String>().Utf8Value().empty())
+            {
+                Napi::TypeError::New(env, "Rate limit rule path (string) expected").ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+            rule.pattern = path.As<Napi::String>().Utf8Value();
+
+            Napi::Value maxRate = obj.Get("maxRate");
+            if (!maxRate.IsUndefined())
+            {
+                double rate = maxRate.IsNumber() ? maxRate.As<Napi::Number>().DoubleValue() : -1.0;
+                if (!(rate >= 0.0) || std::isinf(rate))
+                {
+                    Napi::RangeError::New(env, "maxRate must be a finite number >= 0").ThrowAsJavaScriptException();
+                    return env.Undefined();
+                }
+                rule.minInterval = rate > 0.0 ? 1.0 / rate : 0.0;
+            }
+
+            Napi::Value priority = obj.Get("priority");
+            if (!priority.IsUndefined())
+            {
+                std::string name = priority.IsString() ? priority.As<Napi::String>().Utf8Value() : "";
+                if (name == "high")
+                    rule.priority = DeltaPriority::High;
+                else if (name == "normal")
+                    rule.priority = DeltaPriority::Normal;
+                else if (name == "low")
+                    rule.priority = DeltaPriority::Low;
+                else
+                {
+                    Napi::TypeError::New(env, "priority must be \"high\", \"normal\" or \"low\"").ThrowAsJavaScriptException();
+                    return env.Undefined();
+                }
+            }
+            rules.push_back(std::move(rule));
+        }
+
+        rate_limiter_.setRules(std::move(rules));
+        if (!held_deltas_.IsEmpty())
+        {
+            // Values held under the old rules go out with the next poll
+            released_deltas_ = std::move(held_deltas_);
+        }
         return env.Undefined();
     }
 
+    // Field-by-field diff of one tool table entry, like stat_diff.hh
+    template<typename Sink>
+    static void diffTool(Sink &sink, int i, const CANON_TOOL_TABLE &tdata, const CANON_TOOL_TABLE &oldData, bool force)
+    {
+        char path[128];
+
+        // Helper macros for tool table fields
+        #define TOOL_PATH(idx, name) (snprintf(path, sizeof(path), "toolTable.%d.%s", idx, name), path)
+
+        // Compare fields
+        if (force || tdata.toolno != oldData.toolno)
+            sink.add(TOOL_PATH(i, "toolNo"), tdata.toolno);
+
+        if (force || tdata.pocketno != oldData.pocketno)
+            sink.add(TOOL_PATH(i, "pocketNo"), tdata.pocketno);
+
+        if (force || tdata.diameter != oldData.diameter)
+            sink.add(TOOL_PATH(i, "diameter"), tdata.diameter);
 
+        if (force || tdata.frontangle != oldData.frontangle)
+            sink.add(TOOL_PATH(i, "frontAngle"), tdata.frontangle);
 
-    void NapiStatChannel::compareToolTable(Napi::Env env, Napi::Array &deltas, bool force)
+        if (force || tdata.backangle != oldData.backangle)
+            sink.add(TOOL_PATH(i, "backAngle"), tdata.backangle);
+
+        if (force || tdata.orientation != oldData.orientation)
+            sink.add(TOOL_PATH(i, "orientation"), tdata.orientation);
+
+        if (force || memcmp(&tdata.offset, &oldData.offset, sizeof(EmcPose)) != 0)
+            sink.add(TOOL_PATH(i, "offset"), tdata.offset);
+
+        if (force || strcmp(tdata.comment, oldData.comment) != 0)
+            sink.add(TOOL_PATH(i, "comment"), tdata.comment);
+
+        #undef TOOL_PATH
+    }
+
+    // Adapts a StatJsonWriter to the stat_diff.hh sink interface
+    struct JsonSnapshotSink
     {
-        if (!tool_mmap_initialized_)
+        StatJsonWriter &writer;
+
+        void add(const char *path, double value) { writer.addDouble(path, value); }
+        void add(const char *path, int value) { writer.addInt(path, value); }
+        void add(const char *path, bool value) { writer.addBool(path, value); }
+        void add(const char *path, const char *value) { writer.addString(path, value); }
+        void add(const char *path, const EmcPose &pose)
         {
-            if (tool_mmap_user() != 0)
+            const double values[9] = {pose.tran.x, pose.tran.y, pose.tran.z,
+                                      pose.a, pose.b, pose.c, pose.u, pose.v, pose.w};
+            writer.addPose(path, values);
+        }
+        void addAxes(const char *path, uint32_t axisMask) { writer.addAxes(path, axisMask); }
+    };
+
+    // snapshotJSON(fields?: string[])
+    // Reads the current status and writes it, with progress and the tool
+    // table, as one JSON document straight from the native structs, without
+    // building JavaScript objects. fields limits it to the given leaf or
+    // container paths, e.g. ["task", "motion.traj.position", "toolTable"].
+    Napi::Value NapiStatChannel::SnapshotJSON(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        std::vector<std::string> fields;
+        if (info.Length() > 0 && !info[0].IsUndefined())
+        {
+            if (!info[0].IsArray())
             {
-                // Failed to init, skip
-                return;
+                Napi::TypeError::New(env, "fields must be an array of stat paths").ThrowAsJavaScriptException();
+                return env.Null();
             }
-            tool_mmap_initialized_ = true;
+            Napi::Array array = info[0].As<Napi::Array>();
+            fields.reserve(array.Length());
+            for (uint32_t i = 0; i < array.Length(); ++i)
+            {
+                Napi::Value field = array.Get(i);
+                if (!field.IsString())
+                {
+                    Napi::TypeError::New(env, "fields must be an array of stat paths").ThrowAsJavaScriptException();
+                    return env.Null();
+                }
+                fields.push_back(field.As<Napi::String>().Utf8Value());
+            }
+        }
+
+        if (!s_channel_ || !s_channel_->valid())
+        {
+            if (!connect())
+            {
+                Napi::Error::New(env, "Stat channel not connected and failed to reconnect.").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+        }
+
+        // Read into our own copy: status_ is what the next poll diffs against
+        if (!s_channel_->read(snapshot_status_))
+        {
+            snapshot_status_ = status_;
+        }
+
+        json_.select(std::move(fields));
+        json_.begin();
+        JsonSnapshotSink sink{json_};
+        diffStatus(sink, snapshot_status_, snapshot_status_, true);
+        if (json_.wants("progress"))
+        {
+            // As of the last poll
+            diffProgress(sink, progress_, progress_, true);
+        }
+        if (json_.wants("toolTable") && ensureToolMmap())
+        {
+            int idxmax = tooldata_last_index_get() + 1;
+            for (int i = 0; i < idxmax; ++i)
+            {
+                CANON_TOOL_TABLE tdata;
+                if (tooldata_get(&tdata, i) == IDX_OK)
+                {
+                    diffTool(sink, i, tdata, tdata, true);
+                }
+            }
+        }
+        const std::string &json = json_.finish();
+        return Napi::Buffer<char>::Copy(env, json.data(), json.size());
+    }
+
+    Napi::Value NapiStatChannel::Disconnect(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        disconnect();
+        return env.Undefined();
+    }
+
+
+
+    void NapiStatChannel::compareToolTable(NapiDeltaSink &sink, bool force)
+    {
+        // Every write to the tool mmap bumps the generation (linuxcnc-patches/0006)
+        if (!force && sameGeneration(status_, prev_status_, [](const auto &stat) { return stat.tool_table_generation; }))
+        {
+            return;
+        }
+
+        if (!ensureToolMmap())
+        {
+            // Failed to init, skip
+            return;
         }
 
         int idxmax = tooldata_last_index_get() + 1;
@@ -582,8 +822,6 @@ namespace LinuxCNC
             // but the loop below handles "diff against zero-init" naturally.
         }
 
-        char path[128];
-        
         for (int i = 0; i < idxmax; ++i)
         {
             CANON_TOOL_TABLE tdata;
@@ -593,36 +831,7 @@ namespace LinuxCNC
             }
 
             CANON_TOOL_TABLE &oldData = prev_tool_table_[i];
-
-            // Helper macros for tool table fields
-            #define TOOL_PATH(idx, name) (snprintf(path, sizeof(path), "toolTable.%d.%s", idx, name), path)
-
-            // Compare fields
-            if (force || tdata.toolno != oldData.toolno) 
-                addDelta(env, deltas, TOOL_PATH(i, "toolNo"), tdata.toolno);
-                
-            if (force || tdata.pocketno != oldData.pocketno) 
-                addDelta(env, deltas, TOOL_PATH(i, "pocketNo"), tdata.pocketno);
-                
-            if (force || tdata.diameter != oldData.diameter) 
-                addDelta(env, deltas, TOOL_PATH(i, "diameter"), tdata.diameter);
-                
-            if (force || tdata.frontangle != oldData.frontangle) 
-                addDelta(env, deltas, TOOL_PATH(i, "frontAngle"), tdata.frontangle);
-                
-            if (force || tdata.backangle != oldData.backangle) 
-                addDelta(env, deltas, TOOL_PATH(i, "backAngle"), tdata.backangle);
-                
-            if (force || tdata.orientation != oldData.orientation) 
-                addDelta(env, deltas, TOOL_PATH(i, "orientation"), tdata.orientation);
-                
-            if (force || memcmp(&tdata.offset, &oldData.offset, sizeof(EmcPose)) != 0) 
-                addDelta(env, deltas, TOOL_PATH(i, "offset"), tdata.offset);
-                
-            if (force || strcmp(tdata.comment, oldData.comment) != 0) 
-                addDelta(env, deltas, TOOL_PATH(i, "comment"), tdata.comment);
-
-            #undef TOOL_PATH
+            diffTool(sink, i, tdata, oldData, force);
 
             // Update shadow copy
             oldData = tdata;
@@ -2,6 +2,11 @@
 
 #include <napi.h>
 #include "common.hh"
+#include "shared_stat_channel.hh"
+#include "job_progress.hh"
+#include "stat_rate_limit_utils.hh"
+#include "stat_tree.hh"
+#include "stat_json_utils.hh"
 #include "rcs.hh"
 #include "emc.hh"
 #include "emc_nml.hh"
@@ -11,6 +16,31 @@
 namespace LinuxCNC
 {
 
+    // The deltas of one poll. Applies the channel's rate limits as deltas
+    // are added and returns them ordered by priority class.
+    class StatDeltaBatch
+    {
+    public:
+        StatDeltaBatch(Napi::Env env, StatRateLimiter &limiter, Napi::Object held, double now, bool force);
+
+        void add(const char *path, Napi::Value value);
+
+        // Adds the held values that are due and returns all deltas
+        Napi::Array finish();
+
+    private:
+        void push(DeltaPriority priority, const char *path, Napi::Value value);
+
+        Napi::Env env_;
+        StatRateLimiter &limiter_;
+        Napi::Object held_; // Latest value of each held path, by path
+        double now_;
+        bool force_;
+        Napi::Array classes_[DELTA_PRIORITY_COUNT];
+    };
+
+    struct NapiDeltaSink;
+
     class NapiStatChannel : public Napi::ObjectWrap<NapiStatChannel>
     {
     public:
@@ -21,7 +51,8 @@ namespace LinuxCNC
     private:
         static Napi::FunctionReference constructor;
 
-        RCS_STAT_CHANNEL *s_channel_ = nullptr;
+        NmlConnectionConfig config_;
+        std::shared_ptr<SharedStatChannel> s_channel_;
         EMC_STAT status_{};                  // Current status, directly from NML
         EMC_STAT prev_status_{};             // Previous status for delta comparison
         uint64_t cursor_{0};                 // Monotonic cursor for sync
@@ -33,37 +64,55 @@ namespace LinuxCNC
         void disconnect();
         bool pollInternal(); // Internal poll without Napi dependencies
 
-        // Note: addDelta is a free template function in stat_channel.cc
-        
-        // Compare subsystems and add deltas (force=true emits all fields regardless of comparison)
-        void compareTaskStat(Napi::Env env, Napi::Array &deltas, 
-                            const EMC_TASK_STAT &newStat, const EMC_TASK_STAT &oldStat, bool force);
-        void compareMotionStat(Napi::Env env, Napi::Array &deltas,
-                              const EMC_MOTION_STAT &newStat, const EMC_MOTION_STAT &oldStat, bool force);
-        void compareIoStat(Napi::Env env, Napi::Array &deltas,
-                          const EMC_IO_STAT &newStat, const EMC_IO_STAT &oldStat, bool force);
-        void compareTrajStat(Napi::Env env, Napi::Array &deltas, const char* prefix,
-                            const EMC_TRAJ_STAT &newStat, const EMC_TRAJ_STAT &oldStat, bool force);
-        void compareJointStat(Napi::Env env, Napi::Array &deltas, const char* prefix,
-                             const EMC_JOINT_STAT &newStat, const EMC_JOINT_STAT &oldStat, bool force);
-        void compareSpindleStat(Napi::Env env, Napi::Array &deltas, const char* prefix,
-                               const EMC_SPINDLE_STAT &newStat, const EMC_SPINDLE_STAT &oldStat, bool force);
-        void compareAxisStat(Napi::Env env, Napi::Array &deltas, const char* prefix,
-                            const EMC_AXIS_STAT &newStat, const EMC_AXIS_STAT &oldStat, bool force);
-
-        // Tool table conversion (still needed - from mmap, not EMC_STAT)
-        Napi::Array convertToolTableToNapi(Napi::Env env);
+        // The status fields are diffed by stat_diff.hh into a NapiDeltaSink,
+        // which updates tree_ and the poll's deltas
+
+        // Live stat object returned by materialize()
+        StatTree tree_;
+
+        // Job progress against the program set with setProgram()
+        JobProgressEngine progress_engine_;
+        std::string program_file_;           // Empty matches any task.file
+        JobProgress progress_{};
+        JobProgress prev_progress_{};
+        bool progress_dirty_{false};         // Program changed since the last poll
+        JobProgressInput progressInput() const;
+
+        // Tool table conversion (from mmap, not EMC_STAT), one typed array
+        // per field instead of one object per tool
+        static constexpr size_t TOOL_OFFSET_STRIDE = 9;          // x y z a b c u v w
+        static constexpr int32_t MAX_INDEXED_TOOL_NO = 1 << 20;  // Bounds indexByToolNo
+        bool ensureToolMmap();
+        Napi::Object convertToolTableToColumns(Napi::Env env);
 
         // Shadow tool table for diffing
         std::vector<CANON_TOOL_TABLE> prev_tool_table_;
         
         // Compare tool table and add deltas
-        void compareToolTable(Napi::Env env, Napi::Array &deltas, bool force);
+        void compareToolTable(NapiDeltaSink &sink, bool force);
+
+        // snapshotJSON() state, reused across calls
+        EMC_STAT snapshot_status_{};
+        StatJsonWriter json_;
+
+        // Per-path rate limits and priority classes set with setRateLimits()
+        StatRateLimiter rate_limiter_;
+        Napi::ObjectReference held_deltas_;     // Throttled values not yet emitted
+        Napi::ObjectReference released_deltas_; // Held under rules replaced since the last poll
 
         // Exposed methods
-        Napi::Value Poll(const Napi::CallbackInfo &info);               // Returns delta changes array (accepts optional force bool)
+        Napi::Value Poll(const Napi::CallbackInfo &info);               // Returns delta changes array (accepts optional force and collect bools)
+        Napi::Value Materialize(const Napi::CallbackInfo &info);        // Returns the live stat object
+        Napi::Value GetChangedBitmap(const Napi::CallbackInfo &info);   // Leaves set by the last poll
+        Napi::Value GetLeafIndex(const Napi::CallbackInfo &info);       // Bit of a path in the bitmap
+        Napi::Value GetChangedPaths(const Napi::CallbackInfo &info);    // Paths set by the last poll
         Napi::Value GetCursor(const Napi::CallbackInfo &info);          // Returns current cursor value
         Napi::Value Disconnect(const Napi::CallbackInfo &info);         // Disconnects from NML channel
+        Napi::Value SetProgram(const Napi::CallbackInfo &info);         // Loads the timing table for progress/ETA
+        Napi::Value ClearProgram(const Napi::CallbackInfo &info);       // Drops it
+        Napi::Value GetToolTable(const Napi::CallbackInfo &info);       // Columnar tool table snapshot
+        Napi::Value SetRateLimits(const Napi::CallbackInfo &info);      // Per-path max rates and priorities
+        Napi::Value SnapshotJSON(const Napi::CallbackInfo &info);       // Current status as a UTF-8 JSON Buffer
     };
 
 }
@@ -0,0 +1,448 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include "emc.hh"
+#include "emc_nml.hh"
+#include "job_progress.hh"
+
+// Field-by-field status diff, shared by every status consumer that publishes
+// path/value deltas. Each changed field is handed to a sink:
+//
+//   sink.add(const char *path, double | int | bool | const char * | const EmcPose &)
+//   sink.addAxes(const char *path, uint32_t axisMask)   // availableAxes
+//
+// With force, every field is reported regardless of the comparison.
+
+namespace LinuxCNC
+{
+
+    // Macro helpers for cleaner comparison code - force bypasses comparison
+    #define COMPARE_FIELD(field, path) \
+        if (force || newStat.field != oldStat.field) deltas.add(path, newStat.field)
+    #define COMPARE_BOOL(field, path) \
+        if (force || newStat.field != oldStat.field) deltas.add(path, (bool)newStat.field)
+    #define COMPARE_INT_CAST(field, path) \
+        if (force || (int)newStat.field != (int)oldStat.field) deltas.add(path, (int)newStat.field)
+    #define COMPARE_STRING(field, path) \
+        if (force || strcmp(newStat.field, oldStat.field) != 0) deltas.add(path, newStat.field)
+    #define COMPARE_POSE(field, path) \
+        if (force || memcmp(&newStat.field, &oldStat.field, sizeof(EmcPose)) != 0) deltas.add(path, newStat.field)
+    #define COMPARE_ARRAY(array, idx, path) \
+        if (force || newStat.array[idx] != oldStat.array[idx]) deltas.add(path, newStat.array[idx])
+    #define COMPARE_ARRAY_MEMCMP(array, base_path) \
+        do { \
+            char path[128]; \
+            for (int i = 0; i < (int)(sizeof(newStat.array)/sizeof(newStat.array[0])); ++i) { \
+                if (force || memcmp(&newStat.array[i], &oldStat.array[i], sizeof(newStat.array[0])) != 0) { \
+                    snprintf(path, sizeof(path), base_path ".%d", i); \
+                    deltas.add(path, newStat.array[i]); \
+                } \
+            } \
+        } while(0)
+    #define COMPARE_SCALAR_ARRAY(array, base_path) \
+        do { \
+            char path[128]; \
+            for (int i = 0; i < (int)(sizeof(newStat.array)/sizeof(newStat.array[0])); ++i) { \
+                if (force || newStat.array[i] != oldStat.array[i]) { \
+                    snprintf(path, sizeof(path), base_path ".%d", i); \
+                    deltas.add(path, newStat.array[i]); \
+                } \
+            } \
+        } while(0)
+
+    template <typename Sink>
+    void diffTaskStat(Sink &deltas,
+                      const EMC_TASK_STAT &newStat, const EMC_TASK_STAT &oldStat, bool force)
+    {
+        COMPARE_INT_CAST(mode, "task.mode");
+        COMPARE_INT_CAST(state, "task.state");
+        COMPARE_INT_CAST(execState, "task.execState");
+        COMPARE_INT_CAST(interpState, "task.interpState");
+        COMPARE_INT_CAST(stopState, "task.stopState");
+        COMPARE_FIELD(callLevel, "task.callLevel");
+        COMPARE_FIELD(motionLine, "task.motionLine");
+        COMPARE_FIELD(currentLine, "task.currentLine");
+        COMPARE_FIELD(readLine, "task.readLine");
+        COMPARE_BOOL(optional_stop_state, "task.optionalStopState");
+        COMPARE_BOOL(block_delete_state, "task.blockDeleteState");
+        COMPARE_BOOL(input_timeout, "task.inputTimeout");
+        COMPARE_STRING(file, "task.file");
+        COMPARE_STRING(command, "task.command");
+        COMPARE_STRING(ini_filename, "task.iniFilename");
+        COMPARE_POSE(g5x_offset, "task.g5xOffset");
+        COMPARE_FIELD(g5x_index, "task.g5xIndex");
+        COMPARE_ARRAY_MEMCMP(g5x_offsets, "task.g5xOffsets");
+        COMPARE_SCALAR_ARRAY(g5x_rotations, "task.g5xRotations");
+        COMPARE_POSE(g92_offset, "task.g92Offset");
+        COMPARE_FIELD(rotation_xy, "task.rotationXY");
+        COMPARE_POSE(g28_position, "task.g28Position");
+        COMPARE_POSE(g30_position, "task.g30Position");
+        COMPARE_POSE(toolOffset, "task.toolOffset");
+        
+        // Active G-codes
+        COMPARE_ARRAY(activeGCodes, 1, "task.activeGCodes.motionMode");
+        COMPARE_ARRAY(activeGCodes, 2, "task.activeGCodes.gMode0");
+        COMPARE_ARRAY(activeGCodes, 3, "task.activeGCodes.plane");
+        COMPARE_ARRAY(activeGCodes, 4, "task.activeGCodes.cutterComp");
+        COMPARE_ARRAY(activeGCodes, 5, "task.activeGCodes.units");
+        COMPARE_ARRAY(activeGCodes, 6, "task.activeGCodes.distanceMode");
+        COMPARE_ARRAY(activeGCodes, 7, "task.activeGCodes.feedRateMode");
+        COMPARE_ARRAY(activeGCodes, 8, "task.activeGCodes.origin");
+        COMPARE_ARRAY(activeGCodes, 9, "task.activeGCodes.toolLengthOffset");
+        COMPARE_ARRAY(activeGCodes, 10, "task.activeGCodes.retractMode");
+        COMPARE_ARRAY(activeGCodes, 11, "task.activeGCodes.pathControl");
+        COMPARE_ARRAY(activeGCodes, 13, "task.activeGCodes.spindleSpeedMode");
+        COMPARE_ARRAY(activeGCodes, 14, "task.activeGCodes.ijkDistanceMode");
+        COMPARE_ARRAY(activeGCodes, 15, "task.activeGCodes.latheDiameterMode");
+        COMPARE_ARRAY(activeGCodes, 16, "task.activeGCodes.g92Applied");
+
+        // Active M-codes
+        COMPARE_ARRAY(activeMCodes, 1, "task.activeMCodes.stopping");
+        COMPARE_ARRAY(activeMCodes, 2, "task.activeMCodes.spindleControl");
+        COMPARE_ARRAY(activeMCodes, 3, "task.activeMCodes.toolChange");
+        COMPARE_ARRAY(activeMCodes, 4, "task.activeMCodes.mistCoolant");
+        COMPARE_ARRAY(activeMCodes, 5, "task.activeMCodes.floodCoolant");
+        COMPARE_ARRAY(activeMCodes, 6, "task.activeMCodes.overrideControl");
+        COMPARE_ARRAY(activeMCodes, 7, "task.activeMCodes.adaptiveFeedControl");
+        COMPARE_ARRAY(activeMCodes, 8, "task.activeMCodes.feedHoldControl");
+
+        // Active settings
+        COMPARE_ARRAY(activeSettings, 1, "task.activeSettings.feedRate");
+        COMPARE_ARRAY(activeSettings, 2, "task.activeSettings.speed");
+        COMPARE_ARRAY(activeSettings, 3, "task.activeSettings.blendTolerance");
+        COMPARE_ARRAY(activeSettings, 4, "task.activeSettings.naiveCAMTolerance");
+
+        COMPARE_INT_CAST(programUnits, "task.programUnits");
+        COMPARE_FIELD(delayLeft, "task.delayLeft");
+        COMPARE_BOOL(task_paused, "task.taskPaused");
+        COMPARE_FIELD(interpreter_errcode, "task.interpreterErrorCode");
+        COMPARE_FIELD(queuedMDIcommands, "task.queuedMdiCommands");
+    }
+
+    template <typename Sink>
+    void diffTrajStat(Sink &deltas, const char* prefix,
+                      const EMC_TRAJ_STAT &newStat, const EMC_TRAJ_STAT &oldStat, bool force)
+    {
+        char path[128];
+        #define TRAJ_PATH(name) (snprintf(path, sizeof(path), "%s.%s", prefix, name), path)
+        
+        // Simple field comparisons
+        COMPARE_FIELD(linearUnits, TRAJ_PATH("linearUnits"));
+        COMPARE_FIELD(angularUnits, TRAJ_PATH("angularUnits"));
+        COMPARE_FIELD(cycleTime, TRAJ_PATH("cycleTime"));
+        COMPARE_FIELD(joints, TRAJ_PATH("joints"));
+        COMPARE_FIELD(spindles, TRAJ_PATH("spindles"));
+        
+        // Axis mask, reported as a list of axis letters
+        if (force || newStat.axis_mask != oldStat.axis_mask)
+            deltas.addAxes(TRAJ_PATH("availableAxes"), newStat.axis_mask);
+        
+        COMPARE_INT_CAST(mode, TRAJ_PATH("mode"));
+        COMPARE_BOOL(enabled, TRAJ_PATH("enabled"));
+        COMPARE_BOOL(inpos, TRAJ_PATH("inPosition"));
+        COMPARE_FIELD(queue, TRAJ_PATH("queue"));
+        COMPARE_FIELD(activeQueue, TRAJ_PATH("activeQueue"));
+        COMPARE_BOOL(queueFull, TRAJ_PATH("queueFull"));
+        COMPARE_FIELD(id, TRAJ_PATH("id"));
+        COMPARE_BOOL(paused, TRAJ_PATH("paused"));
+        COMPARE_BOOL(single_stepping, TRAJ_PATH("singleStepping"));
+        
+        // Fields with different path names
+        if (force || newStat.scale != oldStat.scale) deltas.add(TRAJ_PATH("feedRateOverride"), newStat.scale);
+        if (force || newStat.rapid_scale != oldStat.rapid_scale) deltas.add(TRAJ_PATH("rapidRateOverride"), newStat.rapid_scale);
+        
+        COMPARE_POSE(position, TRAJ_PATH("position"));
+        COMPARE_POSE(actualPosition, TRAJ_PATH("actualPosition"));
+        COMPARE_FIELD(acceleration, TRAJ_PATH("acceleration"));
+        COMPARE_FIELD(maxVelocity, TRAJ_PATH("maxVelocity"));
+        COMPARE_FIELD(maxAcceleration, TRAJ_PATH("maxAcceleration"));
+        COMPARE_POSE(probedPosition, TRAJ_PATH("probedPosition"));
+        COMPARE_BOOL(probe_tripped, TRAJ_PATH("probeTripped"));
+        COMPARE_BOOL(probing, TRAJ_PATH("probing"));
+        COMPARE_FIELD(probeval, TRAJ_PATH("probeVal"));
+        COMPARE_FIELD(kinematics_type, TRAJ_PATH("kinematicsType"));
+        COMPARE_FIELD(motion_type, TRAJ_PATH("motionType"));
+        COMPARE_FIELD(distance_to_go, TRAJ_PATH("distanceToGo"));
+        COMPARE_POSE(dtg, TRAJ_PATH("dtg"));
+        COMPARE_FIELD(current_vel, TRAJ_PATH("currentVelocity"));
+        COMPARE_BOOL(feed_override_enabled, TRAJ_PATH("feedOverrideEnabled"));
+        COMPARE_BOOL(adaptive_feed_enabled, TRAJ_PATH("adaptiveFeedEnabled"));
+        COMPARE_BOOL(feed_hold_enabled, TRAJ_PATH("feedHoldEnabled"));
+        
+        #undef TRAJ_PATH
+    }
+
+    template <typename Sink>
+    void diffJointStat(Sink &deltas, const char* prefix,
+                       const EMC_JOINT_STAT &newStat, const EMC_JOINT_STAT &oldStat, bool force)
+    {
+        char path[128];
+        #define JOINT_PATH(name) (snprintf(path, sizeof(path), "%s.%s", prefix, name), path)
+        
+        COMPARE_INT_CAST(jointType, JOINT_PATH("jointType"));
+        COMPARE_FIELD(units, JOINT_PATH("units"));
+        COMPARE_FIELD(backlash, JOINT_PATH("backlash"));
+        COMPARE_FIELD(minPositionLimit, JOINT_PATH("minPositionLimit"));
+        COMPARE_FIELD(maxPositionLimit, JOINT_PATH("maxPositionLimit"));
+        COMPARE_FIELD(minFerror, JOINT_PATH("minFerror"));
+        COMPARE_FIELD(maxFerror, JOINT_PATH("maxFerror"));
+        COMPARE_FIELD(ferrorCurrent, JOINT_PATH("ferrorCurrent"));
+        COMPARE_FIELD(ferrorHighMark, JOINT_PATH("ferrorHighMark"));
+        COMPARE_FIELD(output, JOINT_PATH("output"));
+        COMPARE_FIELD(input, JOINT_PATH("input"));
+        COMPARE_FIELD(velocity, JOINT_PATH("velocity"));
+        COMPARE_BOOL(inpos, JOINT_PATH("inPosition"));
+        COMPARE_BOOL(homing, JOINT_PATH("homing"));
+        COMPARE_BOOL(homed, JOINT_PATH("homed"));
+        COMPARE_BOOL(fault, JOINT_PATH("fault"));
+        COMPARE_BOOL(enabled, JOINT_PATH("enabled"));
+        COMPARE_BOOL(minSoftLimit, JOINT_PATH("minSoftLimit"));
+        COMPARE_BOOL(maxSoftLimit, JOINT_PATH("maxSoftLimit"));
+        COMPARE_BOOL(minHardLimit, JOINT_PATH("minHardLimit"));
+        COMPARE_BOOL(maxHardLimit, JOINT_PATH("maxHardLimit"));
+        COMPARE_BOOL(overrideLimits, JOINT_PATH("overrideLimits"));
+        
+        #undef JOINT_PATH
+    }
+
+    template <typename Sink>
+    void diffSpindleStat(Sink &deltas, const char* prefix,
+                         const EMC_SPINDLE_STAT &newStat, const EMC_SPINDLE_STAT &oldStat, bool force)
+    {
+        char path[128];
+        #define SPINDLE_PATH(name) (snprintf(path, sizeof(path), "%s.%s", prefix, name), path)
+        
+        COMPARE_FIELD(speed, SPINDLE_PATH("speed"));
+        COMPARE_FIELD(feedback, SPINDLE_PATH("feedback"));
+        COMPARE_FIELD(css_maximum, SPINDLE_PATH("cssMaximum"));
+        COMPARE_FIELD(css_factor, SPINDLE_PATH("cssFactor"));
+        COMPARE_FIELD(direction, SPINDLE_PATH("direction"));
+        COMPARE_FIELD(increasing, SPINDLE_PATH("increasing"));
+        COMPARE_FIELD(orient_state, SPINDLE_PATH("orientState"));
+        COMPARE_FIELD(orient_fault, SPINDLE_PATH("orientFault"));
+        COMPARE_BOOL(brake, SPINDLE_PATH("brake"));
+        COMPARE_BOOL(enabled, SPINDLE_PATH("enabled"));
+        COMPARE_BOOL(spindle_override_enabled, SPINDLE_PATH("spindleOverrideEnabled"));
+        COMPARE_BOOL(homed, SPINDLE_PATH("homed"));
+        
+        // Field with different path name
+        if (force || newStat.spindle_scale != oldStat.spindle_scale) 
+            deltas.add(SPINDLE_PATH("override"), newStat.spindle_scale);
+        
+        #undef SPINDLE_PATH
+    }
+
+    template <typename Sink>
+    void diffAxisStat(Sink &deltas, const char* prefix,
+                      const EMC_AXIS_STAT &newStat, const EMC_AXIS_STAT &oldStat, bool force)
+    {
+        char path[128];
+        #define AXIS_PATH(name) (snprintf(path, sizeof(path), "%s.%s", prefix, name), path)
+        
+        COMPARE_FIELD(minPositionLimit, AXIS_PATH("minPositionLimit"));
+        COMPARE_FIELD(maxPositionLimit, AXIS_PATH("maxPositionLimit"));
+        COMPARE_FIELD(velocity, AXIS_PATH("velocity"));
+        
+        #undef AXIS_PATH
+    }
+
+    // EMC_STAT generation counters of linuxcnc-patches/0006, detected so
+    // that the addon still builds against a LinuxCNC without them
+    template <typename Stat, typename = void>
+    struct HasStatusGenerations : std::false_type {};
+    template <typename Stat>
+    struct HasStatusGenerations<Stat, std::void_t<decltype(Stat::task_generation)>> : std::true_type {};
+
+    // Whether the generation that get reads is the same in both statuses.
+    // Always false without the counters, so every part is compared field
+    // by field as before.
+    template <typename Stat, typename Get>
+    bool sameGeneration(const Stat &newStat, const Stat &oldStat, Get get)
+    {
+        if constexpr (HasStatusGenerations<Stat>::value)
+            return get(newStat) == get(oldStat);
+        else
+            return false;
+    }
+
+    // numDIO and numAIO of linuxcnc-patches/0008. Without them every I/O
+    // slot counts as configured, and is compared as before the patch.
+    template <typename MotionStat, typename = void>
+    struct HasIOCounts : std::false_type {};
+    template <typename MotionStat>
+    struct HasIOCounts<MotionStat, std::void_t<decltype(MotionStat::numDIO)>> : std::true_type {};
+
+    template <typename MotionStat>
+    int digitalIOCount(const MotionStat &stat)
+    {
+        if constexpr (HasIOCounts<MotionStat>::value)
+            return stat.numDIO;
+        else
+            return EMCMOT_MAX_DIO;
+    }
+
+    template <typename MotionStat>
+    int analogIOCount(const MotionStat &stat)
+    {
+        if constexpr (HasIOCounts<MotionStat>::value)
+            return stat.numAIO;
+        else
+            return EMCMOT_MAX_AIO;
+    }
+
+    // Number of leading slots of a count-sized array to compare: the ones
+    // configured now or at the previous read, so that a shrinking
+    // configuration still reports the slots it gave up. Slots past the
+    // counts are not sent by a remote status writer (linuxcnc-patches/0008).
+    inline int configuredSlots(int count, int previous, int max, bool force)
+    {
+        if (force)
+            return max;
+        int slots = count > previous ? count : previous;
+        return slots < 0 ? 0 : (slots > max ? max : slots);
+    }
+
+    // Axes up to the highest one in a TRAJ axis_mask
+    inline int axisSlots(int axisMask)
+    {
+        int slots = 0;
+        for (int bit = 0; bit < EMCMOT_MAX_AXIS; ++bit)
+        {
+            if (axisMask & (1 << bit))
+                slots = bit + 1;
+        }
+        return slots;
+    }
+
+    template <typename Sink>
+    void diffMotionStat(Sink &deltas,
+                        const EMC_MOTION_STAT &newStat, const EMC_MOTION_STAT &oldStat, bool force)
+    {
+        // Trajectory
+        diffTrajStat(deltas, "motion.traj", newStat.traj, oldStat.traj, force);
+        char prefix[64];
+        
+        // Joints and spindles have their own generations, see diffStatus
+        
+        // Axes
+        int axes = configuredSlots(axisSlots(newStat.traj.axis_mask), axisSlots(oldStat.traj.axis_mask),
+                                   EMCMOT_MAX_AXIS, force);
+        for (int i = 0; i < axes; ++i) {
+            snprintf(prefix, sizeof(prefix), "motion.axis.%d", i);
+            diffAxisStat(deltas, prefix, newStat.axis[i], oldStat.axis[i], force);
+        }
+        
+        // Local macro for indexed array comparison with dynamic path
+        char path[128];
+        #define COMPARE_INDEXED_IO(array, count, base_path) \
+            for (int i = 0; i < count; ++i) { \
+                if (force || newStat.array[i] != oldStat.array[i]) { \
+                    snprintf(path, sizeof(path), base_path ".%d", i); \
+                    deltas.add(path, newStat.array[i]); \
+                } \
+            }
+        
+        int newDIO = digitalIOCount(newStat), oldDIO = digitalIOCount(oldStat);
+        int newAIO = analogIOCount(newStat), oldAIO = analogIOCount(oldStat);
+        if (force || newDIO != oldDIO)
+            deltas.add("motion.digitalIOCount", newDIO);
+        if (force || newAIO != oldAIO)
+            deltas.add("motion.analogIOCount", newAIO);
+        int dio = configuredSlots(newDIO, oldDIO, EMCMOT_MAX_DIO, force);
+        int aio = configuredSlots(newAIO, oldAIO, EMCMOT_MAX_AIO, force);
+        COMPARE_INDEXED_IO(synch_di, dio, "motion.digitalInput");
+        COMPARE_INDEXED_IO(synch_do, dio, "motion.digitalOutput");
+        COMPARE_INDEXED_IO(analog_input, aio, "motion.analogInput");
+        COMPARE_INDEXED_IO(analog_output, aio, "motion.analogOutput");
+        
+        #undef COMPARE_INDEXED_IO
+    }
+
+    template <typename Sink>
+    void diffIoStat(Sink &deltas,
+                    const EMC_IO_STAT &newStat, const EMC_IO_STAT &oldStat, bool force)
+    {
+        // Tool stat
+        if (force || newStat.tool.pocketPrepped != oldStat.tool.pocketPrepped) 
+            deltas.add("io.tool.pocketPrepped", newStat.tool.pocketPrepped);
+        if (force || newStat.tool.toolInSpindle != oldStat.tool.toolInSpindle) 
+            deltas.add("io.tool.toolInSpindle", newStat.tool.toolInSpindle);
+        if (force || newStat.tool.toolFromPocket != oldStat.tool.toolFromPocket) 
+            deltas.add("io.tool.toolFromPocket", newStat.tool.toolFromPocket);
+        
+        // Coolant stat
+        if (force || newStat.coolant.mist != oldStat.coolant.mist) 
+            deltas.add("io.coolant.mist", (bool)newStat.coolant.mist);
+        if (force || newStat.coolant.flood != oldStat.coolant.flood) 
+            deltas.add("io.coolant.flood", (bool)newStat.coolant.flood);
+        
+        // Aux stat
+        if (force || newStat.aux.estop != oldStat.aux.estop) 
+            deltas.add("io.estop", (bool)newStat.aux.estop);
+    }
+
+    template <typename Sink>
+    void diffProgress(Sink &deltas,
+                      const JobProgress &newStat, const JobProgress &oldStat, bool force)
+    {
+        COMPARE_BOOL(active, "progress.active");
+        COMPARE_FIELD(segment, "progress.segment");
+        COMPARE_FIELD(percent, "progress.percent");
+        COMPARE_FIELD(distanceDone, "progress.distanceDone");
+        COMPARE_FIELD(distanceRemaining, "progress.distanceRemaining");
+        COMPARE_FIELD(timeRemaining, "progress.timeRemaining");
+    }
+
+    // Undefine macros
+    #undef COMPARE_FIELD
+    #undef COMPARE_BOOL
+    #undef COMPARE_INT_CAST
+    #undef COMPARE_STRING
+    #undef COMPARE_POSE
+    #undef COMPARE_ARRAY
+    #undef COMPARE_ARRAY_MEMCMP
+    #undef COMPARE_SCALAR_ARRAY
+
+    template <typename Sink>
+    void diffStatus(Sink &deltas, const EMC_STAT &newStat, const EMC_STAT &oldStat, bool force)
+    {
+        if (force || newStat.echo_serial_number != oldStat.echo_serial_number)
+            deltas.add("echoSerialNumber", (int)newStat.echo_serial_number);
+        if (force || (int)newStat.status != (int)oldStat.status)
+            deltas.add("state", (int)newStat.status);
+        if (force || newStat.debug != oldStat.debug)
+            deltas.add("debug", (int)newStat.debug);
+
+        // Task bumps a subsystem's generation only when its status changed
+        // (linuxcnc-patches/0006), so an equal generation skips the whole
+        // field-by-field comparison of that subsystem
+        if (force || !sameGeneration(newStat, oldStat, [](const auto &stat) { return stat.task_generation; }))
+            diffTaskStat(deltas, newStat.task, oldStat.task, force);
+        if (force || !sameGeneration(newStat, oldStat, [](const auto &stat) { return stat.motion_generation; }))
+            diffMotionStat(deltas, newStat.motion, oldStat.motion, force);
+
+        char prefix[64];
+        int joints = configuredSlots(newStat.motion.traj.joints, oldStat.motion.traj.joints,
+                                     EMCMOT_MAX_JOINTS, force);
+        for (int i = 0; i < joints; ++i) {
+            if (!force && sameGeneration(newStat, oldStat, [i](const auto &stat) { return stat.joint_generation[i]; }))
+                continue;
+            snprintf(prefix, sizeof(prefix), "motion.joint.%d", i);
+            diffJointStat(deltas, prefix, newStat.motion.joint[i], oldStat.motion.joint[i], force);
+        }
+        int spindles = configuredSlots(newStat.motion.traj.spindles, oldStat.motion.traj.spindles,
+                                       EMCMOT_MAX_SPINDLES, force);
+        for (int i = 0; i < spindles; ++i) {
+            if (!force && sameGeneration(newStat, oldStat, [i](const auto &stat) { return stat.spindle_generation[i]; }))
+                continue;
+            snprintf(prefix, sizeof(prefix), "motion.spindle.%d", i);
+            diffSpindleStat(deltas, prefix, newStat.motion.spindle[i], oldStat.motion.spindle[i], force);
+        }
+
+        if (force || !sameGeneration(newStat, oldStat, [](const auto &stat) { return stat.io_generation; }))
+            diffIoStat(deltas, newStat.io, oldStat.io, force);
+    }
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Binary framing of stat deltas for the Unix socket publisher.
+//
+// Frame (all integers little-endian):
+//   u32 size        Bytes after this field
+//   u8  type        1 = snapshot (replaces all state), 2 = delta
+//   u8  version     STAT_FRAME_VERSION
+//   u16 reserved
+//   u32 count       Entries
+//   u64 sequence    Frame number of the publisher
+//   u64 timeNs      Unix time of the status read
+//   entries:
+//     u8 valueType, u8 pathLength, path (UTF-8), value:
+//       1 f64 | 2 i32 | 3 u8 bool | 4 u16 length + UTF-8 string
+//       5 pose: 9 x f64 (x y z a b c u v w) | 6 u8 count + (u8 length + string)...
+
+namespace LinuxCNC
+{
+    enum class StatFrameType : uint8_t
+    {
+        Snapshot = 1,
+        Delta = 2
+    };
+
+    enum class StatValueType : uint8_t
+    {
+        Double = 1,
+        Int = 2,
+        Bool = 3,
+        String = 4,
+        Pose = 5,
+        StringList = 6
+    };
+
+    constexpr uint8_t STAT_FRAME_VERSION = 1;
+    constexpr size_t STAT_FRAME_HEADER_SIZE = 28;
+
+    // Builds one frame at a time into a reusable buffer
+    class StatFrameWriter
+    {
+    public:
+        void begin(StatFrameType type, uint64_t sequence, uint64_t timeNs)
+        {
+            buffer_.assign(STAT_FRAME_HEADER_SIZE, '\0');
+            buffer_[4] = static_cast<char>(type);
+            buffer_[5] = static_cast<char>(STAT_FRAME_VERSION);
+            put64(12, sequence);
+            put64(20, timeNs);
+            count_ = 0;
+        }
+
+        void addDouble(const char *path, double value)
+        {
+            entry(StatValueType::Double, path);
+            appendDouble(value);
+        }
+
+        void addInt(const char *path, int32_t value)
+        {
+            entry(StatValueType::Int, path);
+            append32(static_cast<uint32_t>(value));
+        }
+
+        void addBool(const char *path, bool value)
+        {
+            entry(StatValueType::Bool, path);
+            buffer_.push_back(value ? 1 : 0);
+        }
+
+        void addString(const char *path, const char *value)
+        {
+            entry(StatValueType::String, path);
+            size_t length = std::min<size_t>(strlen(value), 0xffff);
+            append16(static_cast<uint16_t>(length));
+            buffer_.append(value, length);
+        }
+
+        // x y z a b c u v w
+        void addPose(const char *path, const double (&values)[9])
+        {
+            entry(StatValueType::Pose, path);
+            for (double value : values)
+                appendDouble(value);
+        }
+
+        // Axis letters of a TRAJ axis_mask, as in stat.motion.traj.availableAxes
+        void addAxes(const char *path, uint32_t axisMask)
+        {
+            static const char letters[] = "XYZABCUVW";
+            entry(StatValueType::StringList, path);
+            size_t countAt = buffer_.size();
+            buffer_.push_back(0);
+            uint8_t count = 0;
+            for (uint32_t bit = 0; bit < 9; ++bit)
+            {
+                if (axisMask & (1u << bit))
+                {
+                    buffer_.push_back(1);
+                    buffer_.push_back(letters[bit]);
+                    count++;
+                }
+            }
+            buffer_[countAt] = static_cast<char>(count);
+        }
+
+        uint32_t count() const { return count_; }
+
+        // Completes the header and returns the frame
+        const std::string &finish()
+        {
+            put32(0, static_cast<uint32_t>(buffer_.size() - 4));
+            put32(8, count_);
+            return buffer_;
+        }
+
+    private:
+        void entry(StatValueType type, const char *path)
+        {
+            size_t length = std::min<size_t>(strlen(path), 0xff);
+            buffer_.push_back(static_cast<char>(type));
+            buffer_.push_back(static_cast<char>(length));
+            buffer_.append(path, length);
+            count_++;
+        }
+
+        void append16(uint16_t value)
+        {
+            buffer_.push_back(static_cast<char>(value & 0xff));
+            buffer_.push_back(static_cast<char>(value >> 8));
+        }
+
+        void append32(uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+
+        void append64(uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+                buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+
+        void appendDouble(double value)
+        {
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            append64(bits);
+        }
+
+        void put32(size_t at, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                buffer_[at + i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+
+        void put64(size_t at, uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+                buffer_[at + i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+
+        std::string buffer_;
+        uint32_t count_ = 0;
+    };
+
+}
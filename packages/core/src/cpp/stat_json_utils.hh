@@ -0,0 +1,351 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// JSON rendering of stat snapshots.
+//
+// Values arrive as dot-separated leaf paths, like stat deltas, and are
+// nested into objects, or arrays where the next segment is numeric, the
+// same shape StatChannel builds. Paths must arrive grouped by container,
+// which the stat_diff.hh order guarantees. Poses are written as arrays of
+// 9 numbers (x y z a b c u v w); non-finite numbers as null, and invalid
+// UTF-8 in strings as U+FFFD.
+
+namespace LinuxCNC
+{
+    class StatJsonWriter
+    {
+    public:
+        // Limits the following snapshots to the given leaf or container
+        // paths, e.g. "task" or "motion.traj.position"; empty selects all
+        void select(std::vector<std::string> fields) { fields_ = std::move(fields); }
+
+        // Whether any selected field is within prefix or contains it, to
+        // skip collecting whole sections
+        bool wants(const char *prefix) const
+        {
+            if (fields_.empty())
+                return true;
+            size_t length = strlen(prefix);
+            for (const std::string &field : fields_)
+            {
+                size_t common = std::min(length, field.size());
+                if (field.compare(0, common, prefix, common) != 0)
+                    continue;
+                const char next = length > common ? prefix[common] : field.c_str()[common];
+                if (next == '\0' || next == '.')
+                    return true;
+            }
+            return false;
+        }
+
+        void begin()
+        {
+            buffer_.assign(1, '{');
+            open_.clear();
+            open_.push_back(Level{});
+        }
+
+        void addDouble(const char *path, double value)
+        {
+            if (member(path))
+                appendDouble(value);
+        }
+
+        void addInt(const char *path, int32_t value)
+        {
+            if (!member(path))
+                return;
+            char digits[16];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            buffer_.append(digits, result.ptr - digits);
+        }
+
+        void addBool(const char *path, bool value)
+        {
+            if (member(path))
+                buffer_.append(value ? "true" : "false");
+        }
+
+        void addString(const char *path, const char *value)
+        {
+            if (member(path))
+                appendString(value, strlen(value));
+        }
+
+        // x y z a b c u v w
+        void addPose(const char *path, const double (&values)[9])
+        {
+            if (!member(path))
+                return;
+            buffer_.push_back('[');
+            for (int i = 0; i < 9; ++i)
+            {
+                if (i > 0)
+                    buffer_.push_back(',');
+                appendDouble(values[i]);
+            }
+            buffer_.push_back(']');
+        }
+
+        // Axis letters of a TRAJ axis_mask, as in stat.motion.traj.availableAxes
+        void addAxes(const char *path, uint32_t axisMask)
+        {
+            static const char letters[] = "XYZABCUVW";
+            if (!member(path))
+                return;
+            buffer_.push_back('[');
+            bool first = true;
+            for (uint32_t bit = 0; bit < 9; ++bit)
+            {
+                if (axisMask & (1u << bit))
+                {
+                    if (!first)
+                        buffer_.push_back(',');
+                    appendString(&letters[bit], 1);
+                    first = false;
+                }
+            }
+            buffer_.push_back(']');
+        }
+
+        // Closes all open containers and returns the document
+        const std::string &finish()
+        {
+            while (open_.size() > 1)
+                close();
+            buffer_.push_back('}');
+            return buffer_;
+        }
+
+    private:
+        struct Level
+        {
+            std::string name;  // Path segment of this container
+            bool array = false;
+            bool empty = true;
+            uint32_t next = 0; // Next index, for arrays
+        };
+
+        struct Segment
+        {
+            const char *start;
+            size_t length;
+        };
+
+        static constexpr size_t MAX_DEPTH = 16;
+
+        static bool isIndex(const Segment &segment)
+        {
+            if (segment.length == 0)
+                return false;
+            for (size_t i = 0; i < segment.length; ++i)
+            {
+                if (segment.start[i] < '0' || segment.start[i] > '9')
+                    return false;
+            }
+            return true;
+        }
+
+        bool selected(const char *path) const
+        {
+            if (fields_.empty())
+                return true;
+            for (const std::string &field : fields_)
+            {
+                if (strncmp(path, field.c_str(), field.size()) == 0 &&
+                    (path[field.size()] == '\0' || path[field.size()] == '.'))
+                    return true;
+            }
+            return false;
+        }
+
+        // Opens and closes containers up to the parent of path and writes
+        // its key. Returns false for paths outside the selection.
+        bool member(const char *path)
+        {
+            if (!selected(path))
+                return false;
+
+            Segment segments[MAX_DEPTH];
+            size_t count = 0;
+            for (const char *start = path; count < MAX_DEPTH;)
+            {
+                const char *dot = strchr(start, '.');
+                size_t length = dot ? static_cast<size_t>(dot - start) : strlen(start);
+                segments[count++] = Segment{start, length};
+                if (!dot)
+                    break;
+                start = dot + 1;
+            }
+
+            // Keep the containers this path shares with the previous one
+            size_t depth = 0;
+            while (depth + 1 < count && depth + 1 < open_.size() &&
+                   open_[depth + 1].name.compare(0, std::string::npos,
+                                                 segments[depth].start, segments[depth].length) == 0)
+                depth++;
+            while (open_.size() > depth + 1)
+                close();
+
+            for (size_t i = depth; i + 1 < count; ++i)
+            {
+                key(segments[i]);
+                Level level;
+                level.name.assign(segments[i].start, segments[i].length);
+                level.array = isIndex(segments[i + 1]);
+                buffer_.push_back(level.array ? '[' : '{');
+                open_.push_back(std::move(level));
+            }
+            key(segments[count - 1]);
+            return true;
+        }
+
+        // Starts a member of the innermost container; array gaps become null
+        void key(const Segment &segment)
+        {
+            Level &level = open_.back();
+            if (level.array)
+            {
+                uint32_t index = 0;
+                std::from_chars(segment.start, segment.start + segment.length, index);
+                for (; level.next < index; level.next++)
+                {
+                    if (!level.empty)
+                        buffer_.push_back(',');
+                    buffer_.append("null");
+                    level.empty = false;
+                }
+                level.next = index + 1;
+                if (!level.empty)
+                    buffer_.push_back(',');
+                level.empty = false;
+                return;
+            }
+            if (!level.empty)
+                buffer_.push_back(',');
+            level.empty = false;
+            appendString(segment.start, segment.length);
+            buffer_.push_back(':');
+        }
+
+        void close()
+        {
+            buffer_.push_back(open_.back().array ? ']' : '}');
+            open_.pop_back();
+        }
+
+        void appendDouble(double value)
+        {
+            if (!std::isfinite(value))
+            {
+                buffer_.append("null");
+                return;
+            }
+            char digits[32];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            buffer_.append(digits, result.ptr - digits);
+        }
+
+        // Length of the well-formed UTF-8 sequence at s, or 0 and the length
+        // of its maximal ill-formed prefix in invalid, which is replaced by
+        // one U+FFFD as TextDecoder does
+        static size_t utf8Sequence(const unsigned char *s, size_t available, size_t &invalid)
+        {
+            size_t trailing;
+            unsigned char low = 0x80, high = 0xbf; // Range of the second byte
+            if (s[0] >= 0xc2 && s[0] <= 0xdf)
+                trailing = 1;
+            else if (s[0] >= 0xe0 && s[0] <= 0xef)
+            {
+                trailing = 2;
+                if (s[0] == 0xe0)
+                    low = 0xa0; // Overlong
+                else if (s[0] == 0xed)
+                    high = 0x9f; // Surrogates
+            }
+            else if (s[0] >= 0xf0 && s[0] <= 0xf4)
+            {
+                trailing = 3;
+                if (s[0] == 0xf0)
+                    low = 0x90; // Overlong
+                else if (s[0] == 0xf4)
+                    high = 0x8f; // Above U+10FFFF
+            }
+            else
+            {
+                invalid = 1;
+                return 0;
+            }
+
+            for (size_t i = 1; i <= trailing; ++i)
+            {
+                if (i >= available || s[i] < low || s[i] > high)
+                {
+                    invalid = i;
+                    return 0;
+                }
+                low = 0x80;
+                high = 0xbf;
+            }
+            return trailing + 1;
+        }
+
+        // JSON string of value, with invalid UTF-8 replaced by U+FFFD
+        void appendString(const char *value, size_t length)
+        {
+            static const char hex[] = "0123456789abcdef";
+            buffer_.push_back('"');
+            size_t plain = 0; // Start of the run not yet appended
+            for (size_t i = 0; i < length; ++i)
+            {
+                unsigned char c = static_cast<unsigned char>(value[i]);
+                if (c >= 0x80)
+                {
+                    // NML strings carry whatever bytes were written, e.g.
+                    // Latin-1 file names; keep the Buffer valid UTF-8
+                    size_t invalid = 0;
+                    size_t valid = utf8Sequence(reinterpret_cast<const unsigned char *>(value + i),
+                                                length - i, invalid);
+                    if (valid == 0)
+                    {
+                        buffer_.append(value + plain, i - plain);
+                        buffer_.append("\xef\xbf\xbd"); // U+FFFD
+                        plain = i + invalid;
+                    }
+                    i += (valid ? valid : invalid) - 1;
+                    continue;
+                }
+                if (c >= 0x20 && c != '"' && c != '\\')
+                    continue;
+                buffer_.append(value + plain, i - plain);
+                plain = i + 1;
+                switch (c)
+                {
+                case '"': buffer_.append("\\\""); break;
+                case '\\': buffer_.append("\\\\"); break;
+                case '\n': buffer_.append("\\n"); break;
+                case '\r': buffer_.append("\\r"); break;
+                case '\t': buffer_.append("\\t"); break;
+                default:
+                    buffer_.append("\\u00");
+                    buffer_.push_back(hex[c >> 4]);
+                    buffer_.push_back(hex[c & 0xf]);
+                }
+            }
+            buffer_.append(value + plain, length - plain);
+            buffer_.push_back('"');
+        }
+
+        std::vector<std::string> fields_;
+        std::vector<Level> open_; // open_[0] is the root object
+        std::string buffer_;
+    };
+
+}
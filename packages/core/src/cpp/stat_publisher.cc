@@ -0,0 +1,468 @@
+#include "stat_publisher.hh"
+#include "stat_diff.hh"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "timer.hh"
+
+namespace LinuxCNC
+{
+
+    Napi::FunctionReference NapiStatPublisher::constructor;
+
+    namespace
+    {
+        // Adapts a StatFrameWriter to the stat_diff.hh sink interface
+        struct FrameSink
+        {
+            StatFrameWriter &writer;
+
+            void add(const char *path, double value) { writer.addDouble(path, value); }
+            void add(const char *path, int value) { writer.addInt(path, value); }
+            void add(const char *path, bool value) { writer.addBool(path, value); }
+            void add(const char *path, const char *value) { writer.addString(path, value); }
+            void add(const char *path, const EmcPose &pose)
+            {
+                const double values[9] = {pose.tran.x, pose.tran.y, pose.tran.z,
+                                          pose.a, pose.b, pose.c, pose.u, pose.v, pose.w};
+                writer.addPose(path, values);
+            }
+            void addAxes(const char *path, uint32_t axisMask) { writer.addAxes(path, axisMask); }
+        };
+
+        uint64_t wallTimeNs()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+    }
+
+    Napi::Object NapiStatPublisher::Init(Napi::Env env, Napi::Object exports)
+    {
+        Napi::HandleScope scope(env);
+        Napi::Function func = DefineClass(env, "NativeStatPublisher", {
+                                                                          InstanceMethod("start", &NapiStatPublisher::Start),
+                                                                          InstanceMethod("stop", &NapiStatPublisher::Stop),
+                                                                          InstanceMethod("isRunning", &NapiStatPublisher::IsRunning),
+                                                                          InstanceMethod("getStats", &NapiStatPublisher::GetStats),
+                                                                      });
+
+        constructor = Napi::Persistent(func);
+        constructor.SuppressDestruct();
+        exports.Set("NativeStatPublisher", func);
+        return exports;
+    }
+
+    NapiStatPublisher::NapiStatPublisher(const Napi::CallbackInfo &info)
+        : Napi::ObjectWrap<NapiStatPublisher>(info)
+    {
+        if (info.Length() > 0 && !ParseNmlConnectionConfig(info.Env(), info[0], config_))
+        {
+            return;
+        }
+    }
+
+    NapiStatPublisher::~NapiStatPublisher()
+    {
+        stopThread();
+        stat_channel_.reset();
+    }
+
+    void NapiStatPublisher::stopThread()
+    {
+        should_stop_ = true;
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+        for (Client &client : clients_)
+        {
+            ::close(client.fd);
+        }
+        clients_.clear();
+        if (listen_fd_ >= 0)
+        {
+            ::close(listen_fd_);
+            ::unlink(path_.c_str());
+            listen_fd_ = -1;
+        }
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        client_stats_.clear();
+    }
+
+    // Binds the listening socket. A socket file left behind by a process
+    // that is gone is replaced; one that still accepts connections is not.
+    std::string NapiStatPublisher::openSocket(const std::string &path)
+    {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path))
+        {
+            return "Socket path too long: " + path;
+        }
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, path.c_str(), path.size());
+        const sockaddr *address = reinterpret_cast<const sockaddr *>(&addr);
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            return std::string("socket() failed: ") + strerror(errno);
+        }
+
+        int bound = ::bind(fd, address, sizeof(addr));
+        if (bound < 0 && errno == EADDRINUSE)
+        {
+            int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            bool live = probe >= 0 && ::connect(probe, address, sizeof(addr)) == 0;
+            if (probe >= 0)
+            {
+                ::close(probe);
+            }
+            if (live)
+            {
+                ::close(fd);
+                return "Socket already in use: " + path;
+            }
+            ::unlink(path.c_str());
+            bound = ::bind(fd, address, sizeof(addr));
+        }
+        if (bound < 0 || ::listen(fd, 16) < 0)
+        {
+            std::string error = "Cannot listen on " + path + ": " + strerror(errno);
+            ::close(fd);
+            return error;
+        }
+
+        listen_fd_ = fd;
+        path_ = path;
+        return "";
+    }
+
+    // start({ path, interval?, maxClientBuffer?, maxClients? })
+    // Restarts the publisher if it is already running.
+    Napi::Value NapiStatPublisher::Start(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsObject())
+        {
+            Napi::TypeError::New(env, "Publisher options object expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        Napi::Object options = info[0].As<Napi::Object>();
+
+        Napi::Value path = options.Get("path");
+        if (!path.IsString() || path.As<Napi::String>().Utf8Value().empty())
+        {
+            Napi::TypeError::New(env, "Socket path (string) expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        auto positive = [&](const char *key, double &out) -> bool
+        {
+            Napi::Value value = options.Get(key);
+            if (value.IsUndefined())
+                return true;
+            if (!value.IsNumber() || !(value.As<Napi::Number>().DoubleValue() > 0))
+            {
+                Napi::RangeError::New(env, std::string(key) + " must be a positive number").ThrowAsJavaScriptException();
+                return false;
+            }
+            out = value.As<Napi::Number>().DoubleValue();
+            return true;
+        };
+
+        double interval = DEFAULT_INTERVAL;
+        double maxClientBuffer = static_cast<double>(DEFAULT_MAX_CLIENT_BUFFER);
+        double maxClients = static_cast<double>(DEFAULT_MAX_CLIENTS);
+        if (!positive("interval", interval) || !positive("maxClientBuffer", maxClientBuffer) ||
+            !positive("maxClients", maxClients))
+        {
+            return env.Undefined();
+        }
+
+        stopThread();
+
+        if (!stat_channel_)
+        {
+            stat_channel_ = SharedStatChannel::Acquire(config_);
+            if (!stat_channel_)
+            {
+                Napi::Error::New(env, "Failed to connect to LinuxCNC stat channel").ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+        }
+
+        std::string error = openSocket(path.As<Napi::String>().Utf8Value());
+        if (!error.empty())
+        {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        interval_ = interval;
+        max_client_buffer_ = static_cast<size_t>(maxClientBuffer);
+        max_clients_ = static_cast<size_t>(maxClients);
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            last_error_.clear();
+        }
+
+        should_stop_ = false;
+        thread_ = std::thread(&NapiStatPublisher::PublisherThread, this);
+        return env.Undefined();
+    }
+
+    Napi::Value NapiStatPublisher::Stop(const Napi::CallbackInfo &info)
+    {
+        stopThread();
+        return info.Env().Undefined();
+    }
+
+    Napi::Value NapiStatPublisher::IsRunning(const Napi::CallbackInfo &info)
+    {
+        return Napi::Boolean::New(info.Env(), thread_.joinable() && !should_stop_);
+    }
+
+    Napi::Value NapiStatPublisher::GetStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+
+        Napi::Array clients = Napi::Array::New(env, client_stats_.size());
+        for (size_t i = 0; i < client_stats_.size(); ++i)
+        {
+            const ClientStats &stats = client_stats_[i];
+            Napi::Object client = Napi::Object::New(env);
+            client.Set("id", Napi::Number::New(env, stats.id));
+            client.Set("queued", Napi::Number::New(env, static_cast<double>(stats.queued)));
+            client.Set("framesSent", Napi::Number::New(env, static_cast<double>(stats.framesSent)));
+            client.Set("bytesSent", Napi::Number::New(env, static_cast<double>(stats.bytesSent)));
+            client.Set("resyncs", Napi::Number::New(env, stats.resyncs));
+            clients.Set(i, client);
+        }
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("running", Napi::Boolean::New(env, thread_.joinable() && !should_stop_));
+        result.Set("path", listen_fd_ >= 0 ? Napi::String::New(env, path_) : env.Null());
+        result.Set("frames", Napi::Number::New(env, static_cast<double>(frames_)));
+        result.Set("clients", clients);
+        result.Set("lastError", last_error_.empty() ? env.Null() : Napi::String::New(env, last_error_));
+        return result;
+    }
+
+    void NapiStatPublisher::PublisherThread()
+    {
+        // EMC_STAT is too large for the stack
+        std::unique_ptr<EMC_STAT> current(new EMC_STAT());
+        std::unique_ptr<EMC_STAT> previous(new EMC_STAT());
+        bool havePrevious = false;
+        double nextTick = etime();
+        std::vector<pollfd> fds;
+
+        while (!should_stop_)
+        {
+            double now = etime();
+            int timeout = std::max(0, static_cast<int>(std::ceil((nextTick - now) * 1000.0)));
+
+            fds.clear();
+            fds.push_back({listen_fd_, POLLIN, 0});
+            for (const Client &client : clients_)
+            {
+                short events = POLLIN;
+                if (client.queued > 0)
+                    events |= POLLOUT;
+                fds.push_back({client.fd, events, 0});
+            }
+
+            if (::poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR)
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                last_error_ = std::string("poll() failed: ") + strerror(errno);
+                break;
+            }
+
+            // Back to front, so closing a client keeps the others' indices
+            for (size_t i = clients_.size(); i-- > 0;)
+            {
+                Client &client = clients_[i];
+                short revents = fds[i + 1].revents;
+                bool alive = !(revents & (POLLERR | POLLNVAL));
+                if (alive && (revents & (POLLIN | POLLHUP)))
+                {
+                    // Clients do not send anything; this only detects a close
+                    char scratch[256];
+                    ssize_t n = ::recv(client.fd, scratch, sizeof(scratch), MSG_DONTWAIT);
+                    alive = n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+                }
+                if (alive && (revents & POLLOUT))
+                {
+                    alive = flush(client);
+                }
+                if (!alive)
+                {
+                    closeClient(i);
+                }
+            }
+
+            if (fds[0].revents & POLLIN)
+            {
+                for (;;)
+                {
+                    int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd < 0)
+                        break;
+                    if (clients_.size() >= max_clients_)
+                    {
+                        ::close(fd);
+                        continue;
+                    }
+                    Client client;
+                    client.fd = fd;
+                    client.id = next_client_id_++;
+                    clients_.push_back(std::move(client)); // Snapshot on the next tick
+                }
+            }
+
+            now = etime();
+            if (now >= nextTick)
+            {
+                if (stat_channel_->read(*current))
+                {
+                    publish(*current, *previous, !havePrevious);
+                    std::swap(current, previous);
+                    havePrevious = true;
+                }
+                nextTick += interval_;
+                if (nextTick < now)
+                {
+                    nextTick = now + interval_; // Fell behind; do not burst
+                }
+                updateStats();
+            }
+        }
+    }
+
+    // One tick: a delta frame shared by all clients in sync, and a snapshot
+    // for clients that are new or were dropped behind
+    void NapiStatPublisher::publish(const EMC_STAT &status, const EMC_STAT &previous, bool first)
+    {
+        uint64_t timeNs = wallTimeNs();
+        FrameSink sink{writer_};
+
+        if (!first && memcmp(&status, &previous, sizeof(EMC_STAT)) != 0)
+        {
+            writer_.begin(StatFrameType::Delta, ++sequence_, timeNs);
+            diffStatus(sink, status, previous, false);
+            if (writer_.count() > 0)
+            {
+                Frame frame = std::make_shared<const std::string>(writer_.finish());
+                for (Client &client : clients_)
+                {
+                    if (!client.needsSnapshot)
+                        enqueue(client, frame);
+                }
+                published_++;
+            }
+        }
+
+        Frame snapshot;
+        for (Client &client : clients_)
+        {
+            // Wait for a partly sent frame so the stream stays intact
+            if (!client.needsSnapshot || client.queued > 0)
+                continue;
+            if (!snapshot)
+            {
+                writer_.begin(StatFrameType::Snapshot, ++sequence_, timeNs);
+                diffStatus(sink, status, status, true);
+                snapshot = std::make_shared<const std::string>(writer_.finish());
+                published_++;
+            }
+            client.queue.push_back(snapshot);
+            client.queued += snapshot->size();
+            client.needsSnapshot = false;
+        }
+
+        for (size_t i = clients_.size(); i-- > 0;)
+        {
+            if (clients_[i].queued > 0 && !flush(clients_[i]))
+            {
+                closeClient(i);
+            }
+        }
+    }
+
+    void NapiStatPublisher::enqueue(Client &client, const Frame &frame)
+    {
+        if (client.queued + frame->size() > max_client_buffer_)
+        {
+            // Too far behind: drop the backlog, except a frame that is
+            // partly sent, and catch up with a snapshot later
+            size_t keep = client.offset > 0 ? 1 : 0;
+            while (client.queue.size() > keep)
+            {
+                client.queued -= client.queue.back()->size();
+                client.queue.pop_back();
+            }
+            client.needsSnapshot = true;
+            client.resyncs++;
+            return;
+        }
+        client.queue.push_back(frame);
+        client.queued += frame->size();
+    }
+
+    // Writes as much as the socket takes. Returns false if the client is gone.
+    bool NapiStatPublisher::flush(Client &client)
+    {
+        while (!client.queue.empty())
+        {
+            const std::string &data = *client.queue.front();
+            ssize_t n = ::send(client.fd, data.data() + client.offset, data.size() - client.offset,
+                               MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            client.offset += static_cast<size_t>(n);
+            client.queued -= static_cast<size_t>(n);
+            client.bytesSent += static_cast<uint64_t>(n);
+            if (client.offset == data.size())
+            {
+                client.queue.pop_front();
+                client.offset = 0;
+                client.framesSent++;
+            }
+        }
+        return true;
+    }
+
+    void NapiStatPublisher::closeClient(size_t index)
+    {
+        ::close(clients_[index].fd);
+        clients_.erase(clients_.begin() + index);
+    }
+
+    void NapiStatPublisher::updateStats()
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        client_stats_.clear();
+        for (const Client &client : clients_)
+        {
+            client_stats_.push_back({client.id, client.queued, client.framesSent, client.bytesSent, client.resyncs});
+        }
+        frames_ = published_;
+    }
+
+}
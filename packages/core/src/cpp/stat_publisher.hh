@@ -0,0 +1,108 @@
+#pragma once
+
+#include <napi.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common.hh"
+#include "rcs.hh"
+#include "emc.hh"
+#include "emc_nml.hh"
+#include "shared_stat_channel.hh"
+#include "stat_frame_utils.hh"
+
+namespace LinuxCNC
+{
+
+    // Serves the stat delta stream to other local processes over a Unix
+    // domain socket, so tools outside Node share this process's status
+    // reader instead of opening their own NML connections. A native thread
+    // diffs the status once per interval and queues the same frame to every
+    // client; each client starts with a snapshot, and a client that falls
+    // more than maxClientBuffer behind is dropped back to a fresh snapshot
+    // instead of slowing down the others.
+    class NapiStatPublisher : public Napi::ObjectWrap<NapiStatPublisher>
+    {
+    public:
+        static Napi::Object Init(Napi::Env env, Napi::Object exports);
+        NapiStatPublisher(const Napi::CallbackInfo &info);
+        ~NapiStatPublisher();
+
+    private:
+        static Napi::FunctionReference constructor;
+
+        using Frame = std::shared_ptr<const std::string>;
+
+        struct Client
+        {
+            int fd = -1;
+            uint32_t id = 0;
+            std::deque<Frame> queue;
+            size_t offset = 0;        // Bytes of queue.front() already sent
+            size_t queued = 0;        // Bytes not yet sent
+            bool needsSnapshot = true;
+            uint64_t framesSent = 0;
+            uint64_t bytesSent = 0;
+            uint32_t resyncs = 0;     // Times dropped back to a snapshot
+        };
+
+        struct ClientStats
+        {
+            uint32_t id;
+            size_t queued;
+            uint64_t framesSent;
+            uint64_t bytesSent;
+            uint32_t resyncs;
+        };
+
+        // Methods exposed to JavaScript
+        Napi::Value Start(const Napi::CallbackInfo &info);
+        Napi::Value Stop(const Napi::CallbackInfo &info);
+        Napi::Value IsRunning(const Napi::CallbackInfo &info);
+        Napi::Value GetStats(const Napi::CallbackInfo &info);
+
+        void stopThread();
+        std::string openSocket(const std::string &path);
+
+        // Publisher thread
+        void PublisherThread();
+        void publish(const EMC_STAT &status, const EMC_STAT &previous, bool first);
+        void enqueue(Client &client, const Frame &frame);
+        bool flush(Client &client);
+        void closeClient(size_t index);
+        void updateStats();
+
+        NmlConnectionConfig config_;
+        std::shared_ptr<SharedStatChannel> stat_channel_;
+
+        std::thread thread_;
+        std::atomic<bool> should_stop_{false};
+        int listen_fd_ = -1;
+        std::string path_;
+        double interval_ = DEFAULT_INTERVAL;
+        size_t max_client_buffer_ = DEFAULT_MAX_CLIENT_BUFFER;
+        size_t max_clients_ = DEFAULT_MAX_CLIENTS;
+
+        // Publisher thread only
+        std::vector<Client> clients_;
+        uint32_t next_client_id_ = 1;
+        uint64_t sequence_ = 0;
+        uint64_t published_ = 0;
+        StatFrameWriter writer_;
+
+        // Shared with JavaScript, guarded by stats_mutex_
+        std::mutex stats_mutex_;
+        std::vector<ClientStats> client_stats_;
+        uint64_t frames_ = 0;
+        std::string last_error_;
+
+        static constexpr double DEFAULT_INTERVAL = 0.02;                 // s
+        static constexpr size_t DEFAULT_MAX_CLIENT_BUFFER = 1 << 20;     // bytes
+        static constexpr size_t DEFAULT_MAX_CLIENTS = 32;
+    };
+
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Per-path rate limits and priority classes for stat deltas.
+
+namespace LinuxCNC
+{
+    // Order of deltas within one poll
+    enum class DeltaPriority : uint8_t
+    {
+        High = 0,
+        Normal = 1,
+        Low = 2
+    };
+    constexpr size_t DELTA_PRIORITY_COUNT = 3;
+
+    struct RateLimitRule
+    {
+        // Dot-separated stat path; "*" matches any one segment. A rule also
+        // covers everything below it, so "task.*" is all of task.
+        std::string pattern;
+        double minInterval = 0.0; // Seconds between emits of one path (0 = unthrottled)
+        DeltaPriority priority = DeltaPriority::Normal;
+    };
+
+    // Decides, per changed path, whether a delta goes out now or is held
+    // back until its path's interval has passed. Held paths are coalesced:
+    // only the fact that one is pending is kept here, the caller keeps the
+    // latest value.
+    class StatRateLimiter
+    {
+    public:
+        struct Decision
+        {
+            bool emit = true;
+            DeltaPriority priority = DeltaPriority::Normal;
+        };
+
+        // Replaces the rules and forgets all per-path state
+        void setRules(std::vector<RateLimitRule> rules)
+        {
+            rules_.clear();
+            for (RateLimitRule &rule : rules)
+            {
+                CompiledRule compiled;
+                compiled.segments = split(rule.pattern);
+                for (const std::string &segment : compiled.segments)
+                {
+                    if (segment != "*")
+                        compiled.specificity++;
+                }
+                compiled.minInterval = rule.minInterval > 0.0 ? rule.minInterval : 0.0;
+                compiled.priority = rule.priority;
+                rules_.push_back(std::move(compiled));
+            }
+            paths_.clear();
+            pending_.clear();
+        }
+
+        bool empty() const { return rules_.empty(); }
+
+        // A delta for `path` changed at time `now` (seconds, monotonic)
+        Decision offer(const char *path, double now)
+        {
+            Decision decision;
+            PathState &state = lookup(path);
+            decision.priority = state.priority;
+            if (state.minInterval <= 0.0)
+                return decision;
+
+            if (now - state.lastEmit >= state.minInterval)
+            {
+                state.lastEmit = now;
+                if (state.pending)
+                    unpend(state);
+            }
+            else
+            {
+                decision.emit = false;
+                if (!state.pending)
+                {
+                    state.pending = true;
+                    pending_.push_back(&state);
+                }
+            }
+            return decision;
+        }
+
+        // Calls fn(path, priority) for each held path whose interval has
+        // passed, and counts it as emitted now
+        template <typename Fn>
+        void takeDue(double now, Fn &&fn)
+        {
+            size_t kept = 0;
+            for (size_t i = 0; i < pending_.size(); ++i)
+            {
+                PathState *state = pending_[i];
+                if (now - state->lastEmit >= state->minInterval)
+                {
+                    state->pending = false;
+                    state->lastEmit = now;
+                    fn(*state->path, state->priority);
+                }
+                else
+                {
+                    pending_[kept++] = state;
+                }
+            }
+            pending_.resize(kept);
+        }
+
+        // Drops held paths, e.g. after a forced full poll made them current
+        void clearPending()
+        {
+            for (PathState *state : pending_)
+                state->pending = false;
+            pending_.clear();
+        }
+
+        bool hasPending() const { return !pending_.empty(); }
+
+        DeltaPriority priorityOf(const char *path) { return lookup(path).priority; }
+
+    private:
+        struct CompiledRule
+        {
+            std::vector<std::string> segments;
+            size_t specificity = 0; // Literal segments
+            double minInterval = 0.0;
+            DeltaPriority priority = DeltaPriority::Normal;
+        };
+
+        struct PathState
+        {
+            const std::string *path = nullptr; // Key in paths_
+            double minInterval = 0.0;
+            DeltaPriority priority = DeltaPriority::Normal;
+            double lastEmit = -1e300;
+            bool pending = false;
+        };
+
+        static std::vector<std::string> split(const std::string &path)
+        {
+            std::vector<std::string> segments;
+            size_t start = 0;
+            for (;;)
+            {
+                size_t dot = path.find('.', start);
+                segments.push_back(path.substr(start, dot - start));
+                if (dot == std::string::npos)
+                    break;
+                start = dot + 1;
+            }
+            return segments;
+        }
+
+        static bool matches(const CompiledRule &rule, const std::vector<std::string> &segments)
+        {
+            if (rule.segments.size() > segments.size())
+                return false;
+            for (size_t i = 0; i < rule.segments.size(); ++i)
+            {
+                if (rule.segments[i] != "*" && rule.segments[i] != segments[i])
+                    return false;
+            }
+            return true;
+        }
+
+        // The rule of a path is resolved once and cached with its state.
+        // The most specific matching rule wins, the later one on a tie.
+        PathState &lookup(const char *path)
+        {
+            auto it = paths_.find(path);
+            if (it != paths_.end())
+                return it->second;
+
+            it = paths_.emplace(path, PathState{}).first;
+            PathState &state = it->second;
+            state.path = &it->first;
+
+            std::vector<std::string> segments = split(it->first);
+            const CompiledRule *best = nullptr;
+            for (const CompiledRule &rule : rules_)
+            {
+                if (matches(rule, segments) &&
+                    (!best || rule.segments.size() > best->segments.size() ||
+                     (rule.segments.size() == best->segments.size() && rule.specificity >= best->specificity)))
+                {
+                    best = &rule;
+                }
+            }
+            if (best)
+            {
+                state.minInterval = best->minInterval;
+                state.priority = best->priority;
+            }
+            return state;
+        }
+
+        void unpend(PathState &state)
+        {
+            state.pending = false;
+            for (size_t i = 0; i < pending_.size(); ++i)
+            {
+                if (pending_[i] == &state)
+                {
+                    pending_.erase(pending_.begin() + i);
+                    break;
+                }
+            }
+        }
+
+        std::vector<CompiledRule> rules_;
+        std::unordered_map<std::string, PathState> paths_; // Node-based: states keep their address
+        std::vector<PathState *> pending_;
+    };
+
+}
@@ -0,0 +1,201 @@
+#include "stat_tree.hh"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace LinuxCNC
+{
+
+    namespace
+    {
+        bool isIndex(const char *segment, size_t length)
+        {
+            if (length == 0)
+                return false;
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (!isdigit(static_cast<unsigned char>(segment[i])))
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    void StatTree::reset(Napi::Env env)
+    {
+        containers_.clear();
+        indices_.clear();
+        leaves_.clear();
+        bitmap_.Reset();
+        bits_ = nullptr;
+        words_ = 0;
+        changed_count_ = 0;
+        root_ = Napi::Persistent(Napi::Object::New(env));
+    }
+
+    void StatTree::beginPoll()
+    {
+        if (changed_count_ > 0)
+        {
+            memset(bits_, 0, words_ * sizeof(uint32_t));
+            changed_count_ = 0;
+        }
+    }
+
+    void StatTree::set(Napi::Env env, const char *path, Napi::Value value)
+    {
+        uint32_t index = leafFor(env, path);
+        Leaf &leaf = leaves_[index];
+        Napi::Object parent = leaf.parent.Value();
+        if (leaf.element >= 0)
+            parent.Set(static_cast<uint32_t>(leaf.element), value);
+        else
+            parent.Set(leaf.key, value);
+        markChanged(index);
+    }
+
+    void StatTree::setPose(Napi::Env env, const char *path, const EmcPose &pose)
+    {
+        uint32_t index = leafFor(env, path);
+        Leaf &leaf = leaves_[index];
+        if (leaf.data == nullptr)
+        {
+            Napi::Float64Array array = Napi::Float64Array::New(env, 9);
+            Napi::Object parent = leaf.parent.Value();
+            if (leaf.element >= 0)
+                parent.Set(static_cast<uint32_t>(leaf.element), array);
+            else
+                parent.Set(leaf.key, array);
+            leaf.pose = Napi::Persistent(array);
+            leaf.data = array.Data();
+        }
+        // Same element order as EmcPoseToNapiFloat64Array
+        leaf.data[0] = pose.tran.x;
+        leaf.data[1] = pose.tran.y;
+        leaf.data[2] = pose.tran.z;
+        leaf.data[3] = pose.a;
+        leaf.data[4] = pose.b;
+        leaf.data[5] = pose.c;
+        leaf.data[6] = pose.u;
+        leaf.data[7] = pose.v;
+        leaf.data[8] = pose.w;
+        markChanged(index);
+    }
+
+    Napi::Uint32Array StatTree::changedBitmap(Napi::Env env)
+    {
+        if (bitmap_.IsEmpty())
+        {
+            reserveBits(env, leaves_.size());
+        }
+        return bitmap_.Value();
+    }
+
+    int32_t StatTree::indexOf(const std::string &path) const
+    {
+        auto it = indices_.find(path);
+        return it == indices_.end() ? -1 : static_cast<int32_t>(it->second);
+    }
+
+    Napi::Array StatTree::changedPaths(Napi::Env env) const
+    {
+        Napi::Array paths = Napi::Array::New(env);
+        uint32_t n = 0;
+        for (size_t i = 0; i < leaves_.size() && n < changed_count_; ++i)
+        {
+            if (bits_[i >> 5] & (1u << (i & 31)))
+            {
+                paths.Set(n++, Napi::String::New(env, leaves_[i].path));
+            }
+        }
+        return paths;
+    }
+
+    uint32_t StatTree::leafFor(Napi::Env env, const char *path)
+    {
+        auto it = indices_.find(path);
+        if (it != indices_.end())
+        {
+            return it->second;
+        }
+
+        Leaf leaf;
+        leaf.path = path;
+        const char *dot = strrchr(path, '.');
+        const char *segment = dot ? dot + 1 : path;
+        std::string parentPath = dot ? std::string(path, dot - path) : std::string();
+        bool element = isIndex(segment, strlen(segment));
+        if (element)
+            leaf.element = static_cast<int32_t>(strtol(segment, nullptr, 10));
+        else
+            leaf.key = segment;
+        leaf.parent = Napi::Persistent(containerFor(env, parentPath, element));
+
+        uint32_t index = static_cast<uint32_t>(leaves_.size());
+        leaves_.push_back(std::move(leaf));
+        indices_.emplace(path, index);
+        reserveBits(env, leaves_.size());
+        return index;
+    }
+
+    Napi::Object StatTree::containerFor(Napi::Env env, const std::string &path, bool array)
+    {
+        if (path.empty())
+        {
+            return root_.Value();
+        }
+        auto it = containers_.find(path);
+        if (it != containers_.end())
+        {
+            return it->second.Value();
+        }
+
+        // Arrays where the child segment is numeric, as dset would create
+        Napi::Object container = array ? Napi::Array::New(env).As<Napi::Object>() : Napi::Object::New(env);
+        size_t dot = path.rfind('.');
+        std::string segment = dot == std::string::npos ? path : path.substr(dot + 1);
+        bool element = isIndex(segment.c_str(), segment.size());
+        Napi::Object parent = containerFor(env, dot == std::string::npos ? std::string() : path.substr(0, dot), element);
+        if (element)
+            parent.Set(static_cast<uint32_t>(strtoul(segment.c_str(), nullptr, 10)), container);
+        else
+            parent.Set(segment, container);
+        containers_.emplace(path, Napi::Persistent(container));
+        return container;
+    }
+
+    void StatTree::markChanged(uint32_t index)
+    {
+        uint32_t &word = bits_[index >> 5];
+        uint32_t bit = 1u << (index & 31);
+        if (!(word & bit))
+        {
+            word |= bit;
+            changed_count_++;
+        }
+    }
+
+    void StatTree::reserveBits(Napi::Env env, size_t leaves)
+    {
+        size_t needed = (leaves + 31) / 32;
+        if (!bitmap_.IsEmpty() && needed <= words_)
+        {
+            return;
+        }
+
+        // Grow by doubling so that the array JavaScript holds stays valid
+        // across most polls that add leaves
+        size_t words = words_ > 0 ? words_ : 8;
+        while (words < needed)
+            words *= 2;
+        Napi::Uint32Array bitmap = Napi::Uint32Array::New(env, words);
+        if (bits_ != nullptr)
+        {
+            memcpy(bitmap.Data(), bits_, words_ * sizeof(uint32_t));
+        }
+        bitmap_ = Napi::Persistent(bitmap);
+        bits_ = bitmap.Data();
+        words_ = words;
+    }
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <napi.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "emc.hh"
+
+namespace LinuxCNC
+{
+
+    // The LinuxCNCStat object handed to JavaScript, owned and updated in
+    // place by the stat channel. Containers are created once, on the first
+    // poll that reaches them; later polls only overwrite leaves, and poses
+    // are Float64Arrays whose elements are rewritten without replacing the
+    // array. Every leaf gets a stable index on creation, and the leaves set
+    // by the last poll are marked in a bitmap readable from JavaScript.
+    class StatTree
+    {
+    public:
+        bool empty() const { return root_.IsEmpty(); }
+        size_t size() const { return leaves_.size(); }
+        Napi::Object root() const { return root_.Value(); }
+
+        // Drops all objects and leaf indices, starting a new root
+        void reset(Napi::Env env);
+
+        // Clears the changed bits; call at the start of each poll
+        void beginPoll();
+
+        void set(Napi::Env env, const char *path, Napi::Value value);
+        void setPose(Napi::Env env, const char *path, const EmcPose &pose);
+
+        // Whether the last poll set any leaf
+        bool changed() const { return changed_count_ > 0; }
+
+        // One bit per leaf index, bit (i & 31) of word i >> 5. The same
+        // array is returned until new leaves outgrow it.
+        Napi::Uint32Array changedBitmap(Napi::Env env);
+        // Leaf index of path, or -1 when no poll has set it yet
+        int32_t indexOf(const std::string &path) const;
+        Napi::Array changedPaths(Napi::Env env) const;
+
+    private:
+        struct Leaf
+        {
+            std::string path;
+            Napi::ObjectReference parent;
+            std::string key;            // Property name in parent, if an object
+            int32_t element = -1;       // Index in parent, if an array
+            Napi::Reference<Napi::Float64Array> pose;
+            double *data = nullptr;     // Elements of pose
+        };
+
+        uint32_t leafFor(Napi::Env env, const char *path);
+        Napi::Object containerFor(Napi::Env env, const std::string &path, bool array);
+        void markChanged(uint32_t index);
+        void reserveBits(Napi::Env env, size_t leaves);
+
+        Napi::ObjectReference root_;
+        std::unordered_map<std::string, Napi::ObjectReference> containers_; // By path
+        std::unordered_map<std::string, uint32_t> indices_;                 // Leaf index by path
+        std::vector<Leaf> leaves_;
+
+        // Changed bits, written directly into the elements of bitmap_
+        Napi::Reference<Napi::Uint32Array> bitmap_;
+        uint32_t *bits_ = nullptr;
+        size_t words_ = 0;
+        uint32_t changed_count_ = 0;
+    };
+
+}
@@ -1,4 +1,7 @@
-import { NapiCommandChannelInstance } from "./native_type_interfaces";
+import {
+  NapiCommandChannelInstance,
+  NmlConnectionOptions,
+} from "./native_type_interfaces";
 import { addon } from "./constants";
 import {
   TaskMode,
@@ -18,8 +21,8 @@ import {
 export class CommandChannel {
   private nativeInstance: NapiCommandChannelInstance;
 
-  constructor() {
-    this.nativeInstance = new addon.NativeCommandChannel();
+  constructor(options?: NmlConnectionOptions) {
+    this.nativeInstance = new addon.NativeCommandChannel(options);
   }
 
   private async exec<T extends (...args: any[]) => Promise<RcsStatus>>(
@@ -0,0 +1,110 @@
+import * as fs from "fs";
+import {
+  CommandJournalEvent,
+  CommandJournalOptions,
+  CommandJournalRecord,
+  CommandJournalStats,
+  RcsStatus,
+} from "@linuxcnc-node/types";
+import { addon } from "./constants";
+
+const MAGIC = "LCNCJRNL";
+const HEADER_SIZE = 32;
+const RECORD_SIZE = 128;
+const PAYLOAD_OFFSET = 40;
+
+export interface ReadCommandJournalOptions {
+  /**
+   * Also read the rotated files `<path>.1`, `<path>.2`, ... so the result
+   * covers everything still on disk, oldest first (default: false)
+   */
+  includeRotated?: boolean;
+}
+
+/**
+ * Starts journaling every command this process sends, from any
+ * CommandChannel or ProgramSequencer. Records are copied into a native
+ * lock-free ring on the command path and written to `options.path` by a
+ * background thread, so sending never waits on the disk. Restarting
+ * rotates the current file away.
+ */
+export function startCommandJournal(options: CommandJournalOptions): void {
+  addon.startCommandJournal(options);
+}
+
+/**
+ * Writes out the pending records and closes the journal file.
+ */
+export function stopCommandJournal(): void {
+  addon.stopCommandJournal();
+}
+
+export function getCommandJournalStats(): CommandJournalStats {
+  return addon.getCommandJournalStats();
+}
+
+/**
+ * Decodes the records of one journal file. A record cut short by a crash
+ * at the end of the file is ignored.
+ * @throws Error if the buffer is not a command journal
+ */
+export function parseCommandJournal(data: Uint8Array): CommandJournalRecord[] {
+  const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+  if (
+    data.byteLength < HEADER_SIZE ||
+    String.fromCharCode(...data.subarray(0, 8)) !== MAGIC
+  ) {
+    throw new Error("Not a command journal");
+  }
+  // Records are in the byte order of the host that wrote them
+  const littleEndian = view.getUint32(8, true) === 1;
+  if (!littleEndian && view.getUint32(8, false) !== 1) {
+    throw new Error("Unsupported command journal version");
+  }
+  if (view.getUint32(12, littleEndian) !== RECORD_SIZE) {
+    throw new Error("Unexpected command journal record size");
+  }
+
+  const count = Math.floor((data.byteLength - HEADER_SIZE) / RECORD_SIZE);
+  const records: CommandJournalRecord[] = new Array(count);
+  for (let i = 0; i < count; i++) {
+    const at = HEADER_SIZE + i * RECORD_SIZE;
+    const status = view.getInt16(at + 34, littleEndian);
+    const payloadSize = Math.min(
+      view.getUint16(at + 38, littleEndian),
+      RECORD_SIZE - PAYLOAD_OFFSET
+    );
+    records[i] = {
+      time: Number(view.getBigUint64(at, littleEndian)) / 1e6,
+      monotonic: Number(view.getBigUint64(at + 8, littleEndian)) / 1e6,
+      sequence: Number(view.getBigUint64(at + 16, littleEndian)),
+      serial: view.getInt32(at + 24, littleEndian),
+      msgType: view.getInt32(at + 28, littleEndian),
+      event: view.getUint16(at + 32, littleEndian) as CommandJournalEvent,
+      status: status < 0 ? null : (status as RcsStatus),
+      channel: view.getUint16(at + 36, littleEndian),
+      // Copied, so records do not pin the file buffer
+      payload: new Uint8Array(
+        data.subarray(at + PAYLOAD_OFFSET, at + PAYLOAD_OFFSET + payloadSize)
+      ),
+    };
+  }
+  return records;
+}
+
+/**
+ * Reads a command journal written by startCommandJournal(). Works without
+ * a running LinuxCNC, e.g. for offline audits.
+ */
+export function readCommandJournal(
+  path: string,
+  options: ReadCommandJournalOptions = {}
+): CommandJournalRecord[] {
+  const files = [path];
+  if (options.includeRotated) {
+    for (let n = 1; fs.existsSync(`${path}.${n}`); n++) {
+      files.unshift(`${path}.${n}`);
+    }
+  }
+  return files.flatMap((file) => parseCommandJournal(fs.readFileSync(file)));
+}
@@ -1,6 +1,9 @@
 import { RcsStatus } from "@linuxcnc-node/types";
 import { addon } from "../constants";
-import type { NapiCommandChannelInstance } from "../native_type_interfaces";
+import type {
+  NapiCommandChannelInstance,
+  NmlConnectionOptions,
+} from "../native_type_interfaces";
 import { StatusCoordinator } from "./statusCoordinator";
 import type {
   CommandAccepted,
@@ -28,8 +31,9 @@ export class CommandTransport {
   private readonly coordinator: StatusCoordinator;
   private disconnected = false;
 
-  constructor() {
+  constructor(options?: NmlConnectionOptions) {
     this.nativeInstance = new addon.NativeCommandChannel({
+      ...options,
       waitMode: "sent",
     });
     this.coordinator = new StatusCoordinator(this.nativeInstance);
@@ -1,11 +1,14 @@
 import { EventEmitter } from "events";
 import { addon } from "./constants";
 import { NmlMessageType, LinuxCNCError } from "@linuxcnc-node/types";
-import { NapiErrorChannelInstance } from "./native_type_interfaces";
+import {
+  NapiErrorChannelInstance,
+  NmlConnectionOptions,
+} from "./native_type_interfaces";
 
 export const DEFAULT_ERROR_POLL_INTERVAL = 100; // ms
 
-export interface ErrorChannelOptions {
+export interface ErrorChannelOptions extends NmlConnectionOptions {
   pollInterval?: number;
 }
 
@@ -26,7 +29,7 @@ export class ErrorChannel extends EventEmitter<ErrorChannelEvents> {
 
   constructor(options?: ErrorChannelOptions) {
     super();
-    this.nativeInstance = new addon.NativeErrorChannel();
+    this.nativeInstance = new addon.NativeErrorChannel(options);
     const pollInterval = options?.pollInterval ?? DEFAULT_ERROR_POLL_INTERVAL;
     this.poller = setInterval(() => this.poll(), pollInterval);
   }
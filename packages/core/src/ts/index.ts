@@ -10,8 +10,16 @@ import type {
 } from "./commandTransport";
 import { ErrorChannel, ErrorChannelOptions } from "./errorChannel";
 import { PositionLogger } from "./positionLogger";
+import { LineHeatmap } from "./lineHeatmap";
+import { ProgramSequencer } from "./programSequencer";
+import {
+  StatPublisher,
+  StatFrameReader,
+  decodeStatFrame,
+} from "./statPublisher";
 
 import { addon } from "./constants";
+import type { StatChannelPoolEntry } from "./native_type_interfaces";
 
 let nmlFilePath: string = addon.NMLFILE_DEFAULT;
 
@@ -33,12 +41,26 @@ export function getNmlFilePath(): string {
   return addon.getNmlFilePath();
 }
 
+/**
+ * Lists the native status connections open in this process, one per
+ * (nmlFile, processName, statusBuffer), with how many readers share each.
+ * For diagnostics of multi-machine setups.
+ */
+export function getStatChannelPool(): StatChannelPoolEntry[] {
+  return addon.getStatChannelPool();
+}
+
 export {
   StatChannel,
   CommandChannel,
   CommandTransport,
   ErrorChannel,
   PositionLogger,
+  LineHeatmap,
+  ProgramSequencer,
+  StatPublisher,
+  StatFrameReader,
+  decodeStatFrame,
 };
 export { StatWatcherOptions, ErrorChannelOptions };
 export type {
@@ -49,3 +71,21 @@ export type {
   NativeCommandName,
 };
 export { PositionLoggerOptions } from "./positionLogger";
+export { LineHeatmapOptions } from "./lineHeatmap";
+export {
+  ProgramSequencerOptions,
+  SequencerStartOptions,
+} from "./programSequencer";
+export { findToolRow, toolComment } from "./toolTable";
+export {
+  startCommandJournal,
+  stopCommandJournal,
+  getCommandJournalStats,
+  parseCommandJournal,
+  readCommandJournal,
+  ReadCommandJournalOptions,
+} from "./commandJournal";
+export type {
+  NmlConnectionOptions,
+  StatChannelPoolEntry,
+} from "./native_type_interfaces";
@@ -0,0 +1,77 @@
+import { LineHeatmapData } from "@linuxcnc-node/types";
+import { addon } from "./constants";
+import {
+  NapiLineHeatmapInstance,
+  NmlConnectionOptions,
+} from "./native_type_interfaces";
+
+export interface LineHeatmapOptions {
+  /**
+   * Stat paths to aggregate, as they appear in stat deltas, e.g.
+   * "motion.traj.currentVelocity", "motion.joint.0.ferrorCurrent",
+   * "motion.spindle.0.speed" or "motion.analogInput.0". HAL signals are
+   * reached by wiring them to motion.analog-in-NN / digital-in-NN.
+   */
+  channels: string[];
+  /** Sampling interval in seconds (default: 0.001) */
+  interval?: number;
+  /** Highest line number + 1 to keep (default: 1048576) */
+  maxLines?: number;
+}
+
+/**
+ * Per-line process heatmap
+ *
+ * Samples the stat channel on a native thread and, while a program runs,
+ * accumulates min/max/mean of the chosen channels plus time and dwell time
+ * per task.motionLine. Results come back as dense typed arrays indexed by
+ * line number, ready to color a G-code view or plot against the toolpath.
+ */
+export class LineHeatmap {
+  private nativeHeatmap: NapiLineHeatmapInstance;
+
+  constructor(options?: NmlConnectionOptions) {
+    this.nativeHeatmap = new addon.NativeLineHeatmap(options);
+  }
+
+  /**
+   * Start sampling. Restarting with a new channel list discards the
+   * collected data.
+   * @throws TypeError if a channel is not a sampled numeric stat path
+   */
+  start(options: LineHeatmapOptions): void {
+    this.nativeHeatmap.start(
+      options.channels,
+      options.interval ?? 0.001,
+      options.maxLines ?? 1 << 20
+    );
+  }
+
+  /**
+   * Stop sampling; collected data is kept
+   */
+  stop(): void {
+    this.nativeHeatmap.stop();
+  }
+
+  /**
+   * Discard collected data, e.g. before the next run of a program
+   */
+  clear(): void {
+    this.nativeHeatmap.clear();
+  }
+
+  /**
+   * Whether the sampling thread is running
+   */
+  isRunning(): boolean {
+    return this.nativeHeatmap.isRunning();
+  }
+
+  /**
+   * Copy out the statistics collected so far
+   */
+  getData(): LineHeatmapData {
+    return this.nativeHeatmap.getData();
+  }
+}
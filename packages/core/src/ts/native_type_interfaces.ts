@@ -1,7 +1,18 @@
 import {
+  CommandJournalOptions,
+  CommandJournalStats,
+  LineHeatmapData,
   LinuxCNCError,
+  LinuxCNCStat,
+  SequencerCycle,
+  SequencerState,
+  ProgramTimingTable,
   RcsStatus,
   StatChange,
+  StatPublisherOptions,
+  StatPublisherStats,
+  StatRateLimit,
+  ToolTableColumns,
 } from "@linuxcnc-node/types";
 import type { NativeCommandMethods } from "@linuxcnc-node/types";
 
@@ -9,12 +20,31 @@ import type { NativeCommandMethods } from "@linuxcnc-node/types";
 export interface NapiOptions {
   setNmlFilePath: (path: string) => void;
   getNmlFilePath: () => string;
-  NativeStatChannel: { new (): NapiStatChannelInstance };
+  startCommandJournal: (options: CommandJournalOptions) => void;
+  stopCommandJournal: () => void;
+  getCommandJournalStats: () => CommandJournalStats;
+  getStatChannelPool: () => StatChannelPoolEntry[];
+  NativeStatChannel: {
+    new (options?: NmlConnectionOptions): NapiStatChannelInstance;
+  };
   NativeCommandChannel: {
     new (options?: NativeCommandChannelOptions): NapiCommandChannelInstance;
   };
-  NativeErrorChannel: { new (): NapiErrorChannelInstance };
-  NativePositionLogger: { new (): NapiPositionLoggerInstance };
+  NativeErrorChannel: {
+    new (options?: NmlConnectionOptions): NapiErrorChannelInstance;
+  };
+  NativePositionLogger: {
+    new (options?: NmlConnectionOptions): NapiPositionLoggerInstance;
+  };
+  NativeProgramSequencer: {
+    new (options?: NmlConnectionOptions): NapiProgramSequencerInstance;
+  };
+  NativeLineHeatmap: {
+    new (options?: NmlConnectionOptions): NapiLineHeatmapInstance;
+  };
+  NativeStatPublisher: {
+    new (options?: NmlConnectionOptions): NapiStatPublisherInstance;
+  };
 
   // Constants (as defined in nml_addon.cc)
   NMLFILE_DEFAULT: string;
@@ -27,7 +57,41 @@ export interface NapiOptions {
   EMCMOT_MAX_MISC_ERROR: number;
 }
 
-export interface NativeCommandChannelOptions {
+/**
+ * Per-instance NML connection settings. Every channel defaults to the
+ * process-wide file set with `setNmlFilePath()` and the stock LinuxCNC
+ * buffer names, so a single process can talk to several machines by giving
+ * each channel its own `nmlFile`. Status readers for the same file and buffer
+ * share one native NML connection.
+ */
+export interface NmlConnectionOptions {
+  /** Path to the machine's .nml file (default: the process-wide NML file) */
+  nmlFile?: string;
+  /** NML process name used to connect (default: "xemc") */
+  processName?: string;
+  /** Status buffer name (default: "emcStatus") */
+  statusBuffer?: string;
+  /** Command buffer name (default: "emcCommand") */
+  commandBuffer?: string;
+  /** Error buffer name (default: "emcError") */
+  errorBuffer?: string;
+}
+
+/** One shared native status connection, see getStatChannelPool() */
+export interface StatChannelPoolEntry {
+  nmlFile: string;
+  processName: string;
+  statusBuffer: string;
+  /** Native readers sharing the connection */
+  holders: number;
+  /**
+   * Sequence of the status change notification (LinuxCNC patch 0007), or
+   * null when the connection waits by polling
+   */
+  notifySequence: number | null;
+}
+
+export interface NativeCommandChannelOptions extends NmlConnectionOptions {
   waitMode?: "sent";
 }
 
@@ -49,12 +113,26 @@ export interface StatDeltaResult {
 // Interface for the NapiStatChannel instance
 export interface NapiStatChannelInstance {
   /**
-   * Poll for changes.
+   * Poll for changes. Always updates the materialize() object.
    * @param force If true, returns all fields regardless of changes (for full sync)
+   * @param collect If false, skips building the changes array (default true)
    */
-  poll(force?: boolean): StatDeltaResult;
+  poll(force?: boolean, collect?: boolean): StatDeltaResult;
+  /** The live stat object, updated in place by poll() */
+  materialize(): LinuxCNCStat;
+  /** One bit per leaf set by the last poll, see getLeafIndex() */
+  getChangedBitmap(): Uint32Array;
+  /** Bit of a leaf path in the changed bitmap, -1 if not created yet */
+  getLeafIndex(path: string): number;
+  getChangedPaths(): string[];
+  /** Current status as UTF-8 JSON, optionally limited to some paths */
+  snapshotJSON(fields?: string[]): Buffer;
   getCursor(): number;
   disconnect(): void;
+  setProgram(file: string, table: ProgramTimingTable): void;
+  clearProgram(): void;
+  getToolTable(): ToolTableColumns;
+  setRateLimits(rules: StatRateLimit[]): void;
 }
 
 // Interface for the NapiCommandChannel instance
@@ -80,3 +158,32 @@ export interface NapiPositionLoggerInstance {
   getMotionHistory(startIndex?: number, count?: number): Float64Array;
   getHistoryCount(): number;
 }
+
+// Interface for the NapiLineHeatmap instance
+export interface NapiLineHeatmapInstance {
+  start(channels: string[], interval?: number, maxLines?: number): void;
+  stop(): void;
+  clear(): void;
+  isRunning(): boolean;
+  getData(): LineHeatmapData;
+}
+
+// Interface for the NapiStatPublisher instance
+export interface NapiStatPublisherInstance {
+  start(options: StatPublisherOptions): void;
+  stop(): void;
+  isRunning(): boolean;
+  getStats(): StatPublisherStats;
+}
+
+// Interface for the NapiProgramSequencer instance
+export interface NapiProgramSequencerInstance {
+  stage(file: string): number;
+  clearQueue(): void;
+  start(options?: { permissiveInput?: number }): void;
+  stop(): void;
+  hold(reason?: string): void;
+  release(): void;
+  poll(): SequencerState & { cycles: SequencerCycle[] };
+  disconnect(): void;
+}
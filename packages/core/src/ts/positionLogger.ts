@@ -1,4 +1,5 @@
 import { addon } from "./constants";
+import { NmlConnectionOptions } from "./native_type_interfaces";
 
 export interface PositionLoggerOptions {
   /** Logging interval in seconds (default: 0.01) */
@@ -30,8 +31,8 @@ export interface DeltaResult {
 export class PositionLogger {
   private nativeLogger: any;
 
-  constructor() {
-    this.nativeLogger = new addon.NativePositionLogger();
+  constructor(options?: NmlConnectionOptions) {
+    this.nativeLogger = new addon.NativePositionLogger(options);
   }
 
   /**
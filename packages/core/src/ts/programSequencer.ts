@@ -0,0 +1,149 @@
+import { EventEmitter } from "node:events";
+import { SequencerCycle, SequencerState } from "@linuxcnc-node/types";
+import { addon } from "./constants";
+import {
+  NapiProgramSequencerInstance,
+  NmlConnectionOptions,
+} from "./native_type_interfaces";
+
+export const DEFAULT_SEQUENCER_POLL_INTERVAL = 50; // ms
+
+export interface ProgramSequencerOptions extends NmlConnectionOptions {
+  /** How often cycle reports and state are collected, in ms (default: 50) */
+  pollInterval?: number;
+}
+
+export interface SequencerStartOptions {
+  /**
+   * Index of a motion digital input (motion.digital-in-NN) that must be high
+   * before the next program is launched, e.g. door closed or part clamped.
+   */
+  permissiveInput?: number;
+}
+
+/**
+ * Zero-gap program sequencer
+ *
+ * Runs staged programs back to back. Program end is detected and the next
+ * program is closed/opened/run by a native thread on its own command
+ * channel, so the gap between parts does not depend on the JS event loop.
+ * The interval here only affects how soon reports reach JavaScript.
+ *
+ * The next program is launched only while the machine is ON, in AUTO mode,
+ * the interpreter is idle, the permissive input (if any) is high and the
+ * sequencer is not held. A rejected, failed or aborted program holds the
+ * sequencer until release() is called.
+ *
+ * Events:
+ * - "cycle" (SequencerCycle): a program finished, with gap timing
+ * - "state" (SequencerState): phase, hold or wait reason changed
+ */
+export class ProgramSequencer extends EventEmitter {
+  private nativeInstance: NapiProgramSequencerInstance;
+  private pollInterval: number;
+  private poller: NodeJS.Timeout | null = null;
+  private state: SequencerState;
+
+  constructor(options?: ProgramSequencerOptions) {
+    super();
+    this.nativeInstance = new addon.NativeProgramSequencer(options);
+    this.pollInterval =
+      options?.pollInterval ?? DEFAULT_SEQUENCER_POLL_INTERVAL;
+    const { cycles: _cycles, ...state } = this.nativeInstance.poll();
+    this.state = state;
+  }
+
+  /**
+   * Queues a program. It is read ahead while the current program runs.
+   * @param file Program path as the task should open it.
+   * @returns Number of programs queued.
+   * @throws RangeError if the path is empty or too long for NML.
+   */
+  stage(file: string): number {
+    return this.nativeInstance.stage(file);
+  }
+
+  /**
+   * Drops all queued programs; a running program is not affected.
+   */
+  clearQueue(): void {
+    this.nativeInstance.clearQueue();
+  }
+
+  /**
+   * Starts sequencing: queued programs are run as soon as the machine allows.
+   */
+  start(options: SequencerStartOptions = {}): void {
+    this.nativeInstance.start(options);
+    if (!this.poller) {
+      this.poller = setInterval(() => this.poll(), this.pollInterval);
+    }
+    this.poll();
+  }
+
+  /**
+   * Stops sequencing. A program that is running is left to finish.
+   */
+  stop(): void {
+    this.nativeInstance.stop();
+    this.poll();
+    if (this.poller) {
+      clearInterval(this.poller);
+      this.poller = null;
+    }
+  }
+
+  /**
+   * Lets the current program finish but launches no further ones.
+   */
+  hold(reason?: string): void {
+    this.nativeInstance.hold(reason);
+    this.poll();
+  }
+
+  /**
+   * Clears a hold, including one caused by a failed or aborted program.
+   */
+  release(): void {
+    this.nativeInstance.release();
+    this.poll();
+  }
+
+  /**
+   * The last polled state.
+   */
+  getState(): SequencerState {
+    return this.state;
+  }
+
+  /**
+   * Stops sequencing and closes the native channels.
+   */
+  destroy(): void {
+    this.stop();
+    this.removeAllListeners();
+    this.nativeInstance.disconnect();
+  }
+
+  private poll(): void {
+    try {
+      const { cycles, ...state } = this.nativeInstance.poll();
+      for (const cycle of cycles) {
+        this.emit("cycle", cycle as SequencerCycle);
+      }
+      if (
+        state.phase !== this.state.phase ||
+        state.held !== this.state.held ||
+        state.holdReason !== this.state.holdReason ||
+        state.waitingFor !== this.state.waitingFor
+      ) {
+        this.state = state;
+        this.emit("state", state);
+      } else {
+        this.state = state;
+      }
+    } catch (e) {
+      console.error("Error during ProgramSequencer poll:", e);
+    }
+  }
+}
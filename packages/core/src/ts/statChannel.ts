@@ -1,31 +1,47 @@
 import { EventEmitter } from "node:events";
 import {
   NapiStatChannelInstance,
+  NmlConnectionOptions,
   StatDeltaResult,
 } from "./native_type_interfaces";
 import {
+  JobProgress,
   LinuxCNCStat,
   LinuxCNCStatPaths,
+  ProgramTimingTable,
   StatPropertyWatchCallback,
   ToolEntry,
+  ToolTableColumns,
   StatChange,
+  StatRateLimit,
 } from "@linuxcnc-node/types";
 import { addon } from "./constants";
 import delve from "dlv";
-import { dset } from "dset";
 export const DEFAULT_STAT_POLL_INTERVAL = 50; // ms
 
 // Re-export delta types for external use
 export type { StatDeltaResult } from "./native_type_interfaces";
 
-export interface StatWatcherOptions {
+export interface StatWatcherOptions extends NmlConnectionOptions {
   pollInterval?: number;
+  /** Per-path rate limits and priority classes, see setRateLimits() */
+  rateLimits?: StatRateLimit[];
 }
 
 interface WatchedProperty {
   lastValue: unknown;
 }
 
+// Watchers keep a copy: poses in the live stat are overwritten in place
+function snapshotValue(value: unknown): unknown {
+  if (ArrayBuffer.isView(value)) {
+    return (value as Float64Array).slice();
+  }
+  return typeof value === "object" && value !== null
+    ? JSON.parse(JSON.stringify(value))
+    : value;
+}
+
 export class StatChannel extends EventEmitter {
   private nativeInstance: NapiStatChannelInstance;
   private pollInterval: number;
@@ -39,15 +55,16 @@ export class StatChannel extends EventEmitter {
 
   constructor(options?: StatWatcherOptions) {
     super();
-    this.nativeInstance = new addon.NativeStatChannel();
+    this.nativeInstance = new addon.NativeStatChannel(options);
     this.pollInterval = options?.pollInterval ?? DEFAULT_STAT_POLL_INTERVAL;
-
-    // Initial full sync to populate currentStat
-    this.currentStat = {} as LinuxCNCStat;
-    const initialResult = this.nativeInstance.poll(true); // force=true gets all fields
-    for (const change of initialResult.changes) {
-      dset(this.currentStat, change.path, change.value);
+    if (options?.rateLimits) {
+      this.nativeInstance.setRateLimits(options.rateLimits);
     }
+
+    // The native layer owns currentStat and updates it in place on every
+    // poll; the initial full poll populates it
+    this.currentStat = this.nativeInstance.materialize();
+    const initialResult = this.nativeInstance.poll(true, false);
     this.cursor = initialResult.cursor;
     this.startPolling();
   }
@@ -69,15 +86,14 @@ export class StatChannel extends EventEmitter {
     this.isPolling = true;
 
     try {
-      const result = this.nativeInstance.poll();
+      // currentStat is updated either way; the changes array is only built
+      // when someone listens for it
+      const collect =
+        this.watchedProperties.size > 0 || this.listenerCount("delta") > 0;
+      const result = this.nativeInstance.poll(false, collect);
       this.cursor = result.cursor;
 
-      if (result.changes.length > 0 && this.currentStat) {
-        // Apply deltas incrementally to local state (no full stat fetch)
-        for (const change of result.changes) {
-          dset(this.currentStat, change.path, change.value);
-        }
-
+      if (result.changes.length > 0) {
         // Emit raw deltas for listeners who want the batch
         this.emit("delta", result.changes);
 
@@ -90,10 +106,7 @@ export class StatChannel extends EventEmitter {
             const oldValue = watched.lastValue;
             const newValue = change.value;
             // Update lastValue
-            watched.lastValue =
-              typeof newValue === "object" && newValue !== null
-                ? JSON.parse(JSON.stringify(newValue))
-                : newValue;
+            watched.lastValue = snapshotValue(newValue);
 
             // Emit to listeners
             const listeners = this.rawListeners(path);
@@ -131,10 +144,7 @@ export class StatChannel extends EventEmitter {
         ? delve(this.currentStat, propertyPath)
         : null;
       this.watchedProperties.set(propertyPath, {
-        lastValue:
-          typeof initialValue === "object" && initialValue !== null
-            ? JSON.parse(JSON.stringify(initialValue))
-            : initialValue,
+        lastValue: snapshotValue(initialValue),
       });
     }
   }
@@ -235,32 +245,135 @@ export class StatChannel extends EventEmitter {
   }
 
   /**
-   * Retrieves the most recent full status object.
+   * Retrieves the live status object. The native layer updates it in place
+   * on every poll: the same object, containers and pose Float64Arrays are
+   * returned for the life of the channel, so keep a reference instead of
+   * calling get() again, and copy values that must not change.
    * @returns The current LinuxCNCStat object, or null if not yet available.
    */
   get(): LinuxCNCStat | null {
     return this.currentStat;
   }
 
+  /**
+   * Whether the last poll changed a stat leaf, e.g. "motion.traj.position"
+   * or "task.motionLine". Reads the native changed-path bitmap, so it is
+   * cheap enough to call for every frame of a render loop. Only leaves are
+   * tracked, not containers like "motion.traj".
+   */
+  changed(propertyPath: LinuxCNCStatPaths): boolean {
+    const index = this.nativeInstance.getLeafIndex(propertyPath);
+    if (index < 0) return false;
+    const bitmap = this.nativeInstance.getChangedBitmap();
+    return (bitmap[index >>> 5] & (1 << (index & 31))) !== 0;
+  }
+
+  /**
+   * Lists the leaf paths changed by the last poll, including paths held
+   * back by rate limits.
+   */
+  getChangedPaths(): string[] {
+    return this.nativeInstance.getChangedPaths();
+  }
+
+  /**
+   * Serializes the current status natively into a UTF-8 JSON Buffer,
+   * ready to send from a REST or WebSocket endpoint. The status is read
+   * from NML on each call and written straight from the native structs,
+   * without touching the JavaScript stat object. The document has the
+   * shape of get(), with poses as arrays of 9 numbers and non-finite
+   * numbers as null; progress is as of the last poll.
+   *
+   * ```typescript
+   * res.setHeader("Content-Type", "application/json");
+   * res.end(stat.snapshotJSON(["task", "motion.traj.position", "io.estop"]));
+   * ```
+   *
+   * @param fields Leaf or container paths to include; all when omitted.
+   * The tool table is only read when selected.
+   * @throws TypeError if fields is not an array of strings
+   */
+  snapshotJSON(fields?: LinuxCNCStatPaths[]): Buffer {
+    return this.nativeInstance.snapshotJSON(fields);
+  }
+
   /**
    * Forces a full resync of the stat object from native.
    * Use this if cursor gaps are detected or for initial sync scenarios.
    */
   sync(): void {
-    this.currentStat = {} as LinuxCNCStat;
-    const result = this.nativeInstance.poll(true); // force=true gets all fields
-    for (const change of result.changes) {
-      dset(this.currentStat, change.path, change.value);
-    }
+    const result = this.nativeInstance.poll(true, false); // force=true sets all fields
     this.cursor = result.cursor;
     // Update all watched property lastValues
     this.watchedProperties.forEach((watched, path) => {
       watched.lastValue = this.currentStat
-        ? delve(this.currentStat, path)
+        ? snapshotValue(delve(this.currentStat, path))
         : null;
     });
   }
 
+  /**
+   * Sets the program to track job progress for. On every status update the
+   * native layer locates `task.motionLine` and `motion.traj.distanceToGo` in
+   * the table and publishes `progress.*` deltas: percent of the nominal
+   * program time, distance done and remaining, and time remaining at the
+   * current feed and rapid overrides.
+   *
+   * Progress is active while the interpreter runs `file`; pass the path the
+   * program was opened with (or "" to match any file).
+   *
+   * @param file Program path as reported in `task.file`.
+   * @param table One entry per move in program order, e.g.
+   *              `pathSampler.timingTable()` or `simulation.segments` from
+   *              @linuxcnc-node/gcode.
+   * @throws TypeError/RangeError on a malformed table.
+   */
+  setProgram(file: string, table: ProgramTimingTable): void {
+    this.nativeInstance.setProgram(file, table);
+  }
+
+  /**
+   * Stops tracking job progress; `progress.*` goes back to inactive zeros.
+   */
+  clearProgram(): void {
+    this.nativeInstance.clearProgram();
+  }
+
+  /**
+   * Reads the whole tool table in one call as typed-array columns, without
+   * building an object per tool. Use findToolRow() and toolComment() from
+   * this package to look up rows and decode comments.
+   * @returns The tool table as it is now in the tool-data memory map.
+   */
+  getToolTable(): ToolTableColumns {
+    return this.nativeInstance.getToolTable();
+  }
+
+  /**
+   * Limits how often the native layer emits deltas for some paths and
+   * orders each batch by priority class, so that fast-changing values do
+   * not swamp slow consumers while state changes still arrive on the next
+   * poll. A throttled path that changes in between is coalesced and sent
+   * with its latest value once its interval has passed. `sync()` bypasses
+   * the limits. The limits apply to deltas and watchers only; get() and
+   * the getters always read the latest values.
+   *
+   * ```typescript
+   * stat.setRateLimits([
+   *   { path: "motion.traj.position", maxRate: 30 },
+   *   { path: "motion.joint.*.velocity", maxRate: 10, priority: "low" },
+   *   { path: "task.*", priority: "high" },
+   *   { path: "io.estop", priority: "high" },
+   * ]);
+   * ```
+   *
+   * @param rules Replace the previous rules; [] removes all limits.
+   * @throws TypeError/RangeError on a malformed rule.
+   */
+  setRateLimits(rules: StatRateLimit[]): void {
+    this.nativeInstance.setRateLimits(rules);
+  }
+
   /**
    * Gets the current cursor value for sync verification.
    * The cursor increments each time the native layer detects changes.
@@ -284,7 +397,7 @@ export class StatChannel extends EventEmitter {
   }
 
   // --- Convenience Getters for common properties ---
-  // These access the locally cached `this.currentStat`
+  // These access the live `this.currentStat`
 
   get task(): LinuxCNCStat["task"] | undefined {
     return this.currentStat?.task;
@@ -298,4 +411,7 @@ export class StatChannel extends EventEmitter {
   get toolTable(): ToolEntry[] | undefined {
     return this.currentStat?.toolTable;
   }
+  get progress(): JobProgress | undefined {
+    return this.currentStat?.progress;
+  }
 }
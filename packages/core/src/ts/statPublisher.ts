@@ -0,0 +1,173 @@
+import {
+  StatFrame,
+  StatPublisherOptions,
+  StatPublisherStats,
+} from "@linuxcnc-node/types";
+import { addon } from "./constants";
+import {
+  NapiStatPublisherInstance,
+  NmlConnectionOptions,
+} from "./native_type_interfaces";
+
+const HEADER_SIZE = 28;
+const FRAME_VERSION = 1;
+const utf8 = new TextDecoder();
+
+/**
+ * Unix socket stat publisher
+ *
+ * Serves the stat delta stream of this process to any number of local
+ * subscribers (dashboards, MES agents in other languages), so that they
+ * share this process's NML status reader instead of opening their own.
+ * Each subscriber gets a snapshot frame, then delta frames. A subscriber
+ * that falls behind by more than `maxClientBuffer` bytes has its backlog
+ * dropped and gets a fresh snapshot, without slowing the others down.
+ *
+ * The frame format is documented in the package README; StatFrameReader
+ * decodes it for Node subscribers.
+ */
+export class StatPublisher {
+  private nativePublisher: NapiStatPublisherInstance;
+
+  constructor(options?: NmlConnectionOptions) {
+    this.nativePublisher = new addon.NativeStatPublisher(options);
+  }
+
+  /**
+   * Starts listening on `options.path`, restarting if already running.
+   * @throws Error if the socket cannot be created or is served by another
+   * process
+   */
+  start(options: StatPublisherOptions): void {
+    this.nativePublisher.start(options);
+  }
+
+  /**
+   * Disconnects all subscribers and removes the socket file
+   */
+  stop(): void {
+    this.nativePublisher.stop();
+  }
+
+  isRunning(): boolean {
+    return this.nativePublisher.isRunning();
+  }
+
+  getStats(): StatPublisherStats {
+    return this.nativePublisher.getStats();
+  }
+}
+
+/**
+ * Decodes one complete frame, including its 4-byte size prefix.
+ * @throws Error on an unknown frame version or value type
+ */
+export function decodeStatFrame(data: Uint8Array): StatFrame {
+  const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+  const type = view.getUint8(4);
+  if (view.getUint8(5) !== FRAME_VERSION) {
+    throw new Error(`Unsupported stat frame version ${view.getUint8(5)}`);
+  }
+  const count = view.getUint32(8, true);
+  const frame: StatFrame = {
+    type: type === 1 ? "snapshot" : "delta",
+    sequence: Number(view.getBigUint64(12, true)),
+    time: Number(view.getBigUint64(20, true)) / 1e6,
+    changes: new Array(count),
+  };
+
+  let at = HEADER_SIZE;
+  const text = (length: number): string => {
+    const value = utf8.decode(data.subarray(at, at + length));
+    at += length;
+    return value;
+  };
+
+  for (let i = 0; i < count; i++) {
+    const valueType = view.getUint8(at);
+    const pathLength = view.getUint8(at + 1);
+    at += 2;
+    const path = text(pathLength);
+    let value: unknown;
+    switch (valueType) {
+      case 1:
+        value = view.getFloat64(at, true);
+        at += 8;
+        break;
+      case 2:
+        value = view.getInt32(at, true);
+        at += 4;
+        break;
+      case 3:
+        value = view.getUint8(at) !== 0;
+        at += 1;
+        break;
+      case 4: {
+        const length = view.getUint16(at, true);
+        at += 2;
+        value = text(length);
+        break;
+      }
+      case 5: {
+        const pose = new Float64Array(9);
+        for (let j = 0; j < 9; j++) {
+          pose[j] = view.getFloat64(at + j * 8, true);
+        }
+        at += 72;
+        value = pose;
+        break;
+      }
+      case 6: {
+        const items = view.getUint8(at++);
+        const list: string[] = [];
+        for (let j = 0; j < items; j++) {
+          list.push(text(view.getUint8(at++)));
+        }
+        value = list;
+        break;
+      }
+      default:
+        throw new Error(`Unknown stat value type ${valueType} at ${path}`);
+    }
+    frame.changes[i] = { path, value };
+  }
+  return frame;
+}
+
+/**
+ * Splits a subscriber's byte stream into frames.
+ *
+ * ```typescript
+ * const reader = new StatFrameReader();
+ * net.connect("/run/linuxcnc/stat.sock").on("data", (chunk) => {
+ *   for (const frame of reader.push(chunk)) { ... }
+ * });
+ * ```
+ */
+export class StatFrameReader {
+  private pending: Uint8Array = new Uint8Array(0);
+
+  /**
+   * Adds received bytes and returns the frames they complete
+   */
+  push(chunk: Uint8Array): StatFrame[] {
+    let data = chunk;
+    if (this.pending.length > 0) {
+      data = new Uint8Array(this.pending.length + chunk.length);
+      data.set(this.pending, 0);
+      data.set(chunk, this.pending.length);
+    }
+
+    const frames: StatFrame[] = [];
+    const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+    let at = 0;
+    while (data.length - at >= 4) {
+      const end = at + 4 + view.getUint32(at, true);
+      if (end > data.length) break;
+      frames.push(decodeStatFrame(data.subarray(at, end)));
+      at = end;
+    }
+    this.pending = data.slice(at);
+    return frames;
+  }
+}
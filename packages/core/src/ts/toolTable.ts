@@ -0,0 +1,29 @@
+import { ToolTableColumns } from "@linuxcnc-node/types";
+
+const utf8 = new TextDecoder();
+
+/**
+ * Row of a tool number in a columnar tool table, or -1 if it is absent.
+ */
+export function findToolRow(table: ToolTableColumns, toolNo: number): number {
+  if (toolNo >= 0 && toolNo < table.indexByToolNo.length) {
+    return table.indexByToolNo[toolNo];
+  }
+  // Past the end of the index: only tool numbers beyond its cap land here
+  for (let row = 1; row < table.count; row++) {
+    if (table.toolNo[row] === toolNo) return row;
+  }
+  return table.count > 0 && table.toolNo[0] === toolNo ? 0 : -1;
+}
+
+/**
+ * Decodes the comment of one row of a columnar tool table.
+ */
+export function toolComment(table: ToolTableColumns, row: number): string {
+  return utf8.decode(
+    table.comments.subarray(
+      table.commentOffsets[row],
+      table.commentOffsets[row + 1]
+    )
+  );
+}
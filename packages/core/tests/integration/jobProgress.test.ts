@@ -0,0 +1,157 @@
+/**
+ * Integration tests for job progress
+ *
+ * Runs a program with a known timing table on the sim and checks the
+ * progress the native layer computes from task.motionLine and
+ * motion.traj.distanceToGo.
+ */
+
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+import { CommandChannel, StatChannel } from "../../src/ts";
+import { InterpState, TaskMode } from "@linuxcnc-node/types";
+import { startLinuxCNC, stopLinuxCNC, setupLinuxCNC } from "./setupLinuxCNC";
+
+const delay = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+// Line numbers are the file lines of PROGRAM
+const PROGRAM = [
+  "G21 G90 G17",
+  "G0 X0 Y0 Z0",
+  "G1 X50 F600",
+  "G1 Y25",
+  "G4 P1",
+  "G0 X0 Y0",
+  "M2",
+].join("\n");
+
+const DIAGONAL = Math.hypot(50, 25);
+
+// The lengths are exact, the durations nominal: 50 mm and 25 mm at
+// 600 mm/min, a 1 s dwell and a rapid back to the origin
+const TABLE = {
+  lineNumber: Int32Array.from([2, 3, 4, 5, 6]),
+  length: Float64Array.from([0, 50, 25, 0, DIAGONAL]),
+  duration: Float64Array.from([0, 5, 2.5, 1, 0.5]),
+  rapid: Uint8Array.from([1, 0, 0, 0, 1]),
+};
+const TOTAL_LENGTH = 75 + DIAGONAL;
+const TOTAL_TIME = 9;
+
+async function waitFor(
+  condition: () => boolean,
+  timeout: number,
+  what: string
+): Promise<void> {
+  const startTime = Date.now();
+  while (Date.now() - startTime < timeout) {
+    if (condition()) return;
+    await delay(20);
+  }
+  throw new Error(`Timeout waiting for ${what}`);
+}
+
+describe("Integration: job progress", () => {
+  let commandChannel: CommandChannel;
+  let statChannel: StatChannel;
+  let tmpDir: string;
+  let programFile: string;
+
+  beforeAll(async () => {
+    await startLinuxCNC();
+    commandChannel = new CommandChannel();
+    statChannel = new StatChannel();
+    await setupLinuxCNC(commandChannel, statChannel);
+
+    tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), "job-progress-"));
+    programFile = path.join(tmpDir, "progress.ngc");
+    fs.writeFileSync(programFile, PROGRAM + "\n");
+
+    await commandChannel.setTaskMode(TaskMode.AUTO);
+    await commandChannel.programOpen(programFile);
+    statChannel.setProgram(programFile, TABLE);
+    await delay(200);
+  }, 30000);
+
+  afterAll(async () => {
+    statChannel.clearProgram();
+    statChannel.destroy();
+    commandChannel.destroy();
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    await stopLinuxCNC();
+  });
+
+  it("should report the whole program as remaining before the run", () => {
+    const progress = statChannel.progress!;
+    expect(progress.active).toBe(false);
+    expect(progress.distanceRemaining).toBeCloseTo(TOTAL_LENGTH, 6);
+    expect(progress.timeRemaining).toBeCloseTo(TOTAL_TIME, 6);
+  });
+
+  it("should locate a paused move and scale the ETA by the overrides", async () => {
+    await commandChannel.runProgram();
+    await waitFor(
+      () => statChannel.task?.motionLine === 3,
+      5000,
+      "the first feed move"
+    );
+    await delay(1000);
+    await commandChannel.pauseProgram();
+    await waitFor(
+      () => statChannel.motion!.traj.currentVelocity === 0,
+      2000,
+      "the pause"
+    );
+    await delay(200);
+
+    const progress = statChannel.progress!;
+    const traj = statChannel.motion!.traj;
+    // distanceToGo is in machine units; linearUnits is machine units per mm
+    const toGo = traj.distanceToGo / traj.linearUnits;
+    expect(progress.active).toBe(true);
+    expect(progress.segment).toBe(1);
+    expect(toGo).toBeGreaterThan(0);
+    expect(toGo).toBeLessThan(50);
+    expect(progress.distanceRemaining).toBeCloseTo(25 + DIAGONAL + toGo, 3);
+    expect(progress.distanceDone + progress.distanceRemaining).toBeCloseTo(
+      TOTAL_LENGTH,
+      6
+    );
+
+    // 0.5 s of rapid left; the rest is feed time
+    const feedLeft = progress.timeRemaining - 0.5;
+    expect(feedLeft).toBeCloseTo(3.5 + (5 * toGo) / 50, 3);
+    expect(progress.percent).toBeCloseTo(
+      100 * (1 - progress.timeRemaining / TOTAL_TIME),
+      6
+    );
+
+    await commandChannel.setFeedRate(0.5);
+    await delay(200);
+    const slower = statChannel.progress!;
+    expect(slower.timeRemaining).toBeCloseTo(feedLeft / 0.5 + 0.5, 3);
+    // Percent is of the nominal time, so the override leaves it alone
+    expect(slower.percent).toBeCloseTo(progress.percent, 6);
+
+    await commandChannel.setFeedRate(1.0);
+    await commandChannel.resumeProgram();
+  }, 20000);
+
+  it("should read 100% once the program has finished", async () => {
+    await waitFor(
+      () => statChannel.task?.interpState === InterpState.IDLE,
+      15000,
+      "the end of the program"
+    );
+    await delay(200);
+
+    const progress = statChannel.progress!;
+    expect(progress.active).toBe(false);
+    expect(progress.segment).toBe(4);
+    expect(progress.percent).toBeCloseTo(100, 6);
+    expect(progress.distanceDone).toBeCloseTo(TOTAL_LENGTH, 6);
+    expect(progress.distanceRemaining).toBeCloseTo(0, 6);
+    expect(progress.timeRemaining).toBeCloseTo(0, 6);
+  }, 20000);
+});
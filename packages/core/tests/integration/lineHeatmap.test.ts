@@ -0,0 +1,118 @@
+/**
+ * Integration tests for LineHeatmap
+ *
+ * Runs a short program on the sim and checks what lands in each line's bin.
+ */
+
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+import { CommandChannel, LineHeatmap, StatChannel } from "../../src/ts";
+import { InterpState, TaskMode } from "@linuxcnc-node/types";
+import { startLinuxCNC, stopLinuxCNC, setupLinuxCNC } from "./setupLinuxCNC";
+
+const delay = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+// Line 2 feeds 25 mm at 600 mm/min (2.5 s), line 3 dwells for 1 s
+const PROGRAM = ["G21 G90 G17", "G1 X25 F600", "G4 P1", "G0 X0", "M2"].join(
+  "\n"
+);
+const FEED = 10 / 25.4; // 600 mm/min in inch/s, the sim's machine units
+
+describe("Integration: LineHeatmap", () => {
+  let commandChannel: CommandChannel;
+  let statChannel: StatChannel;
+  let tmpDir: string;
+  let programFile: string;
+
+  async function runProgram(): Promise<number> {
+    const started = Date.now();
+    await commandChannel.runProgram();
+    await delay(200);
+    while (statChannel.task?.interpState !== InterpState.IDLE) {
+      if (Date.now() - started > 15000) {
+        throw new Error("Timeout waiting for the end of the program");
+      }
+      await delay(20);
+    }
+    return (Date.now() - started) / 1000;
+  }
+
+  beforeAll(async () => {
+    await startLinuxCNC();
+    commandChannel = new CommandChannel();
+    statChannel = new StatChannel();
+    await setupLinuxCNC(commandChannel, statChannel);
+
+    tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), "line-heatmap-"));
+    programFile = path.join(tmpDir, "heatmap.ngc");
+    fs.writeFileSync(programFile, PROGRAM + "\n");
+
+    await commandChannel.setTaskMode(TaskMode.AUTO);
+    await commandChannel.programOpen(programFile);
+    await delay(200);
+  }, 30000);
+
+  afterAll(async () => {
+    statChannel.destroy();
+    commandChannel.destroy();
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    await stopLinuxCNC();
+  });
+
+  it("should bin time, dwell and channel values by line", async () => {
+    const heatmap = new LineHeatmap();
+    heatmap.start({ channels: ["motion.traj.currentVelocity"] });
+    const elapsed = await runProgram();
+    heatmap.stop();
+
+    const data = heatmap.getData();
+    expect(data.lineCount).toBeGreaterThanOrEqual(4);
+    expect(data.lineCount).toBeLessThanOrEqual(6);
+    expect(data.dropped).toBe(0);
+
+    // Every sample while the program ran lands in some line's bin
+    const binned = data.time.reduce((sum, seconds) => sum + seconds, 0);
+    expect(binned).toBeLessThanOrEqual(elapsed + 0.1);
+    expect(binned).toBeGreaterThan(3.5);
+
+    expect(data.samples[2]).toBeGreaterThan(0);
+    expect(data.time[2]).toBeGreaterThan(2.2);
+    expect(data.time[2]).toBeLessThan(3.0);
+    expect(data.dwellTime[2]).toBe(0);
+
+    expect(data.time[3]).toBeGreaterThan(0.8);
+    expect(data.time[3]).toBeLessThan(1.3);
+    expect(data.dwellTime[3]).toBeGreaterThan(0.8);
+    expect(data.dwellTime[3]).toBeLessThanOrEqual(data.time[3]);
+
+    const velocity = data.channels["motion.traj.currentVelocity"];
+    expect(velocity.max[2]).toBeCloseTo(FEED, 3);
+    expect(velocity.mean[2]).toBeGreaterThan(0.8 * FEED);
+    expect(velocity.mean[2]).toBeLessThanOrEqual(FEED + 1e-6);
+    expect(velocity.min[3]).toBeCloseTo(0, 3);
+    // Lines the program never reached are empty
+    expect(Number.isNaN(velocity.mean[1])).toBe(data.samples[1] === 0);
+  }, 30000);
+
+  it("should drop samples past maxLines and clear the bins", async () => {
+    const heatmap = new LineHeatmap();
+    heatmap.start({
+      channels: ["motion.traj.currentVelocity"],
+      maxLines: 3,
+    });
+    await runProgram();
+    heatmap.stop();
+
+    const data = heatmap.getData();
+    expect(data.lineCount).toBeLessThanOrEqual(3);
+    expect(data.time[2]).toBeGreaterThan(2.2);
+    // The dwell and the rapid are on lines 3 and 4
+    expect(data.dropped).toBeGreaterThan(0);
+
+    heatmap.clear();
+    const cleared = heatmap.getData();
+    expect(cleared.lineCount).toBe(0);
+    expect(cleared.dropped).toBe(0);
+  }, 30000);
+});
@@ -0,0 +1,96 @@
+/**
+ * Integration tests for reading the status over TCP (LinuxCNC patch 0008)
+ *
+ * Patch 0008 changes how EMC_MOTION_STAT is encoded for NML's TCP server, so
+ * a remote reader must decode the same values the local shared memory holds.
+ * The test connects a second reader through a copy of the sim's NML file in
+ * which xemc reads emcStatus REMOTE, via linuxcncsvr's TCP port.
+ */
+
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+import {
+  CommandChannel,
+  StatChannel,
+  getNmlFilePath,
+} from "../../src/ts";
+import { startLinuxCNC, stopLinuxCNC, setupLinuxCNC } from "./setupLinuxCNC";
+
+const delay = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+/** Copy the NML file with xemc reading the status buffer over TCP */
+function writeRemoteNmlFile(dir: string): string {
+  const lines = fs.readFileSync(getNmlFilePath(), "utf8").split("\n");
+  const buffer = lines.find((line) => /^B\s+emcStatus\s/.test(line));
+  expect(buffer).toMatch(/TCP=\d+/);
+
+  const remote = lines.map((line) =>
+    /^P\s+xemc\s+emcStatus\s/.test(line)
+      ? line.replace(/\bLOCAL\b/, "REMOTE")
+      : line
+  );
+  const file = path.join(dir, "remote.nml");
+  fs.writeFileSync(file, remote.join("\n"));
+  return file;
+}
+
+describe("Integration: remote status", () => {
+  let commandChannel: CommandChannel;
+  let localChannel: StatChannel;
+  let remoteChannel: StatChannel;
+  let tmpDir: string;
+
+  beforeAll(async () => {
+    await startLinuxCNC();
+    commandChannel = new CommandChannel();
+    localChannel = new StatChannel();
+    await setupLinuxCNC(commandChannel, localChannel);
+
+    tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), "remote-nml-"));
+    remoteChannel = new StatChannel({ nmlFile: writeRemoteNmlFile(tmpDir) });
+  }, 30000);
+
+  afterAll(async () => {
+    remoteChannel?.destroy();
+    localChannel.destroy();
+    commandChannel.destroy();
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    await stopLinuxCNC();
+  });
+
+  it("should decode the motion status the local reader sees", async () => {
+    // Let both readers pick up the settled machine
+    await delay(1000);
+    const local = localChannel.get()!.motion;
+    const remote = remoteChannel.get()!.motion;
+
+    expect(remote.traj.joints).toBe(local.traj.joints);
+    expect(remote.digitalIOCount).toBe(local.digitalIOCount);
+    expect(remote.analogIOCount).toBe(local.analogIOCount);
+
+    for (let i = 0; i < local.traj.joints; i++) {
+      expect(remote.joint[i].homed).toBe(local.joint[i].homed);
+      expect(remote.joint[i].minPositionLimit).toBe(
+        local.joint[i].minPositionLimit
+      );
+      expect(remote.joint[i].maxPositionLimit).toBe(
+        local.joint[i].maxPositionLimit
+      );
+    }
+    for (let i = local.traj.joints; i < remote.joint.length; i++) {
+      expect(remote.joint[i].homed).toBe(false);
+    }
+    expect(remote.digitalInput.slice(0, local.digitalIOCount)).toEqual(
+      local.digitalInput.slice(0, local.digitalIOCount)
+    );
+  }, 10000);
+
+  it("should follow a status change over TCP", async () => {
+    await commandChannel.setFeedRate(0.5);
+    await delay(500);
+    expect(remoteChannel.get()?.motion.traj.feedRateOverride).toBe(0.5);
+
+    await commandChannel.setFeedRate(1.0);
+  }, 10000);
+});
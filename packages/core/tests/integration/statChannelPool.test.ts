@@ -0,0 +1,65 @@
+/**
+ * Integration tests for the shared native status connections
+ *
+ * Channels with the same NML file and buffer share one connection; a
+ * different file (here a symlink to the same machine) gets its own.
+ */
+
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+import {
+  StatChannel,
+  getNmlFilePath,
+  getStatChannelPool,
+} from "../../src/ts";
+import { startLinuxCNC, stopLinuxCNC } from "./setupLinuxCNC";
+
+describe("Integration: StatChannel pool", () => {
+  let linkDir: string;
+  let linkedNmlFile: string;
+
+  beforeAll(async () => {
+    await startLinuxCNC();
+
+    linkDir = fs.mkdtempSync(path.join(os.tmpdir(), "stat-pool-"));
+    linkedNmlFile = path.join(linkDir, "machine-b.nml");
+    fs.symlinkSync(getNmlFilePath(), linkedNmlFile);
+  }, 30000);
+
+  afterAll(async () => {
+    fs.rmSync(linkDir, { recursive: true, force: true });
+    await stopLinuxCNC();
+  });
+
+  const entryFor = (nmlFile: string) =>
+    getStatChannelPool().find((entry) => entry.nmlFile === nmlFile);
+
+  it("should share one connection per key and open one per other key", () => {
+    const defaultFile = getNmlFilePath();
+    const before = entryFor(defaultFile)?.holders ?? 0;
+
+    const first = new StatChannel();
+    const second = new StatChannel({ nmlFile: defaultFile });
+    const other = new StatChannel({ nmlFile: linkedNmlFile });
+
+    const shared = entryFor(defaultFile);
+    const separate = entryFor(linkedNmlFile);
+    expect(shared?.holders).toBe(before + 2);
+    expect(shared?.statusBuffer).toBe("emcStatus");
+    expect(separate?.holders).toBe(1);
+    expect(
+      getStatChannelPool().filter(
+        (entry) =>
+          entry.nmlFile === defaultFile || entry.nmlFile === linkedNmlFile
+      )
+    ).toHaveLength(2);
+
+    other.destroy();
+    expect(entryFor(linkedNmlFile)).toBeUndefined();
+
+    first.destroy();
+    second.destroy();
+    expect(entryFor(defaultFile)?.holders ?? 0).toBe(before);
+  });
+});
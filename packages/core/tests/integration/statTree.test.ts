@@ -0,0 +1,100 @@
+/**
+ * Integration tests for the native stat tree
+ *
+ * The object returned by StatChannel.get() is owned by the native layer and
+ * updated in place: containers and pose arrays keep their identity across
+ * polls, and only the leaves are rewritten.
+ */
+
+import { CommandChannel, StatChannel } from "../../src/ts";
+import { TaskMode } from "@linuxcnc-node/types";
+import { startLinuxCNC, stopLinuxCNC, setupLinuxCNC } from "./setupLinuxCNC";
+
+const delay = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+describe("Integration: stat tree", () => {
+  let commandChannel: CommandChannel;
+  let statChannel: StatChannel;
+
+  beforeAll(async () => {
+    await startLinuxCNC();
+    commandChannel = new CommandChannel();
+    statChannel = new StatChannel();
+    await setupLinuxCNC(commandChannel, statChannel);
+  }, 30000);
+
+  afterAll(async () => {
+    statChannel.destroy();
+    commandChannel.destroy();
+    await stopLinuxCNC();
+  });
+
+  it("should update leaves without replacing their containers", async () => {
+    const stat = statChannel.get()!;
+    const traj = stat.motion.traj;
+    const joints = stat.motion.joint;
+    const joint0 = joints[0];
+
+    await commandChannel.setFeedRate(0.5);
+    await delay(200);
+
+    expect(statChannel.get()).toBe(stat);
+    expect(stat.motion.traj).toBe(traj);
+    expect(stat.motion.joint).toBe(joints);
+    expect(stat.motion.joint[0]).toBe(joint0);
+    expect(traj.feedRateOverride).toBe(0.5);
+
+    await commandChannel.setFeedRate(1.0);
+    await delay(200);
+    expect(traj.feedRateOverride).toBe(1.0);
+  }, 10000);
+
+  it("should rewrite pose elements in the same array", async () => {
+    const stat = statChannel.get()!;
+    const position = stat.motion.traj.position;
+    const startX = position[0];
+
+    await commandChannel.setTaskMode(TaskMode.MDI);
+    await commandChannel.mdi(`G91 G0 X0.5`);
+    await delay(100);
+    while (!stat.motion.traj.inPosition) {
+      await delay(50);
+    }
+    await delay(100);
+
+    expect(stat.motion.traj.position).toBe(position);
+    expect(position[0]).toBeCloseTo(startX + 0.5, 6);
+
+    await commandChannel.mdi(`G0 X${startX} G90`);
+    await delay(100);
+    while (!stat.motion.traj.inPosition) {
+      await delay(50);
+    }
+  }, 15000);
+
+  it("should mark only the leaves set by the last poll", async () => {
+    const changes = new Promise<{ paths: string[]; flagged: boolean }>(
+      (resolve) => {
+        const onDelta = (deltas: { path: string }[]) => {
+          if (!deltas.some((d) => d.path === "motion.traj.feedRateOverride"))
+            return;
+          statChannel.off("delta", onDelta);
+          // Read the bitmap before the next poll clears it
+          resolve({
+            paths: statChannel.getChangedPaths(),
+            flagged: statChannel.changed("motion.traj.feedRateOverride"),
+          });
+        };
+        statChannel.on("delta", onDelta);
+      }
+    );
+
+    await commandChannel.setFeedRate(0.75);
+    const { paths, flagged } = await changes;
+    expect(flagged).toBe(true);
+    expect(paths).toContain("motion.traj.feedRateOverride");
+    expect(statChannel.changed("io.estop")).toBe(false);
+
+    await commandChannel.setFeedRate(1.0);
+  }, 10000);
+});
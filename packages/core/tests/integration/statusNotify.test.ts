@@ -0,0 +1,62 @@
+/**
+ * Integration tests for the status change notification (LinuxCNC patches
+ * 0006 and 0007)
+ *
+ * Task posts the notification only after a status write in which a
+ * generation changed, so the sequence must stay still on an idle machine
+ * and advance when a command changes the status.
+ */
+
+import {
+  CommandChannel,
+  StatChannel,
+  getNmlFilePath,
+  getStatChannelPool,
+} from "../../src/ts";
+import { startLinuxCNC, stopLinuxCNC, setupLinuxCNC } from "./setupLinuxCNC";
+
+const delay = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+describe("Integration: status notification", () => {
+  let commandChannel: CommandChannel;
+  let statChannel: StatChannel;
+
+  beforeAll(async () => {
+    await startLinuxCNC();
+    commandChannel = new CommandChannel();
+    statChannel = new StatChannel();
+    await setupLinuxCNC(commandChannel, statChannel);
+  }, 30000);
+
+  afterAll(async () => {
+    statChannel.destroy();
+    commandChannel.destroy();
+    await stopLinuxCNC();
+  });
+
+  const notifySequence = () =>
+    getStatChannelPool().find((entry) => entry.nmlFile === getNmlFilePath())
+      ?.notifySequence;
+
+  it("should keep the sequence still while the machine is idle", async () => {
+    // Let homing and the setup commands settle
+    await delay(1000);
+    const idle = notifySequence();
+    expect(idle).toEqual(expect.any(Number));
+
+    await delay(2000);
+    expect(notifySequence()).toBe(idle);
+  }, 10000);
+
+  it("should advance the sequence when the status changes", async () => {
+    const before = notifySequence();
+    expect(before).toEqual(expect.any(Number));
+
+    await commandChannel.setFeedRate(0.5);
+    await delay(200);
+    expect(notifySequence()).not.toBe(before);
+    expect(statChannel.get()?.motion.traj.feedRateOverride).toBe(0.5);
+
+    await commandChannel.setFeedRate(1.0);
+  }, 10000);
+});
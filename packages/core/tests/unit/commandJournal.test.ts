@@ -0,0 +1,160 @@
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+import { CommandJournalEvent, RcsStatus } from "@linuxcnc-node/types";
+import {
+  getCommandJournalStats,
+  parseCommandJournal,
+  readCommandJournal,
+  startCommandJournal,
+  stopCommandJournal,
+} from "../../src/ts/commandJournal";
+
+// Mock the native addon
+jest.mock("../../src/ts/constants", () => ({
+  addon: {
+    startCommandJournal: jest.fn(),
+    stopCommandJournal: jest.fn(),
+    getCommandJournalStats: jest.fn(),
+  },
+}));
+
+import { addon } from "../../src/ts/constants";
+
+interface TestRecord {
+  sequence: number;
+  serial: number;
+  event: CommandJournalEvent;
+  status?: number;
+  payload?: number[];
+}
+
+// Builds a journal file the way the native writer lays it out
+function createJournal(records: TestRecord[], extraBytes = 0): Uint8Array {
+  const data = new Uint8Array(32 + records.length * 128 + extraBytes);
+  const view = new DataView(data.buffer);
+  data.set(new TextEncoder().encode("LCNCJRNL"), 0);
+  view.setUint32(8, 1, true);
+  view.setUint32(12, 128, true);
+  records.forEach((record, i) => {
+    const at = 32 + i * 128;
+    view.setBigUint64(at, BigInt(1700000000000 + i) * BigInt(1000000), true);
+    view.setBigUint64(at + 8, BigInt(i * 500000), true);
+    view.setBigUint64(at + 16, BigInt(record.sequence), true);
+    view.setInt32(at + 24, record.serial, true);
+    view.setInt32(at + 28, 502, true);
+    view.setUint16(at + 32, record.event, true);
+    view.setInt16(at + 34, record.status ?? -1, true);
+    view.setUint16(at + 36, 3, true);
+    const payload = record.payload ?? [];
+    view.setUint16(at + 38, payload.length, true);
+    data.set(payload, at + 40);
+  });
+  return data;
+}
+
+describe("command journal", () => {
+  let dir: string;
+
+  beforeEach(() => {
+    jest.clearAllMocks();
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), "journal-"));
+  });
+
+  afterEach(() => {
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  it("should pass start, stop and stats through to the addon", () => {
+    const stats = {
+      active: true,
+      path: "/tmp/cmd.jrnl",
+      recorded: 2,
+      written: 2,
+      dropped: 0,
+      lastError: null,
+    };
+    (addon.getCommandJournalStats as jest.Mock).mockReturnValue(stats);
+
+    startCommandJournal({ path: "/tmp/cmd.jrnl", maxFiles: 4 });
+    expect(addon.startCommandJournal).toHaveBeenCalledWith({
+      path: "/tmp/cmd.jrnl",
+      maxFiles: 4,
+    });
+    expect(getCommandJournalStats()).toBe(stats);
+    stopCommandJournal();
+    expect(addon.stopCommandJournal).toHaveBeenCalled();
+  });
+
+  it("should decode records", () => {
+    const records = parseCommandJournal(
+      createJournal([
+        {
+          sequence: 0,
+          serial: 7,
+          event: CommandJournalEvent.SENT,
+          payload: [1, 2, 3],
+        },
+        {
+          sequence: 1,
+          serial: 7,
+          event: CommandJournalEvent.COMPLETED,
+          status: RcsStatus.DONE,
+        },
+      ])
+    );
+
+    expect(records).toHaveLength(2);
+    expect(records[0]).toEqual({
+      time: 1700000000000,
+      monotonic: 0,
+      sequence: 0,
+      serial: 7,
+      msgType: 502,
+      event: CommandJournalEvent.SENT,
+      status: null,
+      channel: 3,
+      payload: Uint8Array.from([1, 2, 3]),
+    });
+    expect(records[1].event).toBe(CommandJournalEvent.COMPLETED);
+    expect(records[1].status).toBe(RcsStatus.DONE);
+    expect(records[1].monotonic).toBe(0.5);
+  });
+
+  it("should ignore a truncated last record", () => {
+    const records = parseCommandJournal(
+      createJournal(
+        [{ sequence: 0, serial: 1, event: CommandJournalEvent.SENT }],
+        60
+      )
+    );
+    expect(records).toHaveLength(1);
+  });
+
+  it("should reject other files", () => {
+    expect(() => parseCommandJournal(new Uint8Array(64))).toThrow(
+      "Not a command journal"
+    );
+  });
+
+  it("should read rotated files oldest first", () => {
+    const file = path.join(dir, "cmd.jrnl");
+    fs.writeFileSync(
+      `${file}.2`,
+      createJournal([{ sequence: 0, serial: 1, event: CommandJournalEvent.SENT }])
+    );
+    fs.writeFileSync(
+      `${file}.1`,
+      createJournal([{ sequence: 1, serial: 2, event: CommandJournalEvent.SENT }])
+    );
+    fs.writeFileSync(
+      file,
+      createJournal([{ sequence: 2, serial: 3, event: CommandJournalEvent.SENT }])
+    );
+
+    expect(readCommandJournal(file).map((r) => r.sequence)).toEqual([2]);
+    expect(
+      readCommandJournal(file, { includeRotated: true }).map((r) => r.sequence)
+    ).toEqual([0, 1, 2]);
+  });
+});
@@ -78,6 +78,21 @@ describe("CommandTransport", () => {
     expect(transport.getSerial()).toBe(41);
   });
 
+  it("forwards per-instance NML options while forcing sent mode", () => {
+    const { addon } = require("../../src/ts/constants");
+    const other = new CommandTransport({
+      nmlFile: "/tmp/machine-b.nml",
+      commandBuffer: "emcCommand",
+    });
+
+    expect(addon.NativeCommandChannel).toHaveBeenLastCalledWith({
+      nmlFile: "/tmp/machine-b.nml",
+      commandBuffer: "emcCommand",
+      waitMode: "sent",
+    });
+    other.disconnect();
+  });
+
   it("dispatches native commands by name and resolves acceptance by serial", async () => {
     const handle = transport.send("mdi", ["G0 X1"]);
 
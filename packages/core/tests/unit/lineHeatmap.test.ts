@@ -0,0 +1,108 @@
+import { LineHeatmap } from "../../src/ts/lineHeatmap";
+
+// Mock the native addon
+jest.mock("../../src/ts/constants", () => ({
+  addon: {
+    NativeLineHeatmap: jest.fn(),
+  },
+}));
+
+import { addon } from "../../src/ts/constants";
+
+describe("LineHeatmap", () => {
+  let mockNativeHeatmap: any;
+
+  beforeEach(() => {
+    jest.clearAllMocks();
+
+    mockNativeHeatmap = {
+      start: jest.fn(),
+      stop: jest.fn(),
+      clear: jest.fn(),
+      isRunning: jest.fn().mockReturnValue(false),
+      getData: jest.fn(),
+    };
+
+    (addon.NativeLineHeatmap as jest.Mock).mockImplementation(
+      () => mockNativeHeatmap
+    );
+  });
+
+  it("should pass connection options to the native heatmap", () => {
+    new LineHeatmap({ nmlFile: "/tmp/machine.nml" });
+    expect(addon.NativeLineHeatmap).toHaveBeenCalledWith({
+      nmlFile: "/tmp/machine.nml",
+    });
+  });
+
+  describe("start()", () => {
+    it("should apply default interval and line limit", () => {
+      const heatmap = new LineHeatmap();
+      heatmap.start({ channels: ["motion.traj.currentVelocity"] });
+      expect(mockNativeHeatmap.start).toHaveBeenCalledWith(
+        ["motion.traj.currentVelocity"],
+        0.001,
+        1 << 20
+      );
+    });
+
+    it("should pass custom options", () => {
+      const heatmap = new LineHeatmap();
+      heatmap.start({
+        channels: ["motion.joint.0.ferrorCurrent", "motion.spindle.0.speed"],
+        interval: 0.005,
+        maxLines: 5000,
+      });
+      expect(mockNativeHeatmap.start).toHaveBeenCalledWith(
+        ["motion.joint.0.ferrorCurrent", "motion.spindle.0.speed"],
+        0.005,
+        5000
+      );
+    });
+
+    it("should propagate unknown channel errors", () => {
+      mockNativeHeatmap.start.mockImplementation(() => {
+        throw new TypeError("Unsupported heatmap channel: task.file");
+      });
+      const heatmap = new LineHeatmap();
+      expect(() => heatmap.start({ channels: ["task.file"] })).toThrow(
+        TypeError
+      );
+    });
+  });
+
+  it("should forward stop, clear and isRunning", () => {
+    const heatmap = new LineHeatmap();
+    heatmap.stop();
+    heatmap.clear();
+    mockNativeHeatmap.isRunning.mockReturnValue(true);
+    expect(heatmap.isRunning()).toBe(true);
+    expect(mockNativeHeatmap.stop).toHaveBeenCalled();
+    expect(mockNativeHeatmap.clear).toHaveBeenCalled();
+  });
+
+  it("should return the native per-line arrays", () => {
+    const data = {
+      lineCount: 3,
+      samples: new Uint32Array([0, 4, 2]),
+      time: new Float64Array([0, 0.004, 0.002]),
+      dwellTime: new Float64Array([0, 0, 0.002]),
+      channels: {
+        "motion.traj.currentVelocity": {
+          min: new Float64Array([NaN, 1, 0]),
+          max: new Float64Array([NaN, 5, 0]),
+          mean: new Float64Array([NaN, 3, 0]),
+        },
+      },
+      dropped: 0,
+    };
+    mockNativeHeatmap.getData.mockReturnValue(data);
+
+    const result = new LineHeatmap().getData();
+    expect(result.lineCount).toBe(3);
+    expect(result.samples[1]).toBe(4);
+    expect(
+      Number.isNaN(result.channels["motion.traj.currentVelocity"].mean[0])
+    ).toBe(true);
+  });
+});
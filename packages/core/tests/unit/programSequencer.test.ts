@@ -0,0 +1,112 @@
+import { ProgramSequencer } from "../../src/ts/programSequencer";
+
+// Mock the native addon
+jest.mock("../../src/ts/constants", () => ({
+  addon: {
+    NativeProgramSequencer: jest.fn(),
+  },
+}));
+
+import { addon } from "../../src/ts/constants";
+
+const idleState = {
+  phase: "stopped",
+  held: false,
+  holdReason: null,
+  waitingFor: null,
+  current: null,
+  queued: [],
+  cycles: [],
+};
+
+describe("ProgramSequencer", () => {
+  let mockNative: any;
+
+  beforeEach(() => {
+    jest.clearAllMocks();
+    jest.useFakeTimers();
+
+    mockNative = {
+      stage: jest.fn().mockReturnValue(1),
+      clearQueue: jest.fn(),
+      start: jest.fn(),
+      stop: jest.fn(),
+      hold: jest.fn(),
+      release: jest.fn(),
+      poll: jest.fn().mockReturnValue(idleState),
+      disconnect: jest.fn(),
+    };
+
+    (addon.NativeProgramSequencer as jest.Mock).mockImplementation(
+      () => mockNative
+    );
+  });
+
+  afterEach(() => {
+    jest.useRealTimers();
+  });
+
+  it("should pass connection options and forward staging", () => {
+    const sequencer = new ProgramSequencer({ nmlFile: "/tmp/cell.nml" });
+    expect(addon.NativeProgramSequencer).toHaveBeenCalledWith({
+      nmlFile: "/tmp/cell.nml",
+    });
+
+    expect(sequencer.stage("/parts/a.ngc")).toBe(1);
+    expect(mockNative.stage).toHaveBeenCalledWith("/parts/a.ngc");
+    sequencer.destroy();
+  });
+
+  it("should start the native sequencer with the permissive input", () => {
+    const sequencer = new ProgramSequencer();
+    sequencer.start({ permissiveInput: 3 });
+    expect(mockNative.start).toHaveBeenCalledWith({ permissiveInput: 3 });
+    sequencer.destroy();
+    expect(mockNative.stop).toHaveBeenCalled();
+    expect(mockNative.disconnect).toHaveBeenCalled();
+  });
+
+  it("should emit cycle reports and state changes while started", () => {
+    const sequencer = new ProgramSequencer({ pollInterval: 10 });
+    const onCycle = jest.fn();
+    const onState = jest.fn();
+    sequencer.on("cycle", onCycle);
+    sequencer.on("state", onState);
+
+    const cycle = {
+      index: 1,
+      file: "/parts/a.ngc",
+      result: "done",
+      error: null,
+      gap: 0.012,
+      launchTime: 0.008,
+      openTime: 0.004,
+      cycleTime: 42,
+      endedAt: 1700000000000,
+    };
+    mockNative.poll.mockReturnValue({ ...idleState, phase: "waiting" });
+    sequencer.start();
+    expect(onState).toHaveBeenCalledTimes(1);
+
+    mockNative.poll.mockReturnValueOnce({
+      ...idleState,
+      phase: "waiting",
+      cycles: [cycle],
+    });
+    jest.advanceTimersByTime(10);
+    expect(onCycle).toHaveBeenCalledWith(cycle);
+    expect(onState).toHaveBeenCalledTimes(1);
+    expect(sequencer.getState().phase).toBe("waiting");
+
+    sequencer.destroy();
+  });
+
+  it("should forward hold and release", () => {
+    const sequencer = new ProgramSequencer();
+    sequencer.hold("pallet change");
+    sequencer.release();
+    expect(mockNative.hold).toHaveBeenCalledWith("pallet change");
+    expect(mockNative.release).toHaveBeenCalled();
+    sequencer.destroy();
+  });
+});
@@ -33,11 +33,21 @@ describe("StatChannel", () => {
       },
     } as any;
 
-    // Create mock native instance
+    // Create mock native instance; mockStat stands in for the live object
+    // the native layer updates in place
     mockNativeInstance = {
       getCurrentFullStat: jest.fn(), // Unused now
       poll: jest.fn(),
+      materialize: jest.fn(() => mockStat),
+      getChangedBitmap: jest.fn(() => new Uint32Array(8)),
+      getLeafIndex: jest.fn(() => -1),
+      getChangedPaths: jest.fn(() => []),
+      snapshotJSON: jest.fn(),
       disconnect: jest.fn(),
+      setProgram: jest.fn(),
+      clearProgram: jest.fn(),
+      getToolTable: jest.fn(),
+      setRateLimits: jest.fn(),
     };
 
     // Default poll implementation
@@ -86,6 +96,210 @@ describe("StatChannel", () => {
     });
   });
 
+  describe("constructor", () => {
+    it("should pass per-instance NML options to the native channel", () => {
+      const options = { nmlFile: "/tmp/machine-b.nml", pollInterval: 20 };
+      const statChannel = new StatChannel(options);
+
+      expect(addon.NativeStatChannel).toHaveBeenCalledWith(options);
+      expect(statChannel.getPollInterval()).toBe(20);
+
+      statChannel.destroy();
+    });
+  });
+
+  describe("setRateLimits()", () => {
+    it("should pass rules from the options to the native channel", () => {
+      const rateLimits = [
+        { path: "motion.traj.position", maxRate: 30 },
+        { path: "task.*", priority: "high" as const },
+      ];
+      const statChannel = new StatChannel({ rateLimits });
+
+      expect(mockNativeInstance.setRateLimits).toHaveBeenCalledWith(
+        rateLimits
+      );
+
+      statChannel.setRateLimits([]);
+      expect(mockNativeInstance.setRateLimits).toHaveBeenLastCalledWith([]);
+
+      statChannel.destroy();
+    });
+
+    it("should not set rules unless given", () => {
+      const statChannel = new StatChannel();
+      expect(mockNativeInstance.setRateLimits).not.toHaveBeenCalled();
+      statChannel.destroy();
+    });
+  });
+
+  describe("getToolTable()", () => {
+    it("should return the native columns unchanged", () => {
+      const statChannel = new StatChannel();
+      const columns = { count: 0, toolNo: new Int32Array(0) };
+      mockNativeInstance.getToolTable.mockReturnValue(columns);
+
+      expect(statChannel.getToolTable()).toBe(columns);
+      expect(mockNativeInstance.getToolTable).toHaveBeenCalledTimes(1);
+
+      statChannel.destroy();
+    });
+  });
+
+  describe("setProgram()", () => {
+    it("should hand the timing table to the native channel", () => {
+      const statChannel = new StatChannel();
+      const table = {
+        lineNumber: Int32Array.from([10, 11]),
+        length: Float64Array.from([5, 50]),
+        duration: Float64Array.from([0.1, 15]),
+        rapid: Uint8Array.from([1, 0]),
+      };
+
+      statChannel.setProgram("/tmp/part.ngc", table);
+      expect(mockNativeInstance.setProgram).toHaveBeenCalledWith(
+        "/tmp/part.ngc",
+        table
+      );
+
+      statChannel.clearProgram();
+      expect(mockNativeInstance.clearProgram).toHaveBeenCalled();
+
+      statChannel.destroy();
+    });
+
+    it("should report progress like any other stat", () => {
+      const statChannel = new StatChannel();
+      const callback = jest.fn();
+
+      statChannel.on("progress.percent", callback);
+      (mockStat as any).progress = {
+        active: true,
+        percent: 42,
+        timeRemaining: 90,
+      };
+      mockNativeInstance.poll.mockReturnValue({
+        changes: [
+          { path: "progress.active", value: true },
+          { path: "progress.percent", value: 42 },
+          { path: "progress.timeRemaining", value: 90 },
+        ],
+        cursor: 2,
+      });
+
+      jest.advanceTimersByTime(DEFAULT_STAT_POLL_INTERVAL);
+
+      expect(callback).toHaveBeenCalledWith(42, undefined, "progress.percent");
+      expect(statChannel.progress?.timeRemaining).toBe(90);
+
+      statChannel.destroy();
+    });
+  });
+
+  describe("live stat", () => {
+    it("should return the native object instead of applying deltas", () => {
+      const statChannel = new StatChannel();
+
+      expect(mockNativeInstance.poll).toHaveBeenCalledWith(true, false);
+      expect(statChannel.get()).toBe(mockStat);
+
+      mockNativeInstance.poll.mockReturnValue({
+        changes: [{ path: "task.motionLine", value: 20 }],
+        cursor: 2,
+      });
+      jest.advanceTimersByTime(DEFAULT_STAT_POLL_INTERVAL);
+
+      // The native layer owns the object; the delta is not applied in JS
+      expect(statChannel.task?.motionLine).toBe(10);
+      expect(statChannel.get()).toBe(mockStat);
+      expect(statChannel.getCursor()).toBe(2);
+
+      statChannel.destroy();
+    });
+
+    it("should only collect changes while someone listens", () => {
+      const statChannel = new StatChannel();
+
+      jest.advanceTimersByTime(DEFAULT_STAT_POLL_INTERVAL);
+      expect(mockNativeInstance.poll).toHaveBeenLastCalledWith(false, false);
+
+      const listener = jest.fn();
+      statChannel.on("delta", listener);
+      jest.advanceTimersByTime(DEFAULT_STAT_POLL_INTERVAL);
+      expect(mockNativeInstance.poll).toHaveBeenLastCalledWith(false, true);
+
+      statChannel.off("delta", listener);
+      statChannel.on("task.motionLine", jest.fn());
+      jest.advanceTimersByTime(DEFAULT_STAT_POLL_INTERVAL);
+      expect(mockNativeInstance.poll).toHaveBeenLastCalledWith(false, true);
+
+      statChannel.destroy();
+    });
+
+    it("should read changed leaves from the native bitmap", () => {
+      const statChannel = new StatChannel();
+      const bitmap = new Uint32Array(8);
+      bitmap[1] = 1 << 2; // Leaf 34
+      mockNativeInstance.getChangedBitmap.mockReturnValue(bitmap);
+      const indices: Record<string, number> = {
+        "motion.traj.position": 34,
+        "task.motionLine": 3,
+      };
+      mockNativeInstance.getLeafIndex.mockImplementation(
+        (path: string) => indices[path] ?? -1
+      );
+
+      expect(statChannel.changed("motion.traj.position")).toBe(true);
+      expect(statChannel.changed("task.motionLine")).toBe(false);
+      expect(statChannel.changed("io.estop")).toBe(false);
+
+      statChannel.destroy();
+    });
+
+    it("should keep a copy of watched poses", () => {
+      const statChannel = new StatChannel();
+      const callback = jest.fn();
+
+      statChannel.on("motion.traj.position", callback);
+      const { X } = PositionIndex;
+      mockStat.motion.traj.position[X] = 5; // Overwritten in place
+
+      const newPosition = new Float64Array(9);
+      newPosition[X] = 5;
+      mockNativeInstance.poll.mockReturnValue({
+        changes: [{ path: "motion.traj.position", value: newPosition }],
+        cursor: 2,
+      });
+      jest.advanceTimersByTime(DEFAULT_STAT_POLL_INTERVAL);
+
+      expect(callback).toHaveBeenCalledWith(
+        newPosition,
+        new Float64Array(9),
+        "motion.traj.position"
+      );
+
+      statChannel.destroy();
+    });
+  });
+
+  describe("snapshotJSON()", () => {
+    it("should return the native buffer for the selected fields", () => {
+      const statChannel = new StatChannel();
+      const json = Buffer.from('{"task":{"motionLine":10}}');
+      mockNativeInstance.snapshotJSON.mockReturnValue(json);
+
+      expect(statChannel.snapshotJSON(["task"])).toBe(json);
+      expect(mockNativeInstance.snapshotJSON).toHaveBeenCalledWith(["task"]);
+
+      statChannel.snapshotJSON();
+      expect(mockNativeInstance.snapshotJSON).toHaveBeenLastCalledWith(
+        undefined
+      );
+
+      statChannel.destroy();
+    });
+  });
+
   describe("on()", () => {
     it("should trigger callback only when watched property changes", () => {
       const statChannel = new StatChannel();
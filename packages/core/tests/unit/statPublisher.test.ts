@@ -0,0 +1,163 @@
+import {
+  StatFrameReader,
+  StatPublisher,
+  decodeStatFrame,
+} from "../../src/ts/statPublisher";
+
+// Mock the native addon
+jest.mock("../../src/ts/constants", () => ({
+  addon: {
+    NativeStatPublisher: jest.fn(),
+  },
+}));
+
+import { addon } from "../../src/ts/constants";
+
+type ValueWriter = (view: DataView, at: number) => number;
+
+const f64 =
+  (value: number): ValueWriter =>
+  (view, at) => (view.setFloat64(at, value, true), at + 8);
+const i32 =
+  (value: number): ValueWriter =>
+  (view, at) => (view.setInt32(at, value, true), at + 4);
+const bool =
+  (value: boolean): ValueWriter =>
+  (view, at) => (view.setUint8(at, value ? 1 : 0), at + 1);
+const str =
+  (value: string): ValueWriter =>
+  (view, at) => {
+    view.setUint16(at, value.length, true);
+    new Uint8Array(view.buffer).set(new TextEncoder().encode(value), at + 2);
+    return at + 2 + value.length;
+  };
+const pose =
+  (values: number[]): ValueWriter =>
+  (view, at) => {
+    values.forEach((value, i) => view.setFloat64(at + i * 8, value, true));
+    return at + 72;
+  };
+const list =
+  (values: string[]): ValueWriter =>
+  (view, at) => {
+    view.setUint8(at++, values.length);
+    for (const value of values) {
+      view.setUint8(at++, value.length);
+      new Uint8Array(view.buffer).set(new TextEncoder().encode(value), at);
+      at += value.length;
+    }
+    return at;
+  };
+
+// Encodes a frame the way the native StatFrameWriter does
+function encodeFrame(
+  type: number,
+  sequence: number,
+  entries: [number, string, ValueWriter][]
+): Uint8Array {
+  const data = new Uint8Array(1024);
+  const view = new DataView(data.buffer);
+  view.setUint8(4, type);
+  view.setUint8(5, 1);
+  view.setUint32(8, entries.length, true);
+  view.setBigUint64(12, BigInt(sequence), true);
+  view.setBigUint64(20, BigInt(1700000000000) * BigInt(1000000), true);
+  let at = 28;
+  for (const [valueType, path, writeValue] of entries) {
+    view.setUint8(at, valueType);
+    view.setUint8(at + 1, path.length);
+    data.set(new TextEncoder().encode(path), at + 2);
+    at = writeValue(view, at + 2 + path.length);
+  }
+  view.setUint32(0, at - 4, true);
+  return data.slice(0, at);
+}
+
+function createFrame(): Uint8Array {
+  return encodeFrame(1, 7, [
+    [1, "motion.traj.currentVelocity", f64(12.5)],
+    [2, "task.motionLine", i32(-3)],
+    [3, "io.estop", bool(true)],
+    [4, "task.file", str("a.ngc")],
+    [5, "motion.traj.position", pose([0, 1, 2, 3, 4, 5, 6, 7, 8])],
+    [6, "motion.traj.availableAxes", list(["X", "Z"])],
+  ]);
+}
+
+describe("StatPublisher", () => {
+  let mockNativePublisher: any;
+
+  beforeEach(() => {
+    jest.clearAllMocks();
+
+    mockNativePublisher = {
+      start: jest.fn(),
+      stop: jest.fn(),
+      isRunning: jest.fn().mockReturnValue(true),
+      getStats: jest.fn(),
+    };
+
+    (addon.NativeStatPublisher as jest.Mock).mockImplementation(
+      () => mockNativePublisher
+    );
+  });
+
+  it("should pass options through to the native publisher", () => {
+    const connection = { nmlFile: "/tmp/machine-b.nml" };
+    const publisher = new StatPublisher(connection);
+    expect(addon.NativeStatPublisher).toHaveBeenCalledWith(connection);
+
+    const options = { path: "/tmp/stat.sock", interval: 0.01 };
+    publisher.start(options);
+    expect(mockNativePublisher.start).toHaveBeenCalledWith(options);
+    expect(publisher.isRunning()).toBe(true);
+
+    publisher.stop();
+    expect(mockNativePublisher.stop).toHaveBeenCalled();
+  });
+});
+
+describe("stat frames", () => {
+  it("should decode every value type", () => {
+    const frame = decodeStatFrame(createFrame());
+
+    expect(frame.type).toBe("snapshot");
+    expect(frame.sequence).toBe(7);
+    expect(frame.time).toBe(1700000000000);
+    expect(frame.changes).toEqual([
+      { path: "motion.traj.currentVelocity", value: 12.5 },
+      { path: "task.motionLine", value: -3 },
+      { path: "io.estop", value: true },
+      { path: "task.file", value: "a.ngc" },
+      {
+        path: "motion.traj.position",
+        value: Float64Array.from([0, 1, 2, 3, 4, 5, 6, 7, 8]),
+      },
+      { path: "motion.traj.availableAxes", value: ["X", "Z"] },
+    ]);
+  });
+
+  it("should reassemble frames split across chunks", () => {
+    const first = createFrame();
+    const second = encodeFrame(2, 8, [[2, "task.motionLine", i32(4)]]);
+    const stream = new Uint8Array(first.length + second.length);
+    stream.set(first, 0);
+    stream.set(second, first.length);
+
+    const reader = new StatFrameReader();
+    expect(reader.push(stream.subarray(0, 3))).toEqual([]);
+    expect(reader.push(stream.subarray(3, first.length + 10))).toHaveLength(1);
+    const frames = reader.push(stream.subarray(first.length + 10));
+    expect(frames).toHaveLength(1);
+    expect(frames[0].type).toBe("delta");
+    expect(frames[0].changes).toEqual([{ path: "task.motionLine", value: 4 }]);
+  });
+
+  it("should reject unknown versions", () => {
+    const frame = createFrame();
+    frame[5] = 2;
+    expect(() => decodeStatFrame(frame)).toThrow(
+      "Unsupported stat frame version"
+    );
+  });
+});
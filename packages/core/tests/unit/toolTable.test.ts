@@ -0,0 +1,50 @@
+import { TOOL_OFFSET_STRIDE, ToolTableColumns } from "@linuxcnc-node/types";
+import { findToolRow, toolComment } from "../../src/ts/toolTable";
+
+// Spindle row (tool 2 loaded) followed by tools 1, 2 and a large number
+function createTable(): ToolTableColumns {
+  const comments = ["drill", "drill", "end mill", "Ø6 ball"];
+  const encoded = comments.map((c) => new TextEncoder().encode(c));
+  const commentOffsets = new Uint32Array(comments.length + 1);
+  encoded.forEach((bytes, i) => {
+    commentOffsets[i + 1] = commentOffsets[i] + bytes.length;
+  });
+  const packed = new Uint8Array(commentOffsets[comments.length]);
+  encoded.forEach((bytes, i) => packed.set(bytes, commentOffsets[i]));
+
+  return {
+    count: 4,
+    toolNo: Int32Array.from([2, 1, 2, 5000000]),
+    pocketNo: Int32Array.from([0, 1, 2, 3]),
+    diameter: Float64Array.from([6, 3, 6, 6]),
+    frontAngle: new Float64Array(4),
+    backAngle: new Float64Array(4),
+    orientation: new Int32Array(4),
+    offset: new Float64Array(4 * TOOL_OFFSET_STRIDE),
+    comments: packed,
+    commentOffsets,
+    indexByToolNo: Int32Array.from([-1, 1, 2]),
+  };
+}
+
+describe("tool table columns", () => {
+  it("should find rows through the index", () => {
+    const table = createTable();
+    expect(findToolRow(table, 1)).toBe(1);
+    expect(findToolRow(table, 2)).toBe(2);
+    expect(findToolRow(table, 0)).toBe(-1);
+  });
+
+  it("should scan for tool numbers past the index", () => {
+    const table = createTable();
+    expect(findToolRow(table, 5000000)).toBe(3);
+    expect(findToolRow(table, 7)).toBe(-1);
+    expect(findToolRow(table, -1)).toBe(-1);
+  });
+
+  it("should decode packed comments", () => {
+    const table = createTable();
+    expect(toolComment(table, 2)).toBe("end mill");
+    expect(toolComment(table, 3)).toBe("Ø6 ball");
+  });
+});
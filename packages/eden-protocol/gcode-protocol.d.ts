@@ -5,13 +5,27 @@
  */
 
 import type { ChannelProtocol } from "@edenapp/types";
-import type { GCodeParseResult, ParseProgress } from "@linuxcnc-node/types";
+import type {
+  GCodeParseResult,
+  ParseDiagnostic,
+  ParseProfile,
+  ParseProgress,
+  PrescanResult,
+  ThumbnailOptions,
+} from "@linuxcnc-node/types";
 
 // ============================================================================
 // G-Code Types (re-export for convenience)
 // ============================================================================
 
-export type { GCodeParseResult, ParseProgress };
+export type {
+  GCodeParseResult,
+  ParseDiagnostic,
+  ParseProfile,
+  ParseProgress,
+  PrescanResult,
+  ThumbnailOptions,
+};
 
 // ============================================================================
 // Protocol Definition
@@ -25,6 +39,18 @@ export interface GCodeProtocol extends ChannelProtocol {
     /** Parse progress update */
     "parse-progress": ParseProgress;
 
+    /** A watched program or one of its dependencies changed */
+    "program-invalidated": {
+      filepath: string;
+      changedPath: string;
+    };
+
+    /** Fresh result for a watched program after a change */
+    "program-updated": {
+      filepath: string;
+      result: GCodeParseResult;
+    };
+
     /** Error occurred */
     error: {
       code: string;
@@ -41,10 +67,79 @@ export interface GCodeProtocol extends ChannelProtocol {
         filepath: string;
         iniPath: string;
         progressUpdates?: number;
+        collectErrors?: boolean;
+        maxErrors?: number;
+        profile?: boolean;
+        profileLines?: number;
       };
       result: GCodeParseResult;
     };
 
+    /**
+     * Parse a G-code file into the compact transport encoding; decode it
+     * with decodeParseResult() from @linuxcnc-node/gcode. Much smaller than
+     * `parse` for large programs sent to remote clients.
+     */
+    "parse-compact": {
+      args: {
+        filepath: string;
+        iniPath: string;
+        progressUpdates?: number;
+        collectErrors?: boolean;
+        maxErrors?: number;
+        /** Position quantisation step in mm (default 0.0001) */
+        resolution?: number;
+      };
+      result: Uint8Array;
+    };
+
+    /**
+     * Parse a program and keep watching it, its INI and its subroutine
+     * dependencies; changes are pushed as program-invalidated and
+     * program-updated messages.
+     */
+    watch: {
+      args: {
+        filepath: string;
+        iniPath: string;
+      };
+      result: GCodeParseResult;
+    };
+
+    /** Stop watching a program */
+    unwatch: {
+      args: {
+        filepath: string;
+      };
+      result: void;
+    };
+
+    /** Interpreter-free structural scan of a G-code file */
+    prescan: {
+      args: {
+        filepath: string;
+        maxIssues?: number;
+      };
+      result: PrescanResult;
+    };
+
+    /**
+     * Parse programs and render a PNG toolpath thumbnail for each, e.g. for
+     * a job list. A program that fails to parse gets `error` instead.
+     */
+    thumbnails: {
+      args: {
+        filepaths: string[];
+        iniPath: string;
+        options?: ThumbnailOptions;
+      };
+      result: {
+        filepath: string;
+        png?: Uint8Array;
+        error?: string;
+      }[];
+    };
+
     ping: {
       args: {};
       result: { timestamp: number };
@@ -6,7 +6,20 @@
         "src/cpp/gcode_addon.cc",
         "src/cpp/gcode_parser.cc",
         "src/cpp/canon_preview.cc",
-        "src/cpp/parse_worker.cc"
+        "src/cpp/parse_worker.cc",
+        "src/cpp/parse_flight.cc",
+        "src/cpp/prescan.cc",
+        "src/cpp/prescan_worker.cc",
+        "src/cpp/thumbnail.cc",
+        "src/cpp/thumbnail_worker.cc",
+        "src/cpp/compact_codec.cc",
+        "src/cpp/profiler.cc",
+        "src/cpp/path_sampler.cc",
+        "src/cpp/path_sampler_wrap.cc",
+        "src/cpp/toolpath.cc",
+        "src/cpp/napi_helpers.cc",
+        "src/cpp/planner.cc",
+        "src/cpp/planner_worker.cc"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
@@ -0,0 +1,89 @@
+/**
+ * Arc Geometry - Header
+ *
+ * Shared geometry of ARC_FEED moves as stored in a parse result, for code
+ * that walks the toolpath without the three.js viewer.
+ */
+
+#ifndef GCODE_ARC_GEOMETRY_HH
+#define GCODE_ARC_GEOMETRY_HH
+
+#include <cmath>
+
+namespace GCodeParser
+{
+
+  constexpr double TWO_PI = 2.0 * M_PI;
+
+  /**
+   * Arc geometry in the frame of its plane, following ARC_FEED: for XZ
+   * (G18) the first axis is Z and the second is X.
+   */
+  struct ArcFrame
+  {
+    int first;
+    int second;
+    int helix;
+    double radius;
+    double startAngle;
+    double sweep; // Signed: positive = CCW (G3)
+    double helixStart;
+    double helixDelta;
+  };
+
+  /**
+   * Frame of the arc from `start` to `end` (XYZ). `plane` is a Plane value
+   * and `rotation` the ArcData rotation: its sign is the direction, its
+   * magnitude minus one the number of extra full turns.
+   * @returns false for UV/VW/UW arcs, which do not move XYZ along an arc
+   */
+  inline bool arcFrame(const double *start, const double *end, int plane,
+                       double centerFirst, double centerSecond, int rotation,
+                       ArcFrame &frame)
+  {
+    switch (plane)
+    {
+    case 1: // XY
+      frame.first = 0, frame.second = 1, frame.helix = 2;
+      break;
+    case 2: // YZ
+      frame.first = 1, frame.second = 2, frame.helix = 0;
+      break;
+    case 3: // XZ
+      frame.first = 2, frame.second = 0, frame.helix = 1;
+      break;
+    default:
+      return false;
+    }
+
+    double sf = start[frame.first] - centerFirst;
+    double ss = start[frame.second] - centerSecond;
+    double ef = end[frame.first] - centerFirst;
+    double es = end[frame.second] - centerSecond;
+
+    frame.radius = std::sqrt(sf * sf + ss * ss);
+    frame.startAngle = std::atan2(ss, sf);
+    double endAngle = std::atan2(es, ef);
+
+    bool cw = rotation < 0;
+    int turns = std::abs(rotation);
+    double partial = cw ? frame.startAngle - endAngle : endAngle - frame.startAngle;
+    if (partial < 0.0)
+    {
+      partial += TWO_PI;
+    }
+    double sweep = turns >= 1 ? (turns - 1) * TWO_PI + partial : partial;
+    if (sweep == 0.0)
+    {
+      sweep = TWO_PI;
+    }
+    frame.sweep = cw ? -sweep : sweep;
+
+    frame.helixStart = start[frame.helix];
+    frame.helixDelta = end[frame.helix] - frame.helixStart;
+    return true;
+  }
+
+} // namespace GCodeParser
+
+#endif // GCODE_ARC_GEOMETRY_HH
@@ -13,8 +13,10 @@
 #include "emctool.h"
 #include "tooldata.hh"
 
+#include <algorithm>
 #include <cstring>
 #include <cmath>
+#include <variant>
 
 // Disable _task for preview mode
 int _task = 0;
@@ -28,6 +30,9 @@ EmcPose tool_offset;
 // Thread-local parse context
 static thread_local GCodeParser::ParseContext *g_parseContext = nullptr;
 
+// Selected tool (set by SELECT_TOOL, consumed by CHANGE_TOOL)
+static int g_selectedTool = 0;
+
 namespace GCodeParser
 {
 
@@ -54,6 +59,37 @@ namespace GCodeParser
     }
   }
 
+  void saveCanonState(CanonState &state)
+  {
+    state.toolOffset[0] = tool_offset.tran.x;
+    state.toolOffset[1] = tool_offset.tran.y;
+    state.toolOffset[2] = tool_offset.tran.z;
+    state.toolOffset[3] = tool_offset.a;
+    state.toolOffset[4] = tool_offset.b;
+    state.toolOffset[5] = tool_offset.c;
+    state.toolOffset[6] = tool_offset.u;
+    state.toolOffset[7] = tool_offset.v;
+    state.toolOffset[8] = tool_offset.w;
+    state.selectedTool = g_selectedTool;
+    state.parameterFileName = _parameter_file_name;
+  }
+
+  void restoreCanonState(const CanonState &state)
+  {
+    tool_offset.tran.x = state.toolOffset[0];
+    tool_offset.tran.y = state.toolOffset[1];
+    tool_offset.tran.z = state.toolOffset[2];
+    tool_offset.a = state.toolOffset[3];
+    tool_offset.b = state.toolOffset[4];
+    tool_offset.c = state.toolOffset[5];
+    tool_offset.u = state.toolOffset[6];
+    tool_offset.v = state.toolOffset[7];
+    tool_offset.w = state.toolOffset[8];
+    g_selectedTool = state.selectedTool;
+    strncpy(_parameter_file_name, state.parameterFileName.c_str(), PARAMETER_FILE_NAME_LENGTH - 1);
+    _parameter_file_name[PARAMETER_FILE_NAME_LENGTH - 1] = '\0';
+  }
+
   void setParseContext(ParseContext *ctx)
   {
     g_parseContext = ctx;
@@ -75,12 +111,14 @@ namespace GCodeParser
 #define GET_CTX()                           \
   auto *ctx = GCodeParser::getParseContext(); \
   if (!ctx)                                 \
-    return;
+    return;                                 \
+  ctx->canonCalls++;
 
 #define GET_CTX_RET(ret)                    \
   auto *ctx = GCodeParser::getParseContext(); \
   if (!ctx)                                 \
-    return ret;
+    return ret;                             \
+  ctx->canonCalls++;
 
 // ============================================================================
 // Motion Functions
@@ -607,10 +645,84 @@ void USE_TOOL_LENGTH_OFFSET(const EmcPose &offset)
 }
 
 // ============================================================================
-// Tool Functions
+// Path Control Functions
 // ============================================================================
 
-static int g_selectedTool = 0;
+static void recordMotionMode(GCodeParser::ParseContext *ctx)
+{
+  GCodeParser::MotionModeChangeOp op;
+  op.mode = ctx->motionMode;
+  op.tolerance = ctx->tolerance;
+  op.naivecamTolerance = ctx->naivecamTolerance;
+
+  // G64 P Q arrives as two calls; the second completes the first
+  if (!ctx->operations.empty() &&
+      std::holds_alternative<GCodeParser::MotionModeChangeOp>(ctx->operations.back()))
+  {
+    ctx->operations.back() = op;
+    return;
+  }
+  ctx->addOperation(std::move(op));
+}
+
+static double toleranceInMm(const GCodeParser::ParseContext *ctx, double tolerance)
+{
+  tolerance = std::max(tolerance, 0.0);
+  return ctx->metric ? tolerance : tolerance * 25.4;
+}
+
+static void setMotionMode(GCodeParser::ParseContext *ctx, CANON_MOTION_MODE mode)
+{
+  switch (mode)
+  {
+  case CANON_EXACT_STOP:
+    ctx->motionMode = GCodeParser::MotionMode::EXACT_STOP;
+    break;
+  case CANON_EXACT_PATH:
+    ctx->motionMode = GCodeParser::MotionMode::EXACT_PATH;
+    break;
+  case CANON_CONTINUOUS:
+    ctx->motionMode = GCodeParser::MotionMode::CONTINUOUS;
+    break;
+  }
+}
+
+void SET_MOTION_CONTROL_MODE(CANON_MOTION_MODE mode, double tolerance)
+{
+  GET_CTX();
+
+  setMotionMode(ctx, mode);
+  ctx->tolerance = toleranceInMm(ctx, tolerance);
+  recordMotionMode(ctx);
+}
+
+void SET_MOTION_CONTROL_MODE(double tolerance)
+{
+  GET_CTX();
+
+  ctx->tolerance = toleranceInMm(ctx, tolerance);
+  recordMotionMode(ctx);
+}
+
+void SET_MOTION_CONTROL_MODE(CANON_MOTION_MODE mode)
+{
+  GET_CTX();
+
+  setMotionMode(ctx, mode);
+  recordMotionMode(ctx);
+}
+
+void SET_NAIVECAM_TOLERANCE(double tolerance)
+{
+  GET_CTX();
+
+  ctx->naivecamTolerance = toleranceInMm(ctx, tolerance);
+  recordMotionMode(ctx);
+}
+
+// ============================================================================
+// Tool Functions
+// ============================================================================
 
 void SELECT_TOOL(int tool)
 {
@@ -682,10 +794,6 @@ void ON_RESET() {}
 void PALLET_SHUTTLE() {}
 void UPDATE_TAG(const StateTag &) {}
 void OPTIONAL_PROGRAM_STOP() {}
-void SET_MOTION_CONTROL_MODE(CANON_MOTION_MODE, double) {}
-void SET_MOTION_CONTROL_MODE(double) {}
-void SET_MOTION_CONTROL_MODE(CANON_MOTION_MODE) {}
-void SET_NAIVECAM_TOLERANCE(double) {}
 void CANON_ERROR(const char *, ...) {}
 void CLAMP_AXIS(CANON_AXIS) {}
 void UNCLAMP_AXIS(CANON_AXIS) {}
@@ -10,6 +10,7 @@
 
 #include "operation_types.hh"
 #include <functional>
+#include <string>
 
 namespace GCodeParser
 {
@@ -31,6 +32,9 @@ namespace GCodeParser
     double currentFeedRate = 0.0;
     int selectedTool = 0;
     bool metric = false;
+    MotionMode motionMode = MotionMode::CONTINUOUS;
+    double tolerance = 0.0;         // G64 P, in mm
+    double naivecamTolerance = 0.0; // G64 Q, in mm
 
     // For tracking state changes
     double lastFeedRate = -1.0;
@@ -40,12 +44,37 @@ namespace GCodeParser
     size_t totalBytes = 0;
     size_t linesProcessed = 0;
 
+    // Canon calls that reached the preview, for the line profiler
+    uint64_t canonCalls = 0;
+
     // Helper methods
     void addOperation(Operation &&op);
     void updateExtents(const Position &pos);
     void reportProgress(size_t bytesRead);
   };
 
+  /**
+   * Canon state that outlives a single parse and belongs to one interpreter
+   * instance (tool length offset, selected tool, parameter file name).
+   * Swapped in and out of the canon globals when cached interpreters change.
+   */
+  struct CanonState
+  {
+    double toolOffset[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0}; // x y z a b c u v w
+    int selectedTool = 0;
+    std::string parameterFileName;
+  };
+
+  /**
+   * Copy the active canon globals into `state`.
+   */
+  void saveCanonState(CanonState &state);
+
+  /**
+   * Make `state` the active canon globals.
+   */
+  void restoreCanonState(const CanonState &state);
+
   /**
    * Set the current parse context.
    * Must be called before interpreter execution.
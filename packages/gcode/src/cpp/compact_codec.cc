@@ -0,0 +1,742 @@
+/**
+ * Compact Codec - Implementation
+ *
+ * Compact binary transport form of a ParseResult for remote clients.
+ */
+
+#include "compact_codec.hh"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    constexpr uint8_t HAS_ERRORS = 0x01;
+
+    constexpr int AXES = 9;
+    constexpr uint8_t TYPE_MASK = 0x1f;
+    constexpr int XYZ_SHIFT = 5;
+    constexpr int EXT_AXES = 6; // A B C U V W
+    constexpr uint64_t EXT_MASK = (1u << EXT_AXES) - 1;
+
+    // Largest quantised magnitude; keeps deltas inside int64
+    constexpr double MAX_QUANTISED = 4.0e18;
+
+    using Quantised = int64_t[AXES];
+
+    // Position is nine packed doubles, x..w
+    static_assert(sizeof(Position) == AXES * sizeof(double), "Position layout");
+    static_assert(sizeof(Position3) == 3 * sizeof(double), "Position3 layout");
+
+    double *axes(Position &pos) { return &pos.x; }
+    const double *axes(const Position &pos) { return &pos.x; }
+
+    /**
+     * First, second and helix axis of an arc in `plane`, as ARC_FEED maps
+     * them (XZ is first = Z, second = X).
+     */
+    void planeAxes(Plane plane, int &first, int &second, int &helix)
+    {
+      switch (plane)
+      {
+      case Plane::YZ:
+        first = 1, second = 2, helix = 0;
+        break;
+      case Plane::XZ:
+        first = 2, second = 0, helix = 1;
+        break;
+      default:
+        first = 0, second = 1, helix = 2;
+        break;
+      }
+    }
+
+    // ========================================================================
+    // Writer
+    // ========================================================================
+
+    class Writer
+    {
+    public:
+      explicit Writer(double scale) : scale_(scale) {}
+
+      std::vector<uint8_t> &bytes() { return buf_; }
+
+      void u8(uint8_t v) { buf_.push_back(v); }
+
+      void varint(uint64_t v)
+      {
+        while (v >= 0x80)
+        {
+          buf_.push_back(static_cast<uint8_t>(v) | 0x80);
+          v >>= 7;
+        }
+        buf_.push_back(static_cast<uint8_t>(v));
+      }
+
+      void svarint(int64_t v)
+      {
+        varint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+      }
+
+      void f64(double v)
+      {
+        uint8_t raw[8];
+        std::memcpy(raw, &v, 8);
+        buf_.insert(buf_.end(), raw, raw + 8);
+      }
+
+      void string(const std::string &s)
+      {
+        varint(s.size());
+        buf_.insert(buf_.end(), s.begin(), s.end());
+      }
+
+      int64_t quantise(double v) const
+      {
+        double q = std::round(v * scale_);
+        if (!(std::fabs(q) < MAX_QUANTISED))
+        {
+          throw std::runtime_error("Value " + std::to_string(v) + " out of range for compact resolution");
+        }
+        return static_cast<int64_t>(q);
+      }
+
+    private:
+      double scale_;
+      std::vector<uint8_t> buf_;
+    };
+
+    // ========================================================================
+    // Reader
+    // ========================================================================
+
+    class Reader
+    {
+    public:
+      Reader(const uint8_t *data, size_t size) : p_(data), end_(data + size) {}
+
+      void setScale(double scale) { scale_ = scale; }
+
+      bool done() const { return p_ == end_; }
+
+      uint8_t u8()
+      {
+        need(1);
+        return *p_++;
+      }
+
+      uint64_t varint()
+      {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+          uint8_t b = u8();
+          v |= static_cast<uint64_t>(b & 0x7f) << shift;
+          if (!(b & 0x80))
+          {
+            return v;
+          }
+        }
+        throw std::runtime_error("Malformed compact parse result: varint too long");
+      }
+
+      int64_t svarint()
+      {
+        uint64_t v = varint();
+        return static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1));
+      }
+
+      double f64()
+      {
+        need(8);
+        double v;
+        std::memcpy(&v, p_, 8);
+        p_ += 8;
+        return v;
+      }
+
+      std::string string()
+      {
+        uint64_t n = varint();
+        need(n);
+        std::string s(reinterpret_cast<const char *>(p_), n);
+        p_ += n;
+        return s;
+      }
+
+      /**
+       * Element count that cannot exceed the bytes left (every element
+       * takes at least one byte), so corrupt counts fail before allocating.
+       */
+      size_t count()
+      {
+        uint64_t n = varint();
+        need(n);
+        return static_cast<size_t>(n);
+      }
+
+      double dequantise(int64_t q) const { return static_cast<double>(q) / scale_; }
+
+    private:
+      const uint8_t *p_;
+      const uint8_t *end_;
+      double scale_ = 1.0;
+
+      void need(uint64_t n)
+      {
+        if (n > static_cast<uint64_t>(end_ - p_))
+        {
+          throw std::runtime_error("Malformed compact parse result: unexpected end of data");
+        }
+      }
+    };
+
+    // ========================================================================
+    // Encoding
+    // ========================================================================
+
+    class Encoder
+    {
+    public:
+      explicit Encoder(Writer &out) : out_(out) {}
+
+      void operation(const Operation &op)
+      {
+        std::visit([&](const auto &o)
+                   { encode(o); }, op);
+      }
+
+    private:
+      Writer &out_;
+      Quantised prev_ = {};
+      int prevLine_ = 0;
+
+      /**
+       * Type byte, extension varint and deltas of a position, then make it
+       * the new reference. `count` is 3 for Position3 ops.
+       */
+      void motion(OperationType type, const double *pos, int count, const int *lineNumber)
+      {
+        int64_t delta[AXES] = {};
+        unsigned mask = 0;
+        for (int i = 0; i < count; i++)
+        {
+          int64_t q = out_.quantise(pos[i]);
+          delta[i] = q - prev_[i];
+          prev_[i] = q;
+          if (delta[i] != 0)
+          {
+            mask |= 1u << i;
+          }
+        }
+
+        out_.u8(static_cast<uint8_t>(static_cast<int>(type) | ((mask & 0x7) << XYZ_SHIFT)));
+
+        uint64_t ext = mask >> 3;
+        if (lineNumber)
+        {
+          int64_t lineDelta = static_cast<int64_t>(*lineNumber) - prevLine_;
+          prevLine_ = *lineNumber;
+          ext |= ((static_cast<uint64_t>(lineDelta) << 1) ^ static_cast<uint64_t>(lineDelta >> 63)) << EXT_AXES;
+        }
+        out_.varint(ext);
+
+        for (int i = 0; i < count; i++)
+        {
+          if (mask & (1u << i))
+          {
+            out_.svarint(delta[i]);
+          }
+        }
+      }
+
+      void header(OperationType type) { out_.u8(static_cast<uint8_t>(type)); }
+
+      void offset(const Position &pos)
+      {
+        const double *v = axes(pos);
+        int64_t q[AXES];
+        unsigned mask = 0;
+        for (int i = 0; i < AXES; i++)
+        {
+          q[i] = out_.quantise(v[i]);
+          if (q[i] != 0)
+          {
+            mask |= 1u << i;
+          }
+        }
+        out_.varint(mask);
+        for (int i = 0; i < AXES; i++)
+        {
+          if (mask & (1u << i))
+          {
+            out_.svarint(q[i]);
+          }
+        }
+      }
+
+      void encode(const TraverseOp &op) { motion(op.type, axes(op.pos), AXES, &op.lineNumber); }
+      void encode(const FeedOp &op) { motion(op.type, axes(op.pos), AXES, &op.lineNumber); }
+      void encode(const ProbeOp &op) { motion(op.type, axes(op.pos), AXES, &op.lineNumber); }
+
+      void encode(const ArcOp &op)
+      {
+        // Centre relative to the start point, which is small and stable
+        int first, second, helix;
+        planeAxes(op.plane, first, second, helix);
+        int64_t startFirst = prev_[first];
+        int64_t startSecond = prev_[second];
+
+        motion(op.type, axes(op.pos), AXES, &op.lineNumber);
+
+        out_.u8(static_cast<uint8_t>(op.plane));
+        out_.svarint(op.arcData.rotation);
+        out_.svarint(out_.quantise(op.arcData.centerFirst) - startFirst);
+        out_.svarint(out_.quantise(op.arcData.centerSecond) - startSecond);
+        out_.svarint(out_.quantise(op.arcData.axisEndPoint) - prev_[helix]);
+      }
+
+      void encode(const RigidTapOp &op)
+      {
+        motion(op.type, &op.pos.x, 3, &op.lineNumber);
+        out_.f64(op.scale);
+      }
+
+      void encode(const DwellOp &op)
+      {
+        motion(op.type, axes(op.pos), AXES, nullptr);
+        out_.f64(op.duration);
+        out_.u8(static_cast<uint8_t>(op.plane));
+      }
+
+      template <typename ControlPoint, typename Extra>
+      void controlPoints(const std::vector<ControlPoint> &points, Extra &&extra)
+      {
+        out_.varint(points.size());
+        int64_t px = 0, py = 0;
+        for (const ControlPoint &cp : points)
+        {
+          int64_t x = out_.quantise(cp.x);
+          int64_t y = out_.quantise(cp.y);
+          out_.svarint(x - px);
+          out_.svarint(y - py);
+          px = x;
+          py = y;
+          extra(cp);
+        }
+      }
+
+      void encode(const NurbsG5Op &op)
+      {
+        motion(op.type, axes(op.pos), AXES, &op.lineNumber);
+        out_.u8(static_cast<uint8_t>(op.plane));
+        out_.varint(op.nurbsData.order);
+        controlPoints(op.nurbsData.controlPoints, [&](const NurbsG5ControlPoint &cp)
+                      { out_.f64(cp.weight); });
+      }
+
+      void encode(const NurbsG6Op &op)
+      {
+        motion(op.type, axes(op.pos), AXES, &op.lineNumber);
+        out_.u8(static_cast<uint8_t>(op.plane));
+        out_.varint(op.nurbsData.order);
+        controlPoints(op.nurbsData.controlPoints, [&](const NurbsG6ControlPoint &cp)
+                      {
+                        out_.f64(cp.r);
+                        out_.f64(cp.k); });
+      }
+
+      void encode(const UnitsChangeOp &op)
+      {
+        header(op.type);
+        out_.u8(static_cast<uint8_t>(op.units));
+      }
+
+      void encode(const PlaneChangeOp &op)
+      {
+        header(op.type);
+        out_.u8(static_cast<uint8_t>(op.plane));
+      }
+
+      void encode(const G5xOffsetOp &op)
+      {
+        header(op.type);
+        out_.svarint(op.origin);
+        offset(op.offset);
+      }
+
+      void encode(const G92OffsetOp &op)
+      {
+        header(op.type);
+        offset(op.offset);
+      }
+
+      void encode(const XYRotationOp &op)
+      {
+        header(op.type);
+        out_.f64(op.rotation);
+      }
+
+      void encode(const ToolOffsetOp &op)
+      {
+        header(op.type);
+        offset(op.offset);
+      }
+
+      void encode(const ToolChangeOp &op)
+      {
+        header(op.type);
+        out_.svarint(op.toolNumber);
+      }
+
+      void encode(const FeedRateChangeOp &op)
+      {
+        header(op.type);
+        out_.f64(op.feedRate);
+      }
+
+      void encode(const MotionModeChangeOp &op)
+      {
+        header(op.type);
+        out_.u8(static_cast<uint8_t>(op.mode));
+        out_.f64(op.tolerance);
+        out_.f64(op.naivecamTolerance);
+      }
+    };
+
+    // ========================================================================
+    // Decoding
+    // ========================================================================
+
+    class Decoder
+    {
+    public:
+      explicit Decoder(Reader &in) : in_(in) {}
+
+      Operation operation()
+      {
+        uint8_t head = in_.u8();
+        unsigned xyz = head >> XYZ_SHIFT;
+
+        switch (static_cast<OperationType>(head & TYPE_MASK))
+        {
+        case OperationType::TRAVERSE:
+        {
+          TraverseOp op;
+          motion(xyz, axes(op.pos), AXES, &op.lineNumber);
+          return op;
+        }
+        case OperationType::FEED:
+        {
+          FeedOp op;
+          motion(xyz, axes(op.pos), AXES, &op.lineNumber);
+          return op;
+        }
+        case OperationType::PROBE:
+        {
+          ProbeOp op;
+          motion(xyz, axes(op.pos), AXES, &op.lineNumber);
+          return op;
+        }
+        case OperationType::ARC:
+        {
+          ArcOp op;
+          Quantised start;
+          std::memcpy(start, prev_, sizeof(start));
+          motion(xyz, axes(op.pos), AXES, &op.lineNumber);
+
+          op.plane = static_cast<Plane>(in_.u8());
+          int first, second, helix;
+          planeAxes(op.plane, first, second, helix);
+          op.arcData.rotation = static_cast<int>(in_.svarint());
+          op.arcData.centerFirst = in_.dequantise(start[first] + in_.svarint());
+          op.arcData.centerSecond = in_.dequantise(start[second] + in_.svarint());
+          op.arcData.axisEndPoint = in_.dequantise(prev_[helix] + in_.svarint());
+          return op;
+        }
+        case OperationType::RIGID_TAP:
+        {
+          RigidTapOp op;
+          motion(xyz, &op.pos.x, 3, &op.lineNumber);
+          op.scale = in_.f64();
+          return op;
+        }
+        case OperationType::DWELL:
+        {
+          DwellOp op;
+          motion(xyz, axes(op.pos), AXES, nullptr);
+          op.duration = in_.f64();
+          op.plane = static_cast<Plane>(in_.u8());
+          return op;
+        }
+        case OperationType::NURBS_G5:
+        {
+          NurbsG5Op op;
+          motion(xyz, axes(op.pos), AXES, &op.lineNumber);
+          op.plane = static_cast<Plane>(in_.u8());
+          op.nurbsData.order = static_cast<unsigned int>(in_.varint());
+          controlPoints(op.nurbsData.controlPoints, [&](NurbsG5ControlPoint &cp)
+                        { cp.weight = in_.f64(); });
+          return op;
+        }
+        case OperationType::NURBS_G6:
+        {
+          NurbsG6Op op;
+          motion(xyz, axes(op.pos), AXES, &op.lineNumber);
+          op.plane = static_cast<Plane>(in_.u8());
+          op.nurbsData.order = static_cast<unsigned int>(in_.varint());
+          controlPoints(op.nurbsData.controlPoints, [&](NurbsG6ControlPoint &cp)
+                        {
+                          cp.r = in_.f64();
+                          cp.k = in_.f64(); });
+          return op;
+        }
+        case OperationType::UNITS_CHANGE:
+        {
+          UnitsChangeOp op;
+          op.units = static_cast<Units>(in_.u8());
+          return op;
+        }
+        case OperationType::PLANE_CHANGE:
+        {
+          PlaneChangeOp op;
+          op.plane = static_cast<Plane>(in_.u8());
+          return op;
+        }
+        case OperationType::G5X_OFFSET:
+        {
+          G5xOffsetOp op;
+          op.origin = static_cast<int>(in_.svarint());
+          offset(op.offset);
+          return op;
+        }
+        case OperationType::G92_OFFSET:
+        {
+          G92OffsetOp op;
+          offset(op.offset);
+          return op;
+        }
+        case OperationType::XY_ROTATION:
+        {
+          XYRotationOp op;
+          op.rotation = in_.f64();
+          return op;
+        }
+        case OperationType::TOOL_OFFSET:
+        {
+          ToolOffsetOp op;
+          offset(op.offset);
+          return op;
+        }
+        case OperationType::TOOL_CHANGE:
+        {
+          ToolChangeOp op;
+          op.toolNumber = static_cast<int>(in_.svarint());
+          return op;
+        }
+        case OperationType::FEED_RATE_CHANGE:
+        {
+          FeedRateChangeOp op;
+          op.feedRate = in_.f64();
+          return op;
+        }
+        case OperationType::MOTION_MODE_CHANGE:
+        {
+          MotionModeChangeOp op;
+          op.mode = static_cast<MotionMode>(in_.u8());
+          op.tolerance = in_.f64();
+          op.naivecamTolerance = in_.f64();
+          return op;
+        }
+        }
+
+        throw std::runtime_error("Malformed compact parse result: unknown operation type " +
+                                 std::to_string(head & TYPE_MASK));
+      }
+
+    private:
+      Reader &in_;
+      Quantised prev_ = {};
+      int prevLine_ = 0;
+
+      void motion(unsigned xyz, double *pos, int count, int *lineNumber)
+      {
+        uint64_t ext = in_.varint();
+        unsigned mask = xyz | static_cast<unsigned>((ext & EXT_MASK) << 3);
+        if (lineNumber)
+        {
+          uint64_t zz = ext >> EXT_AXES;
+          prevLine_ += static_cast<int>(static_cast<int64_t>((zz >> 1) ^ (~(zz & 1) + 1)));
+          *lineNumber = prevLine_;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+          if (mask & (1u << i))
+          {
+            prev_[i] += in_.svarint();
+          }
+          pos[i] = in_.dequantise(prev_[i]);
+        }
+      }
+
+      void offset(Position &pos)
+      {
+        double *v = axes(pos);
+        uint64_t mask = in_.varint();
+        for (int i = 0; i < AXES; i++)
+        {
+          v[i] = (mask & (1u << i)) ? in_.dequantise(in_.svarint()) : 0.0;
+        }
+      }
+
+      template <typename ControlPoint, typename Extra>
+      void controlPoints(std::vector<ControlPoint> &points, Extra &&extra)
+      {
+        points.resize(in_.count());
+        int64_t x = 0, y = 0;
+        for (ControlPoint &cp : points)
+        {
+          x += in_.svarint();
+          y += in_.svarint();
+          cp.x = in_.dequantise(x);
+          cp.y = in_.dequantise(y);
+          extra(cp);
+        }
+      }
+    };
+
+  } // namespace
+
+  std::vector<uint8_t> encodeCompact(const ParseResult &result, double resolution, bool withErrors)
+  {
+    if (!(resolution > 0.0) || !std::isfinite(resolution))
+    {
+      throw std::runtime_error("Compact resolution must be a positive number");
+    }
+
+    double scale = 1.0 / resolution;
+    Writer out(scale);
+    // Motion ops take ~4-8 bytes each
+    out.bytes().reserve(16 + result.operations.size() * 6);
+
+    out.u8('G');
+    out.u8('C');
+    out.u8('Z');
+    out.u8(COMPACT_VERSION);
+    out.f64(scale);
+    out.u8(withErrors ? HAS_ERRORS : 0);
+
+    out.varint(result.operations.size());
+    Encoder encoder(out);
+    for (const Operation &op : result.operations)
+    {
+      encoder.operation(op);
+    }
+
+    out.f64(result.extents.min.x);
+    out.f64(result.extents.min.y);
+    out.f64(result.extents.min.z);
+    out.f64(result.extents.max.x);
+    out.f64(result.extents.max.y);
+    out.f64(result.extents.max.z);
+
+    out.varint(result.dependencies.size());
+    for (const std::string &dep : result.dependencies)
+    {
+      out.string(dep);
+    }
+
+    if (withErrors)
+    {
+      out.varint(result.errors.size());
+      for (const ParseDiagnostic &diag : result.errors)
+      {
+        out.svarint(diag.lineNumber);
+        out.string(diag.filename);
+        out.string(diag.message);
+        out.string(diag.text);
+        out.u8(diag.fatal ? 1 : 0);
+      }
+    }
+
+    return std::move(out.bytes());
+  }
+
+  ParseResult decodeCompact(const uint8_t *data, size_t size, bool &withErrors)
+  {
+    Reader in(data, size);
+
+    if (size < 4 || data[0] != 'G' || data[1] != 'C' || data[2] != 'Z')
+    {
+      throw std::runtime_error("Not a compact parse result");
+    }
+    in.u8();
+    in.u8();
+    in.u8();
+    uint8_t version = in.u8();
+    if (version != COMPACT_VERSION)
+    {
+      throw std::runtime_error("Unsupported compact parse result version " + std::to_string(version));
+    }
+
+    double scale = in.f64();
+    if (!(scale > 0.0) || !std::isfinite(scale))
+    {
+      throw std::runtime_error("Malformed compact parse result: bad scale");
+    }
+    in.setScale(scale);
+    withErrors = (in.u8() & HAS_ERRORS) != 0;
+
+    ParseResult result;
+    size_t opCount = in.count();
+    result.operations.reserve(opCount);
+    Decoder decoder(in);
+    for (size_t i = 0; i < opCount; i++)
+    {
+      result.operations.push_back(decoder.operation());
+    }
+
+    result.extents.min.x = in.f64();
+    result.extents.min.y = in.f64();
+    result.extents.min.z = in.f64();
+    result.extents.max.x = in.f64();
+    result.extents.max.y = in.f64();
+    result.extents.max.z = in.f64();
+
+    size_t depCount = in.count();
+    result.dependencies.reserve(depCount);
+    for (size_t i = 0; i < depCount; i++)
+    {
+      result.dependencies.push_back(in.string());
+    }
+
+    if (withErrors)
+    {
+      size_t errorCount = in.count();
+      result.errors.resize(errorCount);
+      for (ParseDiagnostic &diag : result.errors)
+      {
+        diag.lineNumber = static_cast<int>(in.svarint());
+        diag.filename = in.string();
+        diag.message = in.string();
+        diag.text = in.string();
+        diag.fatal = in.u8() != 0;
+      }
+    }
+
+    if (!in.done())
+    {
+      throw std::runtime_error("Malformed compact parse result: trailing data");
+    }
+
+    return result;
+  }
+
+} // namespace GCodeParser
@@ -0,0 +1,49 @@
+/**
+ * Compact Codec - Header
+ *
+ * Compact binary transport form of a ParseResult for remote clients.
+ *
+ * Layout (all varints are LEB128, signed ones zigzag-encoded):
+ *   "GCZ" u8 version  f64 scale  u8 flags  varint opCount
+ *   ops...
+ *   f64 extents[6]  varint depCount  strings...
+ *   [flags & HAS_ERRORS] varint errorCount  diagnostics...
+ *
+ * Each op starts with one byte: the operation type in the low 5 bits and
+ * the changed X/Y/Z axes in the high 3 bits. Positions are quantised to
+ * 1/scale and stored as deltas from the previous position, so unchanged
+ * axes cost nothing. Ops with a position follow with one varint holding
+ * the line number delta and the changed A/B/C/U/V/W axes.
+ */
+
+#ifndef GCODE_COMPACT_CODEC_HH
+#define GCODE_COMPACT_CODEC_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "operation_types.hh"
+
+namespace GCodeParser
+{
+
+  constexpr uint8_t COMPACT_VERSION = 2;
+
+  /**
+   * Encode a parse result.
+   * @param resolution - Quantisation step for positions, in program units (mm)
+   * @param withErrors - Include result.errors (collect-errors mode)
+   * @throws std::runtime_error if a position does not fit at this resolution
+   */
+  std::vector<uint8_t> encodeCompact(const ParseResult &result, double resolution, bool withErrors);
+
+  /**
+   * Decode a buffer produced by encodeCompact.
+   * @param withErrors - Set to whether the buffer carried result.errors
+   * @throws std::runtime_error if the buffer is truncated or malformed
+   */
+  ParseResult decodeCompact(const uint8_t *data, size_t size, bool &withErrors);
+
+} // namespace GCodeParser
+
+#endif // GCODE_COMPACT_CODEC_HH
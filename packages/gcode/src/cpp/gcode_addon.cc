@@ -1,12 +1,31 @@
 /**
  * G-Code Addon - N-API Module Entry Point
  *
- * Exports the parseGCode function to JavaScript.
+ * Exports the parseGCode, prescanGCode, renderThumbnails, simulateToolpath
+ * and decodeParseResult functions and the PathSampler class to JavaScript.
+ *
+ * Threading model:
+ * - The addon is context-aware: every Node environment (main thread or
+ *   worker_thread) that loads it gets its own GCodeAddon instance.
+ * - Parsing runs on the libuv thread pool. The rs274ngc interpreters, their
+ *   canon state and the single-flight registry are process-wide and every
+ *   parse holds parser_mutex while the interpreter runs, so environments
+ *   share them safely but parse one program at a time.
+ * - Progress and result conversion run on the event loop of the environment
+ *   that called parseGCode, so calling it from a worker_thread keeps the
+ *   main event loop free of the JS object building.
  */
 
-#include <napi.h>
 #include <Python.h>
+#include "gcode_addon.hh"
+#include <algorithm>
 #include "parse_worker.hh"
+#include "prescan_worker.hh"
+#include "thumbnail_worker.hh"
+#include "path_sampler_wrap.hh"
+#include "planner_worker.hh"
+#include "napi_helpers.hh"
+#include "compact_codec.hh"
 #include "operation_types.hh"
 
 // Definitions required by librs274.so
@@ -23,8 +42,69 @@ struct _inittab builtin_modules[] = {
 namespace GCodeParser
 {
 
+  GCodeAddon::GCodeAddon(Napi::Env env, Napi::Object exports)
+      : envClosing_(std::make_shared<std::atomic<bool>>(false))
+  {
+    // Export parseGCode, prescanGCode, renderThumbnails, simulateToolpath and decodeParseResult functions
+    DefineAddon(exports, {
+                             InstanceMethod("parseGCode", &GCodeAddon::ParseGCode),
+                             InstanceMethod("prescanGCode", &GCodeAddon::PrescanGCode),
+                             InstanceMethod("renderThumbnails", &GCodeAddon::RenderThumbnails),
+                             InstanceMethod("simulateToolpath", &GCodeAddon::SimulateToolpath),
+                             InstanceMethod("decodeParseResult", &GCodeAddon::DecodeParseResult),
+                         });
+
+    // Export the PathSampler class
+    exports.Set("PathSampler", PathSamplerWrap::Init(env));
+
+    // Export operation type constants
+    exports.Set("OPERATION_TRAVERSE", Napi::Number::New(env, static_cast<int>(OperationType::TRAVERSE)));
+    exports.Set("OPERATION_FEED", Napi::Number::New(env, static_cast<int>(OperationType::FEED)));
+    exports.Set("OPERATION_ARC", Napi::Number::New(env, static_cast<int>(OperationType::ARC)));
+    exports.Set("OPERATION_PROBE", Napi::Number::New(env, static_cast<int>(OperationType::PROBE)));
+    exports.Set("OPERATION_RIGID_TAP", Napi::Number::New(env, static_cast<int>(OperationType::RIGID_TAP)));
+    exports.Set("OPERATION_DWELL", Napi::Number::New(env, static_cast<int>(OperationType::DWELL)));
+    exports.Set("OPERATION_NURBS_G5", Napi::Number::New(env, static_cast<int>(OperationType::NURBS_G5)));
+    exports.Set("OPERATION_NURBS_G6", Napi::Number::New(env, static_cast<int>(OperationType::NURBS_G6)));
+    exports.Set("OPERATION_UNITS_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::UNITS_CHANGE)));
+    exports.Set("OPERATION_PLANE_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::PLANE_CHANGE)));
+    exports.Set("OPERATION_G5X_OFFSET", Napi::Number::New(env, static_cast<int>(OperationType::G5X_OFFSET)));
+    exports.Set("OPERATION_G92_OFFSET", Napi::Number::New(env, static_cast<int>(OperationType::G92_OFFSET)));
+    exports.Set("OPERATION_XY_ROTATION", Napi::Number::New(env, static_cast<int>(OperationType::XY_ROTATION)));
+    exports.Set("OPERATION_TOOL_OFFSET", Napi::Number::New(env, static_cast<int>(OperationType::TOOL_OFFSET)));
+    exports.Set("OPERATION_TOOL_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::TOOL_CHANGE)));
+    exports.Set("OPERATION_FEED_RATE_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::FEED_RATE_CHANGE)));
+    exports.Set("OPERATION_MOTION_MODE_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::MOTION_MODE_CHANGE)));
+
+
+    // Export plane constants
+    exports.Set("PLANE_XY", Napi::Number::New(env, static_cast<int>(Plane::XY)));
+    exports.Set("PLANE_YZ", Napi::Number::New(env, static_cast<int>(Plane::YZ)));
+    exports.Set("PLANE_XZ", Napi::Number::New(env, static_cast<int>(Plane::XZ)));
+    exports.Set("PLANE_UV", Napi::Number::New(env, static_cast<int>(Plane::UV)));
+    exports.Set("PLANE_VW", Napi::Number::New(env, static_cast<int>(Plane::VW)));
+    exports.Set("PLANE_UW", Napi::Number::New(env, static_cast<int>(Plane::UW)));
+
+    // Export units constants
+    exports.Set("UNITS_INCHES", Napi::Number::New(env, static_cast<int>(Units::INCHES)));
+    exports.Set("UNITS_MM", Napi::Number::New(env, static_cast<int>(Units::MM)));
+    exports.Set("UNITS_CM", Napi::Number::New(env, static_cast<int>(Units::CM)));
+
+    // Export thumbnail view constants
+    exports.Set("THUMBNAIL_VIEW_TOP", Napi::Number::New(env, static_cast<int>(ThumbnailView::TOP)));
+    exports.Set("THUMBNAIL_VIEW_FRONT", Napi::Number::New(env, static_cast<int>(ThumbnailView::FRONT)));
+    exports.Set("THUMBNAIL_VIEW_SIDE", Napi::Number::New(env, static_cast<int>(ThumbnailView::SIDE)));
+    exports.Set("THUMBNAIL_VIEW_ISO", Napi::Number::New(env, static_cast<int>(ThumbnailView::ISO)));
+  }
+
+  GCodeAddon::~GCodeAddon()
+  {
+    // Environment teardown: queued parses for this env can skip the interpreter
+    envClosing_->store(true);
+  }
+
   /**
-   * parseGCode(filepath, iniPath, progressUpdates, progressCallback, callback)
+   * parseGCode(filepath, iniPath, progressUpdates, progressCallback, callback[, maxErrors[, compactResolution[, profileLines]]])
    *
    * Asynchronously parse a G-code file.
    *
@@ -33,8 +113,15 @@ namespace GCodeParser
    * @param progressUpdates - Target number of progress updates (0 to disable)
    * @param progressCallback - Function called with progress updates
    * @param callback - Function called with (error, result) when complete
+   * @param maxErrors - Collect up to this many interpreter errors into
+   *                    result.errors instead of failing (optional, 0 = fail)
+   * @param compactResolution - Deliver the result as a compact-encoded Buffer
+   *                            with positions quantised to this step
+   *                            (optional, 0 = JS objects)
+   * @param profileLines - Profile the run and report this many of the hottest
+   *                       lines in result.profile (optional, 0 = off)
    */
-  Napi::Value ParseGCode(const Napi::CallbackInfo &info)
+  Napi::Value GCodeAddon::ParseGCode(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
@@ -81,62 +168,293 @@ namespace GCodeParser
       return env.Undefined();
     }
 
+    if (info.Length() > 5 && !info[5].IsUndefined() && !info[5].IsNumber())
+    {
+      Napi::TypeError::New(env, "maxErrors must be a number")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (info.Length() > 6 && !info[6].IsUndefined() && !info[6].IsNumber())
+    {
+      Napi::TypeError::New(env, "compactResolution must be a number")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (info.Length() > 7 && !info[7].IsUndefined() && !info[7].IsNumber())
+    {
+      Napi::TypeError::New(env, "profileLines must be a number")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
     std::string filepath = info[0].As<Napi::String>().Utf8Value();
     std::string iniPath = info[1].As<Napi::String>().Utf8Value();
     int progressUpdates = info[2].As<Napi::Number>().Int32Value();
     Napi::Function progressCallback = info[3].As<Napi::Function>();
     Napi::Function callback = info[4].As<Napi::Function>();
+    int maxErrors = info.Length() > 5 && info[5].IsNumber() ? info[5].As<Napi::Number>().Int32Value() : 0;
+    double compactResolution = info.Length() > 6 && info[6].IsNumber() ? info[6].As<Napi::Number>().DoubleValue() : 0.0;
+    int profileLines = info.Length() > 7 && info[7].IsNumber() ? info[7].As<Napi::Number>().Int32Value() : 0;
 
     // Create and queue async worker
-    ParseWorker *worker = new ParseWorker(callback, progressCallback, filepath, iniPath, progressUpdates);
+    ParseWorker *worker = new ParseWorker(callback, progressCallback, filepath, iniPath, progressUpdates, maxErrors, compactResolution, profileLines, envClosing_);
     worker->Queue();
 
     return env.Undefined();
   }
 
   /**
-   * Module initialization
+   * prescanGCode(filepath, maxIssues, callback)
+   *
+   * Asynchronously pre-scan a G-code file without the interpreter.
+   *
+   * @param filepath - Path to the G-code file
+   * @param maxIssues - Maximum number of issues to record
+   * @param callback - Function called with (error, result) when complete
    */
-  Napi::Object Init(Napi::Env env, Napi::Object exports)
+  Napi::Value GCodeAddon::PrescanGCode(const Napi::CallbackInfo &info)
   {
-    // Export parseGCode function
-    exports.Set("parseGCode", Napi::Function::New(env, ParseGCode));
+    Napi::Env env = info.Env();
 
-    // Export operation type constants
-    exports.Set("OPERATION_TRAVERSE", Napi::Number::New(env, static_cast<int>(OperationType::TRAVERSE)));
-    exports.Set("OPERATION_FEED", Napi::Number::New(env, static_cast<int>(OperationType::FEED)));
-    exports.Set("OPERATION_ARC", Napi::Number::New(env, static_cast<int>(OperationType::ARC)));
-    exports.Set("OPERATION_PROBE", Napi::Number::New(env, static_cast<int>(OperationType::PROBE)));
-    exports.Set("OPERATION_RIGID_TAP", Napi::Number::New(env, static_cast<int>(OperationType::RIGID_TAP)));
-    exports.Set("OPERATION_DWELL", Napi::Number::New(env, static_cast<int>(OperationType::DWELL)));
-    exports.Set("OPERATION_NURBS_G5", Napi::Number::New(env, static_cast<int>(OperationType::NURBS_G5)));
-    exports.Set("OPERATION_NURBS_G6", Napi::Number::New(env, static_cast<int>(OperationType::NURBS_G6)));
-    exports.Set("OPERATION_UNITS_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::UNITS_CHANGE)));
-    exports.Set("OPERATION_PLANE_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::PLANE_CHANGE)));
-    exports.Set("OPERATION_G5X_OFFSET", Napi::Number::New(env, static_cast<int>(OperationType::G5X_OFFSET)));
-    exports.Set("OPERATION_G92_OFFSET", Napi::Number::New(env, static_cast<int>(OperationType::G92_OFFSET)));
-    exports.Set("OPERATION_XY_ROTATION", Napi::Number::New(env, static_cast<int>(OperationType::XY_ROTATION)));
-    exports.Set("OPERATION_TOOL_OFFSET", Napi::Number::New(env, static_cast<int>(OperationType::TOOL_OFFSET)));
-    exports.Set("OPERATION_TOOL_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::TOOL_CHANGE)));
-    exports.Set("OPERATION_FEED_RATE_CHANGE", Napi::Number::New(env, static_cast<int>(OperationType::FEED_RATE_CHANGE)));
+    if (info.Length() < 3)
+    {
+      Napi::TypeError::New(env, "Expected 3 arguments: filepath, maxIssues, callback")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
 
+    if (!info[0].IsString())
+    {
+      Napi::TypeError::New(env, "filepath must be a string")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
 
-    // Export plane constants
-    exports.Set("PLANE_XY", Napi::Number::New(env, static_cast<int>(Plane::XY)));
-    exports.Set("PLANE_YZ", Napi::Number::New(env, static_cast<int>(Plane::YZ)));
-    exports.Set("PLANE_XZ", Napi::Number::New(env, static_cast<int>(Plane::XZ)));
-    exports.Set("PLANE_UV", Napi::Number::New(env, static_cast<int>(Plane::UV)));
-    exports.Set("PLANE_VW", Napi::Number::New(env, static_cast<int>(Plane::VW)));
-    exports.Set("PLANE_UW", Napi::Number::New(env, static_cast<int>(Plane::UW)));
+    if (!info[1].IsNumber())
+    {
+      Napi::TypeError::New(env, "maxIssues must be a number")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
 
-    // Export units constants
-    exports.Set("UNITS_INCHES", Napi::Number::New(env, static_cast<int>(Units::INCHES)));
-    exports.Set("UNITS_MM", Napi::Number::New(env, static_cast<int>(Units::MM)));
-    exports.Set("UNITS_CM", Napi::Number::New(env, static_cast<int>(Units::CM)));
+    if (!info[2].IsFunction())
+    {
+      Napi::TypeError::New(env, "callback must be a function")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    std::string filepath = info[0].As<Napi::String>().Utf8Value();
+    int maxIssues = info[1].As<Napi::Number>().Int32Value();
+    Napi::Function callback = info[2].As<Napi::Function>();
+
+    PrescanWorker *worker = new PrescanWorker(callback, filepath, static_cast<size_t>(std::max(maxIssues, 0)));
+    worker->Queue();
+
+    return env.Undefined();
+  }
 
-    return exports;
+  /**
+   * renderThumbnails(results, options, threads, callback)
+   *
+   * Asynchronously rasterize one RGBA thumbnail per parse result.
+   *
+   * @param results - Array of parse results from parseGCode
+   * @param options - Size, view, padding and colours
+   * @param threads - Maximum rendering threads (0 = one per CPU)
+   * @param callback - Function called with (error, images) when complete
+   */
+  Napi::Value GCodeAddon::RenderThumbnails(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 4)
+    {
+      Napi::TypeError::New(env, "Expected 4 arguments: results, options, threads, callback")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (!info[0].IsArray())
+    {
+      Napi::TypeError::New(env, "results must be an array")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (!info[1].IsObject())
+    {
+      Napi::TypeError::New(env, "options must be an object")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (!info[2].IsNumber())
+    {
+      Napi::TypeError::New(env, "threads must be a number")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (!info[3].IsFunction())
+    {
+      Napi::TypeError::New(env, "callback must be a function")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Array results = info[0].As<Napi::Array>();
+    ThumbnailOptions options = ThumbnailWorker::optionsFromJS(info[1].As<Napi::Object>());
+    int threads = info[2].As<Napi::Number>().Int32Value();
+    Napi::Function callback = info[3].As<Napi::Function>();
+
+    // The JS results may change after this call returns, so copy the motion now
+    std::vector<std::vector<ThumbnailSegment>> paths;
+    paths.reserve(results.Length());
+    for (uint32_t i = 0; i < results.Length(); i++)
+    {
+      Napi::Value result = results.Get(i);
+      if (!result.IsObject())
+      {
+        Napi::TypeError::New(env, "results must contain parse results")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      paths.push_back(ThumbnailWorker::pathFromJS(env, result.As<Napi::Object>()));
+    }
+
+    ThumbnailWorker *worker = new ThumbnailWorker(callback, std::move(paths), options, static_cast<unsigned>(std::max(threads, 0)));
+    worker->Queue();
+
+    return env.Undefined();
+  }
+
+  /**
+   * simulateToolpath(source, iniPath, options, callback)
+   *
+   * Asynchronously simulate the trajectory planner over a parse result.
+   *
+   * @param source - Parse result from parseGCode, or its compact encoding
+   * @param iniPath - LinuxCNC INI file with the machine limits ("" to take
+   *                  them from options.limits only)
+   * @param options - Blending, overrides, sampling and limit overrides
+   * @param callback - Function called with (error, simulation) when complete
+   */
+  Napi::Value GCodeAddon::SimulateToolpath(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 4)
+    {
+      Napi::TypeError::New(env, "Expected 4 arguments: source, iniPath, options, callback")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (!info[0].IsObject())
+    {
+      Napi::TypeError::New(env, "source must be a parse result or a Uint8Array")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (!info[1].IsString())
+    {
+      Napi::TypeError::New(env, "iniPath must be a string")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (!info[2].IsObject())
+    {
+      Napi::TypeError::New(env, "options must be an object")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (!info[3].IsFunction())
+    {
+      Napi::TypeError::New(env, "callback must be a function")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    std::string iniPath = info[1].As<Napi::String>().Utf8Value();
+    MachineLimits overrides;
+    PlannerOptions options = PlannerWorker::optionsFromJS(info[2].As<Napi::Object>(), overrides);
+    Napi::Function callback = info[3].As<Napi::Function>();
+
+    if (!(options.feedOverride > 0.0) || !(options.rapidOverride > 0.0))
+    {
+      Napi::RangeError::New(env, "feedOverride and rapidOverride must be positive")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    // The JS result may change after this call returns, so copy the toolpath now
+    Toolpath path;
+    if (info[0].IsTypedArray() && info[0].As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array)
+    {
+      Napi::Uint8Array buffer = info[0].As<Napi::Uint8Array>();
+      try
+      {
+        bool withErrors = false;
+        path = toolpathFromResult(decodeCompact(buffer.Data(), buffer.ByteLength(), withErrors));
+      }
+      catch (const std::runtime_error &e)
+      {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+    else
+    {
+      path = toolpathFromJS(env, info[0].As<Napi::Object>());
+    }
+
+    PlannerWorker *worker = new PlannerWorker(callback, std::move(path), iniPath, overrides, options);
+    worker->Queue();
+
+    return env.Undefined();
+  }
+
+  /**
+   * decodeParseResult(buffer)
+   *
+   * Synchronously decode a compact-encoded parse result into its JS form.
+   *
+   * @param buffer - Buffer or Uint8Array from parseGCode with compactResolution
+   * @returns Parse result object, as parseGCode returns it
+   */
+  Napi::Value GCodeAddon::DecodeParseResult(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsTypedArray() ||
+        info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array)
+    {
+      Napi::TypeError::New(env, "buffer must be a Uint8Array")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Uint8Array buffer = info[0].As<Napi::Uint8Array>();
+
+    try
+    {
+      bool withErrors = false;
+      ParseResult result = decodeCompact(buffer.Data(), buffer.ByteLength(), withErrors);
+      return ParseWorker::resultToJS(env, result, withErrors);
+    }
+    catch (const std::runtime_error &e)
+    {
+      Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
   }
 
-  NODE_API_MODULE(gcode_addon, Init)
+  NODE_API_ADDON(GCodeAddon)
 
 } // namespace GCodeParser
@@ -0,0 +1,56 @@
+/**
+ * G-Code Addon - Header
+ *
+ * Per-environment addon instance. One is created for each Node environment
+ * (main thread or worker_thread) that loads gcode_addon.node.
+ */
+
+#ifndef GCODE_ADDON_HH
+#define GCODE_ADDON_HH
+
+#include <napi.h>
+#include <atomic>
+#include <memory>
+
+namespace GCodeParser
+{
+
+  class GCodeAddon : public Napi::Addon<GCodeAddon>
+  {
+  public:
+    GCodeAddon(Napi::Env env, Napi::Object exports);
+    ~GCodeAddon();
+
+  private:
+    /**
+     * parseGCode(filepath, iniPath, progressUpdates, progressCallback, callback[, maxErrors[, compactResolution[, profileLines]]])
+     */
+    Napi::Value ParseGCode(const Napi::CallbackInfo &info);
+
+    /**
+     * prescanGCode(filepath, maxIssues, callback)
+     */
+    Napi::Value PrescanGCode(const Napi::CallbackInfo &info);
+
+    /**
+     * renderThumbnails(results, options, threads, callback)
+     */
+    Napi::Value RenderThumbnails(const Napi::CallbackInfo &info);
+
+    /**
+     * simulateToolpath(source, iniPath, options, callback)
+     */
+    Napi::Value SimulateToolpath(const Napi::CallbackInfo &info);
+
+    /**
+     * decodeParseResult(buffer)
+     */
+    Napi::Value DecodeParseResult(const Napi::CallbackInfo &info);
+
+    // Set when this environment is torn down; shared with its queued workers
+    std::shared_ptr<std::atomic<bool>> envClosing_;
+  };
+
+} // namespace GCodeParser
+
+#endif // GCODE_ADDON_HH
@@ -4,8 +4,12 @@
  * Core parser that uses LinuxCNC's rs274ngc interpreter to parse G-code files.
  */
 
+#include <Python.h>
+
 #include "gcode_parser.hh"
 #include "canon_preview.hh"
+#include "prescan.hh"
+#include "profiler.hh"
 
 // Public LinuxCNC headers only - no internal source dependencies
 #include "interp_base.hh"
@@ -13,9 +17,17 @@
 #include "tooldata.hh"
 
 #include <sys/stat.h>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
 #include <stdexcept>
 #include <cstring>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <set>
+#include <unordered_map>
+#include <variant>
 
 namespace GCodeParser
 {
@@ -24,17 +36,184 @@ namespace GCodeParser
 #define RESULT_OK(r) ((r) == INTERP_OK || (r) == INTERP_EXECUTE_FINISH)
 
   std::mutex parser_mutex;
-  static InterpBase *global_interp = nullptr;
-  static std::string last_ini_path;
+
+  /**
+   * Canonical absolute path, or the path unchanged if it cannot be resolved.
+   */
+  static std::string canonicalPath(const std::string &path)
+  {
+    char resolved[PATH_MAX];
+    if (realpath(path.c_str(), resolved))
+    {
+      return resolved;
+    }
+    return path;
+  }
+
+  /**
+   * Holds the GIL for the remap/o-word Python that runs inside one parse.
+   *
+   * librs274 starts the embedded interpreter lazily from ini_load(), on
+   * whichever thread-pool thread is parsing, and that thread keeps the GIL.
+   * The guard takes the GIL per parse through PyGILState (so any pool thread
+   * can run the next parse) and releases it afterwards, leaving it free
+   * between parses instead of pinned to the first parsing thread.
+   */
+  class PythonGilGuard
+  {
+  public:
+    PythonGilGuard()
+    {
+      if (Py_IsInitialized())
+      {
+        state_ = PyGILState_Ensure();
+        ensured_ = true;
+      }
+    }
+
+    ~PythonGilGuard()
+    {
+      if (ensured_)
+      {
+        PyGILState_Release(state_);
+      }
+      else if (Py_IsInitialized() && PyGILState_Check())
+      {
+        // Python was started during this parse; this thread owns the GIL
+        PyEval_SaveThread();
+      }
+    }
+
+    PythonGilGuard(const PythonGilGuard &) = delete;
+    PythonGilGuard &operator=(const PythonGilGuard &) = delete;
+
+  private:
+    PyGILState_STATE state_ = PyGILState_UNLOCKED;
+    bool ensured_ = false;
+  };
+
+  /**
+   * An interpreter kept initialised for one INI file.
+   * Reloaded when the INI's mtime changes; canon globals are swapped per entry.
+   */
+  struct CachedInterp
+  {
+    std::string iniPath;
+    struct timespec iniMtime = {0, 0};
+    InterpBase *interp = nullptr;
+    CanonState canon;
+  };
+
+  // Most recently used first; guarded by parser_mutex
+  static constexpr size_t INTERP_CACHE_SIZE = 4;
+  static std::list<CachedInterp> interp_cache;
+  static CachedInterp *active_interp = nullptr;
+
+  // INI_FILE_NAME as last set by acquireInterp; guarded by parser_mutex
+  static std::string env_ini_path;
+
+  /**
+   * Return an initialised interpreter for `iniPath`, loading it on a miss and
+   * evicting the least recently used entry when the cache is full.
+   * The returned entry's canon state is active on return.
+   *
+   * Only the interpreter and canon state are per entry. librs274 configures
+   * its embedded Python once per process, from the [PYTHON] section of the
+   * first INI loaded, so every entry runs the remap and o-word modules that
+   * INI imported. INIs with different Python remaps need separate processes,
+   * e.g. one ParsePool per INI.
+   *
+   * INI_FILE_NAME is process-wide and setenv() races getenv() on other
+   * threads (libuv, other addons). It is only rewritten when the INI
+   * differs from the last parse, so a process using one INI sets it once.
+   */
+  static CachedInterp &acquireInterp(const std::string &iniPath)
+  {
+    struct stat iniStat;
+    if (stat(iniPath.c_str(), &iniStat) != 0)
+    {
+      throw std::runtime_error("Failed to load INI file: " + iniPath);
+    }
+
+    // Park the canon state of whichever interpreter ran last
+    if (active_interp)
+    {
+      saveCanonState(active_interp->canon);
+      active_interp = nullptr;
+    }
+
+    auto it = interp_cache.begin();
+    for (; it != interp_cache.end(); ++it)
+    {
+      if (it->iniPath == iniPath)
+      {
+        break;
+      }
+    }
+
+    if (it != interp_cache.end())
+    {
+      interp_cache.splice(interp_cache.begin(), interp_cache, it);
+    }
+    else
+    {
+      if (interp_cache.size() >= INTERP_CACHE_SIZE)
+      {
+        delete interp_cache.back().interp;
+        interp_cache.pop_back();
+      }
+
+      CachedInterp entry;
+      entry.iniPath = iniPath;
+      entry.interp = makeInterp();
+      if (!entry.interp)
+      {
+        throw std::runtime_error("Failed to create interpreter");
+      }
+      interp_cache.push_front(std::move(entry));
+    }
+
+    CachedInterp &entry = interp_cache.front();
+    restoreCanonState(entry.canon);
+    active_interp = &entry;
+
+    // The interpreter re-reads INI_FILE_NAME in init(); point it at this entry
+    if (env_ini_path != iniPath)
+    {
+      setenv("INI_FILE_NAME", iniPath.c_str(), 1);
+      env_ini_path = iniPath;
+    }
+
+    if (entry.iniMtime.tv_sec != iniStat.st_mtim.tv_sec ||
+        entry.iniMtime.tv_nsec != iniStat.st_mtim.tv_nsec)
+    {
+      if (entry.interp->ini_load(iniPath.c_str()) != 0)
+      {
+        throw std::runtime_error("Failed to load INI file: " + iniPath);
+      }
+      entry.iniMtime = iniStat.st_mtim;
+    }
+
+    return entry;
+  }
 
   ParseResult parseFile(
       const std::string &filepath,
       const std::string &iniPath,
       std::function<void(const ParseProgress &)> progressCallback,
-      int progressUpdates)
+      int progressUpdates,
+      int maxErrors,
+      int profileLines)
   {
     // Serialize access to the interpreter
     std::lock_guard<std::mutex> lock(parser_mutex);
+    PythonGilGuard gil;
+
+    std::unique_ptr<LineProfiler> profiler;
+    if (profileLines > 0)
+    {
+      profiler = std::make_unique<LineProfiler>(static_cast<size_t>(profileLines));
+    }
 
     // Validate file exists
     struct stat fileStat;
@@ -43,6 +222,16 @@ namespace GCodeParser
       throw std::runtime_error("G-code file not found: " + filepath);
     }
 
+    std::vector<ParseDiagnostic> diagnostics;
+
+    // Files opened by the interpreter besides the program itself
+    const std::string programPath = canonicalPath(filepath);
+    std::vector<std::string> dependencies;
+    std::set<std::string> seenFiles;
+    // Resolved path per name the interpreter reports; subroutine calls in
+    // a loop would otherwise hit realpath() on every call and return
+    std::unordered_map<std::string, std::string> resolvedNames;
+
     // Create parse context
     ParseContext ctx;
     ctx.progressCallback = progressCallback;
@@ -52,41 +241,29 @@ namespace GCodeParser
     // Set as current context
     setParseContext(&ctx);
 
-    // Create interpreter if not exists
-    if (!global_interp)
-    {
-      global_interp = makeInterp();
-      if (!global_interp)
-      {
-        clearParseContext();
-        throw std::runtime_error("Failed to create interpreter");
-      }
-    }
+    InterpBase *interp = nullptr;
 
     try
     {
-      // Initialize interpreter if INI changed or first run
-      if (last_ini_path != iniPath)
-      {
-        if (global_interp->ini_load(iniPath.c_str()) != 0)
-        {
-          throw std::runtime_error("Failed to load INI file: " + iniPath);
-        }
-        if (global_interp->init() != 0)
-        {
-          throw std::runtime_error("Failed to initialize interpreter");
-        }
-        last_ini_path = iniPath;
-      }
-      else
+      CachedInterp &entry = acquireInterp(iniPath);
+      interp = entry.interp;
+
+      // Reset interpreter state for this parse
+      if (interp->init() != 0)
       {
-        // For same INI, we still need to ensure clean state
-        if (global_interp->init() != 0)
-        {
-          throw std::runtime_error("Failed to initialize interpreter");
-        }
+        // Force a full reload next time in case the INI is unusable
+        entry.iniMtime = {0, 0};
+        throw std::runtime_error("Failed to initialize interpreter");
       }
 
+      // The path control mode set by init() (the interpreter default and
+      // the INI's startup code) is left to the planner options; only the
+      // program's own G61/G64 are recorded
+      ctx.operations.erase(std::remove_if(ctx.operations.begin(), ctx.operations.end(),
+                                          [](const Operation &op)
+                                          { return std::holds_alternative<MotionModeChangeOp>(op); }),
+                           ctx.operations.end());
+
       // Initialize tool data
       if (tool_mmap_user() != 0)
       {
@@ -94,7 +271,7 @@ namespace GCodeParser
       }
 
       // Open the G-code file
-      if (global_interp->open(filepath.c_str()) != 0)
+      if (interp->open(filepath.c_str()) != 0)
       {
         throw std::runtime_error("Failed to open G-code file: " + filepath);
       }
@@ -103,45 +280,166 @@ namespace GCodeParser
       int result = INTERP_OK;
       size_t lineCount = 0;
 
+      // Line index of the program for byte-accurate progress; falls back to
+      // an estimate (~25 bytes per line average for G-code) if unavailable
+      std::vector<uint64_t> lineOffsets;
+      if (progressCallback)
+      {
+        indexFileLines(filepath, lineOffsets);
+      }
+      size_t mainLine = 0;
+      int lastCallLevel = 0;
+
+      if (profiler)
+      {
+        profiler->enterFile(programPath);
+      }
+
       // Adaptive progress interval: aim for ~progressUpdates total updates
-      // Estimate lines based on file size (~25 bytes per line average for G-code)
-      const size_t estimatedLines = std::max(ctx.totalBytes / 25, size_t(100));
+      const size_t estimatedLines = lineOffsets.empty()
+          ? std::max(ctx.totalBytes / 25, size_t(100))
+          : lineOffsets.size();
       const size_t progressInterval = progressUpdates > 0 
           ? std::max(estimatedLines / static_cast<size_t>(progressUpdates), size_t(1))
           : SIZE_MAX; // Effectively disable if progressUpdates is 0
 
-      while (RESULT_OK(result))
+      while (true)
       {
-        result = global_interp->read();
-        if (!RESULT_OK(result))
+        uint64_t blockStart = profiler ? profileTicks() : 0;
+        uint64_t blockCanonCalls = ctx.canonCalls;
+
+        result = interp->read();
+
+        // Entering or leaving a subroutine may switch the file being read
+        // (external o<name> subs, ngc remap bodies); record each new one
+        int callLevel = interp->call_level();
+        if (callLevel != lastCallLevel)
         {
-          break;
+          uint64_t lookupStart = profiler ? profileTicks() : 0;
+
+          char nameBuf[PATH_MAX];
+          const char *name = interp->file_name(nameBuf, sizeof(nameBuf));
+          auto resolved = resolvedNames.find(name);
+          if (resolved == resolvedNames.end())
+          {
+            resolved = resolvedNames.emplace(name, canonicalPath(name)).first;
+          }
+          const std::string &current = resolved->second;
+          if (!current.empty() && current != programPath && seenFiles.insert(current).second)
+          {
+            dependencies.push_back(current);
+          }
+          if (profiler)
+          {
+            profiler->enterFile(current.empty() ? programPath : current);
+            if (callLevel > lastCallLevel)
+            {
+              profiler->enterCall();
+            }
+            // Keep the bookkeeping out of the block's time
+            blockStart += profileTicks() - lookupStart;
+          }
+          lastCallLevel = callLevel;
+        }
+
+        // Line and text of the block just read; execute() may move on
+        // (o-word jumps). Text is only fetched the first time a line runs.
+        int blockLine = 0;
+        char blockText[256];
+        const char *blockTextPtr = nullptr;
+        if (profiler)
+        {
+          blockLine = interp->sequence_number();
+          if (profiler->isNewLine(blockLine))
+          {
+            blockTextPtr = interp->line_text(blockText, sizeof(blockText));
+          }
         }
 
-        result = global_interp->execute();
-        lineCount++;
+        if (RESULT_OK(result))
+        {
+          result = interp->execute();
+          lineCount++;
+
+          // Report progress periodically
+          if (progressCallback && (lineCount % progressInterval == 0))
+          {
+            size_t bytesRead;
+            if (!lineOffsets.empty())
+            {
+              // Position in the main program; subroutine lines don't count
+              if (interp->call_level() == 0)
+              {
+                mainLine = std::max(mainLine, static_cast<size_t>(std::max(interp->sequence_number(), 0)));
+              }
+              bytesRead = mainLine < lineOffsets.size() ? lineOffsets[mainLine] : ctx.totalBytes;
+            }
+            else
+            {
+              // Estimate bytes based on line count (rough approximation)
+              bytesRead = (ctx.totalBytes * lineCount) /
+                          std::max(lineCount + 100, size_t(1));
+            }
+            ctx.reportProgress(std::min(bytesRead, ctx.totalBytes));
+          }
+        }
 
-        // Report progress periodically
-        if (progressCallback && (lineCount % progressInterval == 0))
+        if (profiler)
         {
-          // Estimate bytes based on line count (rough approximation)
-          size_t estimatedBytes = (ctx.totalBytes * lineCount) /
-                                  std::max(lineCount + 100, size_t(1));
-          estimatedBytes = std::min(estimatedBytes, ctx.totalBytes);
-          ctx.reportProgress(estimatedBytes);
+          profiler->record(blockLine, profileTicks() - blockStart, ctx.canonCalls - blockCanonCalls, blockTextPtr);
+        }
+
+        if (RESULT_OK(result))
+        {
+          continue;
+        }
+
+        // End of file is not an error
+        if (result == INTERP_ENDFILE || result == INTERP_EXIT)
+        {
+          break;
         }
-      }
 
-      // Check for errors (but not end of file)
-      if (result != INTERP_ENDFILE && result != INTERP_EXIT && !RESULT_OK(result))
-      {
         char errBuf[256];
-        global_interp->error_text(result, errBuf, sizeof(errBuf));
-        throw std::runtime_error(std::string("G-code parse error: ") + errBuf);
+        interp->error_text(result, errBuf, sizeof(errBuf));
+
+        if (maxErrors <= 0)
+        {
+          throw std::runtime_error(std::string("G-code parse error: ") + errBuf);
+        }
+
+        ParseDiagnostic diag;
+        char textBuf[256];
+        diag.lineNumber = interp->sequence_number();
+        diag.filename = interp->file_name(textBuf, sizeof(textBuf));
+        diag.message = errBuf;
+        diag.text = interp->line_text(textBuf, sizeof(textBuf));
+
+        // The interpreter failed on the same line again: no forward progress
+        if (!diagnostics.empty() &&
+            diagnostics.back().lineNumber == diag.lineNumber &&
+            diagnostics.back().filename == diag.filename)
+        {
+          diagnostics.back().fatal = true;
+          break;
+        }
+
+        // Recovery is only possible at the top level: an error inside a
+        // subroutine leaves the o-word call stack mid-unwind
+        diag.fatal = interp->call_level() > 0 ||
+                     diagnostics.size() + 1 >= static_cast<size_t>(maxErrors);
+        diagnostics.push_back(std::move(diag));
+
+        if (diagnostics.back().fatal)
+        {
+          break;
+        }
+
+        // Otherwise skip the failing block and carry on with the next line
       }
 
       // Close interpreter (file)
-      global_interp->close();
+      interp->close();
 
       // Final progress report
       if (progressCallback)
@@ -152,8 +450,8 @@ namespace GCodeParser
     catch (...)
     {
       // Cleanup on error
-      if (global_interp) {
-          global_interp->close();
+      if (interp) {
+          interp->close();
       }
       clearParseContext();
       throw;
@@ -173,6 +471,12 @@ namespace GCodeParser
     ParseResult parseResult;
     parseResult.operations = std::move(ctx.operations);
     parseResult.extents = ctx.extents;
+    parseResult.errors = std::move(diagnostics);
+    parseResult.dependencies = std::move(dependencies);
+    if (profiler)
+    {
+      parseResult.profile = std::make_shared<const ParseProfile>(profiler->finish());
+    }
 
     return parseResult;
   }
@@ -21,14 +21,21 @@ namespace GCodeParser
    * @param iniPath Path to the LinuxCNC INI file
    * @param progressCallback Optional callback for progress updates
    * @param progressUpdates Target number of progress updates (0 to disable, default 40)
-   * @return ParseResult containing operations and extents
-   * @throws std::runtime_error on parse failure
+   * @param maxErrors Collect up to this many interpreter errors instead of
+   *                  throwing at the first one (0 = throw, default)
+   * @param profileLines Profile the run and report this many of the hottest
+   *                     lines in result.profile (0 = no profiling, default)
+   * @return ParseResult containing operations and extents, plus diagnostics
+   *         and the operations parsed so far in collect-errors mode
+   * @throws std::runtime_error on parse failure (setup failures always throw)
    */
   ParseResult parseFile(
       const std::string &filepath,
       const std::string &iniPath,
       std::function<void(const ParseProgress &)> progressCallback = nullptr,
-      int progressUpdates = 40);
+      int progressUpdates = 40,
+      int maxErrors = 0,
+      int profileLines = 0);
 
 } // namespace GCodeParser
 
@@ -0,0 +1,105 @@
+/**
+ * N-API Helpers - Implementation
+ *
+ * Readers for values coming back from JS.
+ */
+
+#include "napi_helpers.hh"
+
+namespace GCodeParser
+{
+
+  Toolpath toolpathFromJS(Napi::Env env, Napi::Object result)
+  {
+    Napi::Value opsValue = result.Get("operations");
+    if (!opsValue.IsArray())
+    {
+      throw Napi::TypeError::New(env, "result.operations must be an array");
+    }
+
+    Napi::Array operations = opsValue.As<Napi::Array>();
+    uint32_t length = operations.Length();
+
+    Toolpath path;
+    path.reserve(length);
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+      Napi::Value opValue = operations.Get(i);
+      if (!opValue.IsObject())
+      {
+        continue;
+      }
+      Napi::Object op = opValue.As<Napi::Object>();
+
+      ToolpathMove move;
+      move.opIndex = i;
+      move.lineNumber = static_cast<int32_t>(numberOr(op, "lineNumber", 0));
+
+      switch (static_cast<OperationType>(static_cast<int>(numberOr(op, "type", 0))))
+      {
+      case OperationType::FEED_RATE_CHANGE:
+        move.kind = ToolpathMove::FEED_RATE;
+        move.value = numberOr(op, "feedRate", 0.0);
+        path.push_back(move);
+        continue;
+      case OperationType::DWELL:
+        move.kind = ToolpathMove::DWELL;
+        move.value = numberOr(op, "duration", 0.0);
+        path.push_back(move);
+        continue;
+      case OperationType::TOOL_CHANGE:
+        move.kind = ToolpathMove::TOOL_CHANGE;
+        move.value = numberOr(op, "toolNumber", 0.0);
+        path.push_back(move);
+        continue;
+      case OperationType::MOTION_MODE_CHANGE:
+        move.kind = ToolpathMove::MOTION_MODE;
+        move.mode = static_cast<uint8_t>(numberOr(op, "mode", static_cast<int>(MotionMode::CONTINUOUS)));
+        move.value = numberOr(op, "tolerance", 0.0);
+        path.push_back(move);
+        continue;
+      case OperationType::TRAVERSE:
+        move.kind = ToolpathMove::RAPID;
+        break;
+      case OperationType::FEED:
+      case OperationType::NURBS_G5:
+      case OperationType::NURBS_G6:
+        move.kind = ToolpathMove::FEED;
+        break;
+      case OperationType::PROBE:
+        move.kind = ToolpathMove::PROBE;
+        break;
+      case OperationType::RIGID_TAP:
+        move.kind = ToolpathMove::RIGID_TAP;
+        break;
+      case OperationType::ARC:
+      {
+        Napi::Value arcValue = op.Get("arcData");
+        if (!arcValue.IsObject())
+        {
+          move.kind = ToolpathMove::FEED;
+          break;
+        }
+        Napi::Object arcData = arcValue.As<Napi::Object>();
+        move.kind = ToolpathMove::ARC;
+        move.plane = static_cast<uint8_t>(numberOr(op, "plane", static_cast<int>(Plane::XY)));
+        move.centerFirst = numberOr(arcData, "centerFirst", 0.0);
+        move.centerSecond = numberOr(arcData, "centerSecond", 0.0);
+        move.rotation = static_cast<int32_t>(numberOr(arcData, "rotation", 0));
+        break;
+      }
+      default:
+        continue; // Modal state with no effect on timing
+      }
+
+      if (readXYZ(op.Get("pos"), move.end))
+      {
+        path.push_back(move);
+      }
+    }
+
+    return path;
+  }
+
+} // namespace GCodeParser
@@ -0,0 +1,68 @@
+/**
+ * N-API Helpers - Header
+ *
+ * Small readers for values coming back from JS: parse results that went
+ * through JSON or IPC, option objects with missing keys.
+ */
+
+#ifndef GCODE_NAPI_HELPERS_HH
+#define GCODE_NAPI_HELPERS_HH
+
+#include <napi.h>
+#include "toolpath.hh"
+
+namespace GCodeParser
+{
+
+  /**
+   * Read XYZ from a position: Float64Array from parseGCode, or a plain
+   * array when the result went through JSON.
+   */
+  inline bool readXYZ(Napi::Value value, double *out)
+  {
+    if (value.IsTypedArray())
+    {
+      Napi::TypedArray typed = value.As<Napi::TypedArray>();
+      if (typed.TypedArrayType() != napi_float64_array || typed.ElementLength() < 3)
+      {
+        return false;
+      }
+      const double *data = value.As<Napi::Float64Array>().Data();
+      out[0] = data[0];
+      out[1] = data[1];
+      out[2] = data[2];
+      return true;
+    }
+
+    if (value.IsArray())
+    {
+      Napi::Array array = value.As<Napi::Array>();
+      if (array.Length() < 3)
+      {
+        return false;
+      }
+      for (uint32_t i = 0; i < 3; i++)
+      {
+        out[i] = array.Get(i).ToNumber().DoubleValue();
+      }
+      return true;
+    }
+
+    return false;
+  }
+
+  inline double numberOr(Napi::Object obj, const char *key, double fallback)
+  {
+    Napi::Value value = obj.Get(key);
+    return value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : fallback;
+  }
+
+  /**
+   * Extract the toolpath from a parse result object on the calling thread.
+   * @throws Napi::TypeError if result.operations is not an array
+   */
+  Toolpath toolpathFromJS(Napi::Env env, Napi::Object result);
+
+} // namespace GCodeParser
+
+#endif // GCODE_NAPI_HELPERS_HH
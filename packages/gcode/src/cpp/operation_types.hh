@@ -8,6 +8,8 @@
 #ifndef GCODE_OPERATION_TYPES_HH
 #define GCODE_OPERATION_TYPES_HH
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <variant>
 #include <vector>
@@ -40,6 +42,7 @@ namespace GCodeParser
     TOOL_OFFSET = 15,
     TOOL_CHANGE = 16,
     FEED_RATE_CHANGE = 17,
+    MOTION_MODE_CHANGE = 18,
   };
 
   enum class Plane
@@ -52,6 +55,14 @@ namespace GCodeParser
     UW = 6,
   };
 
+  // Path control mode, numbered like CANON_MOTION_MODE
+  enum class MotionMode
+  {
+    EXACT_STOP = 1, // G61.1: stop after every move
+    EXACT_PATH = 2, // G61: stop at corners that are not tangent
+    CONTINUOUS = 3, // G64: blend corners
+  };
+
   enum class Units
   {
     INCHES = 1,
@@ -291,6 +302,14 @@ namespace GCodeParser
     double feedRate = 0.0;
   };
 
+  struct MotionModeChangeOp
+  {
+    static constexpr OperationType type = OperationType::MOTION_MODE_CHANGE;
+    MotionMode mode = MotionMode::CONTINUOUS;
+    double tolerance = 0.0;         // G64 P, in mm (0 = no limit)
+    double naivecamTolerance = 0.0; // G64 Q, in mm (0 = off)
+  };
+
 
 
   // ============================================================================
@@ -313,7 +332,8 @@ namespace GCodeParser
       XYRotationOp,
       ToolOffsetOp,
       ToolChangeOp,
-      FeedRateChangeOp>;
+      FeedRateChangeOp,
+      MotionModeChangeOp>;
 
   // Helper to get OperationType from variant
   inline OperationType getOperationType(const Operation &op)
@@ -326,10 +346,63 @@ namespace GCodeParser
   // Parse Result
   // ============================================================================
 
+  /**
+   * Interpreter error recorded in collect-errors mode.
+   */
+  struct ParseDiagnostic
+  {
+    int lineNumber = 0;    // Line in `filename` where the error occurred
+    std::string filename;  // File being read (main program or subroutine)
+    std::string message;   // Interpreter error text
+    std::string text;      // Source text of the failing block
+    bool fatal = false;    // Parsing stopped here; later lines were not read
+  };
+
+  /**
+   * Time and canon calls attributed to one source line by the profiler.
+   */
+  struct ProfileLine
+  {
+    std::string filename;
+    int lineNumber = 0;
+    std::string text;        // Block text as the interpreter read it
+    std::string subroutine;  // Enclosing o-word sub ("o<name>", "o100"), empty in the main body
+    uint64_t executions = 0; // read()/execute() pairs on this line
+    double timeNs = 0.0;
+    uint64_t canonCalls = 0;
+  };
+
+  /**
+   * Self time of one o-word subroutine: the lines of its body, excluding
+   * subroutines it calls.
+   */
+  struct ProfileSubroutine
+  {
+    std::string name;
+    std::string filename;
+    uint64_t calls = 0;  // Times the subroutine was entered
+    uint64_t blocks = 0; // Blocks executed in the body, over all calls
+    double timeNs = 0.0;
+    uint64_t canonCalls = 0;
+  };
+
+  struct ParseProfile
+  {
+    double wallNs = 0.0;        // Whole parse, including setup
+    double interpreterNs = 0.0; // Sum over read()/execute() pairs
+    uint64_t blocks = 0;
+    uint64_t canonCalls = 0;
+    std::vector<ProfileLine> lines;             // Hottest first, truncated
+    std::vector<ProfileSubroutine> subroutines; // Hottest first
+  };
+
   struct ParseResult
   {
     std::vector<Operation> operations;
     Extents extents;
+    std::vector<ParseDiagnostic> errors; // Collect-errors mode only
+    std::vector<std::string> dependencies; // Other files the interpreter read (subroutines, remaps)
+    std::shared_ptr<const ParseProfile> profile; // Profiling mode only
   };
 
 } // namespace GCodeParser
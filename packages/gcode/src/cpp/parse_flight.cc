@@ -0,0 +1,170 @@
+/**
+ * Parse Flight - Implementation
+ *
+ * Single-flight coordination for concurrent parses of the same program.
+ */
+
+#include "parse_flight.hh"
+
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    std::mutex g_flightsMutex;
+    std::map<std::string, std::weak_ptr<ParseFlight>> g_flights;
+
+    // 64-bit FNV-1a over the file bytes
+    bool hashFile(const std::string &filepath, uint64_t &hash, uint64_t &size)
+    {
+      FILE *fp = std::fopen(filepath.c_str(), "rb");
+      if (!fp)
+      {
+        return false;
+      }
+
+      hash = 1469598103934665603ULL;
+      size = 0;
+      unsigned char buf[65536];
+      size_t n;
+      while ((n = std::fread(buf, 1, sizeof(buf), fp)) > 0)
+      {
+        for (size_t i = 0; i < n; i++)
+        {
+          hash ^= buf[i];
+          hash *= 1099511628211ULL;
+        }
+        size += n;
+      }
+
+      bool ok = !std::ferror(fp);
+      std::fclose(fp);
+      return ok;
+    }
+  } // namespace
+
+  std::string ParseFlight::makeKey(const std::string &filepath, const std::string &iniPath)
+  {
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    if (!hashFile(filepath, hash, size))
+    {
+      return std::string();
+    }
+
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%016llx:%llu:",
+                  static_cast<unsigned long long>(hash),
+                  static_cast<unsigned long long>(size));
+    return std::string(buf) + iniPath;
+  }
+
+  std::shared_ptr<ParseFlight> ParseFlight::join(const std::string &key, bool &leader)
+  {
+    std::lock_guard<std::mutex> lock(g_flightsMutex);
+
+    auto it = g_flights.find(key);
+    if (it != g_flights.end())
+    {
+      if (auto existing = it->second.lock())
+      {
+        leader = false;
+        return existing;
+      }
+    }
+
+    auto flight = std::make_shared<ParseFlight>(key);
+    g_flights[key] = flight;
+    leader = true;
+    return flight;
+  }
+
+  ParseFlight::ParseFlight(const std::string &key) : key_(key) {}
+
+  ParseFlight::~ParseFlight()
+  {
+    unregister();
+  }
+
+  void ParseFlight::unregister()
+  {
+    std::lock_guard<std::mutex> lock(g_flightsMutex);
+    auto it = g_flights.find(key_);
+    // Only drop our own entry; a newer flight may already own the key
+    if (it != g_flights.end() && (it->second.expired() || it->second.lock().get() == this))
+    {
+      g_flights.erase(it);
+    }
+  }
+
+  void ParseFlight::publishProgress(const ParseProgress &progress)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      progress_ = progress;
+      progressSeq_++;
+    }
+    cv_.notify_all();
+  }
+
+  void ParseFlight::complete(SharedParseResult result)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      result_ = std::move(result);
+      done_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  void ParseFlight::fail(const std::string &error)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = error;
+      done_ = true;
+    }
+    cv_.notify_all();
+    unregister();
+  }
+
+  SharedParseResult ParseFlight::wait(const std::function<void(const ParseProgress &)> &onProgress)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t seenSeq = 0;
+
+    while (true)
+    {
+      cv_.wait(lock, [&]
+               { return done_ || progressSeq_ != seenSeq; });
+
+      if (progressSeq_ != seenSeq)
+      {
+        seenSeq = progressSeq_;
+        ParseProgress snapshot = progress_;
+        if (onProgress)
+        {
+          lock.unlock();
+          onProgress(snapshot);
+          lock.lock();
+        }
+      }
+
+      if (done_ && progressSeq_ == seenSeq)
+      {
+        break;
+      }
+    }
+
+    if (!result_)
+    {
+      throw std::runtime_error(error_);
+    }
+    return result_;
+  }
+
+} // namespace GCodeParser
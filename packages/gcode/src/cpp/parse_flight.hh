@@ -0,0 +1,90 @@
+/**
+ * Parse Flight - Header
+ *
+ * Single-flight coordination for concurrent parses of the same program.
+ * Requests for identical (file content, INI) keys attach to the parse that
+ * is already running and share its native result.
+ */
+
+#ifndef GCODE_PARSE_FLIGHT_HH
+#define GCODE_PARSE_FLIGHT_HH
+
+#include "operation_types.hh"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace GCodeParser
+{
+
+  /**
+   * Parse result shared between every request that joined the same flight.
+   * The native operations are freed once the last holder releases it.
+   */
+  using SharedParseResult = std::shared_ptr<const ParseResult>;
+
+  /**
+   * One in-flight (or still referenced) parse.
+   *
+   * The first caller of join() for a key becomes the leader and must run the
+   * parse, then call complete() or fail(). Later callers become followers and
+   * block in wait(). Flights stay registered while any worker holds them, so
+   * a request arriving just after completion reuses the result as well.
+   */
+  class ParseFlight
+  {
+  public:
+    /**
+     * Build a dedup key from the file content hash, size and INI path.
+     * Returns an empty string if the file cannot be read (no dedup; the
+     * parse itself reports the error).
+     */
+    static std::string makeKey(const std::string &filepath, const std::string &iniPath);
+
+    /**
+     * Attach to the flight for `key`, creating it if needed.
+     * @param leader Set to true if the caller created the flight and must parse
+     */
+    static std::shared_ptr<ParseFlight> join(const std::string &key, bool &leader);
+
+    explicit ParseFlight(const std::string &key);
+    ~ParseFlight();
+
+    ParseFlight(const ParseFlight &) = delete;
+    ParseFlight &operator=(const ParseFlight &) = delete;
+
+    /** Leader: publish a progress snapshot to followers. */
+    void publishProgress(const ParseProgress &progress);
+
+    /** Leader: publish the finished result and wake followers. */
+    void complete(SharedParseResult result);
+
+    /** Leader: publish a failure and unregister so later requests retry. */
+    void fail(const std::string &error);
+
+    /**
+     * Follower: block until the leader finishes, forwarding progress
+     * snapshots as they arrive.
+     * @throws std::runtime_error with the leader's message on failure
+     */
+    SharedParseResult wait(const std::function<void(const ParseProgress &)> &onProgress);
+
+  private:
+    void unregister();
+
+    std::string key_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool done_ = false;
+    SharedParseResult result_;
+    std::string error_;
+    ParseProgress progress_;
+    uint64_t progressSeq_ = 0;
+  };
+
+} // namespace GCodeParser
+
+#endif // GCODE_PARSE_FLIGHT_HH
@@ -6,6 +6,7 @@
 
 #include "parse_worker.hh"
 #include "gcode_parser.hh"
+#include "compact_codec.hh"
 
 namespace GCodeParser
 {
@@ -15,11 +16,19 @@ namespace GCodeParser
       Napi::Function &progressCallback,
       const std::string &filepath,
       const std::string &iniPath,
-      int progressUpdates)
+      int progressUpdates,
+      int maxErrors,
+      double compactResolution,
+      int profileLines,
+      std::shared_ptr<std::atomic<bool>> envClosing)
       : Napi::AsyncProgressWorker<ParseProgress>(callback),
         filepath_(filepath),
         iniPath_(iniPath),
-        progressUpdates_(progressUpdates)
+        progressUpdates_(progressUpdates),
+        maxErrors_(maxErrors),
+        compactResolution_(compactResolution),
+        profileLines_(profileLines),
+        envClosing_(std::move(envClosing))
   {
     if (!progressCallback.IsEmpty() && progressCallback.IsFunction())
     {
@@ -31,19 +40,84 @@ namespace GCodeParser
 
   void ParseWorker::Execute(const ExecutionProgress &progress)
   {
+    // The calling environment is gone; don't hold the interpreter for it
+    if (envClosing_ && envClosing_->load())
+    {
+      SetError("Environment is shutting down");
+      return;
+    }
+
+    bool leader = true;
+    std::string key = ParseFlight::makeKey(filepath_, iniPath_);
+    if (!key.empty() && maxErrors_ > 0)
+    {
+      // Collect-errors results differ from fail-fast ones
+      key += ":errors=" + std::to_string(maxErrors_);
+    }
+    if (!key.empty() && profileLines_ > 0)
+    {
+      // Profiled runs are slower and carry a report
+      key += ":profile=" + std::to_string(profileLines_);
+    }
+    if (!key.empty())
+    {
+      flight_ = ParseFlight::join(key, leader);
+    }
+
+    // Create progress callback that reports to Node.js
+    auto progressFn = [&progress](const ParseProgress &p)
+    {
+      progress.Send(&p, 1);
+    };
+
     try
     {
-      // Create progress callback that reports to Node.js
-      auto progressFn = [&progress](const ParseProgress &p)
+      if (!leader)
       {
-        progress.Send(&p, 1);
-      };
+        // Another request is parsing the same content; share its result
+        result_ = flight_->wait(progressFn);
+      }
+      else
+      {
+        auto leaderProgressFn = [this, &progressFn](const ParseProgress &p)
+        {
+          progressFn(p);
+          if (flight_)
+          {
+            flight_->publishProgress(p);
+          }
+        };
 
-      result_ = parseFile(filepath_, iniPath_, progressFn, progressUpdates_);
+        result_ = std::make_shared<const ParseResult>(
+            parseFile(filepath_, iniPath_, leaderProgressFn, progressUpdates_, maxErrors_, profileLines_));
+
+        if (flight_)
+        {
+          flight_->complete(result_);
+        }
+      }
     }
     catch (const std::exception &e)
     {
+      if (flight_ && leader)
+      {
+        flight_->fail(e.what());
+      }
       SetError(e.what());
+      return;
+    }
+
+    if (compactResolution_ > 0.0)
+    {
+      // Encode here rather than in OnOK to keep it off the event loop
+      try
+      {
+        compact_ = encodeCompact(*result_, compactResolution_, maxErrors_ > 0);
+      }
+      catch (const std::exception &e)
+      {
+        SetError(e.what());
+      }
     }
   }
 
@@ -71,7 +145,22 @@ namespace GCodeParser
     Napi::Env env = Env();
     Napi::HandleScope scope(env);
 
-    Callback().Call({env.Null(), resultToJS(env)});
+    Napi::Value result;
+    if (compactResolution_ > 0.0)
+    {
+      result = Napi::Buffer<uint8_t>::Copy(env, compact_.data(), compact_.size());
+      compact_ = std::vector<uint8_t>();
+    }
+    else
+    {
+      result = resultToJS(env, *result_, maxErrors_ > 0);
+    }
+
+    // Drop our reference; the native result is freed with the last holder
+    result_.reset();
+    flight_.reset();
+
+    Callback().Call({env.Null(), result});
   }
 
   void ParseWorker::OnError(const Napi::Error &error)
@@ -79,6 +168,9 @@ namespace GCodeParser
     Napi::Env env = Env();
     Napi::HandleScope scope(env);
 
+    result_.reset();
+    flight_.reset();
+
     Callback().Call({error.Value(), env.Null()});
   }
 
@@ -218,29 +310,113 @@ namespace GCodeParser
       }
       else if constexpr (std::is_same_v<T, FeedRateChangeOp>) {
         obj.Set("feedRate", Napi::Number::New(env, operation.feedRate));
+      }
+      else if constexpr (std::is_same_v<T, MotionModeChangeOp>) {
+        obj.Set("mode", Napi::Number::New(env, static_cast<int>(operation.mode)));
+        obj.Set("tolerance", Napi::Number::New(env, operation.tolerance));
+        obj.Set("naivecamTolerance", Napi::Number::New(env, operation.naivecamTolerance));
       } }, op);
 
     return obj;
   }
 
-  Napi::Object ParseWorker::resultToJS(Napi::Env env)
+  Napi::Object ParseWorker::diagnosticToJS(Napi::Env env, const ParseDiagnostic &diag)
+  {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("lineNumber", Napi::Number::New(env, diag.lineNumber));
+    obj.Set("filename", Napi::String::New(env, diag.filename));
+    obj.Set("message", Napi::String::New(env, diag.message));
+    obj.Set("text", Napi::String::New(env, diag.text));
+    obj.Set("fatal", Napi::Boolean::New(env, diag.fatal));
+    return obj;
+  }
+
+  Napi::Object ParseWorker::profileToJS(Napi::Env env, const ParseProfile &profile)
+  {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("wallMs", Napi::Number::New(env, profile.wallNs / 1e6));
+    obj.Set("interpreterMs", Napi::Number::New(env, profile.interpreterNs / 1e6));
+    obj.Set("blocks", Napi::Number::New(env, static_cast<double>(profile.blocks)));
+    obj.Set("canonCalls", Napi::Number::New(env, static_cast<double>(profile.canonCalls)));
+
+    Napi::Array lines = Napi::Array::New(env, profile.lines.size());
+    for (size_t i = 0; i < profile.lines.size(); i++)
+    {
+      const ProfileLine &line = profile.lines[i];
+      Napi::Object lineObj = Napi::Object::New(env);
+      lineObj.Set("filename", Napi::String::New(env, line.filename));
+      lineObj.Set("lineNumber", Napi::Number::New(env, line.lineNumber));
+      lineObj.Set("text", Napi::String::New(env, line.text));
+      if (!line.subroutine.empty())
+      {
+        lineObj.Set("subroutine", Napi::String::New(env, line.subroutine));
+      }
+      lineObj.Set("executions", Napi::Number::New(env, static_cast<double>(line.executions)));
+      lineObj.Set("timeMs", Napi::Number::New(env, line.timeNs / 1e6));
+      lineObj.Set("canonCalls", Napi::Number::New(env, static_cast<double>(line.canonCalls)));
+      lines[i] = lineObj;
+    }
+    obj.Set("lines", lines);
+
+    Napi::Array subroutines = Napi::Array::New(env, profile.subroutines.size());
+    for (size_t i = 0; i < profile.subroutines.size(); i++)
+    {
+      const ProfileSubroutine &sub = profile.subroutines[i];
+      Napi::Object subObj = Napi::Object::New(env);
+      subObj.Set("name", Napi::String::New(env, sub.name));
+      subObj.Set("filename", Napi::String::New(env, sub.filename));
+      subObj.Set("calls", Napi::Number::New(env, static_cast<double>(sub.calls)));
+      subObj.Set("blocks", Napi::Number::New(env, static_cast<double>(sub.blocks)));
+      subObj.Set("timeMs", Napi::Number::New(env, sub.timeNs / 1e6));
+      subObj.Set("canonCalls", Napi::Number::New(env, static_cast<double>(sub.canonCalls)));
+      subroutines[i] = subObj;
+    }
+    obj.Set("subroutines", subroutines);
+
+    return obj;
+  }
+
+  Napi::Object ParseWorker::resultToJS(Napi::Env env, const ParseResult &parsed, bool withErrors)
   {
     Napi::Object result = Napi::Object::New(env);
 
     // Convert operations array
-    Napi::Array operations = Napi::Array::New(env, result_.operations.size());
-    for (size_t i = 0; i < result_.operations.size(); i++)
+    Napi::Array operations = Napi::Array::New(env, parsed.operations.size());
+    for (size_t i = 0; i < parsed.operations.size(); i++)
     {
-      operations[i] = operationToJS(env, result_.operations[i]);
+      operations[i] = operationToJS(env, parsed.operations[i]);
     }
     result.Set("operations", operations);
 
     // Convert extents
     Napi::Object extents = Napi::Object::New(env);
-    extents.Set("min", position3ToJS(env, result_.extents.min));
-    extents.Set("max", position3ToJS(env, result_.extents.max));
+    extents.Set("min", position3ToJS(env, parsed.extents.min));
+    extents.Set("max", position3ToJS(env, parsed.extents.max));
     result.Set("extents", extents);
 
+    Napi::Array dependencies = Napi::Array::New(env, parsed.dependencies.size());
+    for (size_t i = 0; i < parsed.dependencies.size(); i++)
+    {
+      dependencies[i] = Napi::String::New(env, parsed.dependencies[i]);
+    }
+    result.Set("dependencies", dependencies);
+
+    // Diagnostics are only reported in collect-errors mode
+    if (withErrors)
+    {
+      Napi::Array errors = Napi::Array::New(env, parsed.errors.size());
+      for (size_t i = 0; i < parsed.errors.size(); i++)
+      {
+        errors[i] = diagnosticToJS(env, parsed.errors[i]);
+      }
+      result.Set("errors", errors);
+    }
+
+    if (parsed.profile)
+    {
+      result.Set("profile", profileToJS(env, *parsed.profile));
+    }
+
     return result;
   }
 
@@ -8,13 +8,24 @@
 #define GCODE_PARSE_WORKER_HH
 
 #include <napi.h>
+#include <atomic>
+#include <memory>
 #include "operation_types.hh"
+#include "parse_flight.hh"
 
 namespace GCodeParser
 {
 
   /**
    * Async worker that parses G-code in a background thread.
+   *
+   * Concurrent workers for the same file content and INI share one parse:
+   * the first runs the interpreter, the rest wait on its ParseFlight and
+   * receive the same native result.
+   *
+   * With a compact resolution the result is delivered as a compact-encoded
+   * Buffer (see compact_codec.hh), encoded on the worker thread, instead of
+   * JS objects.
    */
   class ParseWorker : public Napi::AsyncProgressWorker<ParseProgress>
   {
@@ -24,7 +35,11 @@ namespace GCodeParser
         Napi::Function &progressCallback,
         const std::string &filepath,
         const std::string &iniPath,
-        int progressUpdates = 40);
+        int progressUpdates = 40,
+        int maxErrors = 0,
+        double compactResolution = 0.0,
+        int profileLines = 0,
+        std::shared_ptr<std::atomic<bool>> envClosing = nullptr);
 
     ~ParseWorker();
 
@@ -33,19 +48,32 @@ namespace GCodeParser
     void OnOK() override;
     void OnError(const Napi::Error &error) override;
 
+    /**
+     * Convert a native parse result to its JS form.
+     * @param withErrors - Include result.errors (collect-errors mode)
+     */
+    static Napi::Object resultToJS(Napi::Env env, const ParseResult &result, bool withErrors);
+
   private:
     std::string filepath_;
     std::string iniPath_;
     int progressUpdates_;
-    ParseResult result_;
+    int maxErrors_;
+    double compactResolution_;
+    int profileLines_;
+    std::vector<uint8_t> compact_;
+    SharedParseResult result_;
+    std::shared_ptr<ParseFlight> flight_;
+    std::shared_ptr<std::atomic<bool>> envClosing_;
     Napi::FunctionReference progressCallback_;
 
-    // Helper to convert result to JS object
-    Napi::Object resultToJS(Napi::Env env);
-    Napi::Float64Array positionToJS(Napi::Env env, const Position &pos);
-    Napi::Float64Array position3ToJS(Napi::Env env, const Position3 &pos);
+    // Helpers to convert the result to JS objects
+    static Napi::Float64Array positionToJS(Napi::Env env, const Position &pos);
+    static Napi::Float64Array position3ToJS(Napi::Env env, const Position3 &pos);
 
-    Napi::Object operationToJS(Napi::Env env, const Operation &op);
+    static Napi::Object operationToJS(Napi::Env env, const Operation &op);
+    static Napi::Object diagnosticToJS(Napi::Env env, const ParseDiagnostic &diag);
+    static Napi::Object profileToJS(Napi::Env env, const ParseProfile &profile);
   };
 
 } // namespace GCodeParser
@@ -0,0 +1,270 @@
+/**
+ * Path Sampler - Implementation
+ *
+ * Arc-length and time index over the XYZ toolpath of a parse result.
+ */
+
+#include "path_sampler.hh"
+#include "arc_geometry.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    const double ORIGIN[3] = {0.0, 0.0, 0.0};
+
+    double distance3(const double *a, const double *b)
+    {
+      double dx = b[0] - a[0];
+      double dy = b[1] - a[1];
+      double dz = b[2] - a[2];
+      return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    /**
+     * Index of the segment holding `value` in a cumulative table whose
+     * entry i is the start of segment i: the last segment starting at or
+     * before it, skipping zero-length ones that start at the same value.
+     */
+    size_t findSegment(const std::vector<double> &cum, double value)
+    {
+      auto it = std::upper_bound(cum.begin() + 1, cum.end() - 1, value);
+      return static_cast<size_t>(it - (cum.begin() + 1));
+    }
+  } // namespace
+
+  PathSampler::PathSampler(const PathSamplerOptions &options)
+      : options_(options),
+        feedRate_(options.defaultFeedRate),
+        cumLength_{0.0},
+        cumTime_{0.0}
+  {
+  }
+
+  PathSampler PathSampler::fromToolpath(const Toolpath &path, const PathSamplerOptions &options)
+  {
+    PathSampler sampler(options);
+    sampler.segments_.reserve(path.size());
+    sampler.cumLength_.reserve(path.size() + 1);
+    sampler.cumTime_.reserve(path.size() + 1);
+
+    for (const ToolpathMove &move : path)
+    {
+      switch (move.kind)
+      {
+      case ToolpathMove::FEED_RATE:
+        sampler.setFeedRate(move.value);
+        break;
+      case ToolpathMove::DWELL:
+        sampler.dwell(move.opIndex, move.value);
+        break;
+      case ToolpathMove::RIGID_TAP:
+        sampler.rigidTap(move.opIndex, move.lineNumber, move.end);
+        break;
+      case ToolpathMove::ARC:
+        sampler.arc(move.opIndex, move.lineNumber, move.end, move.plane,
+                    move.centerFirst, move.centerSecond, move.rotation);
+        break;
+      case ToolpathMove::RAPID:
+      case ToolpathMove::FEED:
+      case ToolpathMove::PROBE:
+        sampler.line(move.opIndex, move.lineNumber, move.end, move.kind == ToolpathMove::RAPID);
+        break;
+      case ToolpathMove::TOOL_CHANGE:
+      case ToolpathMove::MOTION_MODE:
+        break;
+      }
+    }
+
+    sampler.finish();
+    return sampler;
+  }
+
+  void PathSampler::setFeedRate(double rate)
+  {
+    feedRate_ = rate > 0.0 ? rate : options_.defaultFeedRate;
+  }
+
+  const double *PathSampler::startOf(size_t index) const
+  {
+    return index == 0 ? ORIGIN : segments_[index - 1].end;
+  }
+
+  void PathSampler::push(const Segment &seg, double length, double seconds)
+  {
+    segments_.push_back(seg);
+    cumLength_.push_back(cumLength_.back() + length);
+    cumTime_.push_back(cumTime_.back() + seconds);
+  }
+
+  void PathSampler::line(uint32_t opIndex, int lineNumber, const double *end, bool rapid)
+  {
+    Segment seg;
+    seg.kind = LINE;
+    seg.rapid = rapid;
+    seg.opIndex = opIndex;
+    seg.lineNumber = lineNumber;
+    std::copy(end, end + 3, seg.end);
+
+    double length = distance3(startOf(segments_.size()), end);
+    double rate = rapid ? options_.rapidRate : feedRate_;
+    push(seg, length, length * 60.0 / rate);
+  }
+
+  void PathSampler::arc(uint32_t opIndex, int lineNumber, const double *end, int plane,
+                        double centerFirst, double centerSecond, int rotation)
+  {
+    const double *start = startOf(segments_.size());
+
+    Segment seg;
+    seg.kind = ARC;
+    seg.plane = static_cast<uint8_t>(plane);
+    seg.rotation = rotation;
+    seg.opIndex = opIndex;
+    seg.lineNumber = lineNumber;
+    std::copy(end, end + 3, seg.end);
+    seg.centerFirst = centerFirst;
+    seg.centerSecond = centerSecond;
+
+    ArcFrame frame;
+    double length;
+    if (arcFrame(start, end, plane, centerFirst, centerSecond, rotation, frame))
+    {
+      // Helix length: the arc unrolled against the helical axis travel
+      double planar = frame.radius * std::fabs(frame.sweep);
+      length = std::sqrt(planar * planar + frame.helixDelta * frame.helixDelta);
+    }
+    else
+    {
+      seg.kind = LINE;
+      length = distance3(start, end);
+    }
+    push(seg, length, length * 60.0 / feedRate_);
+  }
+
+  void PathSampler::rigidTap(uint32_t opIndex, int lineNumber, const double *bottom)
+  {
+    double top[3] = {bottom[0], bottom[1], startOf(segments_.size())[2]};
+    line(opIndex, lineNumber, bottom, false);
+    line(opIndex, lineNumber, top, false);
+  }
+
+  void PathSampler::dwell(uint32_t opIndex, double seconds)
+  {
+    const double *start = startOf(segments_.size());
+
+    Segment seg;
+    seg.kind = DWELL;
+    seg.opIndex = opIndex;
+    // Dwells carry no line number; keep the one of the move before
+    seg.lineNumber = segments_.empty() ? 0 : segments_.back().lineNumber;
+    std::copy(start, start + 3, seg.end);
+    push(seg, 0.0, std::max(seconds, 0.0));
+  }
+
+  void PathSampler::finish()
+  {
+    lines_.clear();
+    for (size_t i = 0; i < segments_.size(); i++)
+    {
+      uint32_t index = static_cast<uint32_t>(i);
+      lines_.push_back(LineEntry{segments_[i].lineNumber, index, index});
+    }
+    // Stable, so the first entry of each line is its first segment
+    std::stable_sort(lines_.begin(), lines_.end(), [](const LineEntry &a, const LineEntry &b)
+                     { return a.lineNumber < b.lineNumber; });
+    lines_.erase(std::unique(lines_.begin(), lines_.end(), [](const LineEntry &a, const LineEntry &b)
+                             { return a.lineNumber == b.lineNumber; }),
+                 lines_.end());
+
+    // Lines need not run in program order (subroutines, loops), so the
+    // first move from a later line is a suffix minimum
+    for (size_t i = lines_.size(); i-- > 1;)
+    {
+      lines_[i - 1].firstSegmentFrom = std::min(lines_[i - 1].firstSegment, lines_[i].firstSegmentFrom);
+    }
+  }
+
+  SegmentTiming PathSampler::timing(size_t index) const
+  {
+    SegmentTiming timing;
+    timing.lineNumber = segments_[index].lineNumber;
+    timing.length = cumLength_[index + 1] - cumLength_[index];
+    timing.duration = cumTime_[index + 1] - cumTime_[index];
+    timing.rapid = segments_[index].rapid;
+    return timing;
+  }
+
+  PathSample PathSampler::evaluate(size_t index, double fraction) const
+  {
+    const Segment &seg = segments_[index];
+    const double *start = startOf(index);
+    fraction = std::clamp(fraction, 0.0, 1.0);
+
+    PathSample sample;
+    sample.opIndex = seg.opIndex;
+    sample.lineNumber = seg.lineNumber;
+    sample.distance = cumLength_[index] + (cumLength_[index + 1] - cumLength_[index]) * fraction;
+    sample.time = cumTime_[index] + (cumTime_[index + 1] - cumTime_[index]) * fraction;
+
+    ArcFrame frame;
+    if (seg.kind == ARC && fraction < 1.0 &&
+        arcFrame(start, seg.end, seg.plane, seg.centerFirst, seg.centerSecond, seg.rotation, frame))
+    {
+      double angle = frame.startAngle + frame.sweep * fraction;
+      sample.pos[frame.first] = seg.centerFirst + frame.radius * std::cos(angle);
+      sample.pos[frame.second] = seg.centerSecond + frame.radius * std::sin(angle);
+      sample.pos[frame.helix] = frame.helixStart + frame.helixDelta * fraction;
+      return sample;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+      sample.pos[i] = start[i] + (seg.end[i] - start[i]) * fraction;
+    }
+    return sample;
+  }
+
+  PathSample PathSampler::atDistance(double distance) const
+  {
+    if (segments_.empty())
+    {
+      return PathSample();
+    }
+
+    distance = std::clamp(distance, 0.0, length());
+    size_t index = findSegment(cumLength_, distance);
+    double span = cumLength_[index + 1] - cumLength_[index];
+    return evaluate(index, span > 0.0 ? (distance - cumLength_[index]) / span : 1.0);
+  }
+
+  PathSample PathSampler::atTime(double time) const
+  {
+    if (segments_.empty())
+    {
+      return PathSample();
+    }
+
+    time = std::clamp(time, 0.0, duration());
+    size_t index = findSegment(cumTime_, time);
+    double span = cumTime_[index + 1] - cumTime_[index];
+    return evaluate(index, span > 0.0 ? (time - cumTime_[index]) / span : 1.0);
+  }
+
+  double PathSampler::lineDistance(int lineNumber) const
+  {
+    auto it = std::lower_bound(lines_.begin(), lines_.end(), lineNumber,
+                               [](const LineEntry &entry, int line)
+                               { return entry.lineNumber < line; });
+    if (it == lines_.end())
+    {
+      return -1.0;
+    }
+    return cumLength_[it->lineNumber == lineNumber ? it->firstSegment : it->firstSegmentFrom];
+  }
+
+} // namespace GCodeParser
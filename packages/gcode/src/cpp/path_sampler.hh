@@ -0,0 +1,143 @@
+/**
+ * Path Sampler - Header
+ *
+ * Arc-length and time index over the XYZ toolpath of a parse result, for
+ * scrubbing and playback. Cumulative distance and estimated time tables are
+ * built once; every query is a binary search plus one segment evaluation,
+ * so seeking through million-segment programs costs microseconds.
+ */
+
+#ifndef GCODE_PATH_SAMPLER_HH
+#define GCODE_PATH_SAMPLER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "toolpath.hh"
+
+namespace GCodeParser
+{
+
+  struct PathSamplerOptions
+  {
+    double rapidRate = 5000.0;       // mm/min used for traverses
+    double defaultFeedRate = 1000.0; // mm/min before the first F word
+  };
+
+  /**
+   * Tool position at a point along the path.
+   */
+  struct PathSample
+  {
+    double pos[3] = {0.0, 0.0, 0.0};
+    uint32_t opIndex = 0; // Index into result.operations
+    int lineNumber = 0;
+    double distance = 0.0; // mm from the start of the path
+    double time = 0.0;     // Estimated seconds from the start of the path
+  };
+
+  /**
+   * Length and estimated time of one indexed move.
+   */
+  struct SegmentTiming
+  {
+    int lineNumber = 0;
+    double length = 0.0;   // mm
+    double duration = 0.0; // Seconds
+    bool rapid = false;
+  };
+
+  class PathSampler
+  {
+  public:
+    explicit PathSampler(const PathSamplerOptions &options = {});
+
+    /**
+     * Build from the moves of a parse result.
+     */
+    static PathSampler fromToolpath(const Toolpath &path, const PathSamplerOptions &options = {});
+
+    // ------------------------------------------------------------------------
+    // Building, in program order. The path starts at the origin, like the
+    // viewer, and each move starts where the previous one ended.
+    // ------------------------------------------------------------------------
+
+    void setFeedRate(double rate);
+    void line(uint32_t opIndex, int lineNumber, const double *end, bool rapid);
+    void arc(uint32_t opIndex, int lineNumber, const double *end, int plane,
+             double centerFirst, double centerSecond, int rotation);
+    /** Feed down to `bottom` and back out to the starting Z */
+    void rigidTap(uint32_t opIndex, int lineNumber, const double *bottom);
+    void dwell(uint32_t opIndex, double seconds);
+    /** Index the moves by line for lineDistance(); fromToolpath() calls it */
+    void finish();
+
+    // ------------------------------------------------------------------------
+    // Queries. Out-of-range inputs clamp to the start or end of the path.
+    // ------------------------------------------------------------------------
+
+    PathSample atDistance(double distance) const;
+    PathSample atTime(double time) const;
+
+    /**
+     * Distance at which the first move from `lineNumber` starts, or of the
+     * first move from a later line if that line has none. -1 if neither.
+     */
+    double lineDistance(int lineNumber) const;
+
+    /**
+     * Timing of move `index` (< segmentCount()).
+     */
+    SegmentTiming timing(size_t index) const;
+
+    double length() const { return cumLength_.back(); }
+    double duration() const { return cumTime_.back(); }
+    size_t segmentCount() const { return segments_.size(); }
+
+  private:
+    enum Kind : uint8_t
+    {
+      LINE = 0,
+      ARC = 1,
+      DWELL = 2,
+    };
+
+    struct Segment
+    {
+      Kind kind = LINE;
+      bool rapid = false;
+      uint8_t plane = 1;
+      int32_t rotation = 0;
+      uint32_t opIndex = 0;
+      int32_t lineNumber = 0;
+      double end[3] = {0.0, 0.0, 0.0};
+      double centerFirst = 0.0;
+      double centerSecond = 0.0;
+    };
+
+    void push(const Segment &seg, double length, double seconds);
+    const double *startOf(size_t index) const;
+    PathSample evaluate(size_t index, double fraction) const;
+
+    PathSamplerOptions options_;
+    double feedRate_;
+
+    std::vector<Segment> segments_;
+    // Entry i is the distance/time at the start of segment i; one extra
+    // entry at the end holds the totals
+    std::vector<double> cumLength_;
+    std::vector<double> cumTime_;
+
+    struct LineEntry
+    {
+      int32_t lineNumber;
+      uint32_t firstSegment;     // First segment from this line
+      uint32_t firstSegmentFrom; // First segment from this or a later line
+    };
+    // Sorted by line number
+    std::vector<LineEntry> lines_;
+  };
+
+} // namespace GCodeParser
+
+#endif // GCODE_PATH_SAMPLER_HH
@@ -0,0 +1,226 @@
+/**
+ * Path Sampler Wrap - Implementation
+ *
+ * JS class around PathSampler.
+ */
+
+#include "path_sampler_wrap.hh"
+#include "compact_codec.hh"
+#include "napi_helpers.hh"
+#include <stdexcept>
+
+namespace GCodeParser
+{
+
+  Napi::Function PathSamplerWrap::Init(Napi::Env env)
+  {
+    return DefineClass(env, "PathSampler", {
+                                               InstanceAccessor("length", &PathSamplerWrap::GetLength, nullptr),
+                                               InstanceAccessor("duration", &PathSamplerWrap::GetDuration, nullptr),
+                                               InstanceAccessor("segmentCount", &PathSamplerWrap::GetSegmentCount, nullptr),
+                                               InstanceMethod("atDistance", &PathSamplerWrap::AtDistance),
+                                               InstanceMethod("atTime", &PathSamplerWrap::AtTime),
+                                               InstanceMethod("opAt", &PathSamplerWrap::OpAt),
+                                               InstanceMethod("sample", &PathSamplerWrap::Sample),
+                                               InstanceMethod("lineDistance", &PathSamplerWrap::LineDistance),
+                                               InstanceMethod("timingTable", &PathSamplerWrap::TimingTable),
+                                           });
+  }
+
+  PathSamplerWrap::PathSamplerWrap(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<PathSamplerWrap>(info)
+  {
+    Napi::Env env = info.Env();
+
+    PathSamplerOptions options;
+    if (info.Length() > 1 && info[1].IsObject())
+    {
+      Napi::Object obj = info[1].As<Napi::Object>();
+      options.rapidRate = numberOr(obj, "rapidRate", options.rapidRate);
+      options.defaultFeedRate = numberOr(obj, "defaultFeedRate", options.defaultFeedRate);
+    }
+    if (!(options.rapidRate > 0.0) || !(options.defaultFeedRate > 0.0))
+    {
+      throw Napi::RangeError::New(env, "rapidRate and defaultFeedRate must be positive");
+    }
+
+    if (info.Length() > 0 && info[0].IsTypedArray() &&
+        info[0].As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array)
+    {
+      Napi::Uint8Array buffer = info[0].As<Napi::Uint8Array>();
+      try
+      {
+        bool withErrors = false;
+        ParseResult result = decodeCompact(buffer.Data(), buffer.ByteLength(), withErrors);
+        sampler_ = PathSampler::fromToolpath(toolpathFromResult(result), options);
+      }
+      catch (const std::runtime_error &e)
+      {
+        throw Napi::Error::New(env, e.what());
+      }
+      return;
+    }
+
+    if (info.Length() < 1 || !info[0].IsObject())
+    {
+      throw Napi::TypeError::New(env, "source must be a parse result or a Uint8Array");
+    }
+    sampler_ = PathSampler::fromToolpath(toolpathFromJS(env, info[0].As<Napi::Object>()), options);
+  }
+
+  Napi::Object PathSamplerWrap::sampleToJS(Napi::Env env, const PathSample &sample)
+  {
+    Napi::Object obj = Napi::Object::New(env);
+    Napi::Float64Array pos = Napi::Float64Array::New(env, 3);
+    pos[0] = sample.pos[0];
+    pos[1] = sample.pos[1];
+    pos[2] = sample.pos[2];
+    obj.Set("pos", pos);
+    obj.Set("opIndex", Napi::Number::New(env, sample.opIndex));
+    obj.Set("lineNumber", Napi::Number::New(env, sample.lineNumber));
+    obj.Set("distance", Napi::Number::New(env, sample.distance));
+    obj.Set("time", Napi::Number::New(env, sample.time));
+    return obj;
+  }
+
+  Napi::Value PathSamplerWrap::GetLength(const Napi::CallbackInfo &info)
+  {
+    return Napi::Number::New(info.Env(), sampler_.length());
+  }
+
+  Napi::Value PathSamplerWrap::GetDuration(const Napi::CallbackInfo &info)
+  {
+    return Napi::Number::New(info.Env(), sampler_.duration());
+  }
+
+  Napi::Value PathSamplerWrap::GetSegmentCount(const Napi::CallbackInfo &info)
+  {
+    return Napi::Number::New(info.Env(), static_cast<double>(sampler_.segmentCount()));
+  }
+
+  Napi::Value PathSamplerWrap::AtDistance(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+      Napi::TypeError::New(env, "distance must be a number").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    return sampleToJS(env, sampler_.atDistance(info[0].As<Napi::Number>().DoubleValue()));
+  }
+
+  Napi::Value PathSamplerWrap::AtTime(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+      Napi::TypeError::New(env, "time must be a number").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    return sampleToJS(env, sampler_.atTime(info[0].As<Napi::Number>().DoubleValue()));
+  }
+
+  Napi::Value PathSamplerWrap::OpAt(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+      Napi::TypeError::New(env, "distance must be a number").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (sampler_.segmentCount() == 0)
+    {
+      return Napi::Number::New(env, -1);
+    }
+    return Napi::Number::New(env, sampler_.atDistance(info[0].As<Napi::Number>().DoubleValue()).opIndex);
+  }
+
+  Napi::Value PathSamplerWrap::Sample(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsTypedArray() ||
+        info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array)
+    {
+      Napi::TypeError::New(env, "values must be a Float64Array").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Float64Array values = info[0].As<Napi::Float64Array>();
+    bool byTime = info.Length() > 1 && info[1].ToBoolean().Value();
+    size_t count = values.ElementLength();
+
+    Napi::Float64Array positions = Napi::Float64Array::New(env, count * 3);
+    Napi::Float64Array distances = Napi::Float64Array::New(env, count);
+    Napi::Float64Array times = Napi::Float64Array::New(env, count);
+    Napi::Uint32Array opIndices = Napi::Uint32Array::New(env, count);
+    Napi::Int32Array lineNumbers = Napi::Int32Array::New(env, count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+      PathSample sample = byTime ? sampler_.atTime(values[i]) : sampler_.atDistance(values[i]);
+      positions[i * 3] = sample.pos[0];
+      positions[i * 3 + 1] = sample.pos[1];
+      positions[i * 3 + 2] = sample.pos[2];
+      distances[i] = sample.distance;
+      times[i] = sample.time;
+      opIndices[i] = sample.opIndex;
+      lineNumbers[i] = sample.lineNumber;
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("positions", positions);
+    result.Set("distances", distances);
+    result.Set("times", times);
+    result.Set("opIndices", opIndices);
+    result.Set("lineNumbers", lineNumbers);
+    return result;
+  }
+
+  Napi::Value PathSamplerWrap::LineDistance(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+      Napi::TypeError::New(env, "lineNumber must be a number").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    return Napi::Number::New(env, sampler_.lineDistance(info[0].As<Napi::Number>().Int32Value()));
+  }
+
+  Napi::Value PathSamplerWrap::TimingTable(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    size_t n = sampler_.segmentCount();
+
+    Napi::Int32Array lineNumber = Napi::Int32Array::New(env, n);
+    Napi::Float64Array length = Napi::Float64Array::New(env, n);
+    Napi::Float64Array duration = Napi::Float64Array::New(env, n);
+    Napi::Uint8Array rapid = Napi::Uint8Array::New(env, n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+      SegmentTiming timing = sampler_.timing(i);
+      lineNumber[i] = timing.lineNumber;
+      length[i] = timing.length;
+      duration[i] = timing.duration;
+      rapid[i] = timing.rapid ? 1 : 0;
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("lineNumber", lineNumber);
+    result.Set("length", length);
+    result.Set("duration", duration);
+    result.Set("rapid", rapid);
+    return result;
+  }
+
+} // namespace GCodeParser
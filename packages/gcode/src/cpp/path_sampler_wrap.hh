@@ -0,0 +1,69 @@
+/**
+ * Path Sampler Wrap - Header
+ *
+ * JS class around PathSampler. Built synchronously from a parse result
+ * object or a compact-encoded buffer; queries run on the calling thread.
+ */
+
+#ifndef GCODE_PATH_SAMPLER_WRAP_HH
+#define GCODE_PATH_SAMPLER_WRAP_HH
+
+#include <napi.h>
+#include "path_sampler.hh"
+
+namespace GCodeParser
+{
+
+  class PathSamplerWrap : public Napi::ObjectWrap<PathSamplerWrap>
+  {
+  public:
+    /**
+     * Define the PathSampler class for this environment.
+     */
+    static Napi::Function Init(Napi::Env env);
+
+    /**
+     * new PathSampler(source, options?)
+     * @param source - Parse result object, or Uint8Array from parseGCodeCompact
+     */
+    PathSamplerWrap(const Napi::CallbackInfo &info);
+
+  private:
+    Napi::Value GetLength(const Napi::CallbackInfo &info);
+    Napi::Value GetDuration(const Napi::CallbackInfo &info);
+    Napi::Value GetSegmentCount(const Napi::CallbackInfo &info);
+
+    /**
+     * atDistance(distance) / atTime(time)
+     */
+    Napi::Value AtDistance(const Napi::CallbackInfo &info);
+    Napi::Value AtTime(const Napi::CallbackInfo &info);
+
+    /**
+     * opAt(distance) - index of the operation being executed
+     */
+    Napi::Value OpAt(const Napi::CallbackInfo &info);
+
+    /**
+     * sample(values: Float64Array, byTime: boolean)
+     */
+    Napi::Value Sample(const Napi::CallbackInfo &info);
+
+    /**
+     * lineDistance(lineNumber)
+     */
+    Napi::Value LineDistance(const Napi::CallbackInfo &info);
+
+    /**
+     * timingTable() - { lineNumber, length, duration, rapid } per move
+     */
+    Napi::Value TimingTable(const Napi::CallbackInfo &info);
+
+    static Napi::Object sampleToJS(Napi::Env env, const PathSample &sample);
+
+    PathSampler sampler_;
+  };
+
+} // namespace GCodeParser
+
+#endif // GCODE_PATH_SAMPLER_WRAP_HH
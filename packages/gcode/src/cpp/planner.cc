@@ -0,0 +1,603 @@
+/**
+ * Planner - Implementation
+ *
+ * Offline simulation of the LinuxCNC trajectory planner over a toolpath.
+ */
+
+#include "planner.hh"
+#include "arc_geometry.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    constexpr double EPSILON = 1e-9;
+
+    // Deflection below which a corner counts as straight, and above which
+    // it counts as a reversal that has to stop
+    constexpr double STRAIGHT_ANGLE = 1e-4;
+    constexpr double REVERSAL_ANGLE = M_PI - 1e-3;
+
+    // Acceleration split on circular motion, as in the TP
+    constexpr double ARC_TANGENTIAL_RATIO = 0.5;
+    const double ARC_NORMAL_RATIO = std::sqrt(3.0) / 2.0;
+
+    /**
+     * One entry of the plan: a straight or circular move, or a pause
+     * (dwell or tool change) at the current position.
+     */
+    struct Move
+    {
+      enum Kind : uint8_t
+      {
+        LINE,
+        ARC,
+        PAUSE,
+      };
+
+      Kind kind = LINE;
+      const ToolpathMove *source = nullptr;
+      double start[3] = {0.0, 0.0, 0.0};
+      double end[3] = {0.0, 0.0, 0.0};
+      ArcFrame frame{};
+      double length = 0.0;
+      double pause = 0.0;     // Seconds, for PAUSE
+      double requested = 0.0; // mm/s
+      double vmax = 0.0;      // mm/s, all limits applied
+      double accel = 0.0;     // mm/s^2 along the path
+      double blendAccel = 0.0; // mm/s^2 available for a corner blend
+      double dirStart[3] = {0.0, 0.0, 0.0};
+      double dirEnd[3] = {0.0, 0.0, 0.0};
+      MotionMode mode = MotionMode::CONTINUOUS; // In effect when the move was programmed
+      double tolerance = 0.0;                   // mm, for CONTINUOUS
+      bool stopAfter = false;
+    };
+
+    /**
+     * Stop-to-stop run of moves, planned independently.
+     */
+    struct Block
+    {
+      size_t first = 0;
+      size_t last = 0; // Exclusive
+      double duration = 0.0;
+      double offset = 0.0;
+      std::vector<PlannedSegment> segments;
+      std::vector<PlannerSample> samples;
+    };
+
+    /**
+     * Trapezoidal profile of one move.
+     */
+    struct Profile
+    {
+      double v0, v1, vp, a;
+      double t1, t2, t3; // Accelerate, cruise, decelerate
+      double d1, d2;
+
+      Profile(double length, double entry, double exit, double vmax, double accel)
+          : v0(entry), v1(exit), a(accel)
+      {
+        vp = std::min(vmax, std::sqrt(std::max((2.0 * a * length + v0 * v0 + v1 * v1) / 2.0, 0.0)));
+        vp = std::max({vp, v0, v1});
+        d1 = (vp * vp - v0 * v0) / (2.0 * a);
+        double d3 = (vp * vp - v1 * v1) / (2.0 * a);
+        d2 = std::max(length - d1 - d3, 0.0);
+        t1 = (vp - v0) / a;
+        t2 = vp > EPSILON ? d2 / vp : 0.0;
+        t3 = (vp - v1) / a;
+      }
+
+      double duration() const { return t1 + t2 + t3; }
+
+      /** Distance travelled and velocity at time t into the move */
+      void at(double t, double &s, double &v) const
+      {
+        if (t < t1)
+        {
+          s = v0 * t + 0.5 * a * t * t;
+          v = v0 + a * t;
+        }
+        else if (t < t1 + t2)
+        {
+          s = d1 + vp * (t - t1);
+          v = vp;
+        }
+        else
+        {
+          double td = std::min(t - t1 - t2, t3);
+          s = d1 + d2 + vp * td - 0.5 * a * td * td;
+          v = vp - a * td;
+        }
+      }
+    };
+
+    void normalize(double *v)
+    {
+      double len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+      if (len > EPSILON)
+      {
+        v[0] /= len, v[1] /= len, v[2] /= len;
+      }
+    }
+
+    /**
+     * Tightest of the TRAJ limit and the axis limits projected onto the
+     * (unit) direction `dir`.
+     */
+    double directionalLimit(double trajLimit, const double *axisLimits, const double *dir)
+    {
+      double limit = trajLimit > 0.0 ? trajLimit : 1e300;
+      for (int i = 0; i < 3; i++)
+      {
+        if (axisLimits[i] > 0.0 && std::fabs(dir[i]) > EPSILON)
+        {
+          limit = std::min(limit, axisLimits[i] / std::fabs(dir[i]));
+        }
+      }
+      return limit;
+    }
+
+    /**
+     * Tangent of an arc at `fraction` of its sweep, in XYZ.
+     */
+    void arcTangent(const ArcFrame &frame, double fraction, double *dir)
+    {
+      double angle = frame.startAngle + frame.sweep * fraction;
+      dir[frame.first] = -frame.radius * std::sin(angle) * frame.sweep;
+      dir[frame.second] = frame.radius * std::cos(angle) * frame.sweep;
+      dir[frame.helix] = frame.helixDelta;
+      normalize(dir);
+    }
+
+    void positionAt(const Move &move, double s, double *pos)
+    {
+      double fraction = move.length > EPSILON ? std::clamp(s / move.length, 0.0, 1.0) : 1.0;
+      if (move.kind == Move::ARC)
+      {
+        const ArcFrame &f = move.frame;
+        double angle = f.startAngle + f.sweep * fraction;
+        pos[f.first] = move.source->centerFirst + f.radius * std::cos(angle);
+        pos[f.second] = move.source->centerSecond + f.radius * std::sin(angle);
+        pos[f.helix] = f.helixStart + f.helixDelta * fraction;
+        return;
+      }
+      for (int i = 0; i < 3; i++)
+      {
+        pos[i] = move.start[i] + (move.end[i] - move.start[i]) * fraction;
+      }
+    }
+
+    /**
+     * Turn the toolpath into moves with their individual limits.
+     */
+    std::vector<Move> buildMoves(const Toolpath &path, const PlannerOptions &options)
+    {
+      const MachineLimits &limits = options.limits;
+      std::vector<Move> moves;
+      moves.reserve(path.size());
+
+      double pos[3] = {0.0, 0.0, 0.0};
+      double feed = options.defaultFeedRate > 0.0 ? options.defaultFeedRate / 60.0 : limits.maxVelocity;
+      // The options hold until the program sets a mode with G61, G61.1 or G64
+      MotionMode mode = options.exactStop ? MotionMode::EXACT_STOP : MotionMode::CONTINUOUS;
+      double tolerance = options.tolerance;
+
+      auto addLine = [&](const ToolpathMove &source, const double *end, double requested, bool stop)
+      {
+        Move move;
+        move.kind = Move::LINE;
+        move.source = &source;
+        std::copy(pos, pos + 3, move.start);
+        std::copy(end, end + 3, move.end);
+        for (int i = 0; i < 3; i++)
+        {
+          move.dirStart[i] = end[i] - pos[i];
+        }
+        move.length = std::sqrt(move.dirStart[0] * move.dirStart[0] + move.dirStart[1] * move.dirStart[1] +
+                                move.dirStart[2] * move.dirStart[2]);
+        std::copy(end, end + 3, pos);
+        if (move.length <= EPSILON)
+        {
+          if (stop && !moves.empty())
+          {
+            moves.back().stopAfter = true;
+          }
+          return;
+        }
+        normalize(move.dirStart);
+        std::copy(move.dirStart, move.dirStart + 3, move.dirEnd);
+
+        move.requested = requested;
+        move.vmax = std::min(requested, directionalLimit(limits.maxVelocity, limits.axisVelocity, move.dirStart));
+        move.accel = directionalLimit(limits.maxAcceleration, limits.axisAcceleration, move.dirStart);
+        move.blendAccel = move.accel;
+        move.mode = mode;
+        move.tolerance = tolerance;
+        move.stopAfter = stop;
+        if (stop && !moves.empty())
+        {
+          moves.back().stopAfter = true;
+        }
+        moves.push_back(move);
+      };
+
+      auto addPause = [&](const ToolpathMove &source, double seconds)
+      {
+        Move move;
+        move.kind = Move::PAUSE;
+        move.source = &source;
+        std::copy(pos, pos + 3, move.start);
+        std::copy(pos, pos + 3, move.end);
+        move.pause = std::max(seconds, 0.0);
+        move.stopAfter = true;
+        if (!moves.empty())
+        {
+          moves.back().stopAfter = true;
+        }
+        moves.push_back(move);
+      };
+
+      for (const ToolpathMove &source : path)
+      {
+        switch (source.kind)
+        {
+        case ToolpathMove::FEED_RATE:
+          if (source.value > 0.0)
+          {
+            feed = source.value / 60.0;
+          }
+          break;
+        case ToolpathMove::MOTION_MODE:
+          mode = static_cast<MotionMode>(source.mode);
+          tolerance = std::max(source.value, 0.0);
+          break;
+        case ToolpathMove::DWELL:
+          addPause(source, source.value);
+          break;
+        case ToolpathMove::TOOL_CHANGE:
+          addPause(source, options.toolChangeTime);
+          break;
+        case ToolpathMove::RAPID:
+          addLine(source, source.end, limits.maxVelocity * options.rapidOverride, false);
+          break;
+        case ToolpathMove::FEED:
+          addLine(source, source.end, feed * options.feedOverride, false);
+          break;
+        case ToolpathMove::PROBE:
+          addLine(source, source.end, feed * options.feedOverride, true);
+          break;
+        case ToolpathMove::RIGID_TAP:
+        {
+          // In to depth and back out to the starting Z, stopping at both ends
+          double top[3] = {source.end[0], source.end[1], pos[2]};
+          addLine(source, source.end, feed * options.feedOverride, true);
+          addLine(source, top, feed * options.feedOverride, true);
+          break;
+        }
+        case ToolpathMove::ARC:
+        {
+          Move move;
+          move.kind = Move::ARC;
+          move.source = &source;
+          std::copy(pos, pos + 3, move.start);
+          std::copy(source.end, source.end + 3, move.end);
+
+          if (!arcFrame(pos, source.end, source.plane, source.centerFirst, source.centerSecond,
+                        source.rotation, move.frame) ||
+              move.frame.radius <= EPSILON)
+          {
+            addLine(source, source.end, feed * options.feedOverride, false);
+            break;
+          }
+          std::copy(source.end, source.end + 3, pos);
+
+          double planar = move.frame.radius * std::fabs(move.frame.sweep);
+          move.length = std::sqrt(planar * planar + move.frame.helixDelta * move.frame.helixDelta);
+          arcTangent(move.frame, 0.0, move.dirStart);
+          arcTangent(move.frame, 1.0, move.dirEnd);
+
+          // Every axis of the plane sees the full velocity somewhere on the arc
+          double planeDir[3] = {0.0, 0.0, 0.0};
+          planeDir[move.frame.first] = 1.0;
+          planeDir[move.frame.second] = 1.0;
+          double velocity = directionalLimit(limits.maxVelocity, limits.axisVelocity, planeDir);
+          double accel = directionalLimit(limits.maxAcceleration, limits.axisAcceleration, planeDir);
+
+          double centripetal = std::sqrt(accel * ARC_NORMAL_RATIO * move.frame.radius);
+          move.requested = feed * options.feedOverride;
+          move.vmax = std::min({move.requested, velocity, centripetal});
+          move.accel = accel * ARC_TANGENTIAL_RATIO;
+          move.blendAccel = accel;
+          move.mode = mode;
+          move.tolerance = tolerance;
+          moves.push_back(move);
+          break;
+        }
+        }
+      }
+
+      return moves;
+    }
+
+    /**
+     * Highest speed through the corner from `a` into `b`, under the motion
+     * mode `a` was programmed in.
+     */
+    double cornerVelocity(const Move &a, const Move &b)
+    {
+      if (a.mode == MotionMode::EXACT_STOP)
+      {
+        return 0.0;
+      }
+
+      double cosAngle = a.dirEnd[0] * b.dirStart[0] + a.dirEnd[1] * b.dirStart[1] + a.dirEnd[2] * b.dirStart[2];
+      double deflection = std::acos(std::clamp(cosAngle, -1.0, 1.0));
+      double vmax = std::min(a.vmax, b.vmax);
+
+      if (deflection < STRAIGHT_ANGLE)
+      {
+        return vmax;
+      }
+      if (deflection > REVERSAL_ANGLE || a.mode == MotionMode::EXACT_PATH)
+      {
+        return 0.0;
+      }
+
+      // Tangent circle that consumes at most half of either move and stays
+      // within the path tolerance of the corner
+      double half = deflection / 2.0;
+      double radius = std::min(a.length, b.length) / 2.0 / std::tan(half);
+      if (a.tolerance > 0.0)
+      {
+        radius = std::min(radius, a.tolerance / (1.0 / std::cos(half) - 1.0));
+      }
+
+      double accel = std::min(a.blendAccel, b.blendAccel) * ARC_NORMAL_RATIO;
+      return std::min(vmax, std::sqrt(accel * radius));
+    }
+
+    /**
+     * Plan the velocities of moves [first, last), starting and ending at rest.
+     */
+    void planBlock(const std::vector<Move> &moves, Block &block, const PlannerOptions &options)
+    {
+      if (moves[block.first].kind == Move::PAUSE)
+      {
+        const Move &move = moves[block.first];
+        PlannedSegment seg;
+        seg.opIndex = move.source->opIndex;
+        seg.lineNumber = move.source->lineNumber;
+        seg.duration = move.pause;
+        block.segments.push_back(seg);
+        block.duration = move.pause;
+        return;
+      }
+
+      size_t n = block.last - block.first;
+      auto at = [&](size_t i) -> const Move &
+      { return moves[block.first + i]; };
+
+      // Corner limits, then backward pass: every move must be able to slow
+      // to the next corner speed
+      std::vector<double> exit(n, 0.0);
+      for (size_t i = 0; i + 1 < n; i++)
+      {
+        exit[i] = cornerVelocity(at(i), at(i + 1));
+      }
+      for (size_t i = n - 1; i-- > 0;)
+      {
+        const Move &next = at(i + 1);
+        exit[i] = std::min(exit[i], std::sqrt(exit[i + 1] * exit[i + 1] + 2.0 * next.accel * next.length));
+      }
+
+      // Limited look-ahead: the TP only knows the next `depth` moves and has
+      // to be able to stop at the end of the last one it knows
+      size_t depth = static_cast<size_t>(std::max(options.limits.lookahead, 1));
+      std::vector<double> stopBudget(n + 1, 0.0); // Prefix sums of 2 a L
+      for (size_t i = 0; i < n; i++)
+      {
+        stopBudget[i + 1] = stopBudget[i] + 2.0 * at(i).accel * at(i).length;
+      }
+      for (size_t i = 0; i + 1 < n; i++)
+      {
+        size_t horizon = std::min(i + depth, n - 1);
+        exit[i] = std::min(exit[i], std::sqrt(stopBudget[horizon + 1] - stopBudget[i + 1]));
+      }
+
+      // Forward pass: every move must be able to reach its exit speed
+      double entry = 0.0;
+      double time = 0.0;
+      block.segments.reserve(n);
+      for (size_t i = 0; i < n; i++)
+      {
+        const Move &move = at(i);
+        exit[i] = std::min(exit[i], std::sqrt(entry * entry + 2.0 * move.accel * move.length));
+
+        Profile profile(move.length, entry, exit[i], move.vmax, move.accel);
+
+        PlannedSegment seg;
+        seg.opIndex = move.source->opIndex;
+        seg.lineNumber = move.source->lineNumber;
+        seg.startTime = time;
+        seg.duration = profile.duration();
+        seg.length = move.length;
+        seg.requestedVelocity = move.requested * 60.0;
+        seg.entryVelocity = entry * 60.0;
+        seg.exitVelocity = exit[i] * 60.0;
+        seg.peakVelocity = profile.vp * 60.0;
+        block.segments.push_back(seg);
+
+        time += seg.duration;
+        entry = exit[i];
+      }
+      block.duration = time;
+    }
+
+    /**
+     * Sample a planned block on the global `interval` grid.
+     */
+    void sampleBlock(const std::vector<Move> &moves, Block &block, double interval)
+    {
+      size_t k = static_cast<size_t>(std::ceil(block.offset / interval - 1e-9));
+
+      for (size_t i = 0; i < block.segments.size(); i++)
+      {
+        PlannedSegment &seg = block.segments[i];
+        const Move &move = moves[block.first + i];
+        double end = seg.startTime + seg.duration;
+
+        if (move.kind == Move::PAUSE)
+        {
+          for (double t = k * interval; t < end; t = ++k * interval)
+          {
+            PlannerSample sample;
+            sample.time = t;
+            std::copy(move.start, move.start + 3, sample.pos);
+            sample.opIndex = seg.opIndex;
+            block.samples.push_back(sample);
+          }
+          continue;
+        }
+
+        Profile profile(move.length, seg.entryVelocity / 60.0, seg.exitVelocity / 60.0,
+                        seg.peakVelocity / 60.0, move.accel);
+        for (double t = k * interval; t < end; t = ++k * interval)
+        {
+          double s, v;
+          profile.at(t - seg.startTime, s, v);
+          PlannerSample sample;
+          sample.time = t;
+          positionAt(move, s, sample.pos);
+          sample.velocity = v * 60.0;
+          sample.opIndex = seg.opIndex;
+          block.samples.push_back(sample);
+        }
+      }
+    }
+
+    template <typename Fn>
+    void parallelFor(size_t count, unsigned threads, Fn &&fn)
+    {
+      if (threads == 0)
+      {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+      if (threads <= 1)
+      {
+        for (size_t i = 0; i < count; i++)
+        {
+          fn(i);
+        }
+        return;
+      }
+
+      std::atomic<size_t> next{0};
+      auto worker = [&]()
+      {
+        for (size_t i = next++; i < count; i = next++)
+        {
+          fn(i);
+        }
+      };
+
+      std::vector<std::thread> pool;
+      pool.reserve(threads - 1);
+      for (unsigned t = 1; t < threads; t++)
+      {
+        pool.emplace_back(worker);
+      }
+      worker();
+      for (std::thread &thread : pool)
+      {
+        thread.join();
+      }
+    }
+  } // namespace
+
+  PlanResult planToolpath(const Toolpath &path, const PlannerOptions &options)
+  {
+    if (!(options.limits.maxVelocity > 0.0) || !(options.limits.maxAcceleration > 0.0))
+    {
+      throw std::invalid_argument("Planner needs a positive maximum velocity and acceleration");
+    }
+    if (!(options.feedOverride > 0.0) || !(options.rapidOverride > 0.0))
+    {
+      throw std::invalid_argument("Overrides must be positive");
+    }
+
+    std::vector<Move> moves = buildMoves(path, options);
+
+    // Cut at every stop; pauses are blocks of their own
+    std::vector<Block> blocks;
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+      if (blocks.empty() || moves[i].kind == Move::PAUSE || moves[i - 1].stopAfter)
+      {
+        Block block;
+        block.first = i;
+        blocks.push_back(block);
+      }
+      blocks.back().last = i + 1;
+    }
+
+    parallelFor(blocks.size(), options.threads, [&](size_t i)
+                { planBlock(moves, blocks[i], options); });
+
+    PlanResult result;
+    result.blocks = blocks.size();
+    for (Block &block : blocks)
+    {
+      block.offset = result.duration;
+      for (PlannedSegment &seg : block.segments)
+      {
+        seg.startTime += block.offset;
+      }
+      result.duration += block.duration;
+    }
+
+    if (options.sampleInterval > 0.0)
+    {
+      parallelFor(blocks.size(), options.threads, [&](size_t i)
+                  { sampleBlock(moves, blocks[i], options.sampleInterval); });
+    }
+
+    size_t segmentCount = 0;
+    size_t sampleCount = 0;
+    for (const Block &block : blocks)
+    {
+      segmentCount += block.segments.size();
+      sampleCount += block.samples.size();
+    }
+    result.segments.reserve(segmentCount);
+    result.samples.reserve(sampleCount + 1);
+    for (Block &block : blocks)
+    {
+      result.segments.insert(result.segments.end(), block.segments.begin(), block.segments.end());
+      result.samples.insert(result.samples.end(), block.samples.begin(), block.samples.end());
+      std::vector<PlannedSegment>().swap(block.segments);
+      std::vector<PlannerSample>().swap(block.samples);
+    }
+
+    // Close the trace at the end point
+    if (options.sampleInterval > 0.0 && !moves.empty())
+    {
+      PlannerSample last;
+      last.time = result.duration;
+      std::copy(moves.back().end, moves.back().end + 3, last.pos);
+      last.opIndex = moves.back().source->opIndex;
+      result.samples.push_back(last);
+    }
+
+    return result;
+  }
+
+} // namespace GCodeParser
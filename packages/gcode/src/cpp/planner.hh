@@ -0,0 +1,108 @@
+/**
+ * Planner - Header
+ *
+ * Offline simulation of the LinuxCNC trajectory planner over a toolpath,
+ * for cycle-time estimates that account for acceleration, corner blending
+ * and the limited look-ahead of the real TP.
+ *
+ * Model:
+ * - Each move gets a trapezoidal velocity profile under its requested
+ *   velocity (feed x override, or the rapid rate) and the TRAJ and AXIS
+ *   velocity/acceleration limits projected onto its direction.
+ * - Arcs are additionally limited by centripetal acceleration. Like the TP,
+ *   arcs split the acceleration budget: half tangential, sqrt(3)/2 normal.
+ * - Each move ends under the motion mode in effect when it was programmed.
+ *   G64 blends corners with a tangent circle whose radius is bounded by the
+ *   path tolerance (G64 P) and by half of each adjacent move; the corner
+ *   speed is the speed that circle allows. G61 stops at corners that are
+ *   not tangent, G61.1 after every move. Blend arcs do not change the path
+ *   length used for timing.
+ * - The final velocity of each move is limited so the tool could still stop
+ *   within the next `lookahead` moves (ARC_BLEND_OPTIMIZATION_DEPTH).
+ * - Dwells, tool changes, probes and rigid taps stop the motion. The path
+ *   is cut into blocks at these stops and the blocks are planned on
+ *   separate threads.
+ */
+
+#ifndef GCODE_PLANNER_HH
+#define GCODE_PLANNER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "toolpath.hh"
+
+namespace GCodeParser
+{
+
+  /**
+   * Machine limits, in mm/s and mm/s^2.
+   */
+  struct MachineLimits
+  {
+    double maxVelocity = 0.0;
+    double maxAcceleration = 0.0;
+    double axisVelocity[3] = {0.0, 0.0, 0.0};     // X, Y, Z (0 = unlimited)
+    double axisAcceleration[3] = {0.0, 0.0, 0.0}; // X, Y, Z (0 = unlimited)
+    int lookahead = 50;
+  };
+
+  struct PlannerOptions
+  {
+    MachineLimits limits;
+    // Motion mode until the program's first G61, G61.1 or G64
+    double tolerance = 0.0;        // G64 P, in mm (0 = no tolerance limit)
+    bool exactStop = false;        // G61.1: stop after every move
+    double feedOverride = 1.0;     // Applied to feeds, not rapids
+    double rapidOverride = 1.0;
+    double defaultFeedRate = 0.0;  // mm/min before the first F word (0 = maxVelocity)
+    double toolChangeTime = 0.0;   // Seconds per tool change
+    double sampleInterval = 0.0;   // Seconds between samples (0 = none)
+    unsigned threads = 0;          // 0 = hardware concurrency
+  };
+
+  /**
+   * Achieved motion of one move (a rigid tap yields two: in and out).
+   * Velocities are in mm/min, like feed rates.
+   */
+  struct PlannedSegment
+  {
+    uint32_t opIndex = 0;
+    int32_t lineNumber = 0;
+    double startTime = 0.0; // Seconds from program start
+    double duration = 0.0;
+    double length = 0.0;            // mm
+    double requestedVelocity = 0.0; // Programmed feed (or rapid rate) x override
+    double entryVelocity = 0.0;
+    double exitVelocity = 0.0;
+    double peakVelocity = 0.0;
+  };
+
+  /**
+   * Tool state at one instant of the simulation.
+   */
+  struct PlannerSample
+  {
+    double time = 0.0;
+    double pos[3] = {0.0, 0.0, 0.0};
+    double velocity = 0.0; // mm/min
+    uint32_t opIndex = 0;
+  };
+
+  struct PlanResult
+  {
+    double duration = 0.0; // Seconds
+    size_t blocks = 0;     // Stop-to-stop blocks planned independently
+    std::vector<PlannedSegment> segments;
+    std::vector<PlannerSample> samples;
+  };
+
+  /**
+   * Simulate the planner over a toolpath starting at rest at the origin.
+   * @throws std::invalid_argument if a limit or override is not positive
+   */
+  PlanResult planToolpath(const Toolpath &path, const PlannerOptions &options);
+
+} // namespace GCodeParser
+
+#endif // GCODE_PLANNER_HH
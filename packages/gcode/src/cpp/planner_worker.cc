@@ -0,0 +1,293 @@
+/**
+ * Planner Worker - Implementation
+ *
+ * Async worker that runs the trajectory planner simulation off the event
+ * loop.
+ */
+
+#include "planner_worker.hh"
+#include "napi_helpers.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <strings.h>
+#include "inifile.h"
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    const char *AXIS_SECTIONS[3] = {"AXIS_X", "AXIS_Y", "AXIS_Z"};
+
+    std::optional<double> findIniNumber(const std::string &filename, const char *tag, const char *section)
+    {
+      char value[INI_MAX_LINELEN] = {};
+      if (iniFindString(filename.c_str(), tag, section, value, sizeof(value)) != 0)
+      {
+        return std::nullopt;
+      }
+
+      char *end = nullptr;
+      double number = std::strtod(value, &end);
+      if (end == value)
+      {
+        return std::nullopt;
+      }
+      return number;
+    }
+
+    /**
+     * mm per [TRAJ]LINEAR_UNITS; the INI default is mm.
+     */
+    double linearUnitScale(const std::string &filename)
+    {
+      char value[INI_MAX_LINELEN] = {};
+      if (iniFindString(filename.c_str(), "LINEAR_UNITS", "TRAJ", value, sizeof(value)) != 0)
+      {
+        return 1.0;
+      }
+      if (strcasecmp(value, "inch") == 0 || strcasecmp(value, "in") == 0 || strcasecmp(value, "imperial") == 0)
+      {
+        return 25.4;
+      }
+      if (strcasecmp(value, "cm") == 0)
+      {
+        return 10.0;
+      }
+      char *end = nullptr;
+      double units = std::strtod(value, &end);
+      // A number is units per mm, as in EMC_TRAJ linearUnits
+      return end != value && units > 0.0 ? 1.0 / units : 1.0;
+    }
+
+    void setOverride(Napi::Object obj, const char *key, double &target)
+    {
+      double value = numberOr(obj, key, 0.0);
+      if (value > 0.0)
+      {
+        target = value;
+      }
+    }
+  } // namespace
+
+  PlannerWorker::PlannerWorker(
+      Napi::Function &callback,
+      Toolpath path,
+      const std::string &iniPath,
+      const MachineLimits &overrides,
+      const PlannerOptions &options)
+      : Napi::AsyncWorker(callback),
+        path_(std::move(path)),
+        iniPath_(iniPath),
+        overrides_(overrides),
+        options_(options)
+  {
+  }
+
+  void PlannerWorker::Execute()
+  {
+    try
+    {
+      MachineLimits limits = iniPath_.empty() ? MachineLimits{} : limitsFromIni(iniPath_);
+
+      auto apply = [](double override, double &target)
+      {
+        if (override > 0.0)
+        {
+          target = override;
+        }
+      };
+      apply(overrides_.maxVelocity, limits.maxVelocity);
+      apply(overrides_.maxAcceleration, limits.maxAcceleration);
+      for (int i = 0; i < 3; i++)
+      {
+        apply(overrides_.axisVelocity[i], limits.axisVelocity[i]);
+        apply(overrides_.axisAcceleration[i], limits.axisAcceleration[i]);
+      }
+      if (overrides_.lookahead > 0)
+      {
+        limits.lookahead = overrides_.lookahead;
+      }
+
+      options_.limits = limits;
+      result_ = planToolpath(path_, options_);
+    }
+    catch (const std::exception &e)
+    {
+      SetError(e.what());
+    }
+  }
+
+  void PlannerWorker::OnOK()
+  {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+
+    const std::vector<PlannedSegment> &segments = result_.segments;
+    size_t n = segments.size();
+
+    Napi::Uint32Array segOp = Napi::Uint32Array::New(env, n);
+    Napi::Int32Array segLine = Napi::Int32Array::New(env, n);
+    Napi::Float64Array startTime = Napi::Float64Array::New(env, n);
+    Napi::Float64Array duration = Napi::Float64Array::New(env, n);
+    Napi::Float64Array length = Napi::Float64Array::New(env, n);
+    Napi::Float64Array requested = Napi::Float64Array::New(env, n);
+    Napi::Float64Array entry = Napi::Float64Array::New(env, n);
+    Napi::Float64Array exit = Napi::Float64Array::New(env, n);
+    Napi::Float64Array peak = Napi::Float64Array::New(env, n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+      const PlannedSegment &seg = segments[i];
+      segOp[i] = seg.opIndex;
+      segLine[i] = seg.lineNumber;
+      startTime[i] = seg.startTime;
+      duration[i] = seg.duration;
+      length[i] = seg.length;
+      requested[i] = seg.requestedVelocity;
+      entry[i] = seg.entryVelocity;
+      exit[i] = seg.exitVelocity;
+      peak[i] = seg.peakVelocity;
+    }
+
+    Napi::Object segObj = Napi::Object::New(env);
+    segObj.Set("opIndex", segOp);
+    segObj.Set("lineNumber", segLine);
+    segObj.Set("startTime", startTime);
+    segObj.Set("duration", duration);
+    segObj.Set("length", length);
+    segObj.Set("requestedVelocity", requested);
+    segObj.Set("entryVelocity", entry);
+    segObj.Set("exitVelocity", exit);
+    segObj.Set("peakVelocity", peak);
+
+    const std::vector<PlannerSample> &samples = result_.samples;
+    size_t m = samples.size();
+
+    Napi::Float64Array sampleTime = Napi::Float64Array::New(env, m);
+    Napi::Float64Array positions = Napi::Float64Array::New(env, m * 3);
+    Napi::Float64Array velocity = Napi::Float64Array::New(env, m);
+    Napi::Uint32Array sampleOp = Napi::Uint32Array::New(env, m);
+
+    for (size_t i = 0; i < m; i++)
+    {
+      const PlannerSample &sample = samples[i];
+      sampleTime[i] = sample.time;
+      positions[i * 3] = sample.pos[0];
+      positions[i * 3 + 1] = sample.pos[1];
+      positions[i * 3 + 2] = sample.pos[2];
+      velocity[i] = sample.velocity;
+      sampleOp[i] = sample.opIndex;
+    }
+
+    Napi::Object sampleObj = Napi::Object::New(env);
+    sampleObj.Set("time", sampleTime);
+    sampleObj.Set("positions", positions);
+    sampleObj.Set("velocity", velocity);
+    sampleObj.Set("opIndex", sampleOp);
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("duration", Napi::Number::New(env, result_.duration));
+    obj.Set("blocks", Napi::Number::New(env, static_cast<double>(result_.blocks)));
+    obj.Set("segments", segObj);
+    obj.Set("samples", sampleObj);
+
+    Callback().Call({env.Null(), obj});
+  }
+
+  void PlannerWorker::OnError(const Napi::Error &error)
+  {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+
+    Callback().Call({error.Value(), env.Null()});
+  }
+
+  PlannerOptions PlannerWorker::optionsFromJS(Napi::Object obj, MachineLimits &overrides)
+  {
+    PlannerOptions options;
+
+    options.tolerance = std::max(numberOr(obj, "tolerance", options.tolerance), 0.0);
+    options.feedOverride = numberOr(obj, "feedOverride", options.feedOverride);
+    options.rapidOverride = numberOr(obj, "rapidOverride", options.rapidOverride);
+    options.defaultFeedRate = std::max(numberOr(obj, "defaultFeedRate", options.defaultFeedRate), 0.0);
+    options.toolChangeTime = std::max(numberOr(obj, "toolChangeTime", options.toolChangeTime), 0.0);
+    options.sampleInterval = std::max(numberOr(obj, "sampleInterval", options.sampleInterval), 0.0);
+    options.threads = static_cast<unsigned>(std::max(numberOr(obj, "threads", 0), 0.0));
+
+    Napi::Value exactStop = obj.Get("exactStop");
+    if (exactStop.IsBoolean())
+    {
+      options.exactStop = exactStop.As<Napi::Boolean>().Value();
+    }
+
+    overrides = MachineLimits{};
+    overrides.lookahead = 0;
+    Napi::Value limitsValue = obj.Get("limits");
+    if (limitsValue.IsObject())
+    {
+      Napi::Object limits = limitsValue.As<Napi::Object>();
+      setOverride(limits, "maxVelocity", overrides.maxVelocity);
+      setOverride(limits, "maxAcceleration", overrides.maxAcceleration);
+      overrides.lookahead = static_cast<int>(std::max(numberOr(limits, "lookahead", 0), 0.0));
+
+      Napi::Value axisVelocity = limits.Get("axisVelocity");
+      if (!axisVelocity.IsUndefined())
+      {
+        readXYZ(axisVelocity, overrides.axisVelocity);
+      }
+      Napi::Value axisAcceleration = limits.Get("axisAcceleration");
+      if (!axisAcceleration.IsUndefined())
+      {
+        readXYZ(axisAcceleration, overrides.axisAcceleration);
+      }
+    }
+
+    return options;
+  }
+
+  MachineLimits PlannerWorker::limitsFromIni(const std::string &iniPath)
+  {
+    MachineLimits limits;
+    double scale = linearUnitScale(iniPath);
+
+    auto velocity = findIniNumber(iniPath, "MAX_LINEAR_VELOCITY", "TRAJ");
+    if (!velocity)
+    {
+      velocity = findIniNumber(iniPath, "MAX_VELOCITY", "TRAJ");
+    }
+    auto acceleration = findIniNumber(iniPath, "MAX_LINEAR_ACCELERATION", "TRAJ");
+    if (!acceleration)
+    {
+      acceleration = findIniNumber(iniPath, "MAX_ACCELERATION", "TRAJ");
+    }
+    if (!velocity || !acceleration)
+    {
+      throw std::runtime_error("No [TRAJ] velocity/acceleration limits in " + iniPath);
+    }
+    limits.maxVelocity = *velocity * scale;
+    limits.maxAcceleration = *acceleration * scale;
+
+    for (int i = 0; i < 3; i++)
+    {
+      if (auto axisVelocity = findIniNumber(iniPath, "MAX_VELOCITY", AXIS_SECTIONS[i]))
+      {
+        limits.axisVelocity[i] = *axisVelocity * scale;
+      }
+      if (auto axisAcceleration = findIniNumber(iniPath, "MAX_ACCELERATION", AXIS_SECTIONS[i]))
+      {
+        limits.axisAcceleration[i] = *axisAcceleration * scale;
+      }
+    }
+
+    if (auto depth = findIniNumber(iniPath, "ARC_BLEND_OPTIMIZATION_DEPTH", "TRAJ"))
+    {
+      limits.lookahead = std::max(static_cast<int>(*depth), 1);
+    }
+
+    return limits;
+  }
+
+} // namespace GCodeParser
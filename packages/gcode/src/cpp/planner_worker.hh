@@ -0,0 +1,67 @@
+/**
+ * Planner Worker - Header
+ *
+ * Async worker that runs the trajectory planner simulation off the event
+ * loop.
+ */
+
+#ifndef GCODE_PLANNER_WORKER_HH
+#define GCODE_PLANNER_WORKER_HH
+
+#include <napi.h>
+#include <string>
+#include "planner.hh"
+
+namespace GCodeParser
+{
+
+  /**
+   * Async worker that simulates the planner over one toolpath.
+   *
+   * The toolpath is copied out of JS on the calling thread; the machine
+   * limits are read from the INI file and the simulation runs on the libuv
+   * thread pool. Does not take parser_mutex.
+   */
+  class PlannerWorker : public Napi::AsyncWorker
+  {
+  public:
+    /**
+     * Non-zero fields of `overrides` replace the limits read from `iniPath`;
+     * an empty `iniPath` uses the overrides alone.
+     */
+    PlannerWorker(
+        Napi::Function &callback,
+        Toolpath path,
+        const std::string &iniPath,
+        const MachineLimits &overrides,
+        const PlannerOptions &options);
+
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+    /**
+     * Planner options from a JS object; missing fields keep their defaults.
+     * Limit overrides from `obj.limits` go to `overrides`, in the INI units
+     * (mm/s, mm/s^2) like the limits they replace.
+     */
+    static PlannerOptions optionsFromJS(Napi::Object obj, MachineLimits &overrides);
+
+    /**
+     * Velocity and acceleration limits from the [TRAJ] and [AXIS_X/Y/Z]
+     * sections of a LinuxCNC INI file, converted to mm.
+     * @throws std::runtime_error if the file has no TRAJ limits
+     */
+    static MachineLimits limitsFromIni(const std::string &iniPath);
+
+  private:
+    Toolpath path_;
+    std::string iniPath_;
+    MachineLimits overrides_;
+    PlannerOptions options_;
+    PlanResult result_;
+  };
+
+} // namespace GCodeParser
+
+#endif // GCODE_PLANNER_WORKER_HH
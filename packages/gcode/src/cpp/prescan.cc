@@ -0,0 +1,780 @@
+/**
+ * Pre-scan - Implementation
+ *
+ * Fast structural scan of a G-code file that runs without the interpreter.
+ */
+
+#include "prescan.hh"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    // ========================================================================
+    // Character classes
+    // ========================================================================
+
+    enum CharClass : uint8_t
+    {
+      C_OTHER = 0,
+      C_SPACE,
+      C_LETTER,
+      C_DIGIT,
+      C_SIGN,
+      C_DOT,
+      C_LBRACKET,
+      C_RBRACKET,
+      C_HASH,
+      C_LPAREN,
+      C_SEMICOLON,
+      C_PERCENT,
+      C_SLASH,
+      C_EQUALS,
+    };
+
+    struct ClassTable
+    {
+      uint8_t cls[256];
+
+      ClassTable()
+      {
+        std::memset(cls, C_OTHER, sizeof(cls));
+        for (int c = 'a'; c <= 'z'; c++)
+          cls[c] = C_LETTER;
+        for (int c = 'A'; c <= 'Z'; c++)
+          cls[c] = C_LETTER;
+        for (int c = '0'; c <= '9'; c++)
+          cls[c] = C_DIGIT;
+        cls[' '] = cls['\t'] = cls['\r'] = cls['\f'] = cls['\v'] = C_SPACE;
+        cls['+'] = cls['-'] = C_SIGN;
+        cls['.'] = C_DOT;
+        cls['['] = C_LBRACKET;
+        cls[']'] = C_RBRACKET;
+        cls['#'] = C_HASH;
+        cls['('] = C_LPAREN;
+        cls[';'] = C_SEMICOLON;
+        cls['%'] = C_PERCENT;
+        cls['/'] = C_SLASH;
+        cls['='] = C_EQUALS;
+      }
+    };
+
+    const ClassTable kClasses;
+
+    inline uint8_t classOf(char c)
+    {
+      return kClasses.cls[static_cast<unsigned char>(c)];
+    }
+
+    // ========================================================================
+    // O-word structure
+    // ========================================================================
+
+    enum class BlockKind
+    {
+      SUB,
+      DO,
+      WHILE,
+      IF,
+      REPEAT,
+    };
+
+    struct OpenBlock
+    {
+      BlockKind kind;
+      std::string name;
+      size_t line;
+      size_t subIndex; // Index into subroutines for SUB blocks
+    };
+
+    const char *blockKeyword(BlockKind kind)
+    {
+      switch (kind)
+      {
+      case BlockKind::SUB:
+        return "sub";
+      case BlockKind::DO:
+        return "do";
+      case BlockKind::WHILE:
+        return "while";
+      case BlockKind::IF:
+        return "if";
+      case BlockKind::REPEAT:
+        return "repeat";
+      }
+      return "";
+    }
+
+    // ========================================================================
+    // Scanner
+    // ========================================================================
+
+    class Scanner
+    {
+    public:
+      Scanner(PrescanResult &result, size_t maxIssues)
+          : result_(result), maxIssues_(maxIssues) {}
+
+      void scanLine(const char *begin, const char *end, size_t lineNumber);
+      void finish();
+
+    private:
+      void issue(size_t column, const std::string &message);
+      const char *skipSpaces(const char *p) const;
+      const char *skipComment(const char *p);
+      const char *skipExpression(const char *p);
+      const char *skipParameter(const char *p);
+      const char *skipValue(const char *p, bool &ok);
+      const char *scanWord(const char *p);
+      void scanOWord(const char *p);
+      void closeBlock(BlockKind kind, const std::string &name, const char *keyword, const char *at);
+
+      size_t column(const char *p) const { return static_cast<size_t>(p - lineBegin_) + 1; }
+
+      // Flat G/M histograms for codes below 1000, indexed in tenths of a code
+      // (G38.2 -> 382); folded into the maps in finish()
+      static constexpr int kHistogramSize = 10000;
+
+      PrescanResult &result_;
+      std::vector<uint64_t> gHistogram_ = std::vector<uint64_t>(kHistogramSize, 0);
+      std::vector<uint64_t> mHistogram_ = std::vector<uint64_t>(kHistogramSize, 0);
+      size_t maxIssues_;
+      std::vector<OpenBlock> stack_;
+      const char *lineBegin_ = nullptr;
+      const char *lineEnd_ = nullptr;
+      size_t lineNumber_ = 0;
+    };
+
+    void Scanner::issue(size_t column, const std::string &message)
+    {
+      if (result_.issues.size() >= maxIssues_)
+      {
+        result_.issuesTruncated = true;
+        return;
+      }
+      result_.issues.push_back({lineNumber_, column, message});
+    }
+
+    const char *Scanner::skipSpaces(const char *p) const
+    {
+      while (p < lineEnd_ && classOf(*p) == C_SPACE)
+        p++;
+      return p;
+    }
+
+    // p points at '('; returns the position after ')'
+    const char *Scanner::skipComment(const char *p)
+    {
+      const char *close = static_cast<const char *>(std::memchr(p, ')', lineEnd_ - p));
+      if (!close)
+      {
+        issue(column(p), "Unclosed comment");
+        return lineEnd_;
+      }
+      return close + 1;
+    }
+
+    // p points at '['; returns the position after the matching ']'
+    const char *Scanner::skipExpression(const char *p)
+    {
+      const char *start = p;
+      int depth = 0;
+      while (p < lineEnd_)
+      {
+        char c = *p;
+        if (c == '[')
+          depth++;
+        else if (c == ']')
+        {
+          if (--depth == 0)
+            return p + 1;
+        }
+        else if (c == '(')
+        {
+          p = skipComment(p);
+          continue;
+        }
+        p++;
+      }
+      issue(column(start), "Unbalanced brackets in expression");
+      return lineEnd_;
+    }
+
+    // p points at '#'; returns the position after the parameter reference
+    const char *Scanner::skipParameter(const char *p)
+    {
+      const char *start = p;
+      p++;
+      p = skipSpaces(p);
+      if (p >= lineEnd_)
+      {
+        issue(column(start), "Parameter without number or name");
+        return p;
+      }
+
+      uint8_t cls = classOf(*p);
+      if (*p == '<')
+      {
+        const char *close = static_cast<const char *>(std::memchr(p, '>', lineEnd_ - p));
+        if (!close)
+        {
+          issue(column(start), "Unclosed named parameter");
+          return lineEnd_;
+        }
+        return close + 1;
+      }
+      if (cls == C_DIGIT)
+      {
+        while (p < lineEnd_ && classOf(*p) == C_DIGIT)
+          p++;
+        return p;
+      }
+      if (cls == C_LBRACKET)
+        return skipExpression(p);
+      if (cls == C_HASH)
+        return skipParameter(p);
+
+      issue(column(start), "Parameter without number or name");
+      return p;
+    }
+
+    const char *Scanner::skipValue(const char *p, bool &ok)
+    {
+      ok = true;
+      p = skipSpaces(p);
+      while (p < lineEnd_ && classOf(*p) == C_SIGN)
+        p = skipSpaces(p + 1);
+
+      if (p >= lineEnd_)
+      {
+        ok = false;
+        return p;
+      }
+
+      switch (classOf(*p))
+      {
+      case C_DIGIT:
+      case C_DOT:
+        while (p < lineEnd_ && (classOf(*p) == C_DIGIT || *p == '.'))
+          p++;
+        return p;
+      case C_LBRACKET:
+        return skipExpression(p);
+      case C_HASH:
+        return skipParameter(p);
+      default:
+        ok = false;
+        return p;
+      }
+    }
+
+    // p points at a word letter; returns the position after the word
+    const char *Scanner::scanWord(const char *p)
+    {
+      const char *start = p;
+      char letter = static_cast<char>(*p & ~0x20); // ASCII upper-case
+
+      // Fast path: plain number directly after the letter (G1, X-1.5, F500)
+      const char *q = p + 1;
+      if (q < lineEnd_ && classOf(*q) == C_SIGN)
+        q++;
+      if (q < lineEnd_ && (classOf(*q) == C_DIGIT || *q == '.'))
+      {
+        int whole = 0;
+        int tenth = 0;
+        while (q < lineEnd_ && classOf(*q) == C_DIGIT)
+        {
+          if (whole < 100000)
+            whole = whole * 10 + (*q - '0');
+          q++;
+        }
+        if (q < lineEnd_ && *q == '.')
+        {
+          q++;
+          if (q < lineEnd_ && classOf(*q) == C_DIGIT)
+            tenth = *q - '0';
+          while (q < lineEnd_ && classOf(*q) == C_DIGIT)
+            q++;
+        }
+
+        result_.wordCounts[letter - 'A']++;
+        if ((letter == 'G' || letter == 'M') && classOf(p[1]) == C_DIGIT)
+        {
+          int code = whole * 10 + tenth;
+          if (code < kHistogramSize)
+            (letter == 'G' ? gHistogram_ : mHistogram_)[code]++;
+          else
+            (letter == 'G' ? result_.gCodes : result_.mCodes)[code]++;
+        }
+        return q;
+      }
+
+      const char *valueStart = skipSpaces(p + 1);
+      bool ok;
+      const char *valueEnd = skipValue(valueStart, ok);
+      if (!ok)
+      {
+        issue(column(start), std::string("Word '") + letter + "' has no value");
+        return valueEnd > p + 1 ? valueEnd : p + 1;
+      }
+
+      result_.wordCounts[letter - 'A']++;
+
+      // Histogram plain G/M numbers
+      if ((letter == 'G' || letter == 'M') && classOf(*valueStart) != C_LBRACKET &&
+          classOf(*valueStart) != C_HASH)
+      {
+        int whole = 0;
+        int tenth = 0;
+        const char *q = valueStart;
+        bool valid = q < valueEnd && classOf(*q) == C_DIGIT;
+        while (q < valueEnd && classOf(*q) == C_DIGIT && whole < 100000)
+          whole = whole * 10 + (*q++ - '0');
+        if (q < valueEnd && *q == '.')
+        {
+          q++;
+          if (q < valueEnd && classOf(*q) == C_DIGIT)
+            tenth = *q - '0';
+        }
+        if (valid)
+        {
+          int code = whole * 10 + tenth;
+          if (code < kHistogramSize)
+            (letter == 'G' ? gHistogram_ : mHistogram_)[code]++;
+          else
+            (letter == 'G' ? result_.gCodes : result_.mCodes)[code]++;
+        }
+      }
+
+      return valueEnd;
+    }
+
+    void Scanner::closeBlock(BlockKind kind, const std::string &name, const char *keyword, const char *at)
+    {
+      if (stack_.empty() || stack_.back().kind != kind || stack_.back().name != name)
+      {
+        issue(column(at), std::string("'o") + name + " " + keyword + "' without matching '" +
+                              blockKeyword(kind) + "'");
+        // Resync: drop to the matching block if it is further down
+        for (size_t i = stack_.size(); i-- > 0;)
+        {
+          if (stack_[i].kind == kind && stack_[i].name == name)
+          {
+            stack_.resize(i + 1);
+            break;
+          }
+        }
+        if (stack_.empty() || stack_.back().kind != kind || stack_.back().name != name)
+          return;
+      }
+
+      if (kind == BlockKind::SUB)
+        result_.subroutines[stack_.back().subIndex].endLine = lineNumber_;
+      stack_.pop_back();
+    }
+
+    // p points at the 'O' letter
+    void Scanner::scanOWord(const char *p)
+    {
+      const char *start = p;
+      p = skipSpaces(p + 1);
+
+      // Name: o<name> or oNNN; names are lowercased with spaces removed,
+      // matching the interpreter
+      std::string name;
+      if (p < lineEnd_ && *p == '<')
+      {
+        const char *close = static_cast<const char *>(std::memchr(p, '>', lineEnd_ - p));
+        if (!close)
+        {
+          issue(column(start), "Unclosed O-word name");
+          return;
+        }
+        name.push_back('<');
+        for (const char *q = p + 1; q < close; q++)
+        {
+          if (classOf(*q) != C_SPACE)
+            name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(*q))));
+        }
+        name.push_back('>');
+        p = close + 1;
+      }
+      else if (p < lineEnd_ && classOf(*p) == C_DIGIT)
+      {
+        while (p < lineEnd_ && classOf(*p) == C_DIGIT)
+          name.push_back(*p++);
+      }
+      else
+      {
+        issue(column(start), "O-word without number or name");
+        return;
+      }
+
+      p = skipSpaces(p);
+      std::string keyword;
+      while (p < lineEnd_ && classOf(*p) == C_LETTER)
+        keyword.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(*p++))));
+
+      auto inside = [&](BlockKind kind)
+      {
+        for (const auto &block : stack_)
+        {
+          if (block.kind == kind && block.name == name)
+            return true;
+        }
+        return false;
+      };
+
+      if (keyword == "sub")
+      {
+        result_.subroutines.push_back({name, lineNumber_, 0});
+        stack_.push_back({BlockKind::SUB, name, lineNumber_, result_.subroutines.size() - 1});
+      }
+      else if (keyword == "endsub")
+        closeBlock(BlockKind::SUB, name, "endsub", start);
+      else if (keyword == "call")
+        result_.calls.push_back({name, lineNumber_});
+      else if (keyword == "do")
+        stack_.push_back({BlockKind::DO, name, lineNumber_, 0});
+      else if (keyword == "while")
+      {
+        // "oN while" closes a do block of the same name, otherwise opens a loop
+        if (!stack_.empty() && stack_.back().kind == BlockKind::DO && stack_.back().name == name)
+          stack_.pop_back();
+        else
+          stack_.push_back({BlockKind::WHILE, name, lineNumber_, 0});
+      }
+      else if (keyword == "endwhile")
+        closeBlock(BlockKind::WHILE, name, "endwhile", start);
+      else if (keyword == "if")
+        stack_.push_back({BlockKind::IF, name, lineNumber_, 0});
+      else if (keyword == "elseif" || keyword == "else")
+      {
+        if (stack_.empty() || stack_.back().kind != BlockKind::IF || stack_.back().name != name)
+          issue(column(start), "'o" + name + " " + keyword + "' without matching 'if'");
+      }
+      else if (keyword == "endif")
+        closeBlock(BlockKind::IF, name, "endif", start);
+      else if (keyword == "repeat")
+        stack_.push_back({BlockKind::REPEAT, name, lineNumber_, 0});
+      else if (keyword == "endrepeat")
+        closeBlock(BlockKind::REPEAT, name, "endrepeat", start);
+      else if (keyword == "break" || keyword == "continue")
+      {
+        if (!inside(BlockKind::DO) && !inside(BlockKind::WHILE) && !inside(BlockKind::REPEAT))
+          issue(column(start), "'o" + name + " " + keyword + "' outside a loop of the same name");
+      }
+      else if (keyword == "return")
+      {
+        if (!inside(BlockKind::SUB))
+          issue(column(start), "'o" + name + " return' outside 'o" + name + " sub'");
+      }
+      else
+      {
+        issue(column(start), keyword.empty() ? "O-word without keyword"
+                                             : "Unknown O-word keyword '" + keyword + "'");
+        return;
+      }
+
+      // Arguments / conditions: only check that brackets and comments close
+      while (p < lineEnd_)
+      {
+        uint8_t cls = classOf(*p);
+        if (cls == C_LBRACKET)
+          p = skipExpression(p);
+        else if (cls == C_LPAREN)
+          p = skipComment(p);
+        else if (cls == C_SEMICOLON)
+          break;
+        else
+          p++;
+      }
+    }
+
+    void Scanner::scanLine(const char *begin, const char *end, size_t lineNumber)
+    {
+      lineBegin_ = begin;
+      lineEnd_ = end;
+      lineNumber_ = lineNumber;
+
+      const char *p = skipSpaces(begin);
+
+      // Block delete and program delimiter
+      if (p < end && *p == '/')
+        p = skipSpaces(p + 1);
+      if (p < end && *p == '%')
+        return;
+
+      // Optional N word, then an O-word takes over the whole line
+      if (p < end && (*p == 'N' || *p == 'n'))
+        p = skipSpaces(scanWord(p));
+      if (p < end && (*p == 'O' || *p == 'o'))
+      {
+        scanOWord(p);
+        return;
+      }
+
+      while (p < end)
+      {
+        switch (classOf(*p))
+        {
+        case C_SPACE:
+          p++;
+          break;
+        case C_LPAREN:
+          p = skipComment(p);
+          break;
+        case C_SEMICOLON:
+          return;
+        case C_LETTER:
+          p = scanWord(p);
+          break;
+        case C_HASH:
+        {
+          // Parameter assignment: #n = value
+          const char *start = p;
+          p = skipSpaces(skipParameter(p));
+          if (p >= end || *p != '=')
+          {
+            issue(column(start), "Parameter reference without assignment");
+            break;
+          }
+          bool ok;
+          p = skipValue(p + 1, ok);
+          if (!ok)
+            issue(column(start), "Parameter assignment without value");
+          break;
+        }
+        case C_DIGIT:
+        case C_DOT:
+        case C_SIGN:
+        case C_LBRACKET:
+        {
+          const char *start = p;
+          bool ok;
+          p = skipValue(p, ok);
+          issue(column(start), "Value without word letter");
+          if (p == start)
+            p++;
+          break;
+        }
+        default:
+          issue(column(p), std::string("Unexpected character '") + *p + "'");
+          p++;
+          break;
+        }
+      }
+    }
+
+    void Scanner::finish()
+    {
+      for (int code = 0; code < kHistogramSize; code++)
+      {
+        if (gHistogram_[code])
+          result_.gCodes[code] += gHistogram_[code];
+        if (mHistogram_[code])
+          result_.mCodes[code] += mHistogram_[code];
+      }
+
+      for (const auto &block : stack_)
+      {
+        lineNumber_ = block.line;
+        issue(1, "'o" + block.name + " " + blockKeyword(block.kind) + "' is never closed");
+      }
+      stack_.clear();
+
+      std::set<std::string> defined;
+      for (const auto &sub : result_.subroutines)
+        defined.insert(sub.name);
+
+      std::set<std::string> external;
+      for (const auto &call : result_.calls)
+      {
+        if (defined.count(call.name))
+          continue;
+
+        if (call.name.front() == '<')
+        {
+          // Named subs are looked up as files on SUBROUTINE_PATH
+          if (external.insert(call.name).second)
+            result_.externalSubroutines.push_back(call.name.substr(1, call.name.size() - 2));
+        }
+        else
+        {
+          lineNumber_ = call.lineNumber;
+          issue(1, "Call to undefined subroutine 'o" + call.name + "'");
+        }
+      }
+    }
+
+    // ========================================================================
+    // File mapping
+    // ========================================================================
+
+    class MappedFile
+    {
+    public:
+      explicit MappedFile(const std::string &filepath)
+      {
+        fd_ = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0)
+          throw std::runtime_error("G-code file not found: " + filepath);
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0)
+        {
+          ::close(fd_);
+          throw std::runtime_error("Failed to stat G-code file: " + filepath);
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0)
+        {
+          void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+          if (addr == MAP_FAILED)
+          {
+            ::close(fd_);
+            throw std::runtime_error("Failed to map G-code file: " + filepath);
+          }
+          madvise(addr, size_, MADV_SEQUENTIAL);
+          data_ = static_cast<const char *>(addr);
+        }
+      }
+
+      ~MappedFile()
+      {
+        if (data_)
+          munmap(const_cast<char *>(data_), size_);
+        if (fd_ >= 0)
+          ::close(fd_);
+      }
+
+      MappedFile(const MappedFile &) = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+
+      const char *data() const { return data_; }
+      size_t size() const { return size_; }
+
+    private:
+      int fd_ = -1;
+      const char *data_ = nullptr;
+      size_t size_ = 0;
+    };
+
+  } // namespace
+
+  void indexLines(const char *data, size_t size, std::vector<uint64_t> &offsets)
+  {
+    offsets.clear();
+    if (size == 0)
+      return;
+
+    // ~25 bytes per line on average for G-code
+    offsets.reserve(size / 25 + 1);
+    offsets.push_back(0);
+
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i nl32 = _mm256_set1_epi8('\n');
+    for (; i + 32 <= size; i += 32)
+    {
+      __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+      uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, nl32)));
+      while (mask)
+      {
+        offsets.push_back(i + __builtin_ctz(mask) + 1);
+        mask &= mask - 1;
+      }
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i nl16 = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16)
+    {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nl16)));
+      while (mask)
+      {
+        offsets.push_back(i + __builtin_ctz(mask) + 1);
+        mask &= mask - 1;
+      }
+    }
+#endif
+
+    for (; i < size; i++)
+    {
+      if (data[i] == '\n')
+        offsets.push_back(i + 1);
+    }
+
+    // A trailing newline does not start another line
+    if (offsets.back() == size)
+      offsets.pop_back();
+  }
+
+  PrescanResult prescanBuffer(const char *data, size_t size, size_t maxIssues)
+  {
+    PrescanResult result;
+    result.totalBytes = size;
+
+    indexLines(data, size, result.lineOffsets);
+    result.lineCount = result.lineOffsets.size();
+
+    Scanner scanner(result, maxIssues);
+    for (size_t line = 0; line < result.lineCount; line++)
+    {
+      const char *begin = data + result.lineOffsets[line];
+      const char *end = line + 1 < result.lineCount
+                            ? data + result.lineOffsets[line + 1] - 1
+                            : data + size;
+      if (end > begin && end[-1] == '\n')
+        end--;
+      if (end > begin && end[-1] == '\r')
+        end--;
+      scanner.scanLine(begin, end, line + 1);
+    }
+    scanner.finish();
+
+    return result;
+  }
+
+  bool indexFileLines(const std::string &filepath, std::vector<uint64_t> &offsets)
+  {
+    try
+    {
+      MappedFile file(filepath);
+      indexLines(file.data(), file.size(), offsets);
+      return true;
+    }
+    catch (const std::exception &)
+    {
+      offsets.clear();
+      return false;
+    }
+  }
+
+  PrescanResult prescanFile(const std::string &filepath, size_t maxIssues)
+  {
+    MappedFile file(filepath);
+    return prescanBuffer(file.data(), file.size(), maxIssues);
+  }
+
+} // namespace GCodeParser
@@ -0,0 +1,103 @@
+/**
+ * Pre-scan - Header
+ *
+ * Fast structural scan of a G-code file that runs without the interpreter:
+ * line index, word statistics, obviously malformed words and O-word block
+ * structure. Meant for editor feedback and for deciding whether a full
+ * parse is worth starting.
+ */
+
+#ifndef GCODE_PRESCAN_HH
+#define GCODE_PRESCAN_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace GCodeParser
+{
+
+  /**
+   * Problem found by the pre-scan. Line and column are 1-based.
+   */
+  struct PrescanIssue
+  {
+    size_t lineNumber = 0;
+    size_t column = 0;
+    std::string message;
+  };
+
+  /**
+   * O-word subroutine defined in the scanned file.
+   */
+  struct PrescanSubroutine
+  {
+    std::string name;
+    size_t startLine = 0;
+    size_t endLine = 0; // 0 if the sub is never closed
+  };
+
+  /**
+   * O-word call found in the scanned file.
+   */
+  struct PrescanCall
+  {
+    std::string name;
+    size_t lineNumber = 0;
+  };
+
+  struct PrescanResult
+  {
+    size_t totalBytes = 0;
+    size_t lineCount = 0;
+
+    // Byte offset of the start of each line (lineOffsets[0] == 0)
+    std::vector<uint64_t> lineOffsets;
+
+    // Word counts per letter, A..Z
+    uint64_t wordCounts[26] = {};
+
+    // G and M code histograms, keyed by code * 10 (G38.2 -> 382)
+    std::map<int, uint64_t> gCodes;
+    std::map<int, uint64_t> mCodes;
+
+    std::vector<PrescanIssue> issues;
+    bool issuesTruncated = false;
+
+    std::vector<PrescanSubroutine> subroutines;
+    std::vector<PrescanCall> calls;
+
+    // Called subroutines not defined in this file, resolved by the
+    // interpreter from SUBROUTINE_PATH as <name>.ngc
+    std::vector<std::string> externalSubroutines;
+  };
+
+  /**
+   * Byte offset of the start of every line in `data`.
+   * Uses SSE2/AVX2 newline scanning when available.
+   */
+  void indexLines(const char *data, size_t size, std::vector<uint64_t> &offsets);
+
+  /**
+   * Line index of a file (memory-mapped).
+   * @return false if the file cannot be read
+   */
+  bool indexFileLines(const std::string &filepath, std::vector<uint64_t> &offsets);
+
+  /**
+   * Pre-scan an in-memory program.
+   * @param maxIssues Stop recording issues after this many
+   */
+  PrescanResult prescanBuffer(const char *data, size_t size, size_t maxIssues = 1000);
+
+  /**
+   * Pre-scan a file (memory-mapped).
+   * @throws std::runtime_error if the file cannot be read
+   */
+  PrescanResult prescanFile(const std::string &filepath, size_t maxIssues = 1000);
+
+} // namespace GCodeParser
+
+#endif // GCODE_PRESCAN_HH
@@ -0,0 +1,139 @@
+/**
+ * Pre-scan Worker - Implementation
+ *
+ * Async worker for the interpreter-free G-code pre-scan.
+ */
+
+#include "prescan_worker.hh"
+
+namespace GCodeParser
+{
+
+  PrescanWorker::PrescanWorker(
+      Napi::Function &callback,
+      const std::string &filepath,
+      size_t maxIssues)
+      : Napi::AsyncWorker(callback),
+        filepath_(filepath),
+        maxIssues_(maxIssues)
+  {
+  }
+
+  void PrescanWorker::Execute()
+  {
+    try
+    {
+      result_ = prescanFile(filepath_, maxIssues_);
+    }
+    catch (const std::exception &e)
+    {
+      SetError(e.what());
+    }
+  }
+
+  void PrescanWorker::OnOK()
+  {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+
+    Callback().Call({env.Null(), resultToJS(env)});
+  }
+
+  void PrescanWorker::OnError(const Napi::Error &error)
+  {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+
+    Callback().Call({error.Value(), env.Null()});
+  }
+
+  Napi::Object PrescanWorker::histogramToJS(Napi::Env env, const std::map<int, uint64_t> &histogram, char letter)
+  {
+    // Keys as written in G-code: "G1", "G38.2", "M6"
+    Napi::Object obj = Napi::Object::New(env);
+    for (const auto &[code, count] : histogram)
+    {
+      std::string key(1, letter);
+      key += std::to_string(code / 10);
+      if (code % 10 != 0)
+      {
+        key += "." + std::to_string(code % 10);
+      }
+      obj.Set(key, Napi::Number::New(env, static_cast<double>(count)));
+    }
+    return obj;
+  }
+
+  Napi::Object PrescanWorker::resultToJS(Napi::Env env)
+  {
+    Napi::Object result = Napi::Object::New(env);
+
+    result.Set("totalBytes", Napi::Number::New(env, static_cast<double>(result_.totalBytes)));
+    result.Set("lineCount", Napi::Number::New(env, static_cast<double>(result_.lineCount)));
+
+    Napi::Float64Array lineOffsets = Napi::Float64Array::New(env, result_.lineOffsets.size());
+    for (size_t i = 0; i < result_.lineOffsets.size(); i++)
+    {
+      lineOffsets[i] = static_cast<double>(result_.lineOffsets[i]);
+    }
+    result.Set("lineOffsets", lineOffsets);
+
+    Napi::Object wordCounts = Napi::Object::New(env);
+    for (int i = 0; i < 26; i++)
+    {
+      if (result_.wordCounts[i] > 0)
+      {
+        wordCounts.Set(std::string(1, static_cast<char>('A' + i)),
+                       Napi::Number::New(env, static_cast<double>(result_.wordCounts[i])));
+      }
+    }
+    result.Set("wordCounts", wordCounts);
+    result.Set("gCodes", histogramToJS(env, result_.gCodes, 'G'));
+    result.Set("mCodes", histogramToJS(env, result_.mCodes, 'M'));
+
+    Napi::Array issues = Napi::Array::New(env, result_.issues.size());
+    for (size_t i = 0; i < result_.issues.size(); i++)
+    {
+      const PrescanIssue &issue = result_.issues[i];
+      Napi::Object obj = Napi::Object::New(env);
+      obj.Set("lineNumber", Napi::Number::New(env, static_cast<double>(issue.lineNumber)));
+      obj.Set("column", Napi::Number::New(env, static_cast<double>(issue.column)));
+      obj.Set("message", Napi::String::New(env, issue.message));
+      issues[i] = obj;
+    }
+    result.Set("issues", issues);
+    result.Set("issuesTruncated", Napi::Boolean::New(env, result_.issuesTruncated));
+
+    Napi::Array subroutines = Napi::Array::New(env, result_.subroutines.size());
+    for (size_t i = 0; i < result_.subroutines.size(); i++)
+    {
+      const PrescanSubroutine &sub = result_.subroutines[i];
+      Napi::Object obj = Napi::Object::New(env);
+      obj.Set("name", Napi::String::New(env, sub.name));
+      obj.Set("startLine", Napi::Number::New(env, static_cast<double>(sub.startLine)));
+      obj.Set("endLine", Napi::Number::New(env, static_cast<double>(sub.endLine)));
+      subroutines[i] = obj;
+    }
+    result.Set("subroutines", subroutines);
+
+    Napi::Array calls = Napi::Array::New(env, result_.calls.size());
+    for (size_t i = 0; i < result_.calls.size(); i++)
+    {
+      Napi::Object obj = Napi::Object::New(env);
+      obj.Set("name", Napi::String::New(env, result_.calls[i].name));
+      obj.Set("lineNumber", Napi::Number::New(env, static_cast<double>(result_.calls[i].lineNumber)));
+      calls[i] = obj;
+    }
+    result.Set("calls", calls);
+
+    Napi::Array external = Napi::Array::New(env, result_.externalSubroutines.size());
+    for (size_t i = 0; i < result_.externalSubroutines.size(); i++)
+    {
+      external[i] = Napi::String::New(env, result_.externalSubroutines[i]);
+    }
+    result.Set("externalSubroutines", external);
+
+    return result;
+  }
+
+} // namespace GCodeParser
@@ -0,0 +1,43 @@
+/**
+ * Pre-scan Worker - Header
+ *
+ * Async worker for the interpreter-free G-code pre-scan.
+ */
+
+#ifndef GCODE_PRESCAN_WORKER_HH
+#define GCODE_PRESCAN_WORKER_HH
+
+#include <napi.h>
+#include "prescan.hh"
+
+namespace GCodeParser
+{
+
+  /**
+   * Async worker that pre-scans a G-code file in a background thread.
+   * Does not take parser_mutex, so it never waits behind a running parse.
+   */
+  class PrescanWorker : public Napi::AsyncWorker
+  {
+  public:
+    PrescanWorker(
+        Napi::Function &callback,
+        const std::string &filepath,
+        size_t maxIssues);
+
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+  private:
+    std::string filepath_;
+    size_t maxIssues_;
+    PrescanResult result_;
+
+    Napi::Object resultToJS(Napi::Env env);
+    Napi::Object histogramToJS(Napi::Env env, const std::map<int, uint64_t> &histogram, char letter);
+  };
+
+} // namespace GCodeParser
+
+#endif // GCODE_PRESCAN_WORKER_HH
@@ -0,0 +1,144 @@
+/**
+ * Profiler - Implementation
+ *
+ * Line-level profiler for interpreter runs.
+ */
+
+#include "profiler.hh"
+#include "prescan.hh"
+
+#include <algorithm>
+#include <map>
+
+namespace GCodeParser
+{
+
+  LineProfiler::LineProfiler(size_t maxLines)
+      : maxLines_(maxLines),
+        startTime_(std::chrono::steady_clock::now()),
+        startTicks_(profileTicks())
+  {
+  }
+
+  void LineProfiler::enterFile(const std::string &filename)
+  {
+    auto it = fileIndex_.find(filename);
+    if (it != fileIndex_.end())
+    {
+      currentFile_ = it->second;
+      return;
+    }
+    currentFile_ = static_cast<uint32_t>(files_.size());
+    files_.push_back(filename);
+    fileIndex_.emplace(filename, currentFile_);
+  }
+
+  bool LineProfiler::isNewLine(int lineNumber) const
+  {
+    return lines_.find(key(currentFile_, lineNumber)) == lines_.end();
+  }
+
+  void LineProfiler::record(int lineNumber, uint64_t ticks, uint64_t canonCalls, const char *text)
+  {
+    LineStats &stats = lines_[key(currentFile_, lineNumber)];
+    stats.executions++;
+    if (pendingCall_)
+    {
+      stats.calls++;
+      pendingCall_ = false;
+    }
+    stats.ticks += ticks;
+    stats.canonCalls += canonCalls;
+    if (text && stats.text.empty())
+    {
+      stats.text = text;
+    }
+  }
+
+  ParseProfile LineProfiler::finish()
+  {
+    ParseProfile profile;
+
+    uint64_t elapsedTicks = profileTicks() - startTicks_;
+    profile.wallNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime_).count();
+    double nsPerTick = elapsedTicks > 0 ? profile.wallNs / static_cast<double>(elapsedTicks) : 0.0;
+
+    // Subroutine extents per file, from the pre-scan
+    std::vector<std::vector<PrescanSubroutine>> subs(files_.size());
+    for (size_t i = 0; i < files_.size(); i++)
+    {
+      try
+      {
+        subs[i] = prescanFile(files_[i], 0).subroutines;
+      }
+      catch (const std::exception &)
+      {
+        // File gone since the parse; its lines stay unattributed
+      }
+    }
+
+    auto enclosingSub = [&](uint32_t file, int lineNumber) -> const PrescanSubroutine *
+    {
+      size_t line = static_cast<size_t>(std::max(lineNumber, 0));
+      for (const PrescanSubroutine &sub : subs[file])
+      {
+        if (line >= sub.startLine && (sub.endLine == 0 || line <= sub.endLine))
+        {
+          return &sub;
+        }
+      }
+      return nullptr;
+    };
+
+    std::map<std::pair<uint32_t, std::string>, ProfileSubroutine> subStats;
+    profile.lines.reserve(lines_.size());
+
+    for (const auto &[lineKey, stats] : lines_)
+    {
+      uint32_t file = static_cast<uint32_t>(lineKey >> 32);
+      int lineNumber = static_cast<int>(static_cast<uint32_t>(lineKey));
+
+      ProfileLine line;
+      line.filename = files_[file];
+      line.lineNumber = lineNumber;
+      line.text = stats.text;
+      line.executions = stats.executions;
+      line.timeNs = static_cast<double>(stats.ticks) * nsPerTick;
+      line.canonCalls = stats.canonCalls;
+
+      profile.blocks += stats.executions;
+      profile.interpreterNs += line.timeNs;
+      profile.canonCalls += stats.canonCalls;
+
+      if (const PrescanSubroutine *sub = enclosingSub(file, lineNumber))
+      {
+        line.subroutine = "o" + sub->name;
+        ProfileSubroutine &agg = subStats[{file, sub->name}];
+        agg.name = line.subroutine;
+        agg.filename = line.filename;
+        agg.calls += stats.calls;
+        agg.blocks += line.executions;
+        agg.timeNs += line.timeNs;
+        agg.canonCalls += line.canonCalls;
+      }
+
+      profile.lines.push_back(std::move(line));
+    }
+
+    auto hotter = [](const auto &a, const auto &b)
+    { return a.timeNs > b.timeNs; };
+
+    size_t keep = std::min(maxLines_, profile.lines.size());
+    std::partial_sort(profile.lines.begin(), profile.lines.begin() + keep, profile.lines.end(), hotter);
+    profile.lines.resize(keep);
+
+    for (auto &entry : subStats)
+    {
+      profile.subroutines.push_back(std::move(entry.second));
+    }
+    std::sort(profile.subroutines.begin(), profile.subroutines.end(), hotter);
+
+    return profile;
+  }
+
+} // namespace GCodeParser
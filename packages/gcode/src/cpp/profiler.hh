@@ -0,0 +1,105 @@
+/**
+ * Profiler - Header
+ *
+ * Line-level profiler for interpreter runs. Attributes the time of each
+ * read()/execute() pair and the canon calls it made to the source line and
+ * o-word subroutine it came from.
+ */
+
+#ifndef GCODE_PROFILER_HH
+#define GCODE_PROFILER_HH
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "operation_types.hh"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace GCodeParser
+{
+
+  /**
+   * Cheap monotonic tick counter: the TSC on x86, the steady clock elsewhere.
+   * Converted to nanoseconds against the steady clock over the whole run.
+   */
+  inline uint64_t profileTicks()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+  }
+
+  class LineProfiler
+  {
+  public:
+    /**
+     * Start timing. `maxLines` bounds the hot-line list in the report.
+     */
+    explicit LineProfiler(size_t maxLines);
+
+    /**
+     * The interpreter is now reading `filename` (canonical path).
+     */
+    void enterFile(const std::string &filename);
+
+    /**
+     * Whether `lineNumber` of the current file has no entry yet, so the
+     * caller only fetches the block text once per line.
+     */
+    bool isNewLine(int lineNumber) const;
+
+    /**
+     * The interpreter entered a subroutine or remap body; the next recorded
+     * line counts the call.
+     */
+    void enterCall() { pendingCall_ = true; }
+
+    /**
+     * Attribute one read()/execute() pair to `lineNumber` of the current file.
+     */
+    void record(int lineNumber, uint64_t ticks, uint64_t canonCalls, const char *text = nullptr);
+
+    /**
+     * Stop timing and build the report. Lines are mapped to subroutines by
+     * pre-scanning the files they came from.
+     */
+    ParseProfile finish();
+
+  private:
+    struct LineStats
+    {
+      uint64_t executions = 0;
+      uint64_t calls = 0; // Times a call entered its body at this line
+      uint64_t ticks = 0;
+      uint64_t canonCalls = 0;
+      std::string text;
+    };
+
+    size_t maxLines_;
+    std::chrono::steady_clock::time_point startTime_;
+    uint64_t startTicks_;
+
+    std::vector<std::string> files_;
+    std::unordered_map<std::string, uint32_t> fileIndex_;
+    uint32_t currentFile_ = 0;
+    bool pendingCall_ = false;
+
+    // Keyed by file index << 32 | line number
+    std::unordered_map<uint64_t, LineStats> lines_;
+
+    static uint64_t key(uint32_t file, int lineNumber)
+    {
+      return (static_cast<uint64_t>(file) << 32) | static_cast<uint32_t>(lineNumber);
+    }
+  };
+
+} // namespace GCodeParser
+
+#endif // GCODE_PROFILER_HH
@@ -0,0 +1,379 @@
+/**
+ * Thumbnail - Implementation
+ *
+ * CPU rasterizer for toolpath thumbnails.
+ */
+
+#include "thumbnail.hh"
+#include "arc_geometry.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    // Largest chord error allowed when tessellating arcs, in pixels
+    constexpr double ARC_TOLERANCE_PX = 0.25;
+    constexpr int ARC_MAX_STEPS = 4096;
+
+    // Steps used for arcs while the image scale is not yet known
+    constexpr int ARC_BOUNDS_STEPS = 16;
+
+    struct Vec3
+    {
+      double v[3];
+    };
+
+    struct Point2
+    {
+      double u;
+      double v;
+    };
+
+    /**
+     * Orthographic projection of world XYZ onto the image plane (before
+     * scaling). `v` points up.
+     */
+    Point2 project(const double *p, ThumbnailView view)
+    {
+      switch (view)
+      {
+      case ThumbnailView::TOP:
+        return {p[0], p[1]};
+      case ThumbnailView::FRONT:
+        return {p[0], p[2]};
+      case ThumbnailView::SIDE:
+        return {p[1], p[2]};
+      case ThumbnailView::ISO:
+      default:
+        // Camera on the (1, -1, 1) diagonal looking at the origin
+        return {(p[0] + p[1]) * M_SQRT1_2,
+                (-p[0] + p[1] + 2.0 * p[2]) * (1.0 / std::sqrt(6.0))};
+      }
+    }
+
+    /**
+     * Emit the points of one segment after `start` (excluding it).
+     * `steps` is chosen by the caller for arcs; lines always emit one point.
+     */
+    template <typename Emit>
+    void tessellate(const double *start, const ThumbnailSegment &seg, double pxPerUnit, bool forBounds, Emit &&emit)
+    {
+      ArcFrame frame;
+      if (seg.kind != ThumbnailSegment::ARC || !arcFrame(start, seg.end, seg.plane, seg.centerFirst, seg.centerSecond, seg.rotation, frame))
+      {
+        emit(seg.end);
+        return;
+      }
+
+      int steps = ARC_BOUNDS_STEPS;
+      if (!forBounds)
+      {
+        double radiusPx = frame.radius * pxPerUnit;
+        double step = radiusPx > ARC_TOLERANCE_PX
+                          ? 2.0 * std::acos(1.0 - ARC_TOLERANCE_PX / radiusPx)
+                          : TWO_PI;
+        steps = static_cast<int>(std::ceil(std::fabs(frame.sweep) / step));
+        steps = std::clamp(steps, 1, ARC_MAX_STEPS);
+      }
+
+      double p[3];
+      for (int i = 1; i <= steps; i++)
+      {
+        if (i == steps)
+        {
+          // Land exactly on the programmed end point
+          emit(seg.end);
+          break;
+        }
+        double t = static_cast<double>(i) / steps;
+        double angle = frame.startAngle + frame.sweep * t;
+        p[frame.first] = seg.centerFirst + frame.radius * std::cos(angle);
+        p[frame.second] = seg.centerSecond + frame.radius * std::sin(angle);
+        p[frame.helix] = frame.helixStart + frame.helixDelta * t;
+        emit(p);
+      }
+    }
+
+    // ========================================================================
+    // Coverage rasterization
+    // ========================================================================
+
+    /**
+     * 8-bit line coverage for one colour layer. Overlapping lines keep the
+     * highest coverage, so drawing order does not matter and dense paths do
+     * not saturate into blobs.
+     */
+    class Coverage
+    {
+    public:
+      Coverage(int width, int height)
+          : width_(width), height_(height), data_(static_cast<size_t>(width) * height, 0)
+      {
+      }
+
+      const std::vector<uint8_t> &data() const { return data_; }
+
+      /**
+       * Xiaolin Wu anti-aliased line between pixel-centre coordinates.
+       */
+      void line(double x0, double y0, double x1, double y1)
+      {
+        bool steep = std::fabs(y1 - y0) > std::fabs(x1 - x0);
+        if (steep)
+        {
+          std::swap(x0, y0);
+          std::swap(x1, y1);
+        }
+        if (x0 > x1)
+        {
+          std::swap(x0, x1);
+          std::swap(y0, y1);
+        }
+
+        double dx = x1 - x0;
+        double gradient = dx == 0.0 ? 1.0 : (y1 - y0) / dx;
+
+        // First end point
+        double xend = std::round(x0);
+        double yend = y0 + gradient * (xend - x0);
+        double xgap = rfpart(x0 + 0.5);
+        int xpx1 = static_cast<int>(xend);
+        int ypx1 = static_cast<int>(std::floor(yend));
+        plot(steep, xpx1, ypx1, rfpart(yend) * xgap);
+        plot(steep, xpx1, ypx1 + 1, fpart(yend) * xgap);
+        double intery = yend + gradient;
+
+        // Second end point
+        xend = std::round(x1);
+        yend = y1 + gradient * (xend - x1);
+        xgap = fpart(x1 + 0.5);
+        int xpx2 = static_cast<int>(xend);
+        int ypx2 = static_cast<int>(std::floor(yend));
+        plot(steep, xpx2, ypx2, rfpart(yend) * xgap);
+        plot(steep, xpx2, ypx2 + 1, fpart(yend) * xgap);
+
+        for (int x = xpx1 + 1; x < xpx2; x++)
+        {
+          int y = static_cast<int>(std::floor(intery));
+          plot(steep, x, y, rfpart(intery));
+          plot(steep, x, y + 1, fpart(intery));
+          intery += gradient;
+        }
+      }
+
+    private:
+      int width_;
+      int height_;
+      std::vector<uint8_t> data_;
+
+      static double fpart(double x) { return x - std::floor(x); }
+      static double rfpart(double x) { return 1.0 - fpart(x); }
+
+      void plot(bool steep, int x, int y, double coverage)
+      {
+        if (steep)
+        {
+          std::swap(x, y);
+        }
+        if (x < 0 || y < 0 || x >= width_ || y >= height_)
+        {
+          return;
+        }
+        uint8_t value = static_cast<uint8_t>(coverage * 255.0 + 0.5);
+        uint8_t &pixel = data_[static_cast<size_t>(y) * width_ + x];
+        if (value > pixel)
+        {
+          pixel = value;
+        }
+      }
+    };
+
+    /**
+     * Straight-alpha "over" of `color` (0xRRGGBBAA) scaled by `coverage`.
+     */
+    void blend(uint8_t *dst, uint32_t color, uint8_t coverage)
+    {
+      double srcA = ((color & 0xff) / 255.0) * (coverage / 255.0);
+      if (srcA <= 0.0)
+      {
+        return;
+      }
+      double dstA = dst[3] / 255.0;
+      double outA = srcA + dstA * (1.0 - srcA);
+      for (int c = 0; c < 3; c++)
+      {
+        double src = (color >> (24 - 8 * c)) & 0xff;
+        double out = (src * srcA + dst[c] * dstA * (1.0 - srcA)) / outA;
+        dst[c] = static_cast<uint8_t>(out + 0.5);
+      }
+      dst[3] = static_cast<uint8_t>(outA * 255.0 + 0.5);
+    }
+
+  } // namespace
+
+  ThumbnailImage renderThumbnail(const std::vector<ThumbnailSegment> &path, const ThumbnailOptions &options)
+  {
+    ThumbnailImage image;
+    image.width = std::max(options.width, 1);
+    image.height = std::max(options.height, 1);
+    image.rgba.resize(static_cast<size_t>(image.width) * image.height * 4);
+
+    for (size_t i = 0; i < image.rgba.size(); i += 4)
+    {
+      image.rgba[i] = (options.background >> 24) & 0xff;
+      image.rgba[i + 1] = (options.background >> 16) & 0xff;
+      image.rgba[i + 2] = (options.background >> 8) & 0xff;
+      image.rgba[i + 3] = options.background & 0xff;
+    }
+
+    auto visible = [&](const ThumbnailSegment &seg)
+    {
+      return options.showRapids || seg.kind != ThumbnailSegment::RAPID;
+    };
+
+    // Pass 1: projected bounds of the drawn segments
+    double minU = 1e99, maxU = -1e99, minV = 1e99, maxV = -1e99;
+    auto extend = [&](const double *p)
+    {
+      Point2 q = project(p, options.view);
+      minU = std::min(minU, q.u);
+      maxU = std::max(maxU, q.u);
+      minV = std::min(minV, q.v);
+      maxV = std::max(maxV, q.v);
+    };
+
+    Vec3 current = {{0.0, 0.0, 0.0}};
+    for (const ThumbnailSegment &seg : path)
+    {
+      if (visible(seg))
+      {
+        extend(current.v);
+        tessellate(current.v, seg, 0.0, true, extend);
+      }
+      std::copy(seg.end, seg.end + 3, current.v);
+    }
+
+    if (minU > maxU)
+    {
+      return image; // Nothing to draw
+    }
+
+    // Fit the bounds into the image, keeping the aspect ratio
+    double availW = std::max(image.width - 1 - 2 * options.padding, 1);
+    double availH = std::max(image.height - 1 - 2 * options.padding, 1);
+    double spanU = maxU - minU;
+    double spanV = maxV - minV;
+    double scale;
+    if (spanU <= 0.0 && spanV <= 0.0)
+    {
+      scale = 1.0;
+    }
+    else if (spanU <= 0.0)
+    {
+      scale = availH / spanV;
+    }
+    else if (spanV <= 0.0)
+    {
+      scale = availW / spanU;
+    }
+    else
+    {
+      scale = std::min(availW / spanU, availH / spanV);
+    }
+    double offsetX = (image.width - 1) / 2.0 - (minU + maxU) / 2.0 * scale;
+    double offsetY = (image.height - 1) / 2.0 + (minV + maxV) / 2.0 * scale;
+
+    // Pass 2: rasterize each colour layer
+    Coverage feeds(image.width, image.height);
+    Coverage rapids(image.width, image.height);
+
+    current = {{0.0, 0.0, 0.0}};
+    for (const ThumbnailSegment &seg : path)
+    {
+      if (visible(seg))
+      {
+        Coverage &layer = seg.kind == ThumbnailSegment::RAPID ? rapids : feeds;
+        Point2 prev = project(current.v, options.view);
+        double px = offsetX + prev.u * scale;
+        double py = offsetY - prev.v * scale;
+        tessellate(current.v, seg, scale, false, [&](const double *p)
+                   {
+                     Point2 q = project(p, options.view);
+                     double x = offsetX + q.u * scale;
+                     double y = offsetY - q.v * scale;
+                     layer.line(px, py, x, y);
+                     px = x;
+                     py = y; });
+      }
+      std::copy(seg.end, seg.end + 3, current.v);
+    }
+
+    // Feeds are composited over rapids
+    const std::vector<uint8_t> &rapidCoverage = rapids.data();
+    const std::vector<uint8_t> &feedCoverage = feeds.data();
+    for (size_t i = 0; i < feedCoverage.size(); i++)
+    {
+      uint8_t *pixel = &image.rgba[i * 4];
+      if (rapidCoverage[i])
+      {
+        blend(pixel, options.rapidColor, rapidCoverage[i]);
+      }
+      if (feedCoverage[i])
+      {
+        blend(pixel, options.feedColor, feedCoverage[i]);
+      }
+    }
+
+    return image;
+  }
+
+  std::vector<ThumbnailImage> renderThumbnails(const std::vector<std::vector<ThumbnailSegment>> &paths,
+                                               const ThumbnailOptions &options,
+                                               unsigned threads)
+  {
+    std::vector<ThumbnailImage> images(paths.size());
+
+    if (threads == 0)
+    {
+      threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads = std::min<unsigned>(threads, static_cast<unsigned>(paths.size()));
+
+    // Files are independent: each thread takes the next unrendered one
+    std::atomic<size_t> next{0};
+    auto work = [&]()
+    {
+      for (size_t i = next++; i < paths.size(); i = next++)
+      {
+        images[i] = renderThumbnail(paths[i], options);
+      }
+    };
+
+    if (threads <= 1)
+    {
+      work();
+      return images;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; t++)
+    {
+      pool.emplace_back(work);
+    }
+    work();
+    for (std::thread &thread : pool)
+    {
+      thread.join();
+    }
+
+    return images;
+  }
+
+} // namespace GCodeParser
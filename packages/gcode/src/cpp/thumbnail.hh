@@ -0,0 +1,87 @@
+/**
+ * Thumbnail - Header
+ *
+ * CPU rasterizer for toolpath thumbnails. Draws the XYZ toolpath of a parse
+ * result as anti-aliased lines into an RGBA image, without a GPU or the
+ * three.js viewer. Meant for job lists that show many programs at once.
+ */
+
+#ifndef GCODE_THUMBNAIL_HH
+#define GCODE_THUMBNAIL_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GCodeParser
+{
+
+  enum class ThumbnailView
+  {
+    TOP = 1,   // XY, looking down Z
+    FRONT = 2, // XZ, looking along +Y
+    SIDE = 3,  // YZ, looking along -X
+    ISO = 4,   // Isometric from +X -Y +Z
+  };
+
+  /**
+   * One motion of the toolpath, starting where the previous one ended.
+   * Arcs are tessellated at render time so the chord error stays below a
+   * fraction of a pixel at the requested size.
+   */
+  struct ThumbnailSegment
+  {
+    enum Kind : uint8_t
+    {
+      RAPID = 0,
+      FEED = 1,
+      ARC = 2,
+    };
+
+    Kind kind = FEED;
+    uint8_t plane = 1; // Plane of an arc (1 = XY, 2 = YZ, 3 = XZ)
+    int32_t rotation = 0;
+    double end[3] = {0.0, 0.0, 0.0};
+    double centerFirst = 0.0;
+    double centerSecond = 0.0;
+    double axisEndPoint = 0.0;
+  };
+
+  struct ThumbnailOptions
+  {
+    int width = 256;
+    int height = 256;
+    ThumbnailView view = ThumbnailView::ISO;
+    int padding = 4;             // Pixels kept clear around the path
+    bool showRapids = true;
+    uint32_t background = 0x00000000; // 0xRRGGBBAA
+    uint32_t feedColor = 0x33cc33ff;
+    uint32_t rapidColor = 0xcc3333ff;
+  };
+
+  /**
+   * Rendered RGBA image, row-major from the top-left corner.
+   */
+  struct ThumbnailImage
+  {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgba;
+  };
+
+  /**
+   * Rasterize one toolpath. The path starts at the origin, like the viewer.
+   */
+  ThumbnailImage renderThumbnail(const std::vector<ThumbnailSegment> &path, const ThumbnailOptions &options);
+
+  /**
+   * Rasterize several toolpaths with up to `threads` threads
+   * (0 = hardware concurrency).
+   */
+  std::vector<ThumbnailImage> renderThumbnails(const std::vector<std::vector<ThumbnailSegment>> &paths,
+                                               const ThumbnailOptions &options,
+                                               unsigned threads = 0);
+
+} // namespace GCodeParser
+
+#endif // GCODE_THUMBNAIL_HH
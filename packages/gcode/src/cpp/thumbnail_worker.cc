@@ -0,0 +1,168 @@
+/**
+ * Thumbnail Worker - Implementation
+ *
+ * Async worker that rasterizes toolpath thumbnails off the event loop.
+ */
+
+#include "thumbnail_worker.hh"
+#include "napi_helpers.hh"
+#include "operation_types.hh"
+#include <algorithm>
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    constexpr int MAX_THUMBNAIL_SIZE = 8192;
+  } // namespace
+
+  ThumbnailWorker::ThumbnailWorker(
+      Napi::Function &callback,
+      std::vector<std::vector<ThumbnailSegment>> paths,
+      const ThumbnailOptions &options,
+      unsigned threads)
+      : Napi::AsyncWorker(callback),
+        paths_(std::move(paths)),
+        options_(options),
+        threads_(threads)
+  {
+  }
+
+  void ThumbnailWorker::Execute()
+  {
+    try
+    {
+      images_ = renderThumbnails(paths_, options_, threads_);
+    }
+    catch (const std::exception &e)
+    {
+      SetError(e.what());
+    }
+  }
+
+  void ThumbnailWorker::OnOK()
+  {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+
+    Napi::Array images = Napi::Array::New(env, images_.size());
+    for (size_t i = 0; i < images_.size(); i++)
+    {
+      const ThumbnailImage &image = images_[i];
+      Napi::Object obj = Napi::Object::New(env);
+      obj.Set("width", Napi::Number::New(env, image.width));
+      obj.Set("height", Napi::Number::New(env, image.height));
+      obj.Set("data", Napi::Buffer<uint8_t>::Copy(env, image.rgba.data(), image.rgba.size()));
+      images[i] = obj;
+    }
+
+    Callback().Call({env.Null(), images});
+  }
+
+  void ThumbnailWorker::OnError(const Napi::Error &error)
+  {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+
+    Callback().Call({error.Value(), env.Null()});
+  }
+
+  std::vector<ThumbnailSegment> ThumbnailWorker::pathFromJS(Napi::Env env, Napi::Object result)
+  {
+    Napi::Value opsValue = result.Get("operations");
+    if (!opsValue.IsArray())
+    {
+      throw Napi::TypeError::New(env, "result.operations must be an array");
+    }
+
+    Napi::Array operations = opsValue.As<Napi::Array>();
+    uint32_t length = operations.Length();
+
+    std::vector<ThumbnailSegment> path;
+    path.reserve(length);
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+      Napi::Value opValue = operations.Get(i);
+      if (!opValue.IsObject())
+      {
+        continue;
+      }
+      Napi::Object op = opValue.As<Napi::Object>();
+
+      ThumbnailSegment seg;
+      switch (static_cast<OperationType>(static_cast<int>(numberOr(op, "type", 0))))
+      {
+      case OperationType::TRAVERSE:
+        seg.kind = ThumbnailSegment::RAPID;
+        break;
+      case OperationType::FEED:
+      case OperationType::PROBE:
+      case OperationType::RIGID_TAP:
+      case OperationType::NURBS_G5: // Drawn as a straight move to the end point
+      case OperationType::NURBS_G6:
+        seg.kind = ThumbnailSegment::FEED;
+        break;
+      case OperationType::ARC:
+      {
+        seg.kind = ThumbnailSegment::ARC;
+        seg.plane = static_cast<uint8_t>(numberOr(op, "plane", static_cast<int>(Plane::XY)));
+        Napi::Value arcValue = op.Get("arcData");
+        if (!arcValue.IsObject())
+        {
+          seg.kind = ThumbnailSegment::FEED;
+          break;
+        }
+        Napi::Object arcData = arcValue.As<Napi::Object>();
+        seg.centerFirst = numberOr(arcData, "centerFirst", 0.0);
+        seg.centerSecond = numberOr(arcData, "centerSecond", 0.0);
+        seg.rotation = static_cast<int32_t>(numberOr(arcData, "rotation", 0));
+        seg.axisEndPoint = numberOr(arcData, "axisEndPoint", 0.0);
+        break;
+      }
+      default:
+        continue; // Not a motion
+      }
+
+      if (!readXYZ(op.Get("pos"), seg.end))
+      {
+        continue;
+      }
+      path.push_back(seg);
+    }
+
+    return path;
+  }
+
+  ThumbnailOptions ThumbnailWorker::optionsFromJS(Napi::Object obj)
+  {
+    ThumbnailOptions options;
+
+    options.width = static_cast<int>(numberOr(obj, "width", options.width));
+    options.height = static_cast<int>(numberOr(obj, "height", options.height));
+    options.padding = static_cast<int>(numberOr(obj, "padding", options.padding));
+    options.width = std::clamp(options.width, 1, MAX_THUMBNAIL_SIZE);
+    options.height = std::clamp(options.height, 1, MAX_THUMBNAIL_SIZE);
+    options.padding = std::max(options.padding, 0);
+
+    int view = static_cast<int>(numberOr(obj, "view", static_cast<int>(options.view)));
+    if (view >= static_cast<int>(ThumbnailView::TOP) && view <= static_cast<int>(ThumbnailView::ISO))
+    {
+      options.view = static_cast<ThumbnailView>(view);
+    }
+
+    Napi::Value showRapids = obj.Get("showRapids");
+    if (showRapids.IsBoolean())
+    {
+      options.showRapids = showRapids.As<Napi::Boolean>().Value();
+    }
+
+    options.background = static_cast<uint32_t>(numberOr(obj, "background", options.background));
+    options.feedColor = static_cast<uint32_t>(numberOr(obj, "feedColor", options.feedColor));
+    options.rapidColor = static_cast<uint32_t>(numberOr(obj, "rapidColor", options.rapidColor));
+
+    return options;
+  }
+
+} // namespace GCodeParser
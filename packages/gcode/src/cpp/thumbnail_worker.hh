@@ -0,0 +1,56 @@
+/**
+ * Thumbnail Worker - Header
+ *
+ * Async worker that rasterizes toolpath thumbnails off the event loop.
+ */
+
+#ifndef GCODE_THUMBNAIL_WORKER_HH
+#define GCODE_THUMBNAIL_WORKER_HH
+
+#include <napi.h>
+#include "thumbnail.hh"
+
+namespace GCodeParser
+{
+
+  /**
+   * Async worker that renders one thumbnail per parse result.
+   *
+   * The motion operations are copied out of the JS results on the calling
+   * thread (pathFromJS); rendering then runs on the libuv thread pool and
+   * spreads the files over several threads. Does not take parser_mutex.
+   */
+  class ThumbnailWorker : public Napi::AsyncWorker
+  {
+  public:
+    ThumbnailWorker(
+        Napi::Function &callback,
+        std::vector<std::vector<ThumbnailSegment>> paths,
+        const ThumbnailOptions &options,
+        unsigned threads);
+
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+    /**
+     * Motion of a JS GCodeParseResult as thumbnail segments.
+     * @throws Napi::Error if `result` has no operations array
+     */
+    static std::vector<ThumbnailSegment> pathFromJS(Napi::Env env, Napi::Object result);
+
+    /**
+     * Rendering options from a JS object; missing fields keep their defaults.
+     */
+    static ThumbnailOptions optionsFromJS(Napi::Object obj);
+
+  private:
+    std::vector<std::vector<ThumbnailSegment>> paths_;
+    ThumbnailOptions options_;
+    unsigned threads_;
+    std::vector<ThumbnailImage> images_;
+  };
+
+} // namespace GCodeParser
+
+#endif // GCODE_THUMBNAIL_WORKER_HH
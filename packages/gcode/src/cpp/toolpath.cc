@@ -0,0 +1,98 @@
+/**
+ * Toolpath - Implementation
+ *
+ * Flat list of the timing-relevant moves in a parse result.
+ */
+
+#include "toolpath.hh"
+
+#include <type_traits>
+
+namespace GCodeParser
+{
+
+  namespace
+  {
+    template <typename Op>
+    void setEnd(ToolpathMove &move, const Op &op)
+    {
+      move.end[0] = op.pos.x;
+      move.end[1] = op.pos.y;
+      move.end[2] = op.pos.z;
+    }
+  } // namespace
+
+  Toolpath toolpathFromResult(const ParseResult &result)
+  {
+    Toolpath path;
+    path.reserve(result.operations.size());
+
+    for (size_t i = 0; i < result.operations.size(); i++)
+    {
+      ToolpathMove move;
+      move.opIndex = static_cast<uint32_t>(i);
+
+      bool keep = std::visit(
+          [&](const auto &op)
+          {
+            using T = std::decay_t<decltype(op)>;
+            if constexpr (std::is_same_v<T, FeedRateChangeOp>)
+            {
+              move.kind = ToolpathMove::FEED_RATE;
+              move.value = op.feedRate;
+            }
+            else if constexpr (std::is_same_v<T, DwellOp>)
+            {
+              move.kind = ToolpathMove::DWELL;
+              move.value = op.duration;
+            }
+            else if constexpr (std::is_same_v<T, ToolChangeOp>)
+            {
+              move.kind = ToolpathMove::TOOL_CHANGE;
+              move.value = op.toolNumber;
+            }
+            else if constexpr (std::is_same_v<T, MotionModeChangeOp>)
+            {
+              move.kind = ToolpathMove::MOTION_MODE;
+              move.mode = static_cast<uint8_t>(op.mode);
+              move.value = op.tolerance;
+            }
+            else if constexpr (std::is_same_v<T, ArcOp>)
+            {
+              move.kind = ToolpathMove::ARC;
+              move.lineNumber = op.lineNumber;
+              move.plane = static_cast<uint8_t>(op.plane);
+              move.rotation = op.arcData.rotation;
+              move.centerFirst = op.arcData.centerFirst;
+              move.centerSecond = op.arcData.centerSecond;
+              setEnd(move, op);
+            }
+            else if constexpr (std::is_same_v<T, TraverseOp> || std::is_same_v<T, FeedOp> ||
+                               std::is_same_v<T, ProbeOp> || std::is_same_v<T, RigidTapOp> ||
+                               std::is_same_v<T, NurbsG5Op> || std::is_same_v<T, NurbsG6Op>)
+            {
+              move.kind = std::is_same_v<T, TraverseOp>   ? ToolpathMove::RAPID
+                          : std::is_same_v<T, ProbeOp>    ? ToolpathMove::PROBE
+                          : std::is_same_v<T, RigidTapOp> ? ToolpathMove::RIGID_TAP
+                                                          : ToolpathMove::FEED;
+              move.lineNumber = op.lineNumber;
+              setEnd(move, op);
+            }
+            else
+            {
+              return false; // Modal state with no effect on timing
+            }
+            return true;
+          },
+          result.operations[i]);
+
+      if (keep)
+      {
+        path.push_back(move);
+      }
+    }
+
+    return path;
+  }
+
+} // namespace GCodeParser
@@ -0,0 +1,57 @@
+/**
+ * Toolpath - Header
+ *
+ * Flat list of the moves in a parse result that matter for motion timing,
+ * read either from a native ParseResult or from a JS result object. Used
+ * by the path sampler and the planner simulation.
+ */
+
+#ifndef GCODE_TOOLPATH_HH
+#define GCODE_TOOLPATH_HH
+
+#include <cstdint>
+#include <vector>
+#include "operation_types.hh"
+
+namespace GCodeParser
+{
+
+  struct ToolpathMove
+  {
+    enum Kind : uint8_t
+    {
+      RAPID = 0,
+      FEED = 1, // Also NURBS, as a straight move to the end point
+      ARC = 2,
+      PROBE = 3,
+      RIGID_TAP = 4, // end is the bottom; the tool returns to the starting Z
+      DWELL = 5,     // value = seconds
+      FEED_RATE = 6, // value = mm/min
+      TOOL_CHANGE = 7,
+      MOTION_MODE = 8, // mode = MotionMode, value = G64 P tolerance in mm
+    };
+
+    Kind kind = FEED;
+    uint8_t plane = 1; // Plane of an arc (1 = XY, 2 = YZ, 3 = XZ)
+    uint8_t mode = 0;  // MotionMode of a MOTION_MODE entry
+    int32_t rotation = 0;
+    uint32_t opIndex = 0; // Index into result.operations
+    int32_t lineNumber = 0;
+    double end[3] = {0.0, 0.0, 0.0};
+    double centerFirst = 0.0;
+    double centerSecond = 0.0;
+    double value = 0.0;
+
+    bool isMotion() const { return kind <= RIGID_TAP; }
+  };
+
+  using Toolpath = std::vector<ToolpathMove>;
+
+  /**
+   * Extract the toolpath from a native parse result.
+   */
+  Toolpath toolpathFromResult(const ParseResult &result);
+
+} // namespace GCodeParser
+
+#endif // GCODE_TOOLPATH_HH
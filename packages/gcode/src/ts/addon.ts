@@ -0,0 +1,33 @@
+/**
+ * Native Addon Loader
+ *
+ * Resolves and loads gcode_addon.node for the parser and the parse pool.
+ */
+
+const ADDON_PATHS = [
+  "../build/Release/gcode_addon.node", // Installed in node_modules (path relative to dist/)
+  "../../build/Release/gcode_addon.node", // Local development (path relative to src/ts/)
+];
+
+/**
+ * Resolve the absolute path of the native addon.
+ * @throws Error if the addon has not been built
+ */
+export function resolveAddonPath(): string {
+  for (const path of ADDON_PATHS) {
+    try {
+      return require.resolve(path);
+    } catch {
+      // Try next path
+    }
+  }
+
+  throw new Error(
+    `Failed to load gcode_addon.node. Tried paths:\n` +
+      ADDON_PATHS.map((p) => `  - ${p}`).join("\n")
+  );
+}
+
+// Native addon - loaded immediately on module import
+// eslint-disable-next-line @typescript-eslint/no-explicit-any
+export const addon: any = require(resolveAddonPath());
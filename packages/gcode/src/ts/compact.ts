@@ -0,0 +1,64 @@
+/**
+ * G-Code Compact Encoding Module
+ *
+ * Compact binary transport form of parse results for remote clients.
+ */
+
+import { CompactParseOptions, GCodeParseResult } from "@linuxcnc-node/types";
+import { addon } from "./addon";
+import { runParse } from "./parser";
+
+/** Default position quantisation step, in mm */
+const DEFAULT_RESOLUTION = 1e-4;
+
+/**
+ * Parse a G-code file into the compact transport encoding.
+ *
+ * Positions are quantised to `options.resolution` and stored as zigzag
+ * varint deltas between consecutive operations, with unchanged axes left
+ * out, so a program takes a few bytes per move instead of nine float64s
+ * per position plus the object overhead. The result never exists as JS
+ * objects on this side: it is encoded on the worker thread.
+ *
+ * Decode on the receiving side with decodeParseResult().
+ *
+ * @param filepath - Path to the G-code file to parse
+ * @param options - Parse options plus the quantisation resolution
+ * @returns Promise resolving to the encoded result
+ * @throws Error if parsing fails, or a position does not fit at this resolution
+ *
+ * @example
+ * ```typescript
+ * const data = await parseGCodeCompact("/path/to/program.ngc", {
+ *   iniPath,
+ *   resolution: 0.001,
+ * });
+ * send(data);
+ * // ...on the client
+ * const result = decodeParseResult(data);
+ * ```
+ */
+export async function parseGCodeCompact(
+  filepath: string,
+  options: CompactParseOptions
+): Promise<Uint8Array> {
+  const resolution = options.resolution ?? DEFAULT_RESOLUTION;
+  if (!(resolution > 0) || !Number.isFinite(resolution)) {
+    throw new Error("resolution must be a positive number");
+  }
+  return runParse<Uint8Array>(filepath, options, resolution);
+}
+
+/**
+ * Decode a result produced by parseGCodeCompact().
+ *
+ * Returns the same shape as parseGCode(), with positions, offsets, arc
+ * centres and NURBS control points rounded to the encoding resolution.
+ *
+ * @param data - Encoded result
+ * @returns The decoded parse result
+ * @throws Error if the data is truncated or not a compact parse result
+ */
+export function decodeParseResult(data: Uint8Array): GCodeParseResult {
+  return addon.decodeParseResult(data);
+}
@@ -8,3 +8,31 @@
 
 // Export parser function
 export { parseGCode } from "./parser";
+
+// Export interpreter-free pre-scan
+export { prescanGCode } from "./prescan";
+
+// Export multi-process parse pool
+export { ParsePool } from "./pool";
+export type { ParsePoolOptions } from "./pool";
+
+// Export file-watching re-parser
+export { ProgramWatcher, watchGCode } from "./watcher";
+export type { WatchOptions } from "./watcher";
+
+// Export toolpath thumbnail rendering
+export {
+  renderThumbnail,
+  renderThumbnails,
+  encodePng,
+  encodePngAsync,
+} from "./thumbnail";
+
+// Export compact transport encoding
+export { parseGCodeCompact, decodeParseResult } from "./compact";
+
+// Export toolpath arc-length/time sampler
+export { PathSampler } from "./sampler";
+
+// Export offline trajectory planner simulation
+export { simulateToolpath } from "./simulate";
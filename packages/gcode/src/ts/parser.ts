@@ -5,30 +5,25 @@
  */
 
 import { GCodeParseResult, ParseOptions, ParseProgress } from "@linuxcnc-node/types";
+import { addon } from "./addon";
 
-// Native addon - loaded immediately on module import
-// eslint-disable-next-line @typescript-eslint/no-explicit-any
-function loadAddon(): any {
-  const paths = [
-    "../build/Release/gcode_addon.node", // Installed in node_modules (path relative to dist/)
-    "../../build/Release/gcode_addon.node", // Local development (path relative to src/ts/)
-  ];
-
-  for (const path of paths) {
-    try {
-      return require(path);
-    } catch {
-      // Try next path
-    }
-  }
-
-  throw new Error(
-    `Failed to load gcode_addon.node. Tried paths:\n` +
-      paths.map((p) => `  - ${p}`).join("\n")
-  );
+/**
+ * Native maxErrors argument for the given options (0 = fail at first error).
+ * @internal
+ */
+export function collectErrorsLimit(options: ParseOptions): number {
+  if (!options.collectErrors) return 0;
+  return Math.max(1, Math.floor(options.maxErrors ?? 100));
 }
 
-const addon = loadAddon();
+/**
+ * Native profileLines argument for the given options (0 = no profiling).
+ * @internal
+ */
+export function profileLinesLimit(options: ParseOptions): number {
+  if (!options.profile) return 0;
+  return Math.max(1, Math.floor(options.profileLines ?? 50));
+}
 
 /**
  * Parse a G-code file asynchronously.
@@ -67,27 +62,45 @@ export async function parseGCode(
   filepath: string,
   options: ParseOptions
 ): Promise<GCodeParseResult> {
+  return runParse<GCodeParseResult>(filepath, options, 0);
+}
+
+/**
+ * Run a native parse. With compactResolution > 0 the result is a compact
+ * encoded Buffer instead of JS objects.
+ * @internal
+ */
+export async function runParse<T>(
+  filepath: string,
+  options: ParseOptions,
+  compactResolution: number
+): Promise<T> {
   if (!options.iniPath) {
     throw new Error("iniPath is required in ParseOptions");
   }
 
-  return new Promise<GCodeParseResult>((resolve, reject) => {
+  return new Promise<T>((resolve, reject) => {
     const progressCallback =
       options.onProgress || ((_progress: ParseProgress) => {});
     const progressUpdates = options.progressUpdates ?? 40;
+    const maxErrors = collectErrorsLimit(options);
+    const profileLines = profileLinesLimit(options);
 
     addon.parseGCode(
       filepath,
       options.iniPath,
       progressUpdates,
       progressCallback,
-      (error: Error | null, result: GCodeParseResult) => {
+      (error: Error | null, result: T) => {
         if (error) {
           reject(error);
         } else {
           resolve(result);
         }
-      }
+      },
+      maxErrors,
+      compactResolution,
+      profileLines
     );
   });
 }
@@ -0,0 +1,306 @@
+/**
+ * Parse Pool Module
+ *
+ * Runs parses in child processes so remap-heavy programs scale across cores.
+ *
+ * librs274 keeps one interpreter and one embedded Python per process: every
+ * in-process parse is serialised on the parser mutex and the GIL, whichever
+ * thread it runs on. Each pool process loads its own copy of the addon, so it
+ * has its own interpreter and its own GIL.
+ */
+
+import { ChildProcess, spawn } from "child_process";
+import * as os from "os";
+import {
+  GCodeParseResult,
+  ParseOptions,
+  ParseProgress,
+} from "@linuxcnc-node/types";
+import { resolveAddonPath } from "./addon";
+import { collectErrorsLimit, profileLinesLimit } from "./parser";
+
+/**
+ * Source of each pool process. Reports ready once the addon loaded, then
+ * receives parse requests over IPC and answers with progress, result or
+ * error messages tagged with the request id.
+ */
+const CHILD_SOURCE = `
+const addon = require(process.argv[1]);
+process.send({ ready: true });
+process.on("message", (req) => {
+  addon.parseGCode(
+    req.filepath,
+    req.iniPath,
+    req.progressUpdates,
+    req.wantProgress ? (progress) => process.send({ id: req.id, progress }) : () => {},
+    (error, result) => {
+      if (error) {
+        process.send({ id: req.id, error: error.message });
+      } else {
+        process.send({ id: req.id, result });
+      }
+    },
+    req.maxErrors,
+    0,
+    req.profileLines
+  );
+});
+process.on("disconnect", () => process.exit(0));
+`;
+
+export interface ParsePoolOptions {
+  /**
+   * Number of parser processes.
+   * @default os.availableParallelism()
+   */
+  size?: number;
+}
+
+/** First respawn delay after a parser process exits; doubles per exit in a row */
+const RESPAWN_BASE_DELAY = 100; // ms
+const RESPAWN_MAX_DELAY = 10000; // ms
+/**
+ * Parser processes exiting in a row before becoming ready, after which the
+ * pool gives up, e.g. when the addon cannot load in a child
+ */
+const MAX_CONSECUTIVE_EXITS = 5;
+
+interface PendingParse {
+  id: number;
+  filepath: string;
+  options: ParseOptions;
+  resolve: (result: GCodeParseResult) => void;
+  reject: (error: Error) => void;
+}
+
+interface PoolProcess {
+  child: ChildProcess;
+  /** Addon loaded; parses are only sent to ready processes */
+  ready: boolean;
+  current: PendingParse | null;
+  /** INI of the last parse, so repeat configs land on a warm interpreter */
+  lastIniPath: string | null;
+}
+
+interface ChildMessage {
+  ready?: boolean;
+  id?: number;
+  progress?: ParseProgress;
+  result?: GCodeParseResult;
+  error?: string;
+}
+
+/**
+ * Pool of parser processes.
+ *
+ * @example
+ * ```typescript
+ * const pool = new ParsePool({ size: 4 });
+ * const results = await Promise.all(
+ *   files.map((file) => pool.parse(file, { iniPath }))
+ * );
+ * await pool.close();
+ * ```
+ */
+export class ParsePool {
+  private processes: PoolProcess[] = [];
+  private queue: PendingParse[] = [];
+  private nextId = 1;
+  private closed = false;
+  /** Parser processes that exited since one last became ready */
+  private consecutiveExits = 0;
+  private respawnTimers = new Set<NodeJS.Timeout>();
+  /** Set once respawning gave up and no process is left */
+  private failure: Error | null = null;
+
+  constructor(options: ParsePoolOptions = {}) {
+    const size = Math.max(1, options.size ?? os.availableParallelism());
+    const addonPath = resolveAddonPath();
+
+    for (let i = 0; i < size; i++) {
+      this.processes.push(this.spawnProcess(addonPath));
+    }
+  }
+
+  /** Number of parser processes */
+  get size(): number {
+    return this.processes.length;
+  }
+
+  /**
+   * Parse a G-code file in one of the pool processes.
+   * Same contract as parseGCode().
+   */
+  parse(filepath: string, options: ParseOptions): Promise<GCodeParseResult> {
+    if (!options.iniPath) {
+      return Promise.reject(new Error("iniPath is required in ParseOptions"));
+    }
+    if (this.closed) {
+      return Promise.reject(new Error("ParsePool is closed"));
+    }
+    if (this.failure) {
+      return Promise.reject(this.failure);
+    }
+
+    return new Promise<GCodeParseResult>((resolve, reject) => {
+      this.queue.push({ id: this.nextId++, filepath, options, resolve, reject });
+      this.dispatch();
+    });
+  }
+
+  /**
+   * Stop all parser processes. Queued and running parses are rejected.
+   */
+  async close(): Promise<void> {
+    if (this.closed) return;
+    this.closed = true;
+
+    for (const timer of this.respawnTimers) {
+      clearTimeout(timer);
+    }
+    this.respawnTimers.clear();
+
+    const error = new Error("ParsePool is closed");
+    for (const pending of this.queue.splice(0)) {
+      pending.reject(error);
+    }
+
+    await Promise.all(
+      this.processes.map(
+        (proc) =>
+          new Promise<void>((resolve) => {
+            proc.current?.reject(error);
+            proc.current = null;
+            if (proc.child.exitCode !== null || proc.child.signalCode !== null) {
+              resolve();
+              return;
+            }
+            proc.child.once("exit", () => resolve());
+            proc.child.disconnect();
+          })
+      )
+    );
+  }
+
+  private spawnProcess(addonPath: string): PoolProcess {
+    const child = spawn(process.execPath, ["-e", CHILD_SOURCE, addonPath], {
+      stdio: ["ignore", "inherit", "inherit", "ipc"],
+      serialization: "advanced",
+    });
+
+    const proc: PoolProcess = {
+      child,
+      ready: false,
+      current: null,
+      lastIniPath: null,
+    };
+
+    child.on("message", (message: ChildMessage) => {
+      this.handleMessage(proc, message);
+    });
+
+    // Failed sends to an exiting child; the exit handler cleans up
+    child.on("error", () => {});
+
+    child.on("exit", (code, signal) => {
+      const index = this.processes.indexOf(proc);
+      if (index !== -1) {
+        this.processes.splice(index, 1);
+      }
+      if (proc.current) {
+        proc.current.reject(
+          new Error(`Parser process exited (${signal ?? code})`)
+        );
+        proc.current = null;
+      }
+      if (!this.closed) {
+        this.respawn(addonPath, `${signal ?? code}`);
+      }
+    });
+
+    return proc;
+  }
+
+  /**
+   * Keeps the pool at size after a crash, backing off exponentially while
+   * processes keep exiting before they are ready
+   */
+  private respawn(addonPath: string, reason: string): void {
+    this.consecutiveExits++;
+    if (this.consecutiveExits >= MAX_CONSECUTIVE_EXITS) {
+      if (this.processes.length === 0 && this.respawnTimers.size === 0) {
+        this.failure = new Error(
+          `ParsePool gave up after ${this.consecutiveExits} parser processes ` +
+            `exited in a row (last: ${reason})`
+        );
+        for (const pending of this.queue.splice(0)) {
+          pending.reject(this.failure);
+        }
+      }
+      return;
+    }
+
+    const delay = Math.min(
+      RESPAWN_BASE_DELAY * 2 ** (this.consecutiveExits - 1),
+      RESPAWN_MAX_DELAY
+    );
+    const timer = setTimeout(() => {
+      this.respawnTimers.delete(timer);
+      if (this.closed) return;
+      this.processes.push(this.spawnProcess(addonPath));
+      this.dispatch();
+    }, delay);
+    this.respawnTimers.add(timer);
+  }
+
+  private handleMessage(proc: PoolProcess, message: ChildMessage): void {
+    if (message.ready) {
+      // The addon loads: later crashes are not systematic
+      proc.ready = true;
+      this.consecutiveExits = 0;
+      this.dispatch();
+      return;
+    }
+
+    const pending = proc.current;
+    if (!pending || pending.id !== message.id) return;
+
+    if (message.progress) {
+      pending.options.onProgress?.(message.progress);
+      return;
+    }
+
+    proc.current = null;
+    if (message.error !== undefined) {
+      pending.reject(new Error(message.error));
+    } else {
+      pending.resolve(message.result as GCodeParseResult);
+    }
+    this.dispatch();
+  }
+
+  private dispatch(): void {
+    while (this.queue.length > 0) {
+      const idle = this.processes.filter(
+        (proc) => proc.ready && proc.current === null
+      );
+      if (idle.length === 0) return;
+
+      const pending = this.queue.shift()!;
+      const proc =
+        idle.find((p) => p.lastIniPath === pending.options.iniPath) ?? idle[0];
+
+      proc.current = pending;
+      proc.lastIniPath = pending.options.iniPath;
+      proc.child.send({
+        id: pending.id,
+        filepath: pending.filepath,
+        iniPath: pending.options.iniPath,
+        progressUpdates: pending.options.progressUpdates ?? 40,
+        wantProgress: pending.options.onProgress !== undefined,
+        maxErrors: collectErrorsLimit(pending.options),
+        profileLines: profileLinesLimit(pending.options),
+      });
+    }
+  }
+}
@@ -0,0 +1,53 @@
+/**
+ * G-Code Pre-scan Module
+ *
+ * Interpreter-free structural scan of a G-code file.
+ */
+
+import { PrescanOptions, PrescanResult } from "@linuxcnc-node/types";
+import { addon } from "./addon";
+
+/**
+ * Pre-scan a G-code file without running the interpreter.
+ *
+ * Returns the line index, word statistics, obviously malformed words and
+ * the O-word block structure in a single pass over the file. It does not
+ * wait behind running parses, which makes it suitable for immediate editor
+ * feedback and for deciding whether a full parse is worth starting.
+ *
+ * The pre-scan is syntactic only: a clean result does not guarantee that
+ * parseGCode() succeeds.
+ *
+ * @param filepath - Path to the G-code file
+ * @param options - Pre-scan options
+ * @returns Promise resolving to the pre-scan result
+ * @throws Error if the file cannot be read
+ *
+ * @example
+ * ```typescript
+ * const scan = await prescanGCode("/path/to/program.ngc");
+ * if (scan.issues.length > 0) {
+ *   showIssues(scan.issues);
+ * } else {
+ *   const result = await parseGCode("/path/to/program.ngc", { iniPath });
+ * }
+ * ```
+ */
+export async function prescanGCode(
+  filepath: string,
+  options: PrescanOptions = {}
+): Promise<PrescanResult> {
+  return new Promise<PrescanResult>((resolve, reject) => {
+    addon.prescanGCode(
+      filepath,
+      options.maxIssues ?? 1000,
+      (error: Error | null, result: PrescanResult) => {
+        if (error) {
+          reject(error);
+        } else {
+          resolve(result);
+        }
+      }
+    );
+  });
+}
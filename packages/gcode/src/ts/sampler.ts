@@ -0,0 +1,125 @@
+/**
+ * G-Code Path Sampler Module
+ *
+ * Arc-length and time index over a parsed toolpath for scrubbing and
+ * playback.
+ */
+
+import {
+  GCodeParseResult,
+  PathQuery,
+  PathSample,
+  PathSamplerOptions,
+  PathSamples,
+  ProgramTimingTable,
+} from "@linuxcnc-node/types";
+import { addon } from "./addon";
+
+/**
+ * Native index over the XYZ toolpath of a parse result.
+ *
+ * Building walks the operations once and stores cumulative path length and
+ * estimated time per move; queries are a binary search plus one segment
+ * evaluation, so seeking costs microseconds even for million-move programs.
+ * Arcs are evaluated exactly, without tessellation.
+ *
+ * Time estimates use the programmed feed rates and `rapidRate` for G0; they
+ * ignore acceleration, overrides and inverse-time feed. The path starts at
+ * the origin, like the viewer. NURBS moves are indexed as straight moves to
+ * their end point; rigid taps go down and back out to the starting Z.
+ *
+ * @example
+ * ```typescript
+ * const result = await parseGCode(file, { iniPath });
+ * const sampler = new PathSampler(result);
+ *
+ * slider.oninput = () => {
+ *   const { pos, lineNumber } = sampler.positionAt({
+ *     distance: slider.valueAsNumber * sampler.length,
+ *   });
+ *   moveTool(pos);
+ *   highlight(lineNumber);
+ * };
+ * ```
+ */
+export class PathSampler {
+  // eslint-disable-next-line @typescript-eslint/no-explicit-any
+  private readonly native: any;
+
+  /**
+   * @param source - Result of parseGCode(), or the encoded result from
+   *                 parseGCodeCompact() (decoded natively, no JS objects)
+   * @param options - Rates used for the time estimate
+   * @throws Error if the source is not a parse result
+   */
+  constructor(
+    source: GCodeParseResult | Uint8Array,
+    options: PathSamplerOptions = {}
+  ) {
+    this.native = new addon.PathSampler(source, options);
+  }
+
+  /** Total path length, in mm */
+  get length(): number {
+    return this.native.length;
+  }
+
+  /** Total estimated time, in seconds */
+  get duration(): number {
+    return this.native.duration;
+  }
+
+  /** Number of indexed moves (a rigid tap counts twice) */
+  get segmentCount(): number {
+    return this.native.segmentCount;
+  }
+
+  /**
+   * Tool position at a path length or an estimated time. Values outside
+   * the path clamp to its start or end.
+   */
+  positionAt(query: PathQuery): PathSample {
+    return "time" in query
+      ? this.native.atTime(query.time)
+      : this.native.atDistance(query.distance);
+  }
+
+  /**
+   * Index in result.operations of the move at `distance`, or -1 for a
+   * path without moves.
+   */
+  opAt(distance: number): number {
+    return this.native.opAt(distance);
+  }
+
+  /**
+   * Sample many points in one call, e.g. a trail behind the tool or a
+   * progress strip.
+   *
+   * @param values - Path lengths (mm) or times (s)
+   * @param by - What `values` hold
+   */
+  sample(
+    values: Float64Array | number[],
+    by: "distance" | "time" = "distance"
+  ): PathSamples {
+    const input = values instanceof Float64Array ? values : Float64Array.from(values);
+    return this.native.sample(input, by === "time");
+  }
+
+  /**
+   * Path length at which `lineNumber` first moves the tool, or at which the
+   * next line that does starts. -1 if no later line moves.
+   */
+  lineDistance(lineNumber: number): number {
+    return this.native.lineDistance(lineNumber);
+  }
+
+  /**
+   * Per-move line number, length, estimated time and rapid flag, for live
+   * progress tracking with StatChannel.setProgram() in @linuxcnc-node/core.
+   */
+  timingTable(): ProgramTimingTable {
+    return this.native.timingTable();
+  }
+}
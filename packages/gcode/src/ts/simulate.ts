@@ -0,0 +1,63 @@
+/**
+ * G-Code Planner Simulation Module
+ *
+ * Offline trajectory planner run for cycle-time estimates.
+ */
+
+import {
+  GCodeParseResult,
+  SimulationOptions,
+  ToolpathSimulation,
+} from "@linuxcnc-node/types";
+import { addon } from "./addon";
+
+/**
+ * Simulate the LinuxCNC trajectory planner over a parsed program.
+ *
+ * Unlike PathSampler's feed-rate estimate, this accounts for acceleration,
+ * corner blending under the program's G61/G61.1/G64 modes, the machine's
+ * velocity and acceleration limits and the planner's limited look-ahead,
+ * so the duration tracks what the machine will actually take.
+ *
+ * The toolpath is copied synchronously; the INI is read and the simulation
+ * runs off the event loop. Dwells, tool changes, probes and rigid taps stop
+ * the motion and split the program into blocks planned on separate threads.
+ * The path starts at rest at the origin.
+ *
+ * @param source - Result of parseGCode(), or the encoded result from
+ *                 parseGCodeCompact()
+ * @param options - INI file, limit overrides, blending and sampling
+ * @returns Promise resolving to the duration, per-move timing and samples
+ *
+ * @example
+ * ```typescript
+ * const result = await parseGCode(file, { iniPath });
+ * const sim = await simulateToolpath(result, { iniPath, tolerance: 0.01 });
+ * console.log(`Cycle time: ${(sim.duration / 60).toFixed(1)} min`);
+ * ```
+ */
+export async function simulateToolpath(
+  source: GCodeParseResult | Uint8Array,
+  options: SimulationOptions = {}
+): Promise<ToolpathSimulation> {
+  if (!options.iniPath && !(options.limits?.maxVelocity && options.limits?.maxAcceleration)) {
+    throw new Error(
+      "simulateToolpath needs iniPath or limits.maxVelocity and limits.maxAcceleration"
+    );
+  }
+
+  return new Promise<ToolpathSimulation>((resolve, reject) => {
+    addon.simulateToolpath(
+      source,
+      options.iniPath ?? "",
+      options,
+      (error: Error | null, simulation: ToolpathSimulation) => {
+        if (error) {
+          reject(error);
+        } else {
+          resolve(simulation);
+        }
+      }
+    );
+  });
+}
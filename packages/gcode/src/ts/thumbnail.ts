@@ -0,0 +1,154 @@
+/**
+ * G-Code Thumbnail Module
+ *
+ * CPU rasterizer for toolpath previews in job lists.
+ */
+
+import { promisify } from "util";
+import { deflate, deflateSync } from "zlib";
+import {
+  GCodeParseResult,
+  Thumbnail,
+  ThumbnailOptions,
+} from "@linuxcnc-node/types";
+import { addon } from "./addon";
+
+/**
+ * Render toolpath thumbnails for several parse results.
+ *
+ * The motion is copied out of the results synchronously; rasterization runs
+ * off the event loop with the files spread over `options.threads` threads.
+ * Rapids and feeds are drawn as anti-aliased lines in their own colours,
+ * scaled to fit the image.
+ *
+ * @param results - Parse results from parseGCode()
+ * @param options - Size, view and colours, shared by every thumbnail
+ * @returns Promise resolving to one RGBA thumbnail per result, in order
+ *
+ * @example
+ * ```typescript
+ * const thumbs = await renderThumbnails(results, { width: 128, height: 96 });
+ * const png = encodePng(thumbs[0]);
+ * ```
+ */
+export async function renderThumbnails(
+  results: GCodeParseResult[],
+  options: ThumbnailOptions = {}
+): Promise<Thumbnail[]> {
+  return new Promise<Thumbnail[]>((resolve, reject) => {
+    addon.renderThumbnails(
+      results,
+      options,
+      options.threads ?? 0,
+      (error: Error | null, thumbnails: Thumbnail[]) => {
+        if (error) {
+          reject(error);
+        } else {
+          resolve(thumbnails);
+        }
+      }
+    );
+  });
+}
+
+/**
+ * Render a toolpath thumbnail for one parse result.
+ *
+ * @param result - Parse result from parseGCode()
+ * @param options - Size, view and colours
+ * @returns Promise resolving to the RGBA thumbnail
+ */
+export async function renderThumbnail(
+  result: GCodeParseResult,
+  options: ThumbnailOptions = {}
+): Promise<Thumbnail> {
+  const [thumbnail] = await renderThumbnails([result], options);
+  return thumbnail;
+}
+
+// ============================================================================
+// PNG encoding
+// ============================================================================
+
+const PNG_SIGNATURE = Buffer.from([137, 80, 78, 71, 13, 10, 26, 10]);
+
+const CRC_TABLE = (() => {
+  const table = new Uint32Array(256);
+  for (let n = 0; n < 256; n++) {
+    let c = n;
+    for (let k = 0; k < 8; k++) {
+      c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+    }
+    table[n] = c >>> 0;
+  }
+  return table;
+})();
+
+function crc32(data: Uint8Array): number {
+  let crc = 0xffffffff;
+  for (let i = 0; i < data.length; i++) {
+    crc = CRC_TABLE[(crc ^ data[i]) & 0xff] ^ (crc >>> 8);
+  }
+  return (crc ^ 0xffffffff) >>> 0;
+}
+
+function pngChunk(type: string, data: Buffer): Buffer {
+  const chunk = Buffer.alloc(data.length + 12);
+  chunk.writeUInt32BE(data.length, 0);
+  chunk.write(type, 4, "latin1");
+  data.copy(chunk, 8);
+  chunk.writeUInt32BE(crc32(chunk.subarray(4, 8 + data.length)), 8 + data.length);
+  return chunk;
+}
+
+const deflateAsync = promisify(deflate);
+
+/** Image rows, each prefixed with filter type 0 (None) */
+function pngScanlines(thumbnail: Thumbnail): Buffer {
+  const { width, height, data } = thumbnail;
+  const stride = width * 4;
+
+  const raw = Buffer.alloc((stride + 1) * height);
+  for (let y = 0; y < height; y++) {
+    raw.set(data.subarray(y * stride, (y + 1) * stride), y * (stride + 1) + 1);
+  }
+  return raw;
+}
+
+function pngFile(thumbnail: Thumbnail, compressed: Buffer): Buffer {
+  const header = Buffer.alloc(13);
+  header.writeUInt32BE(thumbnail.width, 0);
+  header.writeUInt32BE(thumbnail.height, 4);
+  header[8] = 8; // Bit depth
+  header[9] = 6; // Colour type: RGBA
+
+  return Buffer.concat([
+    PNG_SIGNATURE,
+    pngChunk("IHDR", header),
+    pngChunk("IDAT", compressed),
+    pngChunk("IEND", Buffer.alloc(0)),
+  ]);
+}
+
+/**
+ * Encode a thumbnail as an 8-bit RGBA PNG.
+ *
+ * Compresses on the calling thread; servers should use encodePngAsync().
+ *
+ * @param thumbnail - Thumbnail from renderThumbnail(s)
+ * @returns PNG file contents
+ */
+export function encodePng(thumbnail: Thumbnail): Buffer {
+  return pngFile(thumbnail, deflateSync(pngScanlines(thumbnail)));
+}
+
+/**
+ * Encode a thumbnail as an 8-bit RGBA PNG, compressing on the libuv thread
+ * pool instead of the event loop.
+ *
+ * @param thumbnail - Thumbnail from renderThumbnail(s)
+ * @returns Promise resolving to the PNG file contents
+ */
+export async function encodePngAsync(thumbnail: Thumbnail): Promise<Buffer> {
+  return pngFile(thumbnail, await deflateAsync(pngScanlines(thumbnail)));
+}
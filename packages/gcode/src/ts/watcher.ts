@@ -0,0 +1,199 @@
+/**
+ * Program Watcher Module
+ *
+ * Keeps a parse result for a program up to date as the program, its INI or
+ * any subroutine file it depends on changes.
+ */
+
+import { EventEmitter } from "events";
+import * as fs from "fs";
+import * as path from "path";
+import { GCodeParseResult, ParseOptions } from "@linuxcnc-node/types";
+import { parseGCode } from "./parser";
+
+export interface WatchOptions extends ParseOptions {
+  /**
+   * Quiet period after the last change before re-parsing, in ms.
+   * Editors often write a file in several steps.
+   * @default 100
+   */
+  debounceMs?: number;
+}
+
+/**
+ * Watches a program and its dependencies and re-parses on change.
+ *
+ * Files are watched through their parent directories (inotify on Linux), so
+ * editors that save by writing a temporary file and renaming it over the
+ * original are picked up too. The watched set is refreshed from
+ * `result.dependencies` after every parse.
+ *
+ * Python remaps and o-word subroutines are not dependencies: the embedded
+ * interpreter imports their modules once per process and never re-reads
+ * them, so editing one neither triggers nor affects a re-parse.
+ *
+ * Events:
+ * - `invalidated` (changedPath: string): the cached result is stale
+ * - `result` (result: GCodeParseResult): a fresh parse finished
+ * - `error` (error: Error): a re-parse failed; watching continues
+ */
+export class ProgramWatcher extends EventEmitter {
+  readonly filepath: string;
+  private options: WatchOptions;
+  private cached: GCodeParseResult | null = null;
+  private watchers = new Map<string, fs.FSWatcher>();
+  private watchedFiles = new Set<string>();
+  private debounceTimer: NodeJS.Timeout | null = null;
+  private parsing = false;
+  private dirty = false;
+  private closed = false;
+
+  constructor(filepath: string, options: WatchOptions) {
+    super();
+    this.filepath = path.resolve(filepath);
+    this.options = options;
+  }
+
+  /** Last parse result, or null while it is stale or being re-parsed */
+  get result(): GCodeParseResult | null {
+    return this.cached;
+  }
+
+  /**
+   * Parse the program and start watching it and its dependencies.
+   * If the initial parse fails, watching stops and start() may be retried.
+   * @returns The initial parse result
+   */
+  async start(): Promise<GCodeParseResult> {
+    this.updateWatches([]);
+    this.parsing = true;
+    try {
+      // Changes during the parse are picked up by parsing again, as reparse()
+      // does, so the returned result is never older than the files
+      let result: GCodeParseResult;
+      do {
+        this.dirty = false;
+        result = await parseGCode(this.filepath, this.options);
+      } while (this.dirty && !this.closed);
+      this.applyResult(result);
+      return result;
+    } catch (err) {
+      this.clearWatches();
+      throw err;
+    } finally {
+      this.parsing = false;
+      this.dirty = false;
+    }
+  }
+
+  /** Stop watching. Pending re-parses are dropped. */
+  close(): void {
+    this.closed = true;
+    this.clearWatches();
+  }
+
+  private clearWatches(): void {
+    if (this.debounceTimer) {
+      clearTimeout(this.debounceTimer);
+      this.debounceTimer = null;
+    }
+    for (const watcher of this.watchers.values()) {
+      watcher.close();
+    }
+    this.watchers.clear();
+    this.watchedFiles.clear();
+  }
+
+  private applyResult(result: GCodeParseResult): void {
+    if (this.closed) return;
+    this.cached = result;
+    this.updateWatches(result.dependencies ?? []);
+  }
+
+  private updateWatches(dependencies: string[]): void {
+    const files = [
+      this.filepath,
+      path.resolve(this.options.iniPath),
+      ...dependencies,
+    ];
+    this.watchedFiles = new Set(files);
+
+    const dirs = new Set(files.map((file) => path.dirname(file)));
+    for (const [dir, watcher] of this.watchers) {
+      if (!dirs.has(dir)) {
+        watcher.close();
+        this.watchers.delete(dir);
+      }
+    }
+    for (const dir of dirs) {
+      if (this.watchers.has(dir)) continue;
+      try {
+        const watcher = fs.watch(dir, (_event, name) => {
+          if (name) this.onChange(path.join(dir, name.toString()));
+        });
+        watcher.on("error", (err) => this.emit("error", err));
+        this.watchers.set(dir, watcher);
+      } catch (err) {
+        this.emit("error", err);
+      }
+    }
+  }
+
+  private onChange(changedPath: string): void {
+    if (this.closed || !this.watchedFiles.has(changedPath)) return;
+
+    if (this.cached) {
+      this.cached = null;
+      this.emit("invalidated", changedPath);
+    }
+
+    if (this.debounceTimer) clearTimeout(this.debounceTimer);
+    this.debounceTimer = setTimeout(() => {
+      this.debounceTimer = null;
+      void this.reparse();
+    }, this.options.debounceMs ?? 100);
+  }
+
+  private async reparse(): Promise<void> {
+    if (this.closed) return;
+    if (this.parsing) {
+      // Changed again mid-parse; run once more when this one finishes
+      this.dirty = true;
+      return;
+    }
+
+    this.parsing = true;
+    try {
+      const result = await parseGCode(this.filepath, this.options);
+      if (!this.dirty) {
+        this.applyResult(result);
+        if (!this.closed) this.emit("result", result);
+      }
+    } catch (err) {
+      if (!this.dirty && !this.closed) this.emit("error", err);
+    } finally {
+      this.parsing = false;
+      if (this.dirty) {
+        this.dirty = false;
+        void this.reparse();
+      }
+    }
+  }
+}
+
+/**
+ * Parse a program and keep the result fresh as files change.
+ *
+ * @example
+ * ```typescript
+ * const watcher = watchGCode("/path/to/program.ngc", { iniPath });
+ * watcher.on("result", (result) => redraw(result));
+ * const initial = await watcher.start();
+ * ```
+ */
+export function watchGCode(
+  filepath: string,
+  options: WatchOptions
+): ProgramWatcher {
+  return new ProgramWatcher(filepath, options);
+}
@@ -6,8 +6,9 @@
  */
 
 import * as fs from "fs";
+import * as os from "os";
 import * as path from "path";
-import { parseGCode } from "../../src/ts";
+import { parseGCode, ParsePool } from "../../src/ts";
 
 // ============================================================================
 // Configuration
@@ -19,6 +20,15 @@ const iniPath = path.join(__dirname, "../config.ini");
 /** Path for the pre-generated large test file */
 const largeFilePath = path.join(__dirname, "../fixtures/large_1mb.ngc");
 
+/** Remap-heavy program: Python tool-change and probe remaps on every cycle */
+const remapFilePath = path.join(__dirname, "../fixtures/remap_heavy.ngc");
+
+/** Directory holding the remap Python sources */
+const remapDir = path.join(__dirname, "../remap");
+
+/** Fail the remap scaling benchmark on a low speedup (GCODE_BENCH_ASSERT=1) */
+const assertSpeedup = process.env.GCODE_BENCH_ASSERT === "1";
+
 // ============================================================================
 // Helpers
 // ============================================================================
@@ -96,6 +106,38 @@ function ensureLargeFileExists(): number {
   return content.length;
 }
 
+/**
+ * Write an INI with the tool-change and probe remaps enabled.
+ * Derived from config.ini; all paths are absolute so the interpreter finds
+ * them regardless of the working directory.
+ */
+function writeRemapIni(): string {
+  const base = fs.readFileSync(iniPath, "utf8");
+  const remapIni = base
+    .replace(
+      "[RS274NGC]\nPARAMETER_FILE = sim_mm.var",
+      [
+        "[RS274NGC]",
+        `PARAMETER_FILE = ${path.join(os.tmpdir(), "linuxcnc-node-remap.var")}`,
+        "REMAP = M6 modalgroup=6 python=tool_change",
+        "REMAP = G88.1 modalgroup=1 argspec=xyZ python=probe_cycle",
+      ].join("\n")
+    )
+    .concat(
+      [
+        "",
+        "[PYTHON]",
+        `PATH_APPEND = ${remapDir}`,
+        `TOPLEVEL = ${path.join(remapDir, "toplevel.py")}`,
+        "",
+      ].join("\n")
+    );
+
+  const remapIniPath = path.join(os.tmpdir(), "linuxcnc-node-remap.ini");
+  fs.writeFileSync(remapIniPath, remapIni);
+  return remapIniPath;
+}
+
 // ============================================================================
 // Tests
 // ============================================================================
@@ -206,3 +248,69 @@ describe("performance", () => {
     expect(progressCallCount).toBe(1);
   }, 120000);
 });
+
+describe("remap scaling", () => {
+  let remapIniPath: string;
+  let pool: ParsePool;
+
+  beforeAll(() => {
+    remapIniPath = writeRemapIni();
+    pool = new ParsePool();
+  });
+
+  afterAll(async () => {
+    await pool.close();
+  });
+
+  it("should scale remap-heavy parses across pool processes", async () => {
+    const runs = Math.max(pool.size * 2, 4);
+
+    // Warm up: interpreter and Python start-up excluded from timings
+    const reference = await parseGCode(remapFilePath, { iniPath: remapIniPath });
+    await Promise.all(
+      Array.from({ length: pool.size }, () =>
+        pool.parse(remapFilePath, { iniPath: remapIniPath })
+      )
+    );
+
+    // In-process parses share one interpreter and one GIL
+    const serialStart = performance.now();
+    for (let i = 0; i < runs; i++) {
+      await parseGCode(remapFilePath, { iniPath: remapIniPath });
+    }
+    const serialTime = performance.now() - serialStart;
+
+    const poolStart = performance.now();
+    const pooled = await Promise.all(
+      Array.from({ length: runs }, () =>
+        pool.parse(remapFilePath, { iniPath: remapIniPath })
+      )
+    );
+    const poolTime = performance.now() - poolStart;
+
+    const speedup = serialTime / poolTime;
+    console.log("\n  ┌─────────────────────────────────────────────────────┐");
+    console.log("  │             REMAP SCALING BENCHMARK                 │");
+    console.log("  ├─────────────────────────────────────────────────────┤");
+    console.log(`  │  Parses:           ${String(runs).padEnd(30)}│`);
+    console.log(`  │  Operations/parse: ${reference.operations.length.toLocaleString().padEnd(30)}│`);
+    console.log(`  │  Pool processes:   ${String(pool.size).padEnd(30)}│`);
+    console.log(`  │  In-process:       ${formatDuration(serialTime).padEnd(30)}│`);
+    console.log(`  │  Pool:             ${formatDuration(poolTime).padEnd(30)}│`);
+    console.log(`  │  Speedup:          ${`${speedup.toFixed(2)}x`.padEnd(30)}│`);
+    console.log("  └─────────────────────────────────────────────────────┘\n");
+
+    expect(reference.operations.length).toBeGreaterThan(0);
+    for (const result of pooled) {
+      expect(result).toEqual(reference);
+    }
+
+    // Timing on shared CI runners is too noisy to fail on, so the speedup
+    // is only checked on request. With two or more processes the pool must
+    // beat the single in-process interpreter by a clear margin; a
+    // single-core machine can only match it.
+    if (assertSpeedup) {
+      expect(speedup).toBeGreaterThan(pool.size >= 2 ? 1.3 : 0.8);
+    }
+  }, 300000);
+});
@@ -0,0 +1,146 @@
+/**
+ * Integration tests for the compact parse result encoding
+ */
+
+import * as path from "path";
+import {
+  decodeParseResult,
+  parseGCode,
+  parseGCodeCompact,
+} from "../../src/ts";
+import { GCodeParseResult } from "@linuxcnc-node/types";
+
+/** Get absolute path to a fixture file */
+const fixturePath = (name: string): string =>
+  path.join(__dirname, "../fixtures", name);
+
+/** Path to the machine configuration INI file */
+const iniPath = path.join(__dirname, "../config.ini");
+
+const FIXTURES = [
+  "simple_linear.ngc",
+  "arcs.ngc",
+  "mixed.ngc",
+  "offsets.ngc",
+  "tool_change.ngc",
+  "motion_modes.ngc",
+];
+
+/**
+ * Compare two results field by field; numbers may differ by `tolerance`.
+ */
+const expectClose = (
+  actual: unknown,
+  expected: unknown,
+  tolerance: number,
+  where = "result"
+): void => {
+  if (typeof expected === "number") {
+    expect(typeof actual).toBe("number");
+    if (Math.abs((actual as number) - expected) > tolerance) {
+      throw new Error(`${where}: ${actual} != ${expected}`);
+    }
+  } else if (
+    expected instanceof Float64Array ||
+    Array.isArray(expected)
+  ) {
+    const a = actual as ArrayLike<unknown>;
+    const e = expected as ArrayLike<unknown>;
+    expect(a.length).toBe(e.length);
+    for (let i = 0; i < e.length; i++) {
+      expectClose(a[i], e[i], tolerance, `${where}[${i}]`);
+    }
+  } else if (expected !== null && typeof expected === "object") {
+    expect(Object.keys(actual as object).sort()).toEqual(
+      Object.keys(expected).sort()
+    );
+    for (const [key, value] of Object.entries(expected)) {
+      expectClose((actual as Record<string, unknown>)[key], value, tolerance, `${where}.${key}`);
+    }
+  } else {
+    expect(actual).toEqual(expected);
+  }
+};
+
+describe("compact encoding", () => {
+  it.each(FIXTURES)("should round-trip %s", async (name) => {
+    const expected = await parseGCode(fixturePath(name), { iniPath });
+    const data = await parseGCodeCompact(fixturePath(name), {
+      iniPath,
+      resolution: 1e-4,
+    });
+    const decoded = decodeParseResult(data);
+
+    expectClose(decoded, expected, 1e-4);
+  });
+
+  it("should be much smaller than the object form", async () => {
+    const result = await parseGCode(fixturePath("mixed.ngc"), { iniPath });
+    const data = await parseGCodeCompact(fixturePath("mixed.ngc"), { iniPath });
+
+    // Lower bound for the object form: nine float64s per position
+    const positions = result.operations.filter((op) => "pos" in op).length;
+    expect(data.length).toBeLessThan(positions * 9 * 8);
+  });
+
+  it("should quantise to the requested resolution", async () => {
+    const data = await parseGCodeCompact(fixturePath("arcs.ngc"), {
+      iniPath,
+      resolution: 1,
+    });
+    const decoded = decodeParseResult(data);
+
+    for (const op of decoded.operations) {
+      if ("pos" in op) {
+        for (const v of op.pos) {
+          expect(Number.isInteger(v)).toBe(true);
+        }
+      }
+    }
+  });
+
+  it("should keep collected errors", async () => {
+    const options = { iniPath, collectErrors: true };
+    const expected = await parseGCode(fixturePath("multiple_errors.ngc"), options);
+    const decoded = decodeParseResult(
+      await parseGCodeCompact(fixturePath("multiple_errors.ngc"), options)
+    );
+
+    expect(decoded.errors).toEqual(expected.errors);
+  });
+
+  it("should omit errors when not collecting", async () => {
+    const decoded = decodeParseResult(
+      await parseGCodeCompact(fixturePath("simple_linear.ngc"), { iniPath })
+    );
+
+    expect(decoded.errors).toBeUndefined();
+  });
+
+  it("should reject truncated or foreign data", async () => {
+    const data = await parseGCodeCompact(fixturePath("mixed.ngc"), { iniPath });
+
+    expect(() => decodeParseResult(data.subarray(0, data.length - 1))).toThrow(
+      "Malformed"
+    );
+    expect(() => decodeParseResult(new Uint8Array([1, 2, 3, 4]))).toThrow(
+      "Not a compact parse result"
+    );
+  });
+
+  it("should reject a non-positive resolution", async () => {
+    await expect(
+      parseGCodeCompact(fixturePath("mixed.ngc"), { iniPath, resolution: 0 })
+    ).rejects.toThrow("resolution");
+  });
+
+  it("should share a parse with a concurrent object request", async () => {
+    const [objects, data] = await Promise.all([
+      parseGCode(fixturePath("arcs.ngc"), { iniPath }),
+      parseGCodeCompact(fixturePath("arcs.ngc"), { iniPath }),
+    ]);
+
+    const decoded: GCodeParseResult = decodeParseResult(data);
+    expect(decoded.operations.length).toBe(objects.operations.length);
+  });
+});
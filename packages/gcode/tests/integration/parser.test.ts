@@ -6,6 +6,7 @@
  */
 
 import * as path from "path";
+import { Worker } from "worker_threads";
 import { parseGCode } from "../../src/ts";
 import {
   GCodeParseResult,
@@ -24,6 +25,8 @@ import {
   UnitsChangeOperation,
   PlaneChangeOperation,
   FeedRateChangeOperation,
+  MotionModeChangeOperation,
+  MotionMode,
   DwellOperation,
   ParseProgress,
 } from "@linuxcnc-node/types";
@@ -502,6 +505,33 @@ describe("parseGCode", () => {
       expect(dwell).toBeDefined();
       expect(dwell!.duration).toBeCloseTo(0.5, 2); // G4 P0.5 = 0.5 seconds
     });
+
+    it("should record G61, G61.1 and G64 as MOTION_MODE_CHANGE operations", async () => {
+      const modes = await parseGCode(fixturePath("motion_modes.ngc"), {
+        iniPath,
+      });
+      const changes = findAll<MotionModeChangeOperation>(
+        modes.operations,
+        OperationType.MOTION_MODE_CHANGE
+      );
+
+      // motion_modes.ngc: G61.1, G61, G64 P0.001 Q0.0005, G64; the P and Q
+      // of one block make a single operation
+      expect(changes.map((c) => c.mode)).toEqual([
+        MotionMode.EXACT_STOP,
+        MotionMode.EXACT_PATH,
+        MotionMode.CONTINUOUS,
+        MotionMode.CONTINUOUS,
+      ]);
+      expect(changes[2].tolerance).toBeCloseTo(0.001, 9);
+      expect(changes[2].naivecamTolerance).toBeCloseTo(0.0005, 9);
+      expect(changes[3].tolerance).toBe(0);
+    });
+
+    it("should not record the interpreter's initial motion mode", () => {
+      // mixed.ngc sets no path control mode
+      expect(countByType(result.operations, OperationType.MOTION_MODE_CHANGE)).toBe(0);
+    });
   });
 
   // --------------------------------------------------------------------------
@@ -605,6 +635,91 @@ describe("parseGCode", () => {
     });
   });
 
+  // --------------------------------------------------------------------------
+  // Concurrent Parses
+  // --------------------------------------------------------------------------
+
+  describe("concurrent parses", () => {
+    it("should return equal results for concurrent parses of the same file", async () => {
+      const results = await Promise.all(
+        [0, 1, 2].map(() => parseGCode(fixturePath("mixed.ngc"), { iniPath }))
+      );
+
+      // Each caller gets its own JS object built from the shared native result
+      expect(results[0]).not.toBe(results[1]);
+      expect(results[1]).toEqual(results[0]);
+      expect(results[2]).toEqual(results[0]);
+    });
+
+    it("should reject every concurrent caller when the shared parse fails", async () => {
+      const attempts = [0, 1].map(() =>
+        parseGCode(fixturePath("invalid_syntax.ngc"), { iniPath })
+      );
+
+      for (const attempt of attempts) {
+        await expect(attempt).rejects.toThrow();
+      }
+    });
+  });
+
+  // --------------------------------------------------------------------------
+  // Interpreter Cache
+  // --------------------------------------------------------------------------
+
+  describe("interpreter cache", () => {
+    it("should give identical results when alternating INI paths", async () => {
+      // A different path string to the same INI gets its own cached interpreter
+      const altIniPath = path.join(__dirname, "../../tests/config.ini");
+
+      const first = await parseGCode(fixturePath("tool_change.ngc"), { iniPath });
+      const alt = await parseGCode(fixturePath("tool_change.ngc"), {
+        iniPath: altIniPath,
+      });
+      const again = await parseGCode(fixturePath("tool_change.ngc"), { iniPath });
+
+      expect(alt).toEqual(first);
+      expect(again).toEqual(first);
+    });
+  });
+
+  // --------------------------------------------------------------------------
+  // Worker Threads
+  // --------------------------------------------------------------------------
+
+  describe("worker threads", () => {
+    it("should parse from a worker_thread while the main thread parses", async () => {
+      const addonPath = path.join(__dirname, "../../build/Release/gcode_addon.node");
+      const worker = new Worker(
+        `
+        const { parentPort, workerData } = require("worker_threads");
+        const addon = require(workerData.addonPath);
+        addon.parseGCode(workerData.file, workerData.iniPath, 0, () => {}, (err, result) => {
+          parentPort.postMessage(err ? { error: err.message } : { count: result.operations.length });
+        });
+        `,
+        {
+          eval: true,
+          workerData: { addonPath, file: fixturePath("arcs.ngc"), iniPath },
+        }
+      );
+
+      const fromWorker = new Promise<{ count?: number; error?: string }>(
+        (resolve, reject) => {
+          worker.once("message", resolve);
+          worker.once("error", reject);
+        }
+      );
+      const [workerResult, mainResult] = await Promise.all([
+        fromWorker,
+        parseGCode(fixturePath("arcs.ngc"), { iniPath }),
+      ]);
+      await worker.terminate();
+
+      expect(workerResult.error).toBeUndefined();
+      expect(workerResult.count).toBe(mainResult.operations.length);
+    });
+  });
+
   // --------------------------------------------------------------------------
   // Error Handling
   // --------------------------------------------------------------------------
@@ -635,5 +750,55 @@ describe("parseGCode", () => {
         parseGCode(fixturePath("invalid_syntax.ngc"), { iniPath })
       ).rejects.toThrow();
     });
+
+    it("should not report errors unless collectErrors is set", async () => {
+      const result = await parseGCode(fixturePath("simple_linear.ngc"), {
+        iniPath,
+      });
+      expect(result.errors).toBeUndefined();
+    });
+  });
+
+  describe("collect errors", () => {
+    it("should collect every error and keep parsing", async () => {
+      const result = await parseGCode(fixturePath("multiple_errors.ngc"), {
+        iniPath,
+        collectErrors: true,
+      });
+
+      expect(result.errors).toHaveLength(2);
+      const [first, second] = result.errors!;
+      expect(first.lineNumber).toBe(7);
+      expect(first.text).toContain("G999");
+      expect(first.message.length).toBeGreaterThan(0);
+      expect(first.fatal).toBe(false);
+      expect(second.lineNumber).toBe(9);
+      expect(second.fatal).toBe(false);
+
+      // Blocks after each bad line were still interpreted
+      const feeds = findAll<FeedOperation>(result.operations, OperationType.FEED);
+      const feedXs = feeds.map((op) => op.pos[X]);
+      expect(feedXs).toContain(20);
+      expect(feedXs).toContain(30);
+    });
+
+    it("should return an empty error list for valid programs", async () => {
+      const result = await parseGCode(fixturePath("mixed.ngc"), {
+        iniPath,
+        collectErrors: true,
+      });
+      expect(result.errors).toEqual([]);
+    });
+
+    it("should stop at maxErrors", async () => {
+      const result = await parseGCode(fixturePath("multiple_errors.ngc"), {
+        iniPath,
+        collectErrors: true,
+        maxErrors: 1,
+      });
+
+      expect(result.errors).toHaveLength(1);
+      expect(result.errors![0].fatal).toBe(true);
+    });
   });
 });
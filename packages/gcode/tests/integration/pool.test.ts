@@ -0,0 +1,47 @@
+/**
+ * ParsePool process supervision
+ *
+ * Uses a child "addon" that fails to load, as with a missing librs274 or an
+ * ABI mismatch, to check that respawning backs off and gives up.
+ */
+
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+
+const mockAddonPath = path.join(
+  fs.mkdtempSync(path.join(os.tmpdir(), "parse-pool-")),
+  "broken_addon.js"
+);
+fs.writeFileSync(mockAddonPath, 'throw new Error("cannot load addon");\n');
+
+jest.mock("../../src/ts/addon", () => ({
+  addon: {},
+  resolveAddonPath: () => mockAddonPath,
+}));
+
+import { ParsePool } from "../../src/ts/pool";
+
+describe("ParsePool", () => {
+  afterAll(() => {
+    fs.rmSync(path.dirname(mockAddonPath), { recursive: true, force: true });
+  });
+
+  it("should reject parses once processes keep failing to start", async () => {
+    const pool = new ParsePool({ size: 1 });
+    const started = performance.now();
+
+    // Queued until a process is ready, then rejected when the pool gives up
+    await expect(
+      pool.parse("/tmp/program.ngc", { iniPath: "/tmp/sim.ini" })
+    ).rejects.toThrow(/gave up after 5 parser processes/);
+
+    // Backoff of 100 + 200 + 400 + 800 ms between the 5 attempts
+    expect(performance.now() - started).toBeGreaterThanOrEqual(1500);
+    await expect(
+      pool.parse("/tmp/program.ngc", { iniPath: "/tmp/sim.ini" })
+    ).rejects.toThrow(/gave up/);
+
+    await pool.close();
+  }, 30000);
+});
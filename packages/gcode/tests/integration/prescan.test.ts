@@ -0,0 +1,69 @@
+/**
+ * Integration tests for the interpreter-free G-code pre-scan
+ */
+
+import * as path from "path";
+import { prescanGCode } from "../../src/ts";
+
+/** Get absolute path to a fixture file */
+const fixturePath = (name: string): string =>
+  path.join(__dirname, "../fixtures", name);
+
+describe("prescanGCode", () => {
+  it("should index every line", async () => {
+    const result = await prescanGCode(fixturePath("simple_linear.ngc"));
+
+    expect(result.lineCount).toBe(result.lineOffsets.length);
+    expect(result.lineOffsets[0]).toBe(0);
+    expect(result.totalBytes).toBeGreaterThan(
+      result.lineOffsets[result.lineCount - 1]
+    );
+    expect(result.issues).toEqual([]);
+  });
+
+  it("should count words and G/M codes", async () => {
+    const result = await prescanGCode(fixturePath("tool_change.ngc"));
+
+    expect(result.wordCounts.T).toBeGreaterThan(0);
+    expect(result.mCodes.M6).toBeGreaterThan(0);
+    expect(result.gCodes.G43).toBeGreaterThan(0);
+  });
+
+  it("should report O-word structure and external subroutines", async () => {
+    const result = await prescanGCode(fixturePath("prescan_structure.ngc"));
+
+    expect(result.subroutines).toEqual([
+      { name: "<probe_corner>", startLine: 3, endLine: 8 },
+      { name: "100", startLine: 10, endLine: 12 },
+    ]);
+    expect(result.calls.map((c) => c.name)).toEqual([
+      "<probe_corner>",
+      "100",
+      "<tool_touch>",
+    ]);
+    expect(result.externalSubroutines).toEqual(["tool_touch"]);
+    expect(result.gCodes["G38.2"]).toBe(1);
+  });
+
+  it("should report malformed words and unclosed blocks", async () => {
+    const result = await prescanGCode(fixturePath("prescan_structure.ngc"));
+
+    const lines = result.issues.map((issue) => issue.lineNumber);
+    expect(lines).toContain(18); // unexpected '@'
+    expect(lines).toContain(22); // Y without value
+    expect(lines).toContain(21); // o102 if never closed
+  });
+
+  it("should cap recorded issues", async () => {
+    const result = await prescanGCode(fixturePath("prescan_structure.ngc"), {
+      maxIssues: 1,
+    });
+
+    expect(result.issues).toHaveLength(1);
+    expect(result.issuesTruncated).toBe(true);
+  });
+
+  it("should reject for a missing file", async () => {
+    await expect(prescanGCode("/nonexistent/file.ngc")).rejects.toThrow();
+  });
+});
@@ -0,0 +1,94 @@
+/**
+ * Integration tests for the interpreter line profiler
+ */
+
+import * as path from "path";
+import { parseGCode } from "../../src/ts";
+
+/** Get absolute path to a fixture file */
+const fixturePath = (name: string): string =>
+  path.join(__dirname, "../fixtures", name);
+
+/** Path to the machine configuration INI file */
+const iniPath = path.join(__dirname, "../config.ini");
+
+describe("profile", () => {
+  it("should not profile by default", async () => {
+    const result = await parseGCode(fixturePath("profile_loop.ngc"), { iniPath });
+
+    expect(result.profile).toBeUndefined();
+  });
+
+  it("should count line executions and canon calls", async () => {
+    const result = await parseGCode(fixturePath("profile_loop.ngc"), {
+      iniPath,
+      profile: true,
+      profileLines: 100,
+    });
+    const profile = result.profile!;
+
+    const line = (n: number) =>
+      profile.lines.find((l) => l.lineNumber === n);
+
+    // Subroutine body runs once per loop iteration
+    expect(line(4)?.executions).toBe(5);
+    expect(line(4)?.text).toContain("G1 X10");
+    expect(line(4)?.canonCalls).toBeGreaterThanOrEqual(5);
+    expect(line(11)?.executions).toBe(5);
+    expect(line(14)?.executions).toBe(1);
+
+    expect(profile.blocks).toBe(
+      profile.lines.reduce((sum, l) => sum + l.executions, 0)
+    );
+    expect(profile.interpreterMs).toBeGreaterThan(0);
+    expect(profile.interpreterMs).toBeLessThanOrEqual(profile.wallMs);
+  });
+
+  it("should attribute lines to subroutines", async () => {
+    const result = await parseGCode(fixturePath("profile_loop.ngc"), {
+      iniPath,
+      profile: true,
+    });
+    const profile = result.profile!;
+
+    expect(profile.lines.find((l) => l.lineNumber === 5)?.subroutine).toBe(
+      "o<zigzag>"
+    );
+    expect(
+      profile.lines.find((l) => l.lineNumber === 14)?.subroutine
+    ).toBeUndefined();
+
+    const zigzag = profile.subroutines.find((s) => s.name === "o<zigzag>");
+    expect(zigzag).toBeDefined();
+    expect(zigzag!.filename).toBe(fixturePath("profile_loop.ngc"));
+    expect(zigzag!.timeMs).toBeGreaterThan(0);
+    // Called once per loop pass, three body lines per call
+    expect(zigzag!.calls).toBe(5);
+    expect(zigzag!.blocks).toBeGreaterThanOrEqual(15);
+  });
+
+  it("should keep only the hottest lines, sorted", async () => {
+    const result = await parseGCode(fixturePath("profile_loop.ngc"), {
+      iniPath,
+      profile: true,
+      profileLines: 3,
+    });
+    const lines = result.profile!.lines;
+
+    expect(lines.length).toBe(3);
+    for (let i = 1; i < lines.length; i++) {
+      expect(lines[i - 1].timeMs).toBeGreaterThanOrEqual(lines[i].timeMs);
+    }
+  });
+
+  it("should not share a parse with an unprofiled request", async () => {
+    const [plain, profiled] = await Promise.all([
+      parseGCode(fixturePath("arcs.ngc"), { iniPath }),
+      parseGCode(fixturePath("arcs.ngc"), { iniPath, profile: true }),
+    ]);
+
+    expect(plain.profile).toBeUndefined();
+    expect(profiled.profile).toBeDefined();
+    expect(profiled.operations.length).toBe(plain.operations.length);
+  });
+});
@@ -0,0 +1,121 @@
+/**
+ * Integration tests for the toolpath path sampler
+ */
+
+import * as path from "path";
+import { parseGCode, parseGCodeCompact, PathSampler } from "../../src/ts";
+
+/** Get absolute path to a fixture file */
+const fixturePath = (name: string): string =>
+  path.join(__dirname, "../fixtures", name);
+
+/** Path to the machine configuration INI file */
+const iniPath = path.join(__dirname, "../config.ini");
+
+const expectPos = (actual: ArrayLike<number>, expected: number[]): void => {
+  for (let i = 0; i < 3; i++) {
+    expect(actual[i]).toBeCloseTo(expected[i], 6);
+  }
+};
+
+describe("PathSampler", () => {
+  // simple_linear.ngc: G0 to Z5, G1 Z0 at F100, 4 x 50 mm square at F200,
+  // G0 to Z10
+  let linear: PathSampler;
+
+  beforeAll(async () => {
+    const result = await parseGCode(fixturePath("simple_linear.ngc"), { iniPath });
+    linear = new PathSampler(result, { rapidRate: 5000 });
+  });
+
+  it("should measure length and estimated time", () => {
+    expect(linear.length).toBeCloseTo(220, 6);
+    // 15 mm of rapids, 5 mm at F100, 200 mm at F200
+    expect(linear.duration).toBeCloseTo((15 / 5000 + 5 / 100 + 200 / 200) * 60, 6);
+    expect(linear.segmentCount).toBe(7);
+  });
+
+  it("should find positions by distance and by time", () => {
+    const byDistance = linear.positionAt({ distance: 35 });
+    expectPos(byDistance.pos, [25, 0, 0]);
+    expect(byDistance.lineNumber).toBe(13);
+    expect(byDistance.time).toBeCloseTo(5 / 5000 * 60 + 3 + 7.5, 6);
+
+    const byTime = linear.positionAt({ time: byDistance.time });
+    expectPos(byTime.pos, [25, 0, 0]);
+    expect(byTime.distance).toBeCloseTo(35, 6);
+    expect(byTime.opIndex).toBe(byDistance.opIndex);
+  });
+
+  it("should clamp queries outside the path", () => {
+    expectPos(linear.positionAt({ distance: -1 }).pos, [0, 0, 0]);
+    expectPos(linear.positionAt({ distance: 1e9 }).pos, [0, 0, 10]);
+    expectPos(linear.positionAt({ time: 1e9 }).pos, [0, 0, 10]);
+  });
+
+  it("should sample in batches", () => {
+    const distances = [0, 35, 80, 220];
+    const samples = linear.sample(distances);
+
+    expect(samples.positions.length).toBe(12);
+    distances.forEach((distance, i) => {
+      const single = linear.positionAt({ distance });
+      expectPos(samples.positions.subarray(i * 3, i * 3 + 3), Array.from(single.pos));
+      expect(samples.opIndices[i]).toBe(single.opIndex);
+      expect(samples.lineNumbers[i]).toBe(single.lineNumber);
+      expect(samples.times[i]).toBeCloseTo(single.time, 9);
+    });
+  });
+
+  it("should report the operation and line start", () => {
+    const op = linear.opAt(35);
+    expect(op).toBe(linear.positionAt({ distance: 35 }).opIndex);
+    expect(linear.lineDistance(13)).toBeCloseTo(10, 6);
+    expect(linear.lineDistance(10)).toBeCloseTo(5, 6);
+    expect(linear.lineDistance(1000)).toBe(-1);
+  });
+
+  it("should export a per-move timing table", () => {
+    const table = linear.timingTable();
+
+    expect(table.lineNumber.length).toBe(linear.segmentCount);
+    expect(Array.from(table.rapid)).toEqual([1, 0, 0, 0, 0, 0, 1]);
+    expect(table.lineNumber[2]).toBe(13);
+    expect(table.length[2]).toBeCloseTo(50, 6);
+    expect(table.duration[2]).toBeCloseTo(15, 6);
+    expect(table.length.reduce((a, b) => a + b, 0)).toBeCloseTo(linear.length, 6);
+    expect(table.duration.reduce((a, b) => a + b, 0)).toBeCloseTo(linear.duration, 6);
+  });
+
+  it("should follow arcs exactly", async () => {
+    const result = await parseGCode(fixturePath("arcs.ngc"), { iniPath });
+    const sampler = new PathSampler(result);
+
+    // Full CW circle on line 19: from (30, 0) around (35, 0)
+    const start = sampler.lineDistance(19);
+    expectPos(sampler.positionAt({ distance: start + 5 * Math.PI }).pos, [40, 0, 0]);
+    expectPos(
+      sampler.positionAt({ distance: start + 2.5 * Math.PI }).pos,
+      [35, 5, 0]
+    );
+  });
+
+  it("should build from the compact encoding", async () => {
+    const data = await parseGCodeCompact(fixturePath("arcs.ngc"), { iniPath });
+    const fromObjects = new PathSampler(
+      await parseGCode(fixturePath("arcs.ngc"), { iniPath })
+    );
+    const fromCompact = new PathSampler(data);
+
+    expect(fromCompact.segmentCount).toBe(fromObjects.segmentCount);
+    expect(fromCompact.length).toBeCloseTo(fromObjects.length, 2);
+    expect(fromCompact.duration).toBeCloseTo(fromObjects.duration, 2);
+  });
+
+  it("should reject invalid sources and rates", () => {
+    expect(() => new PathSampler("x" as never)).toThrow("source");
+    expect(
+      () => new PathSampler({ operations: [] } as never, { rapidRate: 0 })
+    ).toThrow("rapidRate");
+  });
+});
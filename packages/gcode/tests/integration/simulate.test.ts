@@ -0,0 +1,177 @@
+/**
+ * Integration tests for the trajectory planner simulation
+ */
+
+import * as fs from "fs";
+import * as path from "path";
+import {
+  parseGCode,
+  parseGCodeCompact,
+  PathSampler,
+  simulateToolpath,
+} from "../../src/ts";
+import { GCodeParseResult } from "@linuxcnc-node/types";
+
+/** Get absolute path to a fixture file */
+const fixturePath = (name: string): string =>
+  path.join(__dirname, "../fixtures", name);
+
+/** Path to the machine configuration INI file */
+const iniPath = path.join(__dirname, "../config.ini");
+
+describe("simulateToolpath", () => {
+  // simple_linear.ngc: G0 to Z5, G1 Z0 at F100, 4 x 50 mm square at F200,
+  // G0 to Z10. config.ini: axes at 30.48 mm/s and 508 mm/s^2
+  let linear: GCodeParseResult;
+
+  beforeAll(async () => {
+    linear = await parseGCode(fixturePath("simple_linear.ngc"), { iniPath });
+  });
+
+  it("should take at least the feed-rate estimate", async () => {
+    const sim = await simulateToolpath(linear, { iniPath });
+    // Rapids at the axis limit, feeds at their programmed rate
+    const ideal = 15 / 30.48 + (5 / 100) * 60 + (200 / 200) * 60;
+
+    expect(sim.duration).toBeGreaterThan(ideal);
+    expect(sim.duration).toBeLessThan(ideal + 1);
+    expect(sim.blocks).toBeGreaterThanOrEqual(1);
+  });
+
+  it("should report per-move timing", async () => {
+    const sim = await simulateToolpath(linear, { iniPath });
+    const { segments } = sim;
+
+    expect(segments.opIndex.length).toBe(7);
+    expect(segments.startTime[0]).toBe(0);
+    for (let i = 1; i < segments.startTime.length; i++) {
+      expect(segments.startTime[i]).toBeCloseTo(
+        segments.startTime[i - 1] + segments.duration[i - 1],
+        9
+      );
+    }
+    // 50 mm side at F200 reaches the programmed feed
+    expect(segments.length[2]).toBeCloseTo(50, 6);
+    expect(segments.peakVelocity[2]).toBeCloseTo(200, 6);
+    // The program starts and ends at rest
+    expect(segments.entryVelocity[0]).toBe(0);
+    expect(segments.exitVelocity[segments.exitVelocity.length - 1]).toBe(0);
+  });
+
+  it("should stop at corners with exact stop", async () => {
+    const blended = await simulateToolpath(linear, { iniPath });
+    const exact = await simulateToolpath(linear, { iniPath, exactStop: true });
+    const tight = await simulateToolpath(linear, { iniPath, tolerance: 0.001 });
+
+    expect(exact.duration).toBeGreaterThan(blended.duration);
+    expect(tight.duration).toBeGreaterThanOrEqual(blended.duration);
+    expect(tight.duration).toBeLessThanOrEqual(exact.duration);
+    for (let i = 0; i < exact.segments.exitVelocity.length; i++) {
+      expect(exact.segments.exitVelocity[i]).toBe(0);
+    }
+  });
+
+  it("should end each move under the program's motion mode", async () => {
+    const file = fixturePath("motion_modes.ngc");
+    const lines = fs.readFileSync(file, "utf8").split("\n");
+    const result = await parseGCode(file, { iniPath });
+    const sim = await simulateToolpath(result, { iniPath });
+    const { lineNumber, exitVelocity } = sim.segments;
+
+    /** Exit velocity of the move on the first line reading `text` */
+    const exitOf = (text: string, after = 0): number => {
+      const line = lines.indexOf(text, after) + 1;
+      const i = lineNumber.indexOf(line);
+      expect(i).toBeGreaterThanOrEqual(0);
+      return exitVelocity[i];
+    };
+    const g61 = lines.indexOf("G61");
+    const g64 = lines.indexOf("G64");
+
+    // G61.1 stops after every move, even into a tangent move
+    expect(exitOf("G1 X50")).toBe(0);
+    expect(exitOf("G1 X50 Y50")).toBe(0);
+    // G61 stops at the corner but runs through the tangent move
+    expect(exitOf("G1 X50 Y100")).toBe(0);
+    expect(exitOf("G1 X0 Y100")).toBeGreaterThan(0);
+    // G64 P0.001 blends slower than G64 without a tolerance
+    const tight = exitOf("G1 X0 Y0", g61);
+    expect(tight).toBeGreaterThan(0);
+    expect(tight).toBeLessThan(exitOf("G1 X0 Y-50", g64));
+  });
+
+  it("should apply the options only before the program sets a mode", async () => {
+    const result = await parseGCode(fixturePath("motion_modes.ngc"), { iniPath });
+    const plain = await simulateToolpath(result, { iniPath });
+    const options = await simulateToolpath(result, {
+      iniPath,
+      exactStop: true,
+      tolerance: 5,
+    });
+
+    // Only the first feed, before the G61.1, ends differently
+    expect(plain.segments.exitVelocity[1]).toBeGreaterThan(0);
+    expect(options.segments.exitVelocity[1]).toBe(0);
+    expect(Array.from(options.segments.exitVelocity.slice(2))).toEqual(
+      Array.from(plain.segments.exitVelocity.slice(2))
+    );
+  });
+
+  it("should apply overrides and limit overrides", async () => {
+    const base = await simulateToolpath(linear, { iniPath });
+    const slow = await simulateToolpath(linear, { iniPath, feedOverride: 0.5 });
+    const limited = await simulateToolpath(linear, {
+      iniPath,
+      limits: { maxAcceleration: 10 },
+    });
+
+    expect(slow.duration).toBeGreaterThan(base.duration + 50);
+    expect(limited.duration).toBeGreaterThan(base.duration);
+  });
+
+  it("should sample the motion at fixed steps", async () => {
+    const sim = await simulateToolpath(linear, { iniPath, sampleInterval: 0.05 });
+    const { time, positions, velocity } = sim.samples;
+
+    expect(time.length).toBeGreaterThan(sim.duration / 0.05);
+    expect(positions.length).toBe(time.length * 3);
+    for (let i = 1; i < time.length; i++) {
+      expect(time[i]).toBeGreaterThan(time[i - 1]);
+      expect(velocity[i]).toBeLessThanOrEqual(53.34 * 60 + 1e-6);
+    }
+    // Last sample is the end point
+    expect(time[time.length - 1]).toBeCloseTo(sim.duration, 9);
+    expect(Array.from(positions.slice(-3))).toEqual([0, 0, 10]);
+  });
+
+  it("should agree with the sampler's length on arcs", async () => {
+    const result = await parseGCode(fixturePath("arcs.ngc"), { iniPath });
+    const sampler = new PathSampler(result);
+    const sim = await simulateToolpath(result, { iniPath });
+
+    const total = sim.segments.length.reduce((sum, length) => sum + length, 0);
+    expect(total).toBeCloseTo(sampler.length, 6);
+  });
+
+  it("should accept compact results and limits without an INI", async () => {
+    const encoded = await parseGCodeCompact(fixturePath("simple_linear.ngc"), { iniPath });
+    const fromIni = await simulateToolpath(linear, { iniPath });
+    const fromLimits = await simulateToolpath(encoded, {
+      limits: {
+        maxVelocity: 53.34,
+        maxAcceleration: 508,
+        axisVelocity: [30.48, 30.48, 30.48],
+        axisAcceleration: [508, 508, 508],
+      },
+    });
+
+    expect(fromLimits.duration).toBeCloseTo(fromIni.duration, 3);
+  });
+
+  it("should reject missing limits", async () => {
+    await expect(simulateToolpath(linear, {})).rejects.toThrow(/iniPath/);
+    await expect(
+      simulateToolpath(linear, { iniPath: fixturePath("simple_linear.ngc") })
+    ).rejects.toThrow(/TRAJ/);
+  });
+});
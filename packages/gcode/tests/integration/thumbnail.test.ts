@@ -0,0 +1,161 @@
+/**
+ * Integration tests for toolpath thumbnail rendering
+ */
+
+import * as path from "path";
+import {
+  encodePng,
+  encodePngAsync,
+  parseGCode,
+  renderThumbnail,
+  renderThumbnails,
+} from "../../src/ts";
+import {
+  GCodeParseResult,
+  OperationType,
+  Thumbnail,
+  ThumbnailView,
+} from "@linuxcnc-node/types";
+
+/** Get absolute path to a fixture file */
+const fixturePath = (name: string): string =>
+  path.join(__dirname, "../fixtures", name);
+
+/** Path to the machine configuration INI file */
+const iniPath = path.join(__dirname, "../config.ini");
+
+/** Position array with XYZ set */
+const pos = (x: number, y: number, z: number): Float64Array =>
+  new Float64Array([x, y, z, 0, 0, 0, 0, 0, 0]);
+
+/** Count pixels with any alpha */
+const drawnPixels = (thumb: Thumbnail): number => {
+  let count = 0;
+  for (let i = 3; i < thumb.data.length; i += 4) {
+    if (thumb.data[i] > 0) count++;
+  }
+  return count;
+};
+
+/** RGBA of one pixel */
+const pixel = (thumb: Thumbnail, x: number, y: number): number[] =>
+  Array.from(thumb.data.subarray((y * thumb.width + x) * 4, (y * thumb.width + x) * 4 + 4));
+
+/** Hand-built result: a rapid up the Y axis, then a feed along X */
+const lShape = {
+  operations: [
+    { type: OperationType.TRAVERSE, lineNumber: 1, pos: pos(0, 10, 0) },
+    { type: OperationType.FEED, lineNumber: 2, pos: pos(10, 10, 0) },
+  ],
+  extents: {
+    min: new Float64Array([0, 0, 0]),
+    max: new Float64Array([10, 10, 0]),
+  },
+  dependencies: [],
+} as unknown as GCodeParseResult;
+
+describe("renderThumbnail", () => {
+  it("should render an RGBA image of the requested size", async () => {
+    const thumb = await renderThumbnail(lShape, { width: 64, height: 48 });
+
+    expect(thumb.width).toBe(64);
+    expect(thumb.height).toBe(48);
+    expect(thumb.data.length).toBe(64 * 48 * 4);
+    expect(drawnPixels(thumb)).toBeGreaterThan(0);
+  });
+
+  it("should colour rapids and feeds and fit the path", async () => {
+    const thumb = await renderThumbnail(lShape, {
+      width: 21,
+      height: 21,
+      padding: 0,
+      view: ThumbnailView.TOP,
+      feedColor: 0x00ff00ff,
+      rapidColor: 0xff0000ff,
+    });
+
+    // Rapid along the left edge, feed along the top edge
+    expect(pixel(thumb, 0, 10)).toEqual([255, 0, 0, 255]);
+    expect(pixel(thumb, 10, 0)).toEqual([0, 255, 0, 255]);
+    expect(pixel(thumb, 10, 10)).toEqual([0, 0, 0, 0]);
+  });
+
+  it("should skip rapids when asked", async () => {
+    const thumb = await renderThumbnail(lShape, {
+      width: 21,
+      height: 21,
+      padding: 0,
+      view: ThumbnailView.TOP,
+      showRapids: false,
+    });
+
+    // Only the feed remains, so it is scaled across the full width
+    expect(pixel(thumb, 0, 10)[3]).toBeGreaterThan(0);
+    expect(pixel(thumb, 0, 0)[3]).toBe(0);
+  });
+
+  it("should fill the background", async () => {
+    const empty = { ...lShape, operations: [] } as GCodeParseResult;
+    const thumb = await renderThumbnail(empty, {
+      width: 8,
+      height: 8,
+      background: 0x102030ff,
+    });
+
+    expect(pixel(thumb, 0, 7)).toEqual([0x10, 0x20, 0x30, 0xff]);
+  });
+
+  it("should draw arcs from a parsed program", async () => {
+    const result = await parseGCode(fixturePath("arcs.ngc"), { iniPath });
+    const top = await renderThumbnail(result, { view: ThumbnailView.TOP });
+    const iso = await renderThumbnail(result);
+
+    expect(drawnPixels(top)).toBeGreaterThan(100);
+    expect(drawnPixels(iso)).toBeGreaterThan(100);
+  });
+});
+
+describe("renderThumbnails", () => {
+  it("should render one image per result, in order", async () => {
+    const results = await Promise.all(
+      ["simple_linear.ngc", "arcs.ngc", "mixed.ngc"].map((name) =>
+        parseGCode(fixturePath(name), { iniPath })
+      )
+    );
+
+    const batch = await renderThumbnails(results, { width: 96, height: 64, threads: 2 });
+    expect(batch).toHaveLength(3);
+
+    for (let i = 0; i < results.length; i++) {
+      const single = await renderThumbnail(results[i], { width: 96, height: 64 });
+      expect(Buffer.from(batch[i].data).equals(Buffer.from(single.data))).toBe(true);
+    }
+  });
+
+  it("should reject results without operations", async () => {
+    await expect(
+      renderThumbnails([{} as GCodeParseResult])
+    ).rejects.toThrow("operations");
+  });
+});
+
+describe("encodePng", () => {
+  it("should produce a PNG with the thumbnail size", async () => {
+    const thumb = await renderThumbnail(lShape, { width: 40, height: 30 });
+    const png = encodePng(thumb);
+
+    expect(png.subarray(0, 8)).toEqual(
+      Buffer.from([137, 80, 78, 71, 13, 10, 26, 10])
+    );
+    expect(png.toString("latin1", 12, 16)).toBe("IHDR");
+    expect(png.readUInt32BE(16)).toBe(40);
+    expect(png.readUInt32BE(20)).toBe(30);
+    expect(png.toString("latin1", png.length - 8, png.length - 4)).toBe("IEND");
+  });
+
+  it("should encode the same file off the event loop", async () => {
+    const thumb = await renderThumbnail(lShape, { width: 40, height: 30 });
+
+    expect(await encodePngAsync(thumb)).toEqual(encodePng(thumb));
+  });
+});
@@ -0,0 +1,151 @@
+/**
+ * Integration tests for dependency tracking and the program watcher
+ */
+
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+import { parseGCode, watchGCode, ProgramWatcher } from "../../src/ts";
+import { GCodeParseResult } from "@linuxcnc-node/types";
+
+/** Get absolute path to a fixture file */
+const fixturePath = (name: string): string =>
+  path.join(__dirname, "../fixtures", name);
+
+/** Path to the machine configuration INI file */
+const iniPath = path.join(__dirname, "../config.ini");
+
+/**
+ * Write an INI whose SUBROUTINE_PATH points at `subsDir`.
+ * Derived from config.ini with absolute paths.
+ */
+function writeSubroutineIni(dir: string, subsDir: string): string {
+  const base = fs.readFileSync(iniPath, "utf8");
+  const ini = base.replace(
+    "[RS274NGC]\nPARAMETER_FILE = sim_mm.var",
+    [
+      "[RS274NGC]",
+      `PARAMETER_FILE = ${path.join(dir, "subs.var")}`,
+      `SUBROUTINE_PATH = ${subsDir}`,
+    ].join("\n")
+  );
+
+  const subsIniPath = path.join(dir, "subs.ini");
+  fs.writeFileSync(subsIniPath, ini);
+  return subsIniPath;
+}
+
+/** Resolve with the watcher's next event of the given kind */
+function nextEvent<T>(watcher: ProgramWatcher, event: string): Promise<T> {
+  return new Promise<T>((resolve, reject) => {
+    const timer = setTimeout(
+      () => reject(new Error(`Timed out waiting for '${event}'`)),
+      10000
+    );
+    watcher.once(event, (value: T) => {
+      clearTimeout(timer);
+      resolve(value);
+    });
+  });
+}
+
+describe("dependency tracking", () => {
+  let tmpDir: string;
+  let subsIniPath: string;
+
+  beforeAll(() => {
+    tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), "linuxcnc-node-deps-"));
+    subsIniPath = writeSubroutineIni(tmpDir, fixturePath("subs"));
+  });
+
+  afterAll(() => {
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+  });
+
+  it("should report no dependencies for a self-contained program", async () => {
+    const result = await parseGCode(fixturePath("simple_linear.ngc"), { iniPath });
+    expect(result.dependencies).toEqual([]);
+  });
+
+  it("should record external subroutine files once", async () => {
+    const result = await parseGCode(fixturePath("external_sub.ngc"), {
+      iniPath: subsIniPath,
+    });
+
+    expect(result.dependencies).toEqual([
+      fs.realpathSync(fixturePath("subs/square.ngc")),
+    ]);
+  });
+});
+
+describe("watchGCode", () => {
+  let tmpDir: string;
+  let subsDir: string;
+  let programPath: string;
+  let subsIniPath: string;
+  let watcher: ProgramWatcher | null = null;
+
+  beforeEach(() => {
+    tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), "linuxcnc-node-watch-"));
+    subsDir = path.join(tmpDir, "subs");
+    fs.mkdirSync(subsDir);
+    fs.copyFileSync(fixturePath("subs/square.ngc"), path.join(subsDir, "square.ngc"));
+    programPath = path.join(tmpDir, "program.ngc");
+    fs.copyFileSync(fixturePath("external_sub.ngc"), programPath);
+    subsIniPath = writeSubroutineIni(tmpDir, subsDir);
+  });
+
+  afterEach(() => {
+    watcher?.close();
+    watcher = null;
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+  });
+
+  it("should re-parse when the program changes", async () => {
+    watcher = watchGCode(programPath, { iniPath: subsIniPath, debounceMs: 20 });
+    const initial = await watcher.start();
+    expect(watcher.result).toBe(initial);
+
+    const invalidated = nextEvent<string>(watcher, "invalidated");
+    const reparsed = nextEvent<GCodeParseResult>(watcher, "result");
+    fs.writeFileSync(programPath, "G21 G90\nG0 X1 Y1 Z5\nG1 X2 F100\nM2\n");
+
+    expect(await invalidated).toBe(programPath);
+    const result = await reparsed;
+    expect(result.operations.length).not.toBe(initial.operations.length);
+    expect(result.dependencies).toEqual([]);
+    expect(watcher.result).toBe(result);
+  });
+
+  it("should re-parse when a subroutine dependency changes", async () => {
+    watcher = watchGCode(programPath, { iniPath: subsIniPath, debounceMs: 20 });
+    const initial = await watcher.start();
+    const subPath = fs.realpathSync(path.join(subsDir, "square.ngc"));
+    expect(initial.dependencies).toEqual([subPath]);
+
+    const reparsed = nextEvent<GCodeParseResult>(watcher, "result");
+    fs.writeFileSync(
+      subPath,
+      "O<square> sub\n  G1 X#1 Y0 F200\nO<square> endsub\nM2\n"
+    );
+
+    const result = await reparsed;
+    expect(result.operations.length).toBeLessThan(initial.operations.length);
+  });
+
+  it("should stop watching when the initial parse fails", async () => {
+    const missingPath = path.join(tmpDir, "missing.ngc");
+    watcher = watchGCode(missingPath, { iniPath: subsIniPath, debounceMs: 20 });
+    await expect(watcher.start()).rejects.toThrow();
+
+    const onResult = jest.fn();
+    watcher.on("result", onResult);
+    fs.copyFileSync(programPath, missingPath);
+    await new Promise((resolve) => setTimeout(resolve, 300));
+    expect(onResult).not.toHaveBeenCalled();
+
+    // Retrying picks the now existing program up
+    const result = await watcher.start();
+    expect(result.operations.length).toBeGreaterThan(0);
+  });
+});
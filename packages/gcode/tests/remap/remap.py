@@ -0,0 +1,21 @@
+# Tool-change and probing remaps used by the remap benchmark.
+# Kept close to what production configs do: every M6 and every probe
+# cycle goes through Python and back into the interpreter.
+from interpreter import INTERP_OK
+
+
+def tool_change(self, **words):
+    tool = int(self.selected_tool)
+    self.execute("G53 G0 Z50")
+    self.execute("M61 Q%d" % tool)
+    return INTERP_OK
+
+
+def probe_cycle(self, **words):
+    x = words.get("x", 0.0)
+    y = words.get("y", 0.0)
+    z = words["z"]
+    self.execute("G0 X%.4f Y%.4f" % (x, y))
+    self.execute("G38.2 Z%.4f F100" % z)
+    self.execute("G0 Z5")
+    return INTERP_OK
@@ -0,0 +1,2 @@
+# Python toplevel for the remap benchmark configuration
+import remap
@@ -111,3 +111,11 @@ export enum EmcDebug {
   GDBONSIGNAL = 0x00020000,
   STATE_TAGS = 0x00080000,
 }
+
+export enum CommandJournalEvent {
+  SENT = 0,
+  WRITE_FAILED = 1,
+  ACCEPTED = 2,
+  COMPLETED = 3,
+  TIMED_OUT = 4,
+}
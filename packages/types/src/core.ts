@@ -13,11 +13,15 @@ import {
   JointType,
   OrientState,
   EmcDebug,
+  CommandJournalEvent,
 } from "./constants";
 
 /** Stride for position data in Float64Array: x, y, z, a, b, c, u, v, w, motionType */
 export const POSITION_STRIDE = 10;
 
+/** Stride of ToolTableColumns.offset: x, y, z, a, b, c, u, v, w */
+export const TOOL_OFFSET_STRIDE = 9;
+
 /** Index constants for position logger data in Float64Array (10 elements with MotionType) */
 export enum PositionLoggerIndex {
   X = 0,
@@ -723,15 +727,36 @@ export interface MotionStat {
   /** Trajectory planner status and motion execution information. */
   traj: TrajectoryStat;
 
-  /** Array of joint status information. Length matches EMCMOT_MAX_JOINTS. */
+  /**
+   * Array of joint status information. Length matches EMCMOT_MAX_JOINTS;
+   * entries past `traj.joints` are not configured and stay zeroed.
+   */
   joint: JointStat[];
 
-  /** Array of axis status information. Length matches EMCMOT_MAX_AXIS. */
+  /**
+   * Array of axis status information. Length matches EMCMOT_MAX_AXIS;
+   * entries past the highest axis in `traj.availableAxes` stay zeroed.
+   */
   axis: AxisStat[];
 
-  /** Array of spindle status information. Length matches EMCMOT_MAX_SPINDLES. */
+  /**
+   * Array of spindle status information. Length matches EMCMOT_MAX_SPINDLES;
+   * entries past `traj.spindles` are not configured and stay zeroed.
+   */
   spindle: SpindleStat[];
 
+  /**
+   * Number of configured digital I/O pins (motmod `num_dio`), or
+   * EMCMOT_MAX_DIO with a LinuxCNC without patch 0008.
+   */
+  digitalIOCount: number;
+
+  /**
+   * Number of configured analog I/O pins (motmod `num_aio`), or
+   * EMCMOT_MAX_AIO with a LinuxCNC without patch 0008.
+   */
+  analogIOCount: number;
+
   /** Current state of digital input pins. */
   digitalInput: number[];
 
@@ -785,6 +810,254 @@ export interface LinuxCNCStat {
 
   /** Complete tool table with all tool entries and their properties. */
   toolTable: ToolEntry[];
+
+  /** Job progress against the program set with StatChannel.setProgram(). */
+  progress: JobProgress;
+}
+
+/**
+ * Per-move timing of a program, in program order: the join key between a
+ * parse result and live status for progress tracking. Structurally matches
+ * PathSampler.timingTable() and ToolpathSimulation.segments from
+ * @linuxcnc-node/gcode.
+ */
+export interface ProgramTimingTable {
+  /** Source line of each move, as reported in task.motionLine */
+  lineNumber: Int32Array;
+  /** Path length of each move, in mm */
+  length: Float64Array;
+  /** Nominal duration of each move, in seconds */
+  duration: Float64Array;
+  /** 1 for rapids (scaled by the rapid override), 0 for feeds */
+  rapid?: Uint8Array;
+}
+
+/**
+ * Live job progress, computed natively on every status update.
+ */
+export interface JobProgress {
+  /** True while a program is set and the interpreter is running it */
+  active: boolean;
+
+  /** Index of the move being executed; -1 before the first move. */
+  segment: number;
+
+  /** Share of the nominal program time done, 0-100. */
+  percent: number;
+
+  /** Path length done, in mm. */
+  distanceDone: number;
+
+  /** Path length left, in mm. */
+  distanceRemaining: number;
+
+  /** Estimated seconds left at the current feed and rapid overrides. */
+  timeRemaining: number;
+}
+
+/**
+ * The tool table as one typed array per field, row i describing one tool
+ * (row 0 is the spindle). Cheap to fetch and transfer for large tables.
+ */
+export interface ToolTableColumns {
+  /** Number of rows */
+  count: number;
+  toolNo: Int32Array;
+  pocketNo: Int32Array;
+  diameter: Float64Array;
+  frontAngle: Float64Array;
+  backAngle: Float64Array;
+  orientation: Int32Array;
+  /** TOOL_OFFSET_STRIDE values per row: x, y, z, a, b, c, u, v, w */
+  offset: Float64Array;
+  /** All comments back to back as UTF-8 */
+  comments: Uint8Array;
+  /** Comment i is comments[commentOffsets[i] .. commentOffsets[i + 1]) */
+  commentOffsets: Uint32Array;
+  /**
+   * Row of each tool number, -1 if absent. Pocket rows take precedence over
+   * the spindle row. Very large tool numbers may be past its end; see
+   * findToolRow().
+   */
+  indexByToolNo: Int32Array;
+}
+
+/** Where a ProgramSequencer is in its cycle */
+export type SequencerPhase =
+  | "stopped"
+  | "waiting"
+  | "launching"
+  | "starting"
+  | "running";
+
+/**
+ * What a waiting ProgramSequencer waits for: a hold, the queue, the next
+ * program to be read, the machine to be ON, AUTO mode, the interpreter to go
+ * idle, or the permissive input.
+ */
+export type SequencerWaitReason =
+  | "hold"
+  | "queue"
+  | "staging"
+  | "machine"
+  | "mode"
+  | "interpreter"
+  | "permissive";
+
+/**
+ * One program run by a ProgramSequencer. Times are in seconds.
+ */
+export interface SequencerCycle {
+  /** 1-based count of programs launched since construction */
+  index: number;
+  file: string;
+  /** "aborted" when the machine left ON/AUTO mid-program */
+  result: "done" | "aborted" | "error";
+  error: string | null;
+  /** Previous program end (or start()) to this one running */
+  gap: number;
+  /** Close/open/run sent to the interpreter running */
+  launchTime: number;
+  /** Of which close and open (and the transfer to a remote task) */
+  openTime: number;
+  /** Interpreter running to idle */
+  cycleTime: number;
+  /** End of the cycle, Unix time in ms */
+  endedAt: number;
+}
+
+export interface SequencerState {
+  phase: SequencerPhase;
+  held: boolean;
+  holdReason: string | null;
+  waitingFor: SequencerWaitReason | null;
+  /** Program being launched or run */
+  current: string | null;
+  queued: string[];
+}
+
+/**
+ * Per-line statistics of one heatmap channel. Lines that were never sampled
+ * hold NaN.
+ */
+export interface LineHeatmapChannel {
+  min: Float64Array;
+  max: Float64Array;
+  mean: Float64Array;
+}
+
+/**
+ * Process statistics accumulated per program line (task.motionLine) while
+ * a program runs. All arrays are indexed by line number.
+ */
+export interface LineHeatmapData {
+  /** One past the highest line sampled */
+  lineCount: number;
+  /** Samples taken on each line */
+  samples: Uint32Array;
+  /** Seconds spent on each line */
+  time: Float64Array;
+  /** Seconds spent dwelling (task.delayLeft > 0) on each line */
+  dwellTime: Float64Array;
+  /** Statistics keyed by the stat path of each sampled channel */
+  channels: Record<string, LineHeatmapChannel>;
+  /** Samples dropped because the line was beyond maxLines */
+  dropped: number;
+}
+
+export interface StatPublisherOptions {
+  /** Unix domain socket path; a stale socket file is replaced */
+  path: string;
+  /** Seconds between status diffs (default: 0.02) */
+  interval?: number;
+  /**
+   * Bytes a client may fall behind before its backlog is dropped and it is
+   * sent a fresh snapshot (default: 1 MiB)
+   */
+  maxClientBuffer?: number;
+  /** Further connections are closed right away (default: 32) */
+  maxClients?: number;
+}
+
+export interface StatPublisherClient {
+  id: number;
+  /** Bytes queued for the client */
+  queued: number;
+  framesSent: number;
+  bytesSent: number;
+  /** Times the client fell behind and was resynced with a snapshot */
+  resyncs: number;
+}
+
+export interface StatPublisherStats {
+  running: boolean;
+  path: string | null;
+  /** Frames built since start */
+  frames: number;
+  clients: StatPublisherClient[];
+  lastError: string | null;
+}
+
+/**
+ * One frame of the stat publisher stream. A snapshot replaces all state;
+ * deltas apply on top of it.
+ */
+export interface StatFrame {
+  type: "snapshot" | "delta";
+  /** Frame number of the publisher; not contiguous per client */
+  sequence: number;
+  /** Status read time, Unix time in ms */
+  time: number;
+  /** Same paths and values as StatChannel deltas (without progress and tool table) */
+  changes: { path: string; value: unknown }[];
+}
+
+export interface CommandJournalOptions {
+  /** Journal file; an existing one is rotated to `<path>.1` */
+  path: string;
+  /** Bytes per file before rotating (default: 64 MiB) */
+  maxFileSize?: number;
+  /** Files kept, including the active one (default: 8) */
+  maxFiles?: number;
+  /** Ring capacity in records, rounded up to a power of two (default: 65536) */
+  capacity?: number;
+  /** Seconds between flushes to disk (default: 0.05) */
+  flushInterval?: number;
+}
+
+export interface CommandJournalStats {
+  active: boolean;
+  path: string | null;
+  /** Records taken into the ring since the process started */
+  recorded: number;
+  /** Records flushed to disk */
+  written: number;
+  /** Records lost because the ring was full */
+  dropped: number;
+  lastError: string | null;
+}
+
+/**
+ * One command journal record. A command yields SENT (or WRITE_FAILED),
+ * then ACCEPTED and COMPLETED (or TIMED_OUT) as far as they were observed.
+ */
+export interface CommandJournalRecord {
+  /** Unix time in ms */
+  time: number;
+  /** Monotonic time in ms, for intervals within one process */
+  monotonic: number;
+  /** Per-process record number; gaps mean dropped records */
+  sequence: number;
+  serial: number;
+  /** NML message type (EMC_*_TYPE) */
+  msgType: number;
+  event: CommandJournalEvent;
+  /** RcsStatus for COMPLETED, otherwise null */
+  status: RcsStatus | null;
+  /** Id of the channel that sent the command */
+  channel: number;
+  /** Message body after the NML header, truncated to 88 bytes */
+  payload: Uint8Array;
 }
 
 /**
@@ -860,3 +1133,25 @@ export type StatChange = {
     value: GetPropertyType<LinuxCNCStat, P>;
   };
 }[LinuxCNCStatPaths];
+
+/** Order of stat deltas within one poll: high first, low last */
+export type StatDeltaPriority = "high" | "normal" | "low";
+
+/**
+ * Rate limit and priority class for the stat paths matching `path`.
+ */
+export interface StatRateLimit {
+  /**
+   * Stat path or prefix, e.g. "motion.traj.position" or "task.*". "*"
+   * matches one segment ("motion.joint.*.velocity"). The rule covers every
+   * path below it; the most specific rule wins.
+   */
+  path: string;
+  /**
+   * Maximum deltas per second for each matching path (default: 0, no
+   * limit). Changes in between are coalesced to the latest value.
+   */
+  maxRate?: number;
+  /** Default: "normal" */
+  priority?: StatDeltaPriority;
+}
@@ -35,6 +35,19 @@ export enum OperationType {
   TOOL_OFFSET = 15,
   TOOL_CHANGE = 16,
   FEED_RATE_CHANGE = 17,
+  MOTION_MODE_CHANGE = 18,
+}
+
+/**
+ * Path control mode (G61, G61.1, G64).
+ */
+export enum MotionMode {
+  /** G61.1: stop after every move */
+  EXACT_STOP = 1,
+  /** G61: stop at corners that are not tangent */
+  EXACT_PATH = 2,
+  /** G64: blend corners */
+  CONTINUOUS = 3,
 }
 
 /**
@@ -270,6 +283,18 @@ export interface FeedRateChangeOperation {
   feedRate: number;
 }
 
+/**
+ * Path control mode change (G61, G61.1, G64).
+ */
+export interface MotionModeChangeOperation {
+  type: OperationType.MOTION_MODE_CHANGE;
+  mode: MotionMode;
+  /** G64 P path tolerance in mm (0 = no limit) */
+  tolerance: number;
+  /** G64 Q naive CAM tolerance in mm (0 = off) */
+  naivecamTolerance: number;
+}
+
 // ============================================================================
 // Union Types
 // ============================================================================
@@ -293,7 +318,8 @@ export type GCodeOperation =
   | XYRotationOperation
   | ToolOffsetOperation
   | ToolChangeOperation
-  | FeedRateChangeOperation;
+  | FeedRateChangeOperation
+  | MotionModeChangeOperation;
 
 // ============================================================================
 // Result Types
@@ -310,6 +336,82 @@ export interface Extents {
   max: Position3;
 }
 
+/**
+ * Interpreter error recorded when parsing with `collectErrors`.
+ */
+export interface ParseDiagnostic {
+  /** Line number in `filename` where the error occurred */
+  lineNumber: number;
+  /** File being read: the program itself or a called subroutine */
+  filename: string;
+  /** Interpreter error message */
+  message: string;
+  /** Source text of the failing block */
+  text: string;
+  /**
+   * Parsing stopped at this error (inside a subroutine, no forward progress,
+   * or `maxErrors` reached); later lines were not interpreted.
+   */
+  fatal: boolean;
+}
+
+/**
+ * One source line in a parse profile.
+ */
+export interface ProfileLine {
+  /** File the line is in: the program itself or a called subroutine */
+  filename: string;
+  /** Line number in `filename` */
+  lineNumber: number;
+  /** Source text of the line */
+  text: string;
+  /** Enclosing o-word subroutine (e.g. "o<probe>"), if any */
+  subroutine?: string;
+  /** Number of times the interpreter read and executed the line */
+  executions: number;
+  /** Total interpreter time spent on the line, in milliseconds */
+  timeMs: number;
+  /** Canon calls (motion, offsets, tool changes...) the line produced */
+  canonCalls: number;
+}
+
+/**
+ * Time spent in one o-word subroutine's own lines, excluding the
+ * subroutines it calls.
+ */
+export interface ProfileSubroutine {
+  /** Subroutine name as written, e.g. "o<probe>" or "o100" */
+  name: string;
+  /** File the subroutine is defined in */
+  filename: string;
+  /** Number of times the subroutine was called */
+  calls: number;
+  /** Line executions inside the subroutine body, over all calls */
+  blocks: number;
+  /** Total interpreter time spent in the body, in milliseconds */
+  timeMs: number;
+  /** Canon calls made from the body */
+  canonCalls: number;
+}
+
+/**
+ * Interpreter profile recorded when parsing with `profile`.
+ */
+export interface ParseProfile {
+  /** Wall time of the whole parse, in milliseconds */
+  wallMs: number;
+  /** Time spent inside the interpreter's read/execute, in milliseconds */
+  interpreterMs: number;
+  /** Blocks read and executed, counting every loop iteration and call */
+  blocks: number;
+  /** Canon calls made in total */
+  canonCalls: number;
+  /** Hottest lines by time, descending, at most `profileLines` */
+  lines: ProfileLine[];
+  /** All subroutines that executed, by time descending */
+  subroutines: ProfileSubroutine[];
+}
+
 /**
  * Complete result from parsing a G-code file.
  */
@@ -318,6 +420,18 @@ export interface GCodeParseResult {
   operations: GCodeOperation[];
   /** Bounding box of all motion operations */
   extents: Extents;
+  /**
+   * Interpreter errors, in order. Only present when parsed with
+   * `collectErrors`; operations then hold everything that did interpret.
+   */
+  errors?: ParseDiagnostic[];
+  /** Interpreter profile. Only present when parsed with `profile`. */
+  profile?: ParseProfile;
+  /**
+   * Absolute paths of other files the interpreter read while parsing:
+   * external subroutines and ngc remap bodies. Excludes the program itself.
+   */
+  dependencies: string[];
 }
 
 /**
@@ -350,4 +464,316 @@ export interface ParseOptions {
    * @default 40
    */
   progressUpdates?: number;
+  /**
+   * Record interpreter errors in `result.errors`, skip the failing block and
+   * keep parsing, instead of rejecting at the first error.
+   * @default false
+   */
+  collectErrors?: boolean;
+  /**
+   * Maximum number of errors to collect before stopping.
+   * Only used with `collectErrors`.
+   * @default 100
+   */
+  maxErrors?: number;
+  /**
+   * Time every source line and subroutine the interpreter runs and report
+   * the result in `result.profile`. Adds a little overhead to the parse.
+   * @default false
+   */
+  profile?: boolean;
+  /**
+   * Number of hottest lines to keep in `result.profile.lines`.
+   * Only used with `profile`.
+   * @default 50
+   */
+  profileLines?: number;
+}
+
+/**
+ * Options for parsing into the compact transport encoding.
+ */
+export interface CompactParseOptions extends ParseOptions {
+  /**
+   * Quantisation step for positions, offsets, arc centres and NURBS control
+   * points, in mm. Feed rates, durations and other scalars stay exact.
+   * @default 0.0001
+   */
+  resolution?: number;
+}
+
+// ============================================================================
+// Pre-scan
+// ============================================================================
+
+/**
+ * Problem found by the pre-scan. Line and column are 1-based.
+ */
+export interface PrescanIssue {
+  lineNumber: number;
+  column: number;
+  message: string;
+}
+
+/**
+ * O-word subroutine defined in the scanned file.
+ */
+export interface PrescanSubroutine {
+  /** Normalised name: "<name>" for named subs, digits for numbered ones */
+  name: string;
+  startLine: number;
+  /** Line of the matching endsub, 0 if never closed */
+  endLine: number;
+}
+
+/**
+ * O-word call found in the scanned file.
+ */
+export interface PrescanCall {
+  name: string;
+  lineNumber: number;
+}
+
+/**
+ * Result of the interpreter-free pre-scan.
+ */
+export interface PrescanResult {
+  totalBytes: number;
+  lineCount: number;
+  /** Byte offset of the start of each line; lineOffsets[n - 1] is line n */
+  lineOffsets: Float64Array;
+  /** Word counts per letter ("G", "X", ...); letters never used are omitted */
+  wordCounts: Record<string, number>;
+  /** G-code histogram keyed as written ("G1", "G38.2") */
+  gCodes: Record<string, number>;
+  /** M-code histogram keyed as written ("M3", "M6") */
+  mCodes: Record<string, number>;
+  /** Malformed words and O-word structure errors */
+  issues: PrescanIssue[];
+  /** More issues were found than `maxIssues` */
+  issuesTruncated: boolean;
+  subroutines: PrescanSubroutine[];
+  calls: PrescanCall[];
+  /**
+   * Called subroutines not defined in the file. The interpreter resolves
+   * them as `<name>.ngc` on the INI's SUBROUTINE_PATH.
+   */
+  externalSubroutines: string[];
+}
+
+/**
+ * Options for pre-scanning a G-code file.
+ */
+export interface PrescanOptions {
+  /**
+   * Maximum number of issues to record.
+   * @default 1000
+   */
+  maxIssues?: number;
+}
+
+// ============================================================================
+// Thumbnails
+// ============================================================================
+
+/**
+ * Projection used for toolpath thumbnails.
+ */
+export enum ThumbnailView {
+  /** XY, looking down Z */
+  TOP = 1,
+  /** XZ, looking along +Y */
+  FRONT = 2,
+  /** YZ, looking along -X */
+  SIDE = 3,
+  /** Isometric from the +X -Y +Z corner */
+  ISO = 4,
+}
+
+/**
+ * Options for rendering toolpath thumbnails.
+ * Colours are 0xRRGGBBAA numbers.
+ */
+export interface ThumbnailOptions {
+  /** @default 256 */
+  width?: number;
+  /** @default 256 */
+  height?: number;
+  /** @default ThumbnailView.ISO */
+  view?: ThumbnailView;
+  /** Pixels kept clear around the toolpath. @default 4 */
+  padding?: number;
+  /** Draw G0 rapids. @default true */
+  showRapids?: boolean;
+  /** @default 0x00000000 (transparent) */
+  background?: number;
+  /** Colour of feeds and arcs. @default 0x33cc33ff */
+  feedColor?: number;
+  /** @default 0xcc3333ff */
+  rapidColor?: number;
+  /**
+   * Maximum rendering threads for a batch (0 = one per CPU).
+   * @default 0
+   */
+  threads?: number;
+}
+
+/**
+ * Rendered thumbnail: straight-alpha RGBA pixels, row-major from the
+ * top-left corner.
+ */
+export interface Thumbnail {
+  width: number;
+  height: number;
+  /** width * height * 4 bytes */
+  data: Uint8Array;
+}
+
+// ============================================================================
+// Path sampling
+// ============================================================================
+
+/**
+ * Options for building a PathSampler.
+ */
+export interface PathSamplerOptions {
+  /** Speed of G0 rapids used for the time estimate, in mm/min. @default 5000 */
+  rapidRate?: number;
+  /** Feed rate assumed before the first F word, in mm/min. @default 1000 */
+  defaultFeedRate?: number;
+}
+
+/**
+ * A point along the toolpath: by path length or by estimated time.
+ */
+export type PathQuery = { distance: number } | { time: number };
+
+/**
+ * Tool position at a point along the toolpath.
+ */
+export interface PathSample {
+  /** Tool position as Position3: [x, y, z] */
+  pos: Position3;
+  /** Index of the motion operation in result.operations */
+  opIndex: number;
+  /** Source line of that operation */
+  lineNumber: number;
+  /** Path length from the start, in mm */
+  distance: number;
+  /** Estimated time from the start, in seconds */
+  time: number;
+}
+
+/**
+ * Batch of samples, one entry per requested value.
+ */
+export interface PathSamples {
+  /** XYZ triples: [x0, y0, z0, x1, y1, z1, ...] */
+  positions: Float64Array;
+  distances: Float64Array;
+  times: Float64Array;
+  opIndices: Uint32Array;
+  lineNumbers: Int32Array;
+}
+
+// ============================================================================
+// Trajectory planner simulation
+// ============================================================================
+
+/**
+ * Machine limits for the planner simulation, in mm/s and mm/s².
+ * Fields left out come from the INI file.
+ */
+export interface MachineLimits {
+  /** [TRAJ]MAX_LINEAR_VELOCITY */
+  maxVelocity?: number;
+  /** [TRAJ]MAX_LINEAR_ACCELERATION */
+  maxAcceleration?: number;
+  /** [AXIS_X/Y/Z]MAX_VELOCITY (0 = unlimited) */
+  axisVelocity?: Position3 | [number, number, number];
+  /** [AXIS_X/Y/Z]MAX_ACCELERATION (0 = unlimited) */
+  axisAcceleration?: Position3 | [number, number, number];
+  /** Moves of look-ahead, [TRAJ]ARC_BLEND_OPTIMIZATION_DEPTH. @default 50 */
+  lookahead?: number;
+}
+
+/**
+ * Options for simulateToolpath().
+ */
+export interface SimulationOptions {
+  /**
+   * LinuxCNC INI file to read the machine limits from. Optional when
+   * `limits` gives at least maxVelocity and maxAcceleration.
+   */
+  iniPath?: string;
+  /** Overrides for the INI limits */
+  limits?: MachineLimits;
+  /**
+   * Path tolerance of G64 P, in mm (0 = blend as fast as possible), until
+   * the program sets a mode. @default 0
+   */
+  tolerance?: number;
+  /**
+   * Stop after every move, as G61.1, until the program sets a mode.
+   * @default false
+   */
+  exactStop?: boolean;
+  /** Feed override factor. @default 1 */
+  feedOverride?: number;
+  /** Rapid override factor. @default 1 */
+  rapidOverride?: number;
+  /** Feed rate before the first F word, in mm/min (0 = max velocity). @default 0 */
+  defaultFeedRate?: number;
+  /** Seconds added per tool change. @default 0 */
+  toolChangeTime?: number;
+  /** Seconds between samples of the simulated motion (0 = none). @default 0 */
+  sampleInterval?: number;
+  /** Maximum planning threads (0 = one per CPU). @default 0 */
+  threads?: number;
+}
+
+/**
+ * Achieved motion per move, one entry per index. Velocities are in mm/min;
+ * a rigid tap has two entries (in and out).
+ */
+export interface SimulatedSegments {
+  /** Index of the operation in result.operations */
+  opIndex: Uint32Array;
+  lineNumber: Int32Array;
+  /** Seconds from program start */
+  startTime: Float64Array;
+  /** Seconds */
+  duration: Float64Array;
+  /** mm */
+  length: Float64Array;
+  /** Programmed feed (or rapid rate) times the override */
+  requestedVelocity: Float64Array;
+  entryVelocity: Float64Array;
+  exitVelocity: Float64Array;
+  peakVelocity: Float64Array;
+}
+
+/**
+ * Simulated motion at fixed time steps.
+ */
+export interface SimulatedSamples {
+  /** Seconds from program start */
+  time: Float64Array;
+  /** XYZ triples: [x0, y0, z0, x1, y1, z1, ...] */
+  positions: Float64Array;
+  /** Path velocity, in mm/min */
+  velocity: Float64Array;
+  opIndex: Uint32Array;
+}
+
+/**
+ * Result of simulateToolpath().
+ */
+export interface ToolpathSimulation {
+  /** Estimated cycle time, in seconds */
+  duration: number;
+  /** Stop-to-stop blocks the path was planned in */
+  blocks: number;
+  segments: SimulatedSegments;
+  samples: SimulatedSamples;
 }